@@ -0,0 +1,124 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: bench_da_par.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: Scaling of parallel sort and parallel for from 1 to 64 threads
+// *               usage: bench_da_par.out [number of elements]
+// ***************************************************************************************
+
+#define DC_PARALLEL
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+static f64 now_seconds()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (f64)ts.tv_sec + (f64)ts.tv_nsec / 1e9;
+}
+
+DC_DV_OP_FN_DECL(DCResI32, cmp_i64)
+{
+    DC_RES_i32();
+
+    i64 a = dc_dv_as(*_dv1, i64);
+    i64 b = dc_dv_as(*_dv2, i64);
+
+    dc_ret_ok((a > b) - (a < b));
+}
+
+DC_DA_VISITOR_FN_DECL(mix_value)
+{
+    (void)_ctx;
+
+    DC_RES_void();
+
+    u64 x = (u64)dc_dv_as(*_it, i64) ^ _idx;
+    x ^= x >> 33;
+    x *= 0xff51afd7ed558ccdULL;
+    x ^= x >> 33;
+
+    dc_dv_set(*_it, i64, (i64)x);
+
+    dc_ret();
+}
+
+DCResVoid bench(usize count)
+{
+    DC_RES_void();
+
+    DCDynVal* original = malloc(count * sizeof(DCDynVal));
+    DCDynVal* reference = malloc(count * sizeof(DCDynVal));
+    if (!original || !reference) dc_ret_e(2, "Memory allocation failed");
+
+    u64 seed = 88172645463325252ULL;
+    for (usize i = 0; i < count; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        original[i] = dc_dv(i64, (i64)seed);
+    }
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init2(&darr, count, 2, NULL));
+
+    printf("elements: " dc_fmt(usize) ", cpus: " dc_fmt(usize) "\n", count, dc_cpu_count());
+    printf("%8s %14s %14s %14s\n", "threads", "radix sort(s)", "cmp sort(s)", "par for(s)");
+
+    for (usize threads = 1; threads <= 64; threads *= 2)
+    {
+        f64 timings[3];
+
+        for (usize pass = 0; pass < 2; ++pass)
+        {
+            memcpy(darr.elements, original, count * sizeof(DCDynVal));
+            darr.count = count;
+
+            f64 start = now_seconds();
+            dc_try_fail(dc_da_par_sort(&darr, pass == 0 ? NULL : cmp_i64, threads));
+            timings[pass] = now_seconds() - start;
+
+            // Results must not depend on the number of threads or the comparator
+            if (threads == 1 && pass == 0)
+                memcpy(reference, darr.elements, count * sizeof(DCDynVal));
+            else if (memcmp(reference, darr.elements, count * sizeof(DCDynVal)) != 0)
+                dc_ret_e(5, "sort result depends on the number of threads");
+        }
+
+        f64 start = now_seconds();
+        dc_try_fail(dc_da_par_for(&darr, mix_value, NULL, threads));
+        timings[2] = now_seconds() - start;
+
+        printf("%8" PRIuMAX " %14.3f %14.3f %14.3f\n", (uintmax_t)threads, timings[0], timings[1], timings[2]);
+    }
+
+    free(reference);
+    free(original);
+
+    return dc_da_free(&darr);
+}
+
+int main(int argc, string argv[])
+{
+    DC_RES_void();
+
+    usize count = 10000000;
+    if (argc > 1) count = (usize)strtoull(argv[1], NULL, 10);
+
+    dc_try(bench(count));
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,168 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: bench_json.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: Throughput of parsing JSON and newline delimited JSON and of
+// *               writing it back
+// *               usage: bench_json.out [number of records]
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+static f64 now_seconds()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (f64)ts.tv_sec + (f64)ts.tv_nsec / 1e9;
+}
+
+/**
+ * Appends a record shaped like typical API output, every line is a document
+ */
+static DCResVoid append_record(DCStrBuilder* sb, usize id)
+{
+    return dc_sb_appendf(sb,
+                         "{\"id\": %" PRIuMAX ", \"name\": \"user_%" PRIuMAX "\", \"email\": \"user%" PRIuMAX
+                         "@example.com\", \"active\": %s, \"score\": %" PRIuMAX ".%02u, \"tags\": [\"alpha\", \"beta\", "
+                         "\"gamma\"], \"address\": {\"city\": \"Berlin\", \"zip\": \"10115\", \"geo\": [52.52, 13.405]}, "
+                         "\"bio\": \"Writes \\\"C\\\" for fun\\nand profit, likes caf\\u00e9s and long walks on the beach\", "
+                         "\"parent\": null}",
+                         (uintmax_t)id, (uintmax_t)id, (uintmax_t)id, id % 3 ? "true" : "false", (uintmax_t)(id % 1000),
+                         (u32)(id % 100));
+}
+
+DCResVoid bench(usize count)
+{
+    DC_RES_void();
+
+    DCStrBuilder ndjson;
+    dc_try_fail(dc_sb_init(&ndjson, 0));
+
+    DCStrBuilder array;
+    dc_try_fail(dc_sb_init(&array, 0));
+
+    dc_try_fail(dc_sb_append_char(&array, '['));
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_fail(append_record(&ndjson, i));
+        dc_try_fail(dc_sb_append_char(&ndjson, '\n'));
+
+        if (i > 0) dc_try_fail(dc_sb_append_str(&array, ",\n"));
+        dc_try_fail(append_record(&array, i));
+    }
+
+    dc_try_fail(dc_sb_append_char(&array, ']'));
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    printf("records: " dc_fmt(usize) ", document: " dc_fmt(usize) " bytes\n", count, array.len);
+    printf("%12s %10s %10s\n", "mode", "time(s)", "GB/s");
+
+    for (usize pass = 0; pass < 3; ++pass)
+    {
+        DCJsonParser jp;
+        dc_try_fail(dc_json_init(&jp, array.buf, array.len, &arena));
+
+        f64 start = now_seconds();
+        dc_try_or_fail_with3(DCRes, doc, dc_json_parse(&jp), {});
+        f64 elapsed = now_seconds() - start;
+
+        if (dc_dv_as(dc_unwrap2(doc), DCDynArrPtr)->count != count) dc_ret_e(5, "wrong number of parsed records");
+
+        printf("%12s %10.3f %10.3f\n", "document", elapsed, (f64)array.len / elapsed / 1e9);
+
+        dc_try_fail(dc_json_free(&jp));
+        dc_try_fail(dc_arena_reset(&arena));
+    }
+
+    for (usize pass = 0; pass < 3; ++pass)
+    {
+        DCJsonParser jp;
+        dc_try_fail(dc_json_init(&jp, ndjson.buf, ndjson.len, &arena));
+
+        usize parsed = 0;
+
+        f64 start = now_seconds();
+        while (true)
+        {
+            DCDynVal doc;
+            dc_try_or_fail_with3(DCResBool, next, dc_json_next(&jp, &doc), {});
+            if (!dc_unwrap2(next)) break;
+
+            parsed++;
+
+            // Every record only lives until the next one
+            dc_try_fail(dc_arena_reset(&arena));
+        }
+        f64 elapsed = now_seconds() - start;
+
+        if (parsed != count) dc_ret_e(5, "wrong number of parsed lines");
+
+        printf("%12s %10.3f %10.3f\n", "ndjson", elapsed, (f64)ndjson.len / elapsed / 1e9);
+
+        dc_try_fail(dc_json_free(&jp));
+    }
+
+    // Writing the parsed document back, compared to rendering it as text
+    DCJsonParser jp;
+    dc_try_fail(dc_json_init(&jp, array.buf, array.len, &arena));
+    dc_try_or_fail_with3(DCRes, doc, dc_json_parse(&jp), {});
+
+    for (usize pass = 0; pass < 3; ++pass)
+    {
+        DCJsonWriter jw;
+        dc_try_fail(dc_jw_init(&jw, NULL));
+
+        f64 start = now_seconds();
+        dc_try_fail(dc_jw_write(&jw, &dc_unwrap2(doc)));
+        f64 elapsed = now_seconds() - start;
+
+        printf("%12s %10.3f %10.3f\n", "write", elapsed, (f64)jw.sb.len / elapsed / 1e9);
+
+        dc_try_fail(dc_jw_free(&jw));
+    }
+
+    for (usize pass = 0; pass < 3; ++pass)
+    {
+        f64 start = now_seconds();
+        dc_try_or_fail_with3(DCResString, text, dc_tostr_dv(&dc_unwrap2(doc)), {});
+        f64 elapsed = now_seconds() - start;
+
+        printf("%12s %10.3f %10.3f\n", "tostr", elapsed, (f64)strlen(dc_unwrap2(text)) / elapsed / 1e9);
+
+        free(dc_unwrap2(text));
+    }
+
+    dc_try_fail(dc_json_free(&jp));
+
+    dc_try_fail(dc_arena_free(&arena));
+    dc_try_fail(dc_sb_free(&array));
+
+    return dc_sb_free(&ndjson);
+}
+
+int main(int argc, string argv[])
+{
+    DC_RES_void();
+
+    usize count = 200000;
+    if (argc > 1) count = (usize)strtoull(argv[1], NULL, 10);
+
+    dc_try(bench(count));
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
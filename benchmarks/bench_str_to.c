@@ -0,0 +1,133 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: bench_str_to.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: Parsing a column of integers with dc_str_to_* against strtol
+// *               usage: bench_str_to.out [number of values]
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+static f64 now_seconds()
+{
+    struct timespec ts;
+    timespec_get(&ts, TIME_UTC);
+
+    return (f64)ts.tv_sec + (f64)ts.tv_nsec / 1e9;
+}
+
+/**
+ * The `strtoll` way of converting, with the same checks `dc_str_to_i64` does
+ */
+static DCResI64 strtoll_i64(const string str)
+{
+    DC_RES_i64();
+
+    string end;
+    errno = 0;
+    long long val = strtoll(str, &end, 10);
+
+    if (end == str || *end != '\0') dc_ret_e(1, "str is not '\\0' terminated, or not provided");
+    if (errno == ERANGE) dc_ret_e(1, "result is not within the 'i64' range");
+
+    dc_ret_ok((i64)val);
+}
+
+/**
+ * The `strtoul` way of converting, with the same checks `dc_str_to_u32` does
+ */
+static DCResU32 strtoul_u32(const string str)
+{
+    DC_RES_u32();
+
+    string end;
+    errno = 0;
+    unsigned long val = strtoul(str, &end, 10);
+
+    if (end == str || *end != '\0') dc_ret_e(1, "str is not '\\0' terminated, or not provided");
+    if (val > UINT32_MAX || errno == ERANGE) dc_ret_e(1, "result is not within the 'u32' range");
+
+    dc_ret_ok((u32)val);
+}
+
+#define run(NAME, RES_TYPE, FN, STRS)                                                                                         \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        u64 sum = 0;                                                                                                           \
+        f64 start = now_seconds();                                                                                             \
+        for (usize i = 0; i < count; ++i)                                                                                      \
+        {                                                                                                                      \
+            RES_TYPE res = FN(STRS[i]);                                                                                        \
+            if (dc_is_err2(res)) dc_ret_e(5, "parsing failed");                                                                \
+            sum += (u64)dc_unwrap2(res);                                                                                       \
+        }                                                                                                                      \
+        f64 elapsed = now_seconds() - start;                                                                                   \
+        printf("%16s %10.3f %10.1f %20" PRIu64 "\n", NAME, elapsed, elapsed * 1e9 / (f64)count, sum);                        \
+    } while (0)
+
+DCResVoid bench(usize count)
+{
+    DC_RES_void();
+
+    // Numbers of every length like a real column, signed ones and unsigned ones
+    string signed_buf = malloc(count * 24);
+    string unsigned_buf = malloc(count * 16);
+    string* signed_strs = malloc(count * sizeof(string));
+    string* unsigned_strs = malloc(count * sizeof(string));
+
+    if (!signed_buf || !unsigned_buf || !signed_strs || !unsigned_strs) dc_ret_e(2, "Memory allocation failed");
+
+    srand(7);
+    for (usize i = 0; i < count; ++i)
+    {
+        u64 value = ((u64)rand() << 42) ^ ((u64)rand() << 21) ^ (u64)rand();
+        value >>= 1 + rand() % 60;
+
+        signed_strs[i] = signed_buf + i * 24;
+        snprintf(signed_strs[i], 24, "%s%" PRIu64, i % 2 ? "-" : "", value);
+
+        unsigned_strs[i] = unsigned_buf + i * 16;
+        snprintf(unsigned_strs[i], 16, "%" PRIu32, (u32)value);
+    }
+
+    printf("values: " dc_fmt(usize) "\n", count);
+    printf("%16s %10s %10s %20s\n", "parser", "time(s)", "ns/value", "checksum");
+
+    for (usize pass = 0; pass < 3; ++pass)
+    {
+        run("strtoll i64", DCResI64, strtoll_i64, signed_strs);
+        run("dc_str_to_i64", DCResI64, dc_str_to_i64, signed_strs);
+        run("strtoul u32", DCResU32, strtoul_u32, unsigned_strs);
+        run("dc_str_to_u32", DCResU32, dc_str_to_u32, unsigned_strs);
+    }
+
+    free(signed_buf);
+    free(unsigned_buf);
+    free(signed_strs);
+    free(unsigned_strs);
+
+    dc_ret();
+}
+
+int main(int argc, string argv[])
+{
+    DC_RES_void();
+
+    usize count = 2000000;
+    if (argc > 1) count = (usize)strtoull(argv[1], NULL, 10);
+
+    dc_try(bench(count));
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
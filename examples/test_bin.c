@@ -0,0 +1,251 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_bin.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DC_HT_HASH_FN_DECL(string_hash)
+{
+    DC_RES_u32();
+
+    if (_key->type != dc_dvt(string)) dc_ret_e(dc_e_code(TYPE), dc_e_msg(TYPE));
+
+    string str = dc_dv_as(*_key, string);
+    u32 hash = 5381;
+    i32 c;
+    while ((c = *str++))
+    {
+        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    }
+
+    dc_ret_ok(hash);
+}
+
+DC_HT_KEY_CMP_FN_DECL(string_key_cmp)
+{
+    return dc_dv_eq(_key1, _key2);
+}
+
+/**
+ * Builds an array with every serializable kind of value, the returned value
+ * owns everything
+ */
+DCRes make_tree()
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResDa, darr_res, dc_da_new(NULL), {});
+    DCDynArr* darr = dc_unwrap2(darr_res);
+
+    dc_try_or_fail_with3(DCResDa, nested_res, dc_da_new(NULL), {});
+    dc_try_fail_temp(DCResVoid, dc_da_push(dc_unwrap2(nested_res), dc_dv(u8, 255)));
+    dc_try_fail_temp(DCResVoid, dc_da_push(dc_unwrap2(nested_res), dc_dv(string, NULL)));
+
+    DCPair* pair = malloc(sizeof(DCPair));
+    pair->first = dc_dv(char, 'k');
+    pair->second = dc_dva(string, dc_unwrap2(dc_strdup("pair value")));
+
+    dc_try_or_fail_with3(DCResHt, ht_res, dc_ht_new(7, string_hash, string_key_cmp, NULL), {});
+    dc_try_fail_temp(DCResVoid, dc_ht_set(dc_unwrap2(ht_res), dc_dv(string, "one"), dc_dv(i32, 1), DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail_temp(DCResVoid, dc_ht_set(dc_unwrap2(ht_res), dc_dv(string, "two"), dc_dv(f64, 2.5), DC_HT_SET_CREATE_OR_FAIL));
+
+    DCDynVal values[] = {
+        dc_dv(b1, true),
+        dc_dv(i8, -8),
+        dc_dv(i16, -1600),
+        dc_dv(i32, INT32_MIN),
+        dc_dv(i64, INT64_MIN),
+        dc_dv(u16, 65535),
+        dc_dv(u32, 4000000000u),
+        dc_dv(u64, UINT64_MAX),
+        dc_dv(f32, 1.5f),
+        dc_dv(f64, -0.125),
+        dc_dv(size, -42),
+        dc_dv(usize, 42),
+        dc_dva(string, dc_unwrap2(dc_strdup("hello binary"))),
+        dc_unwrap2(dc_dv_istr("inline")),
+        dc_unwrap2(dc_dv_istr("an inline string too long to stay inline")),
+        dc_dva(DCDynArrPtr, dc_unwrap2(nested_res)),
+        dc_dva(DCPairPtr, pair),
+    };
+
+    dc_try_fail_temp(DCResVoid, __dc_da_append_values(darr, dc_count(values), values));
+
+    dc_try_or_fail_with3(DCRes, sv_res, dc_dv_box_sv(dc_sv("a string view", 2, 6)), {});
+    dc_try_fail_temp(DCResVoid, dc_da_push(darr, dc_unwrap2(sv_res)));
+
+    dc_try_fail_temp(DCResVoid, dc_da_push(darr, dc_dva(DCHashTablePtr, dc_unwrap2(ht_res))));
+
+    dc_ret_ok(dc_dva(DCDynArrPtr, darr));
+}
+
+/**
+ * Checks the hash table at the end of the read tree and prints the rest
+ */
+DCResVoid check_tree(DCDynVal* tree)
+{
+    DC_RES_void();
+
+    DCDynArr* darr = dc_dv_as(*tree, DCDynArrPtr);
+
+    DCDynVal* ht_dv = &dc_da_get2(*darr, darr->count - 1);
+    if (!dc_dv_is(*ht_dv, DCHashTablePtr)) dc_ret_e(5, "hash table is missing");
+
+    DCDynVal* found = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(dc_dv_as(*ht_dv, DCHashTablePtr), dc_dv(string, "two"), &found));
+    if (!found || dc_dv_as(*found, f64) != 2.5) dc_ret_e(5, "wrong hash table value");
+
+    DCDynArrView without_ht = {.elements = darr->elements, .count = darr->count - 1, .stride = 1};
+    dc_try_or_fail_with3(DCRes, without_ht_dv, dc_dv_box_dav(without_ht), {});
+    dc_dv_println(&dc_unwrap2(without_ht_dv));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(without_ht_dv), NULL));
+
+    if (dc_da_get_as(*darr, 3, i32) != INT32_MIN || dc_da_get_as(*darr, 4, i64) != INT64_MIN ||
+        dc_da_get_as(*darr, 7, u64) != UINT64_MAX)
+        dc_ret_e(5, "wrong integers after reading");
+
+    dc_ret();
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCRes, tree, make_tree(), {});
+
+    DCBinWriter bw;
+    dc_try_fail(dc_bw_init(&bw, NULL));
+    dc_try_fail(dc_bw_write(&bw, &dc_unwrap2(tree)));
+
+    printf("========\nEncoded tree\n========\n");
+    printf("-- bytes: '" dc_fmt(usize) "'\n", bw.len);
+
+    // Everything read without an arena is owned by the result
+    DCBinReader br;
+    dc_try_fail(dc_br_init(&br, bw.buf, bw.len, NULL, false));
+    br.hash_fn = string_hash;
+    br.key_cmp_fn = string_key_cmp;
+
+    dc_try_or_fail_with3(DCRes, read, dc_br_read(&br), {});
+    if (!dc_br_done(br)) dc_ret_e(5, "reader must consume the whole input");
+
+    printf("========\nRead back\n========\n");
+    dc_try_fail(check_tree(&dc_unwrap2(read)));
+
+    // Arena and zero copy, strings stay in the input buffer
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 256));
+
+    dc_try_fail(dc_br_init(&br, bw.buf, bw.len, &arena, true));
+    br.hash_fn = string_hash;
+    br.key_cmp_fn = string_key_cmp;
+
+    dc_try_or_fail_with3(DCRes, viewed, dc_br_read(&br), {});
+
+    printf("========\nRead into arena\n========\n");
+    dc_try_fail(check_tree(&dc_unwrap2(viewed)));
+
+    string str = dc_da_get_as(*dc_dv_as(dc_unwrap2(viewed), DCDynArrPtr), 12, string);
+    if ((u8*)str < bw.buf || (u8*)str >= bw.buf + bw.len) dc_ret_e(5, "zero copy strings must point into the input");
+
+    // Long inline strings stay on the heap but belong to the arena
+    DCDynVal* long_istr = &dc_da_get2(*dc_dv_as(dc_unwrap2(viewed), DCDynArrPtr), 14);
+    if (dc_dv_is_allocated(*long_istr) || strcmp(dc_dv_istr_str(*long_istr), "an inline string too long to stay inline") != 0)
+        dc_ret_e(5, "long inline strings read into an arena must not be owned");
+
+    dc_try_fail(dc_dv_free(long_istr, NULL));
+
+    dc_try_fail(dc_arena_free(&arena));
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(read), NULL));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(tree), NULL));
+
+    return dc_bw_free(&bw);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    fileptr file = tmpfile();
+    if (!file) dc_ret_e(5, "cannot create a temporary file");
+
+    // Values are streamed to the file while the buffer stays small
+    DCBinWriter bw;
+    dc_try_fail(dc_bw_init(&bw, file));
+
+    for (i64 i = 0; i < 50000; ++i)
+    {
+        DCDynVal value = (i % 2 == 0) ? dc_dv(i64, i * 1000) : dc_dv(string, "streamed");
+        dc_try_fail(dc_bw_write(&bw, &value));
+    }
+
+    dc_try_fail(dc_bw_flush(&bw));
+
+    printf("========\nStreamed to file\n========\n");
+    printf("-- file size: '%ld', buffer capacity: '" dc_fmt(usize) "'\n", ftell(file), bw.cap);
+
+    usize len = (usize)ftell(file);
+    u8* data = malloc(len);
+    rewind(file);
+    if (fread(data, 1, len, file) != len) dc_ret_e(5, "cannot read the temporary file back");
+
+    fclose(file);
+
+    DCBinReader br;
+    dc_try_fail(dc_br_init(&br, data, len, NULL, true));
+
+    usize count = 0;
+    i64 sum = 0;
+    while (!dc_br_done(br))
+    {
+        dc_try_or_fail_with3(DCRes, value, dc_br_read(&br), { free(data); });
+
+        if (dc_dv_is(dc_unwrap2(value), i64)) sum += dc_dv_as(dc_unwrap2(value), i64);
+        count++;
+    }
+
+    printf("-- values: '" dc_fmt(usize) "', sum: '" dc_fmt(i64) "'\n", count, sum);
+
+    if (count != 50000 || sum != (i64)624975000000) dc_ret_e(5, "wrong values read from the stream");
+
+    // Truncated input and values without meaning outside of the process are errors
+    dc_try_fail(dc_br_init(&br, data, 3, NULL, false));
+    br.pos = 2;
+    DCRes truncated = dc_br_read(&br);
+    if (dc_is_ok2(truncated)) dc_ret_e(5, "truncated input must fail");
+
+    DCDynVal ptr = dc_dv(voidptr, data);
+    DCResVoid rejected = dc_bw_write(&bw, &ptr);
+    if (dc_is_ok2(rejected)) dc_ret_e(5, "pointers must not be serialized");
+
+    free(data);
+
+    return dc_bw_free(&bw);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,272 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_btree.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+/**
+ * Shuffles the numbers with a fixed seed so every run is the same
+ */
+void shuffle(i64* numbers, usize count)
+{
+    u64 seed = 88172645463325252ull;
+    for (usize i = count - 1; i > 0; --i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        usize j = (usize)(seed % (i + 1));
+        i64 tmp = numbers[i];
+        numbers[i] = numbers[j];
+        numbers[j] = tmp;
+    }
+}
+
+/**
+ * Checks that every node but the root has enough keys, separators are the
+ * smallest key of their right subtree and all the leaves are at the same depth
+ */
+DCResUsize check_node(DCBTree* bt, DCBTreeNode* node, DCDynVal** out_min)
+{
+    DC_RES_usize();
+
+    if (node != bt->root && node->count < DC_BT_MIN_KEYS) dc_ret_e(5, "node has too few keys");
+
+    if (node->leaf)
+    {
+        *out_min = &node->keys[0];
+        dc_ret_ok(1);
+    }
+
+    usize depth = 0;
+    for (usize i = 0; i <= node->count; ++i)
+    {
+        DCDynVal* min = NULL;
+        dc_try_or_fail_with3(DCResUsize, child_depth, check_node(bt, node->slots.children[i], &min), {});
+
+        if (i == 0) *out_min = min;
+        if (i > 0 && dc_dv_as(node->keys[i - 1], i64) != dc_dv_as(*min, i64)) dc_ret_e(5, "wrong separator");
+        if (i > 0 && depth != dc_unwrap2(child_depth)) dc_ret_e(5, "leaves are not at the same depth");
+
+        depth = dc_unwrap2(child_depth);
+    }
+
+    dc_ret_ok(depth + 1);
+}
+
+DCResVoid check_tree(DCBTree* bt)
+{
+    DC_RES_void();
+
+    if (!bt->root) dc_ret();
+
+    DCDynVal* min = NULL;
+    dc_try_fail_temp(DCResUsize, check_node(bt, bt->root, &min));
+
+    // The leaf chain visits every key in order
+    DCBTreeIter it;
+    dc_try_fail(dc_bt_iter(bt, NULL, NULL, &it));
+
+    usize count = 0;
+    DCDynVal* prev = NULL;
+    DCDynVal* key = NULL;
+    while (true)
+    {
+        dc_try_or_fail_with3(DCResBool, next, dc_bt_next(&it, &key, NULL), {});
+        if (!dc_unwrap2(next)) break;
+
+        if (prev && dc_dv_as(*prev, i64) >= dc_dv_as(*key, i64)) dc_ret_e(5, "keys are not in order");
+
+        prev = key;
+        count++;
+    }
+
+    if (count != bt->count) dc_ret_e(5, "wrong number of entries");
+
+    dc_ret();
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    i64 numbers[10000];
+    for (usize i = 0; i < dc_count(numbers); ++i) numbers[i] = (i64)i;
+    shuffle(numbers, dc_count(numbers));
+
+    DCBTree bt;
+    dc_try_fail(dc_bt_init(&bt, NULL, NULL));
+
+    for (usize i = 0; i < dc_count(numbers); ++i)
+    {
+        string str = NULL;
+        dc_sprintf(&str, "value %" PRIiMAX, (intmax_t)numbers[i]);
+        dc_try_fail(dc_bt_set(&bt, dc_dv(i64, numbers[i]), dc_dva(string, str), DC_HT_SET_CREATE_OR_FAIL));
+    }
+
+    dc_try_fail(check_tree(&bt));
+
+    printf("========\nB+tree\n========\n");
+    printf("-- count: '" dc_fmt(usize) "'\n", bt.count);
+
+    DCDynVal* found = NULL;
+    dc_try_fail(dc_bt_find(&bt, dc_dv(i64, 4321), &found));
+    if (!found) dc_ret_e(5, "key must be found");
+
+    dc_dv_println(found);
+
+    dc_try_fail(dc_bt_find(&bt, dc_dv(i64, 10000), &found));
+    if (found) dc_ret_e(5, "key must not be found");
+
+    DCResVoid duplicate = dc_bt_set(&bt, dc_dv(i64, 5), dc_dv(string, "duplicate"), DC_HT_SET_CREATE_OR_FAIL);
+    if (dc_is_ok2(duplicate)) dc_ret_e(5, "duplicate keys must fail");
+
+    dc_try_fail(dc_bt_set(&bt, dc_dv(i64, 5), dc_dv(string, "updated"), DC_HT_SET_CREATE_OR_UPDATE));
+    dc_try_fail(dc_bt_find(&bt, dc_dv(i64, 5), &found));
+    if (strcmp(dc_dv_as(*found, string), "updated") != 0) dc_ret_e(5, "value must be updated");
+
+    // Range between two keys
+    DCDynVal from = dc_dv(i64, 100);
+    DCDynVal to = dc_dv(i64, 199);
+
+    DCBTreeIter it;
+    dc_try_fail(dc_bt_iter(&bt, &from, &to, &it));
+
+    i64 sum = 0;
+    DCDynVal* key = NULL;
+    while (true)
+    {
+        dc_try_or_fail_with3(DCResBool, next, dc_bt_next(&it, &key, NULL), {});
+        if (!dc_unwrap2(next)) break;
+
+        sum += dc_dv_as(*key, i64);
+    }
+
+    printf("-- sum of keys in [100, 199]: '" dc_fmt(i64) "'\n", sum);
+    if (sum != 14950) dc_ret_e(5, "wrong range");
+
+    // Deleting every even key in random order
+    for (usize i = 0; i < dc_count(numbers); ++i)
+    {
+        if (numbers[i] % 2 != 0) continue;
+
+        dc_try_or_fail_with3(DCResBool, deleted, dc_bt_delete(&bt, dc_dv(i64, numbers[i])), {});
+        if (!dc_unwrap2(deleted)) dc_ret_e(5, "existing key must be deleted");
+    }
+
+    dc_try_or_fail_with3(DCResBool, missing, dc_bt_delete(&bt, dc_dv(i64, 2)), {});
+    if (dc_unwrap2(missing)) dc_ret_e(5, "deleted key must not exist");
+
+    dc_try_fail(check_tree(&bt));
+
+    printf("-- count after deleting even keys: '" dc_fmt(usize) "'\n", bt.count);
+
+    // Range starting between two keys
+    from = dc_dv(i64, 9990);
+    dc_try_fail(dc_bt_iter(&bt, &from, NULL, &it));
+    dc_try_or_fail_with3(DCResBool, first, dc_bt_next(&it, &key, NULL), {});
+    if (!dc_unwrap2(first) || dc_dv_as(*key, i64) != 9991) dc_ret_e(5, "range must start from the next key");
+
+    for (usize i = 0; i < dc_count(numbers); ++i)
+    {
+        if (numbers[i] % 2 == 0) continue;
+
+        dc_try_fail_temp(DCResBool, dc_bt_delete(&bt, dc_dv(i64, numbers[i])));
+    }
+
+    if (bt.count != 0 || bt.root != NULL) dc_ret_e(5, "tree must be empty");
+
+    return dc_bt_free(&bt);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    usize count = 5000;
+
+    DCPair* pairs = malloc(count * sizeof(DCPair));
+    for (usize i = 0; i < count; ++i)
+    {
+        pairs[i].first = dc_dv(i64, (i64)i * 2);
+        pairs[i].second = dc_dva(string, dc_unwrap2(dc_strdup("bulk")));
+    }
+
+    DCBTree bt;
+    dc_try_fail(dc_bt_init(&bt, NULL, NULL));
+
+    // Unsorted input is rejected without taking anything
+    DCPair swapped = pairs[10];
+    pairs[10] = pairs[11];
+    pairs[11] = swapped;
+
+    DCResVoid unsorted = dc_bt_bulk_load(&bt, count, pairs);
+    if (dc_is_ok2(unsorted)) dc_ret_e(5, "unsorted input must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(unsorted));
+    dc_try_fail(dc_result_free(&unsorted));
+
+    pairs[11] = pairs[10];
+    pairs[10] = swapped;
+
+    dc_try_fail(dc_bt_bulk_load(&bt, count, pairs));
+    free(pairs);
+
+    dc_try_fail(check_tree(&bt));
+
+    printf("========\nBulk loaded B+tree\n========\n");
+    printf("-- count: '" dc_fmt(usize) "'\n", bt.count);
+
+    // The loaded tree keeps working as usual
+    for (i64 i = 1; i < 2000; i += 2) dc_try_fail(dc_bt_set(&bt, dc_dv(i64, i), dc_dv(string, "odd"), DC_HT_SET_CREATE_OR_FAIL));
+    for (i64 i = 0; i < 6000; i += 3) dc_try_fail_temp(DCResBool, dc_bt_delete(&bt, dc_dv(i64, i)));
+
+    dc_try_fail(check_tree(&bt));
+
+    printf("-- count after changes: '" dc_fmt(usize) "'\n", bt.count);
+
+    // Biggest keys
+    DCDynVal from = dc_dv(i64, 9990);
+
+    DCBTreeIter it;
+    dc_try_fail(dc_bt_iter(&bt, &from, NULL, &it));
+
+    DCDynVal* key = NULL;
+    DCDynVal* value = NULL;
+    while (true)
+    {
+        dc_try_or_fail_with3(DCResBool, next, dc_bt_next(&it, &key, &value), {});
+        if (!dc_unwrap2(next)) break;
+
+        printf("-- '" dc_fmt(i64) "' -> '%s'\n", dc_dv_as(*key, i64), dc_dv_as(*value, string));
+    }
+
+    return dc_bt_free(&bt);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
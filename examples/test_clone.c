@@ -0,0 +1,250 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_clone.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DC_HT_HASH_FN_DECL(string_hash)
+{
+    DC_RES_u32();
+
+    if (_key->type != dc_dvt(string)) dc_ret_e(dc_e_code(TYPE), dc_e_msg(TYPE));
+
+    string str = dc_dv_as(*_key, string);
+    u32 hash = 5381;
+    i32 c;
+    while ((c = *str++))
+    {
+        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    }
+
+    dc_ret_ok(hash);
+}
+
+DC_HT_KEY_CMP_FN_DECL(string_key_cmp)
+{
+    return dc_dv_eq(_key1, _key2);
+}
+
+DC_HT_PAIR_FREE_FN_DECL(string_pair_free)
+{
+    DC_RES_void();
+
+    dc_try_fail(dc_dv_free(&_pair->first, NULL));
+    dc_try_fail(dc_dv_free(&_pair->second, NULL));
+
+    dc_ret();
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCResHt, ht_res, dc_ht_new(17, string_hash, string_key_cmp, string_pair_free), {});
+    DCHashTable* ht = dc_unwrap2(ht_res);
+
+    // Both keys point to the same array
+    dc_try_or_fail_with3(DCResDa, shared_res, dc_da_new(NULL), {});
+    for (i32 i = 0; i < 3; ++i)
+    {
+        string str = NULL;
+        dc_sprintf(&str, "shared %d", i);
+        dc_try_fail(dc_da_push(dc_unwrap2(shared_res), dc_dva(string, str)));
+    }
+
+    dc_try_fail(dc_ht_set(ht, dc_dva(string, dc_unwrap2(dc_strdup("first"))), dc_dva(DCDynArrPtr, dc_unwrap2(shared_res)),
+                          DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail(dc_ht_set(ht, dc_dva(string, dc_unwrap2(dc_strdup("second"))), dc_dv(DCDynArrPtr, dc_unwrap2(shared_res)),
+                          DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_try_or_fail_with3(DCResDa, numbers_res, dc_da_new(NULL), {});
+    for (i64 i = 0; i < 1000; ++i) dc_try_fail(dc_da_push(dc_unwrap2(numbers_res), dc_dv(i64, i)));
+
+    dc_try_fail(dc_ht_set(ht, dc_dva(string, dc_unwrap2(dc_strdup("numbers"))), dc_dva(DCDynArrPtr, dc_unwrap2(numbers_res)),
+                          DC_HT_SET_CREATE_OR_FAIL));
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCDynVal original = dc_dva(DCHashTablePtr, ht);
+    dc_try_or_fail_with3(DCRes, clone_res, dc_dv_clone(&original, &arena), {});
+
+    // The copy does not need the original anymore
+    dc_try_fail(dc_dv_free(&original, NULL));
+
+    DCDynVal copy = dc_unwrap2(clone_res);
+    if (dc_dv_is_allocated(copy)) dc_ret_e(5, "cloned values must not be marked as allocated");
+
+    DCHashTable* copy_ht = dc_dv_as(copy, DCHashTablePtr);
+    if (copy_ht->key_count != 3) dc_ret_e(5, "wrong number of cloned keys");
+
+    DCDynVal* first = NULL;
+    DCDynVal* second = NULL;
+    DCDynVal* numbers = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(copy_ht, dc_dv(string, "first"), &first));
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(copy_ht, dc_dv(string, "second"), &second));
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(copy_ht, dc_dv(string, "numbers"), &numbers));
+
+    if (!first || !second || !numbers) dc_ret_e(5, "cloned keys must be found");
+
+    printf("========\nCloned hash table\n========\n");
+    dc_dv_println(first);
+
+    if (dc_dv_as(*first, DCDynArrPtr) != dc_dv_as(*second, DCDynArrPtr)) dc_ret_e(5, "shared arrays must stay shared");
+
+    DCDynArr* shared = dc_dv_as(*first, DCDynArrPtr);
+    if (shared->count != 3 || shared->owned_count != 0 || strcmp(dc_da_get_as(*shared, 2, string), "shared 2") != 0)
+        dc_ret_e(5, "wrong cloned array");
+
+    if (dc_da_get_as(*dc_dv_as(*numbers, DCDynArrPtr), 999, i64) != 999) dc_ret_e(5, "wrong cloned numbers");
+
+    // Changing the copy in place is fine, growing it stays inside the arena
+    dc_try_fail(dc_da_set(dc_dv_as(*numbers, DCDynArrPtr), 0, dc_dv(i64, -1)));
+
+    for (i64 i = 0; i < 1000; ++i) dc_try_fail(dc_da_push(dc_dv_as(*numbers, DCDynArrPtr), dc_dv(i64, i)));
+
+    string added[] = {"third", "fourth", "fifth", "sixth", "seventh", "eighth", "ninth", "tenth"};
+    for (usize i = 0; i < dc_count(added); ++i)
+        dc_try_fail(dc_ht_set(copy_ht, dc_dv(string, added[i]), dc_dv(usize, i), DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_try_fail(dc_ht_set(copy_ht, dc_dv(string, "first"), dc_dv(usize, 0), DC_HT_SET_UPDATE_OR_FAIL));
+
+    if (dc_da_storage(*dc_dv_as(*numbers, DCDynArrPtr)) != DC_DA_STORAGE_ARENA || copy_ht->key_count != 3 + dc_count(added))
+        dc_ret_e(5, "grown copy must stay in the arena");
+
+    // Releasing the arena releases the whole copy
+    return dc_arena_free(&arena);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    // An array that contains itself, a pair and a pointer to the same pair value
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    DCPair pair = {.first = dc_dv(string, "key"), .second = dc_dv(f64, 1.5)};
+
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCDynArrPtr, &darr)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCPairPtr, &pair)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCDynValPtr, &pair.second)));
+
+    dc_try_or_fail_with3(DCRes, istr, dc_dv_istr("an inline string that is too long to be kept inline"), {});
+    dc_try_fail(dc_da_push(&darr, dc_unwrap2(istr)));
+
+    dc_try_or_fail_with3(DCResDa, inner_res, dc_da_new(NULL), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(inner_res), dc_dv(i32, 7)));
+    dc_try_or_fail_with3(DCRes, handle, dc_rc_new_da(dc_unwrap2(inner_res)), {});
+    dc_try_fail(dc_da_push(&darr, dc_unwrap2(handle)));
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCDynVal original = dc_dv(DCDynArrPtr, &darr);
+    dc_try_or_fail_with3(DCRes, clone_res, dc_dv_clone(&original, &arena), {});
+
+    DCDynArr* copy = dc_dv_as(dc_unwrap2(clone_res), DCDynArrPtr);
+    if (copy == &darr) dc_ret_e(5, "array must be copied");
+
+    if (dc_da_get_as(*copy, 0, DCDynArrPtr) != copy) dc_ret_e(5, "cycles must point to the copy");
+
+    DCPair* pair_copy = dc_da_get_as(*copy, 1, DCPairPtr);
+    if (pair_copy == &pair || dc_da_get_as(*copy, 2, DCDynValPtr) == &pair.second) dc_ret_e(5, "pair must be copied");
+
+    if (strcmp(dc_dv_as(pair_copy->first, string), "key") != 0 || dc_dv_as(*dc_da_get_as(*copy, 2, DCDynValPtr), f64) != 1.5)
+        dc_ret_e(5, "wrong cloned pair");
+
+    DCDynVal* istr_copy = &dc_da_get2(*copy, 3);
+    if (strcmp(dc_dv_istr_str(*istr_copy), dc_dv_istr_str(dc_da_get2(darr, 3))) != 0) dc_ret_e(5, "wrong cloned inline string");
+
+    // The arena releases the heap copy, freeing the value leaves it alone
+    if (dc_dv_is_allocated(*istr_copy)) dc_ret_e(5, "cloned inline strings must not be owned");
+    dc_try_fail(dc_dv_free(istr_copy, NULL));
+
+    // Shared handles become borrowed handles of their own copy
+    DCDynVal* handle_copy = &dc_da_get2(*copy, 4);
+    if (dc_dv_is_allocated(*handle_copy) || dc_rc_da(*handle_copy) == dc_rc_da(dc_unwrap2(handle)))
+        dc_ret_e(5, "shared handle must be copied");
+
+    printf("========\nCloned array with a cycle\n========\n");
+    printf("-- arena used: '" dc_fmt(usize) "' bytes\n", arena.head->used);
+
+    // Values owning memory the arena can't copy are rejected
+    DCDynVal owned_ptr = dc_dva(voidptr, malloc(8));
+    DCRes rejected = dc_dv_clone(&owned_ptr, &arena);
+    if (dc_is_ok2(rejected)) dc_ret_e(5, "allocated voidptr must not be cloned");
+
+    printf("got expected error: %s\n", dc_err_msg2(rejected));
+    dc_try_fail(dc_result_free(&rejected));
+    dc_try_fail(dc_dv_free(&owned_ptr, NULL));
+
+    dc_try_fail(dc_arena_free(&arena));
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test3()
+{
+    DC_RES_void();
+
+    // Changed in place behind the back of the array
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+    for (i32 i = 0; i < 3; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i32, i)));
+
+    dc_da_get2(darr, 1) = dc_dva(string, dc_unwrap2(dc_strdup("changed in place")));
+
+    // Cloning looks at the elements themselves, the count is only needed to free the source
+    dc_try_fail_temp(DCResUsize, dc_da_update_owned(&darr));
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCDynVal original = dc_dv(DCDynArrPtr, &darr);
+    dc_try_or_fail_with3(DCRes, clone_res, dc_dv_clone(&original, &arena), {});
+
+    DCDynArr* copy = dc_dv_as(dc_unwrap2(clone_res), DCDynArrPtr);
+
+    printf("========\nCloned array changed in place\n========\n");
+    dc_dv_println(&dc_unwrap2(clone_res));
+
+    if (dc_da_get_as(*copy, 1, string) == dc_da_get_as(darr, 1, string) ||
+        strcmp(dc_da_get_as(*copy, 1, string), "changed in place") != 0)
+        dc_ret_e(5, "strings changed in place must be copied");
+
+    if (copy->owned_count != 0) dc_ret_e(5, "owned count must come from the copied elements");
+
+    dc_try_fail(dc_arena_free(&arena));
+
+    return dc_da_free(&darr);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test3());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,161 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_deque.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+void print_dq(DCDeque* dq)
+{
+    printf("(cap: '" dc_fmt(usize) "', head: '" dc_fmt(usize) "') ", dq->cap, dq->head);
+
+    dc_dq_for(print_loop, *dq, {
+        dc_dv_print(_it);
+        printf(" ");
+    });
+
+    printf("\n");
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    DCDeque dq;
+    dc_try_fail(dc_dq_init(&dq, 0, NULL));
+
+    // Work queue usage, pushing at the back and popping from the front wraps around
+    for (i32 i = 0; i < 6; ++i) dc_try_fail(dc_dq_push_back(&dq, dc_dv(i32, i)));
+
+    DCDynVal popped;
+    for (i32 i = 0; i < 4; ++i)
+    {
+        dc_try_fail(dc_dq_pop_front(&dq, &popped));
+        if (dc_dv_as(popped, i32) != i) dc_ret_e(5, "wrong element popped from the front");
+    }
+
+    for (i32 i = 6; i < 12; ++i) dc_try_fail(dc_dq_push_back(&dq, dc_dv(i32, i)));
+
+    printf("========\nWrapped around\n========\n");
+    print_dq(&dq);
+
+    if (dq.cap != DC_DQ_INITIAL_CAP) dc_ret_e(5, "deque must reuse the freed slots");
+
+    // Growing unwraps the elements
+    dc_try_fail(dc_dq_push_front(&dq, dc_dv(i32, 3)));
+    dc_try_fail(dc_dq_push_front(&dq, dc_dv(i32, 2)));
+    dc_try_fail(dc_dq_push_front(&dq, dc_dv(i32, 1)));
+
+    printf("========\nAfter growing\n========\n");
+    print_dq(&dq);
+
+    for (usize i = 0; i < dq.count; ++i)
+    {
+        if (dc_dq_get_as(dq, i, i32) != (i32)i + 1) dc_ret_e(5, "deque order is broken after growing");
+    }
+
+    dc_try_fail(dc_dq_pop_back(&dq, &popped));
+    if (dc_dv_as(popped, i32) != 11) dc_ret_e(5, "wrong element popped from the back");
+
+    dc_try_or_fail_with3(DCResPtr, last, dc_dq_get(&dq, dq.count - 1), {});
+    if (dc_dv_as(*dc_unwrap2(last), i32) != 10) dc_ret_e(5, "wrong last element");
+
+    DCResPtr out_of_bound = dc_dq_get(&dq, dq.count);
+    if (dc_is_ok2(out_of_bound)) dc_ret_e(5, "index out of bound must fail");
+
+    return dc_dq_free(&dq);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    DCDeque dq;
+    dc_try_fail(dc_dq_init(&dq, 8, NULL));
+
+    DCDynVal window[5];
+    for (i32 i = 0; i < 5; ++i) window[i] = dc_dv(i32, i);
+
+    // Sliding window, bulk operations wrap around the end of the buffer
+    dc_try_fail(dc_dq_push_back_values(&dq, 5, window));
+    dc_try_fail(dc_dq_pop_front_values(&dq, 3, NULL));
+    dc_try_fail(dc_dq_push_back_values(&dq, 5, window));
+
+    printf("========\nSliding window\n========\n");
+    print_dq(&dq);
+
+    DCDynVal out[4];
+    dc_try_fail(dc_dq_pop_front_values(&dq, 4, out));
+
+    i32 expected[] = {3, 4, 0, 1};
+    for (usize i = 0; i < 4; ++i)
+    {
+        if (dc_dv_as(out[i], i32) != expected[i]) dc_ret_e(5, "wrong elements popped in bulk");
+    }
+
+    dc_try_fail(dc_dq_push_front_values(&dq, 5, window));
+    dc_try_fail(dc_dq_pop_back_values(&dq, 2, out));
+
+    printf("========\nPushed to front, popped from back\n========\n");
+    print_dq(&dq);
+
+    if (dc_dv_as(out[0], i32) != 3 || dc_dv_as(out[1], i32) != 4) dc_ret_e(5, "wrong elements popped from the back");
+
+    DCResVoid too_many = dc_dq_pop_front_values(&dq, dq.count + 1, NULL);
+    if (dc_is_ok2(too_many)) dc_ret_e(5, "popping more than count must fail");
+
+    return dc_dq_free(&dq);
+}
+
+DCResVoid test3()
+{
+    DC_RES_void();
+
+    DCDeque dq;
+    dc_try_fail(dc_dq_init(&dq, 0, NULL));
+
+    // Allocated elements are freed by pop without output, clear and free
+    dc_try_fail(dc_dq_push_back(&dq, dc_dva(string, dc_unwrap2(dc_strdup("first")))));
+    dc_try_fail(dc_dq_push_back(&dq, dc_dva(string, dc_unwrap2(dc_strdup("second")))));
+    dc_try_fail(dc_dq_push_front(&dq, dc_dva(string, dc_unwrap2(dc_strdup("zeroth")))));
+
+    printf("========\nStrings\n========\n");
+    print_dq(&dq);
+
+    dc_try_fail(dc_dq_pop_front(&dq, NULL));
+    dc_try_fail(dc_dq_clear(&dq));
+
+    if (dq.count != 0 || dq.cap == 0) dc_ret_e(5, "clear must keep the capacity");
+
+    dc_try_fail(dc_dq_push_back(&dq, dc_dva(string, dc_unwrap2(dc_strdup("third")))));
+
+    return dc_dq_free(&dq);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test3());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,94 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_dv_compact.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+// The compact build of the examples defines it already
+#ifndef DC_DV_COMPACT
+#define DC_DV_COMPACT
+#endif
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    printf("========\nCompact dynamic value\n========\n");
+    printf("-- sizeof(DCDynVal): '" dc_fmt(usize) "'\n", sizeof(DCDynVal));
+
+    if (sizeof(DCDynVal) != 16) dc_ret_e(5, "compact dynamic value must be 16 bytes");
+
+    string text = "Hello compact world!";
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    // Narrow values are created as usual
+    dc_try_fail(dc_da_push(&darr, dc_dv(i32, 42)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 3.5)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, text)));
+
+    // Wide values need a box
+    dc_try_or_fail_with3(DCRes, sv_res, dc_dv_box_sv(dc_sv(text, 6, 7)), {});
+    dc_try_fail(dc_da_push(&darr, dc_unwrap2(sv_res)));
+
+    DCDynVal* sv_dv = &dc_da_get2(darr, 3);
+    if (!dc_dv_is(*sv_dv, DCStringView) || !dc_dv_is_boxed(*sv_dv)) dc_ret_e(5, "string view must be boxed");
+    if (dc_dv_is_not_allocated(*sv_dv)) dc_ret_e(5, "boxes must be marked as allocated");
+
+    // Boxed values are still reachable with dc_dv_as
+    if (dc_dv_as(*sv_dv, DCStringView).len != 7) dc_ret_e(5, "wrong boxed string view");
+
+    dc_try_or_fail_with3(DCResBool, eq_res, dc_dv_eq(sv_dv, sv_dv), {});
+    if (!dc_unwrap2(eq_res)) dc_ret_e(5, "boxed value must be equal to itself");
+
+    dc_try_or_fail_with3(DCResDav, view_res, dc_da_view(&darr, 0, 2), {});
+    dc_try_or_fail_with3(DCRes, view_dv, dc_dv_box_dav(dc_unwrap2(view_res)), {});
+
+    dc_try_fail(dc_dv_println(&dc_unwrap2(view_dv)));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(view_dv), NULL));
+
+    DCDynVal darr_dv = dc_dv(DCDynArrPtr, &darr);
+    dc_try_fail(dc_dv_println(&darr_dv));
+
+    // Boxes of cloned values are released along with the arena
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    dc_try_or_fail_with3(DCRes, clone_res, dc_dv_clone(&darr_dv, &arena), {});
+    DCDynVal* sv_clone = &dc_da_get2(*dc_dv_as(dc_unwrap2(clone_res), DCDynArrPtr), 3);
+
+    if (!dc_dv_is_boxed(*sv_clone) || sv_clone->value.DCStringView_box == sv_dv->value.DCStringView_box)
+        dc_ret_e(5, "cloned string view must have its own box");
+
+    // The arena owns the boxes of the clone
+    if (dc_dv_is_allocated(*sv_clone)) dc_ret_e(5, "boxes of cloned values must not be marked as allocated");
+
+    dc_try_fail(dc_dv_println(&dc_unwrap2(clone_res)));
+    dc_try_fail(dc_arena_free(&arena));
+
+    return dc_da_free(&darr);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -103,13 +103,14 @@ DCResVoid test2()
     DCDynArr darr;
 
     string some_text = "This is Navid";
+    dc_try_or_fail_with3(DCRes, name_sv, dc_dv_box_sv(dc_sv(some_text, 8, 5)), {});
 
     // Add elements
     dc_try_fail_da_init_with_values(&darr, NULL,
 
                                     dc_dv(u8, 42), dc_dv(i32, -12345), dc_dv(Person, person_new("Navid", 30)),
 
-                                    dc_dv(DCStringView, dc_sv(some_text, 8, 5)),
+                                    dc_unwrap2(name_sv),
 
                                     // here it is a literal string so it doesn't need
                                     // to be mark as allocated (that's why dc_dv is used)
@@ -142,6 +143,137 @@ DCResVoid test2()
     dc_ret();
 }
 
+/* Operations of the custom type can be registered once, dynamic values and
+    containers then use them without passing functions around */
+DC_DV_OP_FN_DECL(DCResBool, person_eq)
+{
+    DC_RES_bool();
+
+    Person* p1 = &dc_dv_as(*_dv1, Person);
+    Person* p2 = &dc_dv_as(*_dv2, Person);
+
+    dc_ret_ok(p1->age == p2->age && strcmp(p1->name, p2->name) == 0);
+}
+
+DC_DV_OP_FN_DECL(DCResI32, person_cmp)
+{
+    DC_RES_i32();
+
+    u8 age1 = dc_dv_as(*_dv1, Person).age;
+    u8 age2 = dc_dv_as(*_dv2, Person).age;
+
+    dc_ret_ok((age1 > age2) - (age1 < age2));
+}
+
+DC_DV_TOSTR_FN_DECL(person_tostr)
+{
+    DC_RES_string();
+
+    string result = NULL;
+    dc_sprintf(&result, "%s (" dc_fmt(u8) ")", dc_dv_as(*_value, Person).name, dc_dv_as(*_value, Person).age);
+
+    dc_ret_ok(result);
+}
+
+/* Allocated people own their name */
+DC_DV_FREE_FN_DECL(person_free)
+{
+    DC_RES_void();
+
+    free(dc_dv_as(*_value, Person).name);
+    dc_dv_as(*_value, Person).name = NULL;
+
+    dc_ret();
+}
+
+DC_DV_CONVERT_FN_DECL(person_to_bin)
+{
+    DC_RES();
+
+    DCPair* pair = malloc(sizeof(DCPair));
+    pair->first = dc_dv(string, dc_dv_as(*_value, Person).name);
+    pair->second = dc_dv(u8, dc_dv_as(*_value, Person).age);
+
+    dc_ret_ok(dc_dva(DCPairPtr, pair));
+}
+
+DC_DV_CONVERT_FN_DECL(person_from_bin)
+{
+    DC_RES();
+
+    DCPair* pair = dc_dv_as(*_value, DCPairPtr);
+
+    dc_try_or_fail_with3(DCResString, name, dc_strdup(dc_dv_as(pair->first, string)), {});
+
+    dc_ret_ok(dc_dva(Person, person_new(dc_unwrap2(name), dc_dv_as(pair->second, u8))));
+}
+
+DCResVoid test3()
+{
+    DC_RES_void();
+
+    DCDvVTable person_vtable = {
+        .name = "Person",
+        .eq_fn = person_eq,
+        .cmp_fn = person_cmp,
+        .tostr_fn = person_tostr,
+        .free_fn = person_free,
+        .to_bin_fn = person_to_bin,
+        .from_bin_fn = person_from_bin,
+    };
+
+    dc_try_fail(dc_dv_register_type(dc_dvt(Person), &person_vtable));
+
+    DCResVoid builtin = dc_dv_register_type(dc_dvt(string), &person_vtable);
+    if (dc_is_ok2(builtin)) dc_ret_e(5, "built-in types must not be registered");
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    dc_try_fail(dc_da_push(&darr, dc_dva(Person, person_new(dc_unwrap2(dc_strdup("Navid")), 30))));
+    dc_try_fail(dc_da_push(&darr, dc_dva(Person, person_new(dc_unwrap2(dc_strdup("James")), 40))));
+    dc_try_fail(dc_da_push(&darr, dc_dva(Person, person_new(dc_unwrap2(dc_strdup("Bob")), 20))));
+
+    // Sorting and finding use the registered functions
+    dc_try_fail(dc_da_sort(&darr, NULL));
+
+    DCDynVal james = dc_dv(Person, person_new("James", 40));
+    dc_try_or_fail_with3(DCResUsize, found, dc_da_find2(&darr, &james, NULL), {});
+    if (dc_unwrap2(found) != 2) dc_ret_e(5, "registered equality must be used");
+
+    printf("========\nRegistered extra type\n========\n");
+    printf("-- type name: '%s'\n", dc_tostr_dvt(&james));
+
+    DCDynVal darr_dv = dc_dv(DCDynArrPtr, &darr);
+    dc_try_fail(dc_dv_println(&darr_dv));
+
+    // Serialized as the pair it converts to and read back as a person
+    DCBinWriter bw;
+    dc_try_fail(dc_bw_init(&bw, NULL));
+    dc_try_fail(dc_bw_write(&bw, &darr_dv));
+
+    DCBinReader br;
+    dc_try_fail(dc_br_init(&br, bw.buf, bw.len, NULL, false));
+    dc_try_or_fail_with3(DCRes, read_res, dc_br_read(&br), {});
+
+    DCDynArr* people = dc_dv_as(dc_unwrap2(read_res), DCDynArrPtr);
+    if (people->count != darr.count) dc_ret_e(5, "people must be read back");
+
+    for (usize i = 0; i < darr.count; ++i)
+    {
+        dc_try_or_fail_with3(DCResBool, eq_res, dc_dv_eq(&people->elements[i], &darr.elements[i]), {});
+        if (!dc_unwrap2(eq_res)) dc_ret_e(5, "people must be read back");
+    }
+
+    dc_try_fail(dc_dv_println(&dc_unwrap2(read_res)));
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(read_res), NULL));
+    dc_try_fail(dc_bw_free(&bw));
+
+    // Allocated names are freed by the registered free function
+    return dc_da_free(&darr);
+}
+
 int main()
 {
     DC_RES_void();
@@ -152,5 +284,8 @@ int main()
     dc_try(test2());
     dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
 
+    dc_try(test3());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,207 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_dv_hash.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+/**
+ * Builds `[id, "name", (tags, [id, id + 1]), {"id": id, "name": "name"}]`, every
+ * call gives new containers with the same content
+ */
+static DCRes make_record(i32 id, string name, usize ht_cap, b1 reverse)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResDa, record_res, dc_da_new(NULL), {});
+    DCDynArr* record = dc_unwrap2(record_res);
+
+    dc_try_fail_temp(DCResVoid, dc_da_push(record, dc_dv(i32, id)));
+    dc_try_fail_temp(DCResVoid, dc_da_push(record, dc_dv(string, name)));
+
+    dc_try_or_fail_with3(DCResDa, tags_res, dc_da_new(NULL), {});
+    dc_try_fail_temp(DCResVoid, dc_da_push(dc_unwrap2(tags_res), dc_dv(i32, id)));
+    dc_try_fail_temp(DCResVoid, dc_da_push(dc_unwrap2(tags_res), dc_dv(i32, id + 1)));
+
+    DCPair* pair = malloc(sizeof(DCPair));
+    *pair = (DCPair){.first = dc_dv(string, "tags"), .second = dc_dva(DCDynArrPtr, dc_unwrap2(tags_res))};
+    dc_try_fail_temp(DCResVoid, dc_da_push(record, dc_dva(DCPairPtr, pair)));
+
+    // Hashing and comparing don't depend on the capacity or the order of keys
+    dc_try_or_fail_with3(DCResHt, fields_res, dc_ht_new(ht_cap, NULL, NULL, NULL), {});
+    DCHashTable* fields = dc_unwrap2(fields_res);
+
+    DCPair entries[] = {{dc_dv(string, "id"), dc_dv(i32, id)}, {dc_dv(string, "name"), dc_dv(string, name)}};
+    for (usize i = 0; i < dc_count(entries); ++i)
+    {
+        DCPair* entry = &entries[reverse ? dc_count(entries) - 1 - i : i];
+        dc_try_fail_temp(DCResVoid, dc_ht_set(fields, entry->first, entry->second, DC_HT_SET_CREATE_OR_FAIL));
+    }
+
+    dc_try_fail_temp(DCResVoid, dc_da_push(record, dc_dva(DCHashTablePtr, fields)));
+
+    dc_ret_ok(dc_dva(DCDynArrPtr, record));
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCRes, a_res, make_record(7, "seven", 3, false), {});
+    dc_try_or_fail_with3(DCRes, b_res, make_record(7, "seven", 31, true), {});
+    dc_try_or_fail_with3(DCRes, c_res, make_record(8, "seven", 3, false), {});
+
+    DCDynVal a = dc_unwrap2(a_res);
+    DCDynVal b = dc_unwrap2(b_res);
+    DCDynVal c = dc_unwrap2(c_res);
+
+    dc_try_or_fail_with3(DCResU64, a_hash, dc_dv_hash(&a, 0), {});
+    dc_try_or_fail_with3(DCResU64, b_hash, dc_dv_hash(&b, 0), {});
+    dc_try_or_fail_with3(DCResU64, c_hash, dc_dv_hash(&c, 0), {});
+    dc_try_or_fail_with3(DCResU64, seeded_hash, dc_dv_hash(&a, 42), {});
+
+    printf("========\nHashing nested values\n========\n");
+    dc_dv_println(&a);
+    printf("-- a: '%" PRIx64 "', b: '%" PRIx64 "', c: '%" PRIx64 "'\n", dc_unwrap2(a_hash), dc_unwrap2(b_hash), dc_unwrap2(c_hash));
+
+    if (dc_unwrap2(a_hash) != dc_unwrap2(b_hash)) dc_ret_e(5, "equal contents must have equal hashes");
+    if (dc_unwrap2(a_hash) == dc_unwrap2(c_hash) || dc_unwrap2(a_hash) == dc_unwrap2(seeded_hash))
+        dc_ret_e(5, "different contents or seeds must change the hash");
+
+    dc_try_or_fail_with3(DCResI32, a_b, dc_dv_cmp(&a, &b), {});
+    dc_try_or_fail_with3(DCResI32, a_c, dc_dv_cmp(&a, &c), {});
+    dc_try_or_fail_with3(DCResI32, c_a, dc_dv_cmp(&c, &a), {});
+
+    if (dc_unwrap2(a_b) != 0 || dc_unwrap2(a_c) >= 0 || dc_unwrap2(c_a) <= 0) dc_ret_e(5, "wrong order of records");
+
+    // Strings, inline strings and views of the same text are still different types
+    DCDynVal str = dc_dv(string, "seven");
+    dc_try_or_fail_with3(DCRes, sv_res, dc_dv_box_sv(dc_sv("sevenfold", 0, 5)), {});
+    dc_try_or_fail_with3(DCRes, sv2_res, dc_dv_box_sv(dc_sv("a seven", 2, 5)), {});
+    DCDynVal sv = dc_unwrap2(sv_res);
+    DCDynVal sv2 = dc_unwrap2(sv2_res);
+
+    dc_try_or_fail_with3(DCResU64, sv_hash, dc_dv_hash(&sv, 0), {});
+    dc_try_or_fail_with3(DCResU64, sv2_hash, dc_dv_hash(&sv2, 0), {});
+    dc_try_or_fail_with3(DCResU64, str_hash, dc_dv_hash(&str, 0), {});
+    dc_try_or_fail_with3(DCResI32, sv_str, dc_dv_cmp(&sv, &str), {});
+
+    if (dc_unwrap2(sv_hash) != dc_unwrap2(sv2_hash) || dc_unwrap2(sv_hash) == dc_unwrap2(str_hash) || dc_unwrap2(sv_str) == 0)
+        dc_ret_e(5, "wrong hash of views");
+
+    dc_try_fail(dc_dv_free(&sv, NULL));
+    dc_try_fail(dc_dv_free(&sv2, NULL));
+
+    dc_try_fail(dc_dv_free(&a, NULL));
+    dc_try_fail(dc_dv_free(&b, NULL));
+
+    return dc_dv_free(&c, NULL);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    // No hash or key comparison functions needed for built-in keys
+    DCHashTable ht;
+    dc_try_fail(dc_ht_init(&ht, 5, NULL, NULL, NULL));
+
+    DCDynArr key_arr;
+    dc_try_fail(dc_da_init(&key_arr, NULL));
+    dc_try_fail(dc_da_push(&key_arr, dc_dv(i32, 1)));
+    dc_try_fail(dc_da_push(&key_arr, dc_dv(i32, 2)));
+
+    DCPair key_pair = {.first = dc_dv(string, "x"), .second = dc_dv(f64, 0.5)};
+
+    dc_try_fail(dc_ht_set(&ht, dc_dv(i32, 1), dc_dv(string, "int"), DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail(dc_ht_set(&ht, dc_dv(i64, 1), dc_dv(string, "long"), DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail(dc_ht_set(&ht, dc_dv(string, "one"), dc_dv(string, "string"), DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail(dc_ht_set(&ht, dc_dv(DCDynArrPtr, &key_arr), dc_dv(string, "array"), DC_HT_SET_CREATE_OR_FAIL));
+    dc_try_fail(dc_ht_set(&ht, dc_dv(DCPairPtr, &key_pair), dc_dv(string, "pair"), DC_HT_SET_CREATE_OR_FAIL));
+
+    printf("========\nHash table with default hashing\n========\n");
+    dc_dv_println(&dc_dv(DCHashTablePtr, &ht));
+
+    if (ht.key_count != 5) dc_ret_e(5, "keys of different types must not collide");
+
+    // Looking up with separately built keys of the same content
+    DCDynArr lookup_arr;
+    dc_try_fail(dc_da_init(&lookup_arr, NULL));
+    dc_try_fail(dc_da_push(&lookup_arr, dc_dv(i32, 1)));
+    dc_try_fail(dc_da_push(&lookup_arr, dc_dv(i32, 2)));
+
+    DCPair lookup_pair = {.first = dc_dv(string, "x"), .second = dc_dv(f64, 0.5)};
+
+    DCDynVal* found_arr = NULL;
+    DCDynVal* found_pair = NULL;
+    DCDynVal* found_str = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(&ht, dc_dv(DCDynArrPtr, &lookup_arr), &found_arr));
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(&ht, dc_dv(DCPairPtr, &lookup_pair), &found_pair));
+    dc_try_or_fail_with3(DCRes, sv_key, dc_dv_box_sv(dc_sv("one", 0, 3)), {});
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(&ht, dc_unwrap2(sv_key), &found_str));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(sv_key), NULL));
+
+    if (!found_arr || strcmp(dc_dv_as(*found_arr, string), "array") != 0 || !found_pair ||
+        strcmp(dc_dv_as(*found_pair, string), "pair") != 0)
+        dc_ret_e(5, "keys must be found by content");
+
+    if (found_str) dc_ret_e(5, "a view must not find a string key");
+
+    // Sorting a mixed array without a comparator orders by type then by content
+    DCDynArr mixed;
+    dc_try_fail(dc_da_init(&mixed, NULL));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(DCDynArrPtr, &key_arr)));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(string, "b")));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(i32, 3)));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(DCDynArrPtr, &lookup_arr)));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(string, "a")));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(i32, -3)));
+    dc_try_fail(dc_da_push(&mixed, dc_dv(DCPairPtr, &key_pair)));
+
+    dc_try_fail(dc_da_sort(&mixed, NULL));
+    dc_dv_println(&dc_dv(DCDynArrPtr, &mixed));
+
+    if (dc_da_get_as(mixed, 0, i32) != -3 || dc_da_get_as(mixed, 1, i32) != 3 ||
+        strcmp(dc_da_get_as(mixed, 2, string), "a") != 0)
+        dc_ret_e(5, "wrong order of mixed values");
+
+    // Cycles are reported instead of recursing forever
+    dc_try_fail(dc_da_push(&lookup_arr, dc_dv(DCDynArrPtr, &lookup_arr)));
+
+    DCResU64 cyclic = dc_dv_hash(&dc_dv(DCDynArrPtr, &lookup_arr), 0);
+    if (dc_is_ok2(cyclic)) dc_ret_e(5, "hashing a cycle must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(cyclic));
+
+    dc_try_fail(dc_da_free(&mixed));
+    dc_try_fail(dc_da_free(&lookup_arr));
+    dc_try_fail(dc_da_free(&key_arr));
+
+    return dc_ht_free(&ht);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
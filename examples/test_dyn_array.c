@@ -14,6 +14,19 @@
 // *  Description:
 // ***************************************************************************************
 
+// Lets huge arrays grow in place with `mremap` on Linux
+#define _GNU_SOURCE
+
+// Small chunks so that parallel functions really use multiple threads in tests
+#define DC_DA_PAR_MIN_CHUNK 64
+
+// Small enough that test12 reaches memory mapped storage without 64MB arrays
+#define DC_DA_MMAP_THRESHOLD ((usize)64 * 1024)
+
+// Small enough that test16 can fill the side heap of file backed arrays
+#define DC_DA_FILE_HEAP_RESERVE ((usize)1024 * 1024)
+
+#define DC_PARALLEL
 #define DCOMMON_IMPL
 #include "../src/dcommon/dcommon.h"
 
@@ -133,6 +146,19 @@ DCResVoid test1()
     LOG_DYNAMIC_ARRAY_INFO(darr);
     print_da(&darr);
 
+    // Capacities whose size in bytes overflows must be rejected untouched
+    usize cap_before_overflow = darr.cap;
+
+    DCResVoid overflow_res = dc_da_grow_by(&darr, SIZE_MAX);
+    if (dc_is_ok2(overflow_res)) dc_ret_e(5, "grow_by must reject an overflowing capacity");
+    printf("got expected error: %s\n", dc_err_msg2(overflow_res));
+
+    overflow_res = dc_da_grow_to(&darr, SIZE_MAX / sizeof(DCDynVal) + 1);
+    if (dc_is_ok2(overflow_res)) dc_ret_e(5, "grow_to must reject an overflowing capacity");
+    printf("got expected error: %s\n", dc_err_msg2(overflow_res));
+
+    if (darr.cap != cap_before_overflow) dc_ret_e(5, "failed grow must keep the capacity");
+
     printf("========\nTruncate\n========\n");
     // Try truncating unused capacity of the first array or fail
     dc_try_fail(dc_da_trunc(&darr));
@@ -420,6 +446,537 @@ DCResVoid test7()
     return dc_da_free(&darr);
 }
 
+DC_DV_PREDICATE_FN_DECL(keep_even_numbers)
+{
+    DC_RES_bool();
+
+    // Strings are always kept
+    if (dc_dv_is_not(*_value, i32)) dc_ret_ok(true);
+
+    dc_ret_ok(dc_dv_as(*_value, i32) % 2 == 0);
+}
+
+DCResVoid test8()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    for (i32 i = 0; i < 10; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i32, i)));
+
+    // Allocated strings to make sure only removed elements are freed
+    dc_try_fail_da_insert_values(&darr, 5, dc_dva(string, dc_unwrap2(dc_strdup("first allocated"))),
+                                 dc_dva(string, dc_unwrap2(dc_strdup("second allocated"))));
+
+    printf("========\nBulk inserted 2 strings in the middle\n========\n");
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+    print_da(&darr);
+
+    printf("========\nDeleting 3 elements starting at index 3\n========\n");
+    dc_try_fail(dc_da_delete_range(&darr, 3, 3));
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+    print_da(&darr);
+
+    // Out of bound ranges must fail with index error (code 4)
+    DCResVoid range_res = dc_da_delete_range(&darr, 5, 100);
+    if (dc_is_ok2(range_res) || dc_err_code2(range_res) != dc_e_code(INDEX)) dc_ret_e(5, "out of bound range got deleted!");
+
+    printf("========\nRetaining only even numbers\n========\n");
+    DCResUsize removed_res = dc_da_retain(&darr, keep_even_numbers);
+    dc_fail_if_err2(removed_res);
+
+    printf("removed '" dc_fmt(usize) "' elements\n", dc_unwrap2(removed_res));
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+    print_da(&darr);
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test9()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    // Enough elements to go through the blocked search and its remainder
+    for (i32 i = 0; i < 37; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i32, i % 5)));
+
+    DCDynVal three = dc_dv(i32, 3);
+
+    usize* indexes = NULL;
+    DCResUsize found_res = dc_da_find_all(&darr, &three, NULL, &indexes);
+    dc_fail_if_err2(found_res);
+
+    printf("========\nfound '" dc_fmt(usize) "' elements equal to 3 at:", dc_unwrap2(found_res));
+    for (usize i = 0; indexes[i] != dc_stopper(usize); ++i) printf(" " dc_fmt(usize), indexes[i]);
+    printf("\n========\n");
+
+    free(indexes);
+
+    // A value of another type can't be found among the i32 elements
+    DCResUsize not_found_res = dc_da_find(&darr, dc_dv(u8, 3), NULL);
+    if (dc_is_ok2(not_found_res) || dc_err_code2(not_found_res) != dc_e_code(NF)) dc_ret_e(5, "found u8 among i32 elements!");
+
+    // Mixed types are found by their own type
+    dc_try_fail(dc_da_set(&darr, 35, dc_dv(u8, 3)));
+
+    dc_try_or_fail_with3(DCResUsize, u8_res, dc_da_find(&darr, dc_dv(u8, 3), NULL), {});
+    printf("u8 3 found at index '" dc_fmt(usize) "'\n", dc_unwrap2(u8_res));
+
+    dc_try_or_fail_with3(DCResUsize, count_res, dc_da_count(&darr, &three, NULL), {});
+    printf("i32 3 appears '" dc_fmt(usize) "' times\n", dc_unwrap2(count_res));
+
+    dc_try_fail(dc_da_delete(&darr, 35));
+
+    // Elements written in place are found as well
+    dc_da_get2(darr, 20) = dc_dv(b1, true);
+    dc_try_or_fail_with3(DCResUsize, stale_res, dc_da_find(&darr, dc_dv(b1, true), NULL), {});
+    if (dc_unwrap2(stale_res) != 20) dc_ret_e(5, "element written in place must be found");
+
+    return dc_da_free(&darr);
+}
+
+DC_DV_OP_FN_DECL(DCResI32, descending_i32)
+{
+    DC_RES_i32();
+
+    dc_ret_ok((dc_dv_as(*_dv2, i32) > dc_dv_as(*_dv1, i32)) - (dc_dv_as(*_dv2, i32) < dc_dv_as(*_dv1, i32)));
+}
+
+DC_DV_KEY_FN_DECL(last_digit_key)
+{
+    DC_RES_i64();
+
+    dc_ret_ok(dc_dv_as(*_value, i32) % 10);
+}
+
+DCResVoid test10()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    // Big enough to go through radix sort, negatives make sure signs are handled
+    u32 seed = 12345;
+    for (i32 i = 0; i < 200; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        dc_try_fail(dc_da_push(&darr, dc_dv(i32, (i32)(seed >> 16) % 1000 - 500)));
+    }
+
+    dc_try_fail(dc_da_sort(&darr, NULL));
+    for (usize i = 1; i < darr.count; ++i)
+        if (dc_da_get_as(darr, i - 1, i32) > dc_da_get_as(darr, i, i32)) dc_ret_e(5, "radix sort result is not sorted");
+
+    dc_try_fail(dc_da_sort(&darr, descending_i32));
+    for (usize i = 1; i < darr.count; ++i)
+        if (dc_da_get_as(darr, i - 1, i32) < dc_da_get_as(darr, i, i32)) dc_ret_e(5, "introsort result is not sorted");
+
+    // Elements with equal keys must keep their current (descending) order
+    dc_try_fail(dc_da_sort_by_key(&darr, last_digit_key));
+    for (usize i = 1; i < darr.count; ++i)
+    {
+        i32 prev = dc_da_get_as(darr, i - 1, i32);
+        i32 current = dc_da_get_as(darr, i, i32);
+
+        if (prev % 10 > current % 10 || (prev % 10 == current % 10 && prev < current))
+            dc_ret_e(5, "sort by key result is not stable");
+    }
+
+    printf("========\nSorted 200 numbers, first: %d, last: %d\n========\n", dc_da_get_as(darr, 0, i32),
+           dc_da_get_as(darr, darr.count - 1, i32));
+
+    dc_try_fail(dc_da_free(&darr));
+
+    dc_try_fail_da_init_with_values(&darr, NULL, dc_dv(string, "pear"), dc_dv(string, "apple"), dc_dv(string, "apricot"),
+                                    dc_dv(string, "banana"), dc_dv(string, "app"), dc_dv(string, ""),
+                                    dc_dv(string, "peach"));
+
+    dc_try_fail(dc_da_sort(&darr, NULL));
+    print_da(&darr);
+
+    // Mixed types are ordered by type first and then by value
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 2.5)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, -1.5)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(i8, 3)));
+
+    dc_try_fail(dc_da_sort_stable(&darr, NULL));
+    print_da(&darr);
+
+    dc_try_fail(dc_da_free(&darr));
+
+    // Long shared prefixes in descending order must not make multikey quicksort recurse deeply
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    char prefix[301];
+    memset(prefix, 'x', sizeof(prefix) - 1);
+    prefix[sizeof(prefix) - 1] = '\0';
+
+    for (usize i = 3000; i > 0; --i)
+    {
+        string str = NULL;
+        dc_try_fail_temp(DCResUsize, dc_sprintf(&str, "%.*s%05" PRIuMAX, (int)(i % 300), prefix, (uintmax_t)i));
+        dc_try_fail(dc_da_push(&darr, dc_dva(string, str)));
+    }
+
+    // A single element of another type must not be sorted as a string
+    dc_try_fail(dc_dv_free(&dc_da_get2(darr, 7), NULL));
+    dc_da_get2(darr, 7) = dc_dv(i32, 7);
+
+    dc_try_fail(dc_da_sort(&darr, NULL));
+
+    if (!dc_da_is(darr, 0, i32)) dc_ret_e(5, "the number must be ordered before the strings");
+
+    for (usize i = 2; i < darr.count; ++i)
+        if (strcmp(dc_da_get_as(darr, i - 1, string), dc_da_get_as(darr, i, string)) > 0)
+            dc_ret_e(5, "strings with shared prefixes are not sorted");
+
+    printf("========\nSorted '" dc_fmt(usize) "' strings sharing long prefixes\n========\n", darr.count - 1);
+
+    return dc_da_free(&darr);
+}
+
+DC_DA_VISITOR_FN_DECL(double_until_limit)
+{
+    DC_RES_void();
+
+    i32 limit = *(i32*)_ctx;
+
+    if (dc_dv_as(*_it, i32) > limit) dc_ret_ea(5, "value at index '" dc_fmt(usize) "' is over the limit", _idx);
+
+    dc_dv_set(*_it, i32, dc_dv_as(*_it, i32) * 2);
+
+    dc_ret();
+}
+
+DCResVoid test11()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    DCDynArr expected;
+    dc_try_fail(dc_da_init(&darr, NULL));
+    dc_try_fail(dc_da_init(&expected, NULL));
+
+    u32 seed = 42;
+    for (i32 i = 0; i < 1000; ++i)
+    {
+        seed = seed * 1103515245 + 12345;
+        dc_try_fail(dc_da_push(&darr, dc_dv(i32, (i32)(seed >> 16) % 100)));
+    }
+
+    dc_try_fail(dc_da_append(&expected, &darr));
+
+    // Result must be exactly the same as the single threaded stable sort
+    dc_try_fail(dc_da_sort_stable(&expected, descending_i32));
+    dc_try_fail(dc_da_par_sort(&darr, descending_i32, 4));
+
+    if (memcmp(darr.elements, expected.elements, darr.count * sizeof(DCDynVal)) != 0)
+        dc_ret_e(5, "parallel sort result differs from the stable sort");
+
+    i32 limit = 1000;
+    dc_try_fail(dc_da_par_for(&darr, double_until_limit, &limit, 4));
+
+    printf("========\nParallel sorted and doubled 1000 numbers, first: %d, last: %d\n========\n",
+           dc_da_get_as(darr, 0, i32), dc_da_get_as(darr, darr.count - 1, i32));
+
+    // Only elements at the end of the (descending) array are still below the limit
+    limit = 50;
+    DCResVoid visit_res = dc_da_par_for(&darr, double_until_limit, &limit, 4);
+    if (dc_is_ok2(visit_res)) dc_ret_e(5, "visitor error is not reported");
+
+    printf("got expected error: %s\n", dc_err_msg2(visit_res));
+    dc_try_fail(dc_result_free(&visit_res));
+
+    dc_try_fail(dc_da_free(&expected));
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test12()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init2(&darr, 10, 1, NULL));
+
+    // Multiplier of 1 used to never grow
+    for (i32 i = 0; i < 12; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i32, i)));
+
+    printf("========\nGrowth with multiplier 1\n========\n");
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+
+    dc_try_fail(dc_da_set_growth(&darr, DC_DA_GROW_FACTOR, 1.5f));
+    dc_try_fail(dc_da_grow(&darr));
+
+    printf("========\nGrowth by 1.5x\n========\n");
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+
+    DCResVoid growth_res = dc_da_set_growth(&darr, DC_DA_GROW_FACTOR, 0.5f);
+    if (dc_is_ok2(growth_res)) dc_ret_e(5, "growth factors less than 1 must be rejected");
+
+    // Big enough to move to a memory mapping (where supported)
+    dc_try_fail(dc_da_set_growth(&darr, DC_DA_GROW_SCHEDULE, 0));
+    usize big = DC_DA_MMAP_THRESHOLD / sizeof(DCDynVal) + 1;
+    dc_try_fail(dc_da_grow_to(&darr, big));
+
+    dc_da_get2(darr, 11) = dc_dv(i32, 42);
+    dc_try_fail(dc_da_grow(&darr));
+
+    printf("========\nHuge array (mmap: %s), element 11: %d\n========\n", dc_tostr_bool(dc_da_storage(darr) == DC_DA_STORAGE_MMAP),
+           dc_da_get_as(darr, 11, i32));
+
+    dc_try_fail(dc_da_trunc(&darr));
+    LOG_DYNAMIC_ARRAY_INFO(darr);
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test13()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    for (i32 i = 0; i < 20; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i32, i * 10)));
+
+    // Elements 5..9 without copying anything
+    dc_try_or_fail_with3(DCResDav, slice_res, dc_da_view(&darr, 5, 5), {});
+    DCDynArrView slice = dc_unwrap2(slice_res);
+
+    if (slice.elements != &darr.elements[5]) dc_ret_e(5, "view must point into the array");
+
+    dc_try_or_fail_with3(DCRes, slice_dv, dc_dv_box_dav(slice), {});
+    printf("========\nView of elements 5..9\n========\n");
+    dc_dv_println(&dc_unwrap2(slice_dv));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(slice_dv), NULL));
+
+    // Every third element starting from 1: 10, 40, 70, 100, 130, 160, 190
+    dc_try_or_fail_with3(DCResDav, strided_res, dc_da_view2(&darr, 1, 7, 3), {});
+    DCDynArrView strided = dc_unwrap2(strided_res);
+
+    printf("========\nStrided view\n========\n");
+    dc_dav_for(strided_loop, strided, {
+        printf("['" dc_fmt(usize) "'] ", _idx);
+        print_dv(_it);
+    });
+
+    dc_try_or_fail_with3(DCResUsize, found, dc_dav_find(&strided, dc_dv(i32, 130), NULL), {});
+    if (dc_unwrap2(found) != 4) dc_ret_e(5, "wrong index found in strided view");
+
+    DCResUsize not_found = dc_dav_find(&strided, dc_dv(i32, 20), NULL);
+    if (dc_is_ok2(not_found) || dc_err_code2(not_found) != 6) dc_ret_e(5, "element out of the view must not be found");
+
+    DCResDav out_of_bounds = dc_da_view2(&darr, 1, 8, 3);
+    if (dc_is_ok2(out_of_bounds)) dc_ret_e(5, "view past the end of the array must be rejected");
+
+    i32* flat = NULL;
+    dc_try_or_fail_with3(DCResUsize, flat_count, dc_i32_dav_to_flat_arr(&strided, &flat, true), {});
+
+    printf("========\nFlat array of strided view\n========\n");
+    for (usize i = 0; i < dc_unwrap2(flat_count); ++i) printf(dc_fmt(i32) " ", flat[i]);
+    printf("\n");
+
+    free(flat);
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test14()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    // The third one is exactly DC_ISTR_MAX_LEN characters long (it depends on `DC_DV_COMPACT`)
+    string longest = "exactly twenty three ch";
+    string words[] = {"short", "", longest + strlen(longest) - DC_ISTR_MAX_LEN, "this one is too long to be kept inline"};
+    for (usize i = 0; i < dc_count(words); ++i)
+    {
+        dc_try_or_fail_with3(DCRes, istr, dc_dv_istr(words[i]), {});
+        dc_try_fail(dc_da_push(&darr, dc_unwrap2(istr)));
+    }
+
+    printf("========\nInline strings\n========\n");
+    dc_da_for(istr_loop, darr, {
+        dc_try_or_fail_with3(DCResUsize, len, dc_dv_istr_len(_it), {});
+        printf("['" dc_fmt(usize) "'] (inline: %s, len: '" dc_fmt(usize) "') ", _idx, dc_tostr_bool(dc_dv_is_not_allocated(*_it)),
+               dc_unwrap2(len));
+        print_dv(_it);
+    });
+
+    if (dc_da_is_not(darr, 2, DCInlineStr) || dc_dv_is_allocated(dc_da_get2(darr, 2)) ||
+        dc_dv_is_not_allocated(dc_da_get2(darr, 3)))
+        dc_ret_e(5, "only strings longer than DC_ISTR_MAX_LEN must use the heap");
+
+    dc_try_or_fail_with3(DCRes, key, dc_dv_istr("short"), {});
+    dc_try_or_fail_with3(DCResUsize, found, dc_da_find2(&darr, &dc_unwrap2(key), NULL), {});
+    if (dc_unwrap2(found) != 0) dc_ret_e(5, "inline string must be found");
+
+    dc_try_or_fail_with3(DCRes, long_key, dc_dv_istr(words[3]), {});
+    dc_try_or_fail_with3(DCResUsize, long_found, dc_da_find2(&darr, &dc_unwrap2(long_key), NULL), {});
+    if (dc_unwrap2(long_found) != 3) dc_ret_e(5, "heap inline string must be found");
+    dc_try_fail(dc_dv_free(&dc_unwrap2(long_key), NULL));
+
+    dc_try_or_fail_with3(DCResBool, empty_bool, dc_dv_to_bool(&dc_da_get2(darr, 1)), {});
+    if (dc_unwrap2(empty_bool)) dc_ret_e(5, "empty inline string must be false");
+
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, "plain")));
+
+    string* flat = NULL;
+    dc_try_or_fail_with3(DCResUsize, flat_count, dc_string_da_to_flat_arr(&darr, &flat, true), {});
+
+    printf("========\nFlat array of strings\n========\n");
+    dc_foreach(flat_loop, flat, string, printf("'%s' ", *_it));
+    printf("(count: '" dc_fmt(usize) "')\n", dc_unwrap2(flat_count));
+
+    free(flat);
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test15()
+{
+    DC_RES_void();
+
+    DCDynArr numbers;
+    dc_try_fail(dc_da_init(&numbers, NULL));
+
+    for (i64 i = 0; i < 100000; ++i) dc_try_fail(dc_da_push(&numbers, dc_dv(i64, i)));
+
+    if (dc_da_has_owned(numbers)) dc_ret_e(5, "array of numbers must not own anything");
+
+    dc_try_fail(dc_da_delete_range(&numbers, 10, 1000));
+    dc_try_fail(dc_da_free(&numbers));
+
+    DCDynArr strings;
+    dc_try_fail(dc_da_init(&strings, NULL));
+
+    dc_try_fail(dc_da_push(&strings, dc_dv(string, "literal")));
+    dc_try_fail(dc_da_push(&strings, dc_dva(string, dc_unwrap2(dc_strdup("allocated 1")))));
+    dc_try_fail(dc_da_push(&strings, dc_dva(string, dc_unwrap2(dc_strdup("allocated 2")))));
+    dc_try_fail(dc_da_push(&strings, dc_dv(string, dc_unwrap2(dc_strdup("allocated later")))));
+
+    printf("========\nOwned elements\n========\n");
+    printf("-- after push: '" dc_fmt(usize) "'\n", strings.owned_count);
+
+    dc_da_mark_alloc(strings, 3);
+    printf("-- after marking: '" dc_fmt(usize) "'\n", strings.owned_count);
+
+    dc_try_fail(dc_da_delete(&strings, 1));
+    dc_try_fail(dc_da_set(&strings, 0, dc_dva(string, dc_unwrap2(dc_strdup("replaced")))));
+    printf("-- after delete and set: '" dc_fmt(usize) "'\n", strings.owned_count);
+
+    if (strings.owned_count != 3) dc_ret_e(5, "wrong owned element count");
+
+    dc_try_or_fail_with3(DCResUsize, owned, dc_da_update_owned(&strings), {});
+    if (dc_unwrap2(owned) != 3 || strings.owned_count != 3) dc_ret_e(5, "rescan must find the same owned elements");
+
+    dc_try_fail(dc_da_free(&strings));
+
+    // Owned values assigned in place are released once the array counts them
+    DCDynArr marked;
+    dc_try_fail(dc_da_init(&marked, NULL));
+
+    for (usize i = 0; i < 3; ++i) dc_try_fail(dc_da_push(&marked, dc_dv(string, "literal")));
+
+    if (dc_da_has_owned(marked)) dc_ret_e(5, "literals must not be owned");
+
+    dc_da_get2(marked, 2) = dc_dva(string, dc_unwrap2(dc_strdup("assigned in place")));
+
+    dc_try_or_fail_with3(DCResUsize, recounted, dc_da_update_owned(&marked), {});
+    if (dc_unwrap2(recounted) != 1) dc_ret_e(5, "assigned element must be counted");
+
+    dc_try_fail(dc_da_pop(&marked, 1, NULL, false));
+    if (dc_da_has_owned(marked)) dc_ret_e(5, "popping must release the assigned element");
+
+    dc_dv_set(dc_da_get2(marked, 0), string, dc_unwrap2(dc_strdup("marked in place")));
+    dc_da_mark_alloc(marked, 0);
+
+    if (marked.owned_count != 1) dc_ret_e(5, "marking in place must be counted");
+
+    return dc_da_free(&marked);
+}
+
+DCResVoid test16()
+{
+    DC_RES_void();
+
+#ifndef DC_WINDOWS
+    string path = "_test_file_backed.darr";
+    remove(path);
+    remove("_test_file_backed.darr.heap");
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_open_file(&darr, path));
+
+    for (i64 i = 0; i < 1000; ++i) dc_try_fail(dc_da_push(&darr, dc_dv(i64, i * i)));
+
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, "literal")));
+    dc_try_fail(dc_da_push(&darr, dc_dva(string, dc_unwrap2(dc_strdup("allocated")))));
+    dc_try_fail(dc_da_insert(&darr, 0, dc_unwrap2(dc_dv_istr("inline"))));
+
+    // Only values that mean the same thing after reopening are accepted
+    DCResVoid rejected = dc_da_push(&darr, dc_dv(voidptr, &darr));
+    if (dc_is_ok2(rejected)) dc_ret_e(5, "pointers must not be persisted");
+
+    if (darr.owned_count != 0) dc_ret_e(5, "file backed arrays must not own anything");
+
+    // A string that doesn't fit in the side heap leaves the array as it was
+    usize count_before = darr.count;
+
+    string huge = (string)malloc(DC_DA_FILE_HEAP_RESERVE + 1);
+    if (!huge) dc_ret_e(2, "Memory allocation failed");
+
+    memset(huge, 'x', DC_DA_FILE_HEAP_RESERVE);
+    huge[DC_DA_FILE_HEAP_RESERVE] = '\0';
+
+    DCResVoid too_big = dc_da_push(&darr, dc_dva(string, huge));
+    if (dc_is_ok2(too_big) || darr.count != count_before) dc_ret_e(5, "failed push must not add the string");
+
+    // Still owned by the caller
+    free(huge);
+
+    dc_try_fail(dc_da_sync(&darr));
+    dc_try_fail(dc_da_free(&darr));
+
+    dc_try_fail(dc_da_open_file(&darr, path));
+
+    printf("========\nFile backed array\n========\n");
+    printf("-- reopened count: '" dc_fmt(usize) "', capacity: '" dc_fmt(usize) "'\n", darr.count, darr.cap);
+    dc_dv_println(&dc_da_get2(darr, 0));
+    dc_dv_println(&dc_da_get2(darr, 1001));
+    dc_dv_println(&dc_da_get2(darr, 1002));
+
+    if (darr.count != 1003 || dc_da_get_as(darr, 500, i64) != 499 * 499) dc_ret_e(5, "wrong elements after reopening");
+
+    if (strcmp(dc_da_get_as(darr, 1002, string), "allocated") != 0) dc_ret_e(5, "wrong string after reopening");
+
+    dc_try_fail(dc_da_pop(&darr, 1000, NULL, true));
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, "appended after reopening")));
+
+    dc_try_fail(dc_da_free(&darr));
+
+    dc_try_fail(dc_da_open_file(&darr, path));
+    printf("-- after shrinking count: '" dc_fmt(usize) "'\n", darr.count);
+    dc_dv_println(&dc_da_get2(darr, darr.count - 1));
+
+    if (darr.count != 4) dc_ret_e(5, "wrong count after shrinking");
+
+    dc_try_fail(dc_da_free(&darr));
+
+    remove(path);
+    remove("_test_file_backed.darr.heap");
+#endif
+
+    dc_ret();
+}
+
 int main()
 {
     /**
@@ -462,5 +1019,32 @@ int main()
     dc_try(test7());
     dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
 
+    dc_try(test8());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test9());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test10());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test11());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test12());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test13());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test14());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test15());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test16());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
     return 0;
 }
@@ -0,0 +1,159 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_heap.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+/**
+ * Orders pairs by their first value (the priority)
+ */
+DC_DV_OP_FN_DECL(DCResI32, priority_cmp)
+{
+    DC_RES_i32();
+
+    i64 p1 = dc_dv_as(dc_dv_as(*_dv1, DCPairPtr)->first, i64);
+    i64 p2 = dc_dv_as(dc_dv_as(*_dv2, DCPairPtr)->first, i64);
+
+    dc_ret_ok((p1 > p2) - (p1 < p2));
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    // Existing elements are arranged in O(n)
+    u64 seed = 88172645463325252ull;
+    for (usize i = 0; i < 1000; ++i)
+    {
+        seed ^= seed << 13;
+        seed ^= seed >> 7;
+        seed ^= seed << 17;
+
+        dc_try_fail(dc_da_push(&darr, dc_dv(i64, (i64)(seed % 100000))));
+    }
+
+    DCHeap heap;
+    dc_try_fail(dc_heap_init(&heap, &darr, NULL));
+
+    for (i64 i = 0; i < 500; ++i) dc_try_fail_temp(DCResUsize, dc_heap_push(&heap, dc_dv(i64, i * 7)));
+
+    printf("========\nHeap\n========\n");
+    printf("-- count: '" dc_fmt(usize) "', top: '" dc_fmt(i64) "'\n", dc_heap_count(heap), dc_dv_as(dc_heap_top(heap), i64));
+
+    i64 prev = INT64_MIN;
+    usize popped_count = 0;
+    while (dc_heap_count(heap) > 0)
+    {
+        DCDynVal popped;
+        dc_try_fail(dc_heap_pop(&heap, &popped));
+
+        if (dc_dv_as(popped, i64) < prev) dc_ret_e(5, "elements must be popped in order");
+
+        prev = dc_dv_as(popped, i64);
+        popped_count++;
+    }
+
+    if (popped_count != 1500) dc_ret_e(5, "wrong number of popped elements");
+
+    DCResVoid empty = dc_heap_pop(&heap, NULL);
+    if (dc_is_ok2(empty)) dc_ret_e(5, "popping from an empty heap must fail");
+
+    dc_try_fail(dc_heap_free(&heap));
+
+    return dc_da_free(&darr);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    DCHeap heap;
+    dc_try_fail(dc_heap_init(&heap, &darr, priority_cmp));
+
+    string names[] = {"parse", "compile", "link", "test", "deploy"};
+    usize handles[dc_count(names)];
+
+    for (usize i = 0; i < dc_count(names); ++i)
+    {
+        DCPair* job = malloc(sizeof(DCPair));
+        job->first = dc_dv(i64, (i64)(i + 1) * 10);
+        job->second = dc_dva(string, dc_unwrap2(dc_strdup(names[i])));
+
+        dc_try_or_fail_with3(DCResUsize, handle, dc_heap_push(&heap, dc_dva(DCPairPtr, job)), {});
+        handles[i] = dc_unwrap2(handle);
+    }
+
+    // Decrease-key in place through the handle
+    dc_try_or_fail_with3(DCResPtr, deploy, dc_heap_get(&heap, handles[4]), {});
+    dc_dv_as(*dc_unwrap2(deploy), DCPairPtr)->first = dc_dv(i64, 5);
+    dc_try_fail(dc_heap_fix(&heap, handles[4]));
+
+    // Increasing works as well, the old job is freed
+    DCPair* later = malloc(sizeof(DCPair));
+    later->first = dc_dv(i64, 100);
+    later->second = dc_dva(string, dc_unwrap2(dc_strdup("parse again")));
+    dc_try_fail(dc_heap_update(&heap, handles[0], dc_dva(DCPairPtr, later)));
+
+    printf("========\nScheduled jobs\n========\n");
+
+    string expected[] = {"deploy", "compile", "link", "test", "parse again"};
+    for (usize i = 0; i < dc_count(expected); ++i)
+    {
+        DCDynVal job;
+        dc_try_fail(dc_heap_pop(&heap, &job));
+
+        dc_dv_println(&job);
+
+        if (strcmp(dc_dv_as(dc_dv_as(job, DCPairPtr)->second, string), expected[i]) != 0) dc_ret_e(5, "wrong job order");
+
+        dc_try_fail(dc_dv_free(&job, NULL));
+    }
+
+    // Handles of popped elements are no longer valid
+    DCResPtr stale = dc_heap_get(&heap, handles[1]);
+    if (dc_is_ok2(stale)) dc_ret_e(5, "stale handle must fail");
+
+    // Freed handles are reused
+    DCPair* reused = malloc(sizeof(DCPair));
+    reused->first = dc_dv(i64, 1);
+    reused->second = dc_dv(string, "reused");
+
+    dc_try_or_fail_with3(DCResUsize, handle, dc_heap_push(&heap, dc_dva(DCPairPtr, reused)), {});
+    if (dc_unwrap2(handle) >= dc_count(names)) dc_ret_e(5, "handles must be reused");
+
+    dc_try_fail(dc_heap_free(&heap));
+
+    return dc_da_free(&darr);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
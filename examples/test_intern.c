@@ -0,0 +1,197 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_intern.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DC_PARALLEL
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+#define NAME_COUNT 1000
+
+typedef struct
+{
+    DCInternPool* pool;
+    DCSymbol** symbols;
+} InternJob;
+
+/**
+ * Interns one of the shared names, every name is interned by several threads
+ */
+DC_DA_VISITOR_FN_DECL(intern_name)
+{
+    DC_RES_void();
+
+    InternJob* job = (InternJob*)_ctx;
+
+    char name[32];
+    snprintf(name, sizeof(name), "metric.%" PRIuMAX, (uintmax_t)(dc_dv_as(*_it, usize) % NAME_COUNT));
+
+    dc_try_or_fail_with3(DCResSymbol, symbol, dc_intern(job->pool, name), {});
+    job->symbols[_idx] = dc_unwrap2(symbol);
+
+    dc_ret();
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    DCInternPool pool;
+    dc_try_fail(dc_intern_init(&pool, 0));
+
+    string text = "the quick brown fox jumps over the lazy dog the end";
+
+    DCHashTable ht;
+    dc_try_fail(dc_ht_init(&ht, 17, dc_symbol_hash, dc_symbol_key_cmp, NULL));
+
+    // Counting words, every word is interned straight from the text
+    usize start = 0;
+    usize len = strlen(text);
+    for (usize i = 0; i <= len; ++i)
+    {
+        if (i < len && text[i] != ' ') continue;
+
+        dc_try_or_fail_with3(DCResSymbol, word, dc_intern_sv(&pool, dc_sv(text, start, i - start)), {});
+        DCDynVal key = dc_dv(DCSymbolPtr, dc_unwrap2(word));
+
+        DCDynVal* count = NULL;
+        dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(&ht, key, &count));
+
+        if (count)
+            dc_dv_as(*count, usize)++;
+        else
+            dc_try_fail(dc_ht_set(&ht, key, dc_dv(usize, 1), DC_HT_SET_CREATE_OR_FAIL));
+
+        start = i + 1;
+    }
+
+    printf("========\nInterned words\n========\n");
+    printf("-- symbols: '" dc_fmt(usize) "', keys: '" dc_fmt(usize) "'\n", pool.count, ht.key_count);
+
+    if (pool.count != 9 || ht.key_count != 9) dc_ret_e(5, "wrong number of symbols");
+
+    // The same text is always the same symbol
+    dc_try_or_fail_with3(DCRes, the, dc_dv_intern(&pool, "the"), {});
+    if (dc_dv_as(dc_unwrap2(the), DCSymbolPtr)->id != 0) dc_ret_e(5, "the first word must have the first id");
+
+    DCDynVal* the_count = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(&ht, dc_unwrap2(the), &the_count));
+    if (!the_count || dc_dv_as(*the_count, usize) != 3) dc_ret_e(5, "wrong count of 'the'");
+
+    dc_dv_println(&dc_unwrap2(the));
+
+    dc_try_or_fail_with3(DCResSymbol, fox, dc_intern_find(&pool, "fox jumps", 3), {});
+    dc_try_or_fail_with3(DCResSymbol, fox_by_id, dc_intern_get(&pool, dc_unwrap2(fox)->id), {});
+    if (!dc_unwrap2(fox) || dc_unwrap2(fox) != dc_unwrap2(fox_by_id) || strcmp(dc_unwrap2(fox)->str, "fox") != 0)
+        dc_ret_e(5, "wrong symbol of 'fox'");
+
+    // Looking up doesn't intern anything
+    dc_try_or_fail_with3(DCResSymbol, cat, dc_intern_find(&pool, "cat", 3), {});
+    if (dc_unwrap2(cat) != NULL || pool.count != 9) dc_ret_e(5, "unknown text must not be found");
+
+    DCResSymbol missing = dc_intern_get(&pool, 9);
+    if (dc_is_ok2(missing)) dc_ret_e(5, "unknown id must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(missing));
+
+    // Symbols are ordered by their text
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+    for (u32 id = 0; id < pool.count; ++id)
+    {
+        dc_try_or_fail_with3(DCResSymbol, symbol, dc_intern_get(&pool, id), {});
+        dc_try_fail(dc_da_push(&darr, dc_dv(DCSymbolPtr, dc_unwrap2(symbol))));
+    }
+
+    dc_try_fail(dc_da_sort(&darr, NULL));
+    dc_dv_println(&dc_dv(DCDynArrPtr, &darr));
+
+    if (strcmp(dc_dv_symbol_str(dc_da_get2(darr, 0)), "brown") != 0) dc_ret_e(5, "wrong order of symbols");
+
+    // Symbols are interned again when they're read back
+    DCBinWriter bw;
+    dc_try_fail(dc_bw_init(&bw, NULL));
+    dc_try_fail(dc_bw_write(&bw, &dc_dv(DCDynArrPtr, &darr)));
+
+    DCBinReader br;
+    dc_try_fail(dc_br_init(&br, bw.buf, bw.len, NULL, false));
+    br.pool = &pool;
+
+    dc_try_or_fail_with3(DCRes, read, dc_br_read(&br), {});
+
+    DCDynArr* read_darr = dc_dv_as(dc_unwrap2(read), DCDynArrPtr);
+    for (usize i = 0; i < darr.count; ++i)
+    {
+        if (dc_da_get_as(*read_darr, i, DCSymbolPtr) != dc_da_get_as(darr, i, DCSymbolPtr))
+            dc_ret_e(5, "symbols must be read back as the same symbols");
+    }
+
+    if (pool.count != 9) dc_ret_e(5, "reading must not add new symbols");
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(read), NULL));
+    dc_try_fail(dc_bw_free(&bw));
+
+    dc_try_fail(dc_da_free(&darr));
+    dc_try_fail(dc_ht_free(&ht));
+
+    return dc_intern_free(&pool);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    DCInternPool pool;
+    dc_try_fail(dc_intern_init(&pool, 4));
+
+    usize count = NAME_COUNT * 8;
+
+    DCDynArr work;
+    dc_try_fail(dc_da_init2(&work, count, 2, NULL));
+    for (usize i = 0; i < count; ++i) dc_try_fail(dc_da_push(&work, dc_dv(usize, i)));
+
+    InternJob job = {.pool = &pool, .symbols = malloc(count * sizeof(DCSymbol*))};
+
+    dc_try_fail(dc_da_par_for(&work, intern_name, &job, 4));
+
+    printf("========\nInterned from threads\n========\n");
+    printf("-- symbols: '" dc_fmt(usize) "', slots: '" dc_fmt(usize) "'\n", pool.count, pool.slot_cap);
+
+    if (pool.count != NAME_COUNT) dc_ret_e(5, "every name must be interned once");
+
+    for (usize i = NAME_COUNT; i < count; ++i)
+    {
+        if (job.symbols[i] != job.symbols[i % NAME_COUNT]) dc_ret_e(5, "every thread must get the same symbol");
+    }
+
+    free(job.symbols);
+
+    dc_try_fail(dc_da_free(&work));
+
+    return dc_intern_free(&pool);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
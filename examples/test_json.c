@@ -0,0 +1,444 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_json.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+static DCDynVal* field(DCDynVal* object, string key)
+{
+    DCDynVal* found = NULL;
+    dc_ht_find_by_key(dc_dv_as(*object, DCHashTablePtr), dc_dv(string, key), &found);
+
+    return found;
+}
+
+static b1 sv_is(DCDynVal* dv, string text)
+{
+    if (!dv || !dc_dv_is(*dv, DCStringView)) return false;
+
+    DCStringView sv = dc_dv_as(*dv, DCStringView);
+
+    return sv.len == strlen(text) && memcmp(sv.str, text, sv.len) == 0;
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    string text = "{\n"
+                  "  \"name\": \"dcommon\",\n"
+                  "  \"version\": 3, \"ratio\": -0.25, \"big\": 1e-300, \"huge\": 123456789012345678901,\n"
+                  "  \"min\": -9223372036854775808, \"tiny\": 2.5E-3,\n"
+                  "  \"digits\": 1234567890123456789, \"fraction\": -0.000125,\n"
+                  "  \"ok\": true, \"off\": false, \"none\": null,\n"
+                  "  \"escaped\": \"tab\\there \\\"quoted\\\" \\\\ \\u00e9\\u20ac\\ud83d\\ude00\",\n"
+                  "  \"list\": [1, [2, [3, []]], {}, \"\"],\n"
+                  "  \"name\": \"repeated keys keep the last value\"\n"
+                  "}";
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCJsonParser jp;
+    dc_try_fail(dc_json_init(&jp, text, strlen(text), &arena));
+
+    dc_try_or_fail_with3(DCRes, doc_res, dc_json_parse(&jp), {});
+    DCDynVal doc = dc_unwrap2(doc_res);
+
+    printf("========\nParsed JSON\n========\n");
+    dc_dv_println(&doc);
+
+    if (!dc_dv_is(doc, DCHashTablePtr) || dc_dv_as(doc, DCHashTablePtr)->key_count != 14) dc_ret_e(5, "wrong parsed object");
+
+    DCDynVal* name = field(&doc, "name");
+    if (!sv_is(name, "repeated keys keep the last value")) dc_ret_e(5, "wrong repeated key");
+
+    // Strings without escapes point into the input
+    DCStringView name_sv = dc_dv_as(*name, DCStringView);
+    if (name_sv.str < text || name_sv.str >= text + strlen(text)) dc_ret_e(5, "plain strings must view the input");
+
+    if (!sv_is(field(&doc, "escaped"), "tab\there \"quoted\" \\ \xc3\xa9\xe2\x82\xac\xf0\x9f\x98\x80"))
+        dc_ret_e(5, "wrong unescaped string");
+
+    DCDynVal* version = field(&doc, "version");
+    DCDynVal* ratio = field(&doc, "ratio");
+    DCDynVal* big = field(&doc, "big");
+    DCDynVal* huge = field(&doc, "huge");
+    DCDynVal* min = field(&doc, "min");
+    DCDynVal* tiny = field(&doc, "tiny");
+    DCDynVal* digits = field(&doc, "digits");
+    DCDynVal* fraction = field(&doc, "fraction");
+
+    if (!dc_dv_is(*version, i64) || dc_dv_as(*version, i64) != 3 || dc_dv_as(*ratio, f64) != -0.25 ||
+        dc_dv_as(*big, f64) != 1e-300 || !dc_dv_is(*huge, f64) || dc_dv_as(*huge, f64) != 123456789012345678901.0 ||
+        dc_dv_as(*min, i64) != INT64_MIN || dc_dv_as(*tiny, f64) != 2.5e-3 || !dc_dv_is(*digits, i64) ||
+        dc_dv_as(*digits, i64) != 1234567890123456789 || dc_dv_as(*fraction, f64) != -0.000125)
+        dc_ret_e(5, "wrong parsed numbers");
+
+    if (!dc_dv_as(*field(&doc, "ok"), b1) || dc_dv_as(*field(&doc, "off"), b1) || dc_dv_as(*field(&doc, "none"), voidptr) != NULL)
+        dc_ret_e(5, "wrong parsed literals");
+
+    DCDynArr* list = dc_dv_as(*field(&doc, "list"), DCDynArrPtr);
+    DCDynArr* nested = dc_da_get_as(*dc_da_get_as(*list, 1, DCDynArrPtr), 1, DCDynArrPtr);
+    if (list->count != 4 || dc_da_get_as(*nested, 0, i64) != 3 || dc_da_get_as(*nested, 1, DCDynArrPtr)->count != 0 ||
+        dc_da_get_as(*list, 2, DCHashTablePtr)->key_count != 0 || !sv_is(&dc_da_get2(*list, 3), ""))
+        dc_ret_e(5, "wrong parsed arrays");
+
+    // Growing parsed values takes memory from the arena too
+    for (i64 i = 0; i < 100; ++i) dc_try_fail(dc_da_push(list, dc_dv(i64, i)));
+
+    DCHashTable* doc_ht = dc_dv_as(doc, DCHashTablePtr);
+
+    string added[] = {"added 1", "added 2", "added 3", "added 4", "added 5", "added 6", "added 7", "added 8"};
+    for (usize i = 0; i < dc_count(added); ++i)
+        dc_try_fail(dc_ht_set(doc_ht, dc_dv(string, added[i]), dc_dv(usize, i), DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_try_fail(dc_ht_set(doc_ht, dc_dv(string, "name"), dc_dv(string, "updated"), DC_HT_SET_UPDATE_OR_FAIL));
+
+    if (dc_da_storage(*list) != DC_DA_STORAGE_ARENA || list->count != 104 || doc_ht->key_count != 14 + dc_count(added) ||
+        strcmp(dc_dv_as(*field(&doc, "name"), string), "updated") != 0)
+        dc_ret_e(5, "wrong grown document");
+
+    // Malformed documents
+    string bad[] = {"",          "   ",          "{",          "[1, 2",      "[1 2]",       "{\"a\" 1}",   "{\"a\": 1,}",
+                    "[01]",      "[1.]",         "[-]",        "[1e]",       "tru",         "nul",         "[true false]",
+                    "\"a\nb\"",  "\"\\x\"",      "\"\\ud800\"", "\"abc",     "{1: 2}",      "[1] [2]",     "@",
+                    "[\"a\"b]",  "[1,,2]",       "]",          "[-01]",      "[truex]",     "[1.5.]",      "[2x]"};
+
+    for (usize i = 0; i < dc_count(bad); ++i)
+    {
+        DCJsonParser bad_jp;
+        dc_try_fail(dc_json_init(&bad_jp, bad[i], strlen(bad[i]), &arena));
+
+        DCRes bad_res = dc_json_parse(&bad_jp);
+        dc_try_fail(dc_json_free(&bad_jp));
+
+        if (dc_is_ok2(bad_res)) dc_ret_ea(5, "malformed JSON must fail: %s", bad[i]);
+
+        if (i == 4) printf("got expected error: %s\n", dc_err_msg2(bad_res));
+        dc_try_fail(dc_result_free(&bad_res));
+    }
+
+    // Too deep nesting is refused
+    string deep = malloc(DC_JSON_MAX_DEPTH * 2 + 3);
+    if (!deep) dc_ret_e(2, "Memory allocation failed");
+
+    memset(deep, '[', DC_JSON_MAX_DEPTH + 1);
+    memset(deep + DC_JSON_MAX_DEPTH + 1, ']', DC_JSON_MAX_DEPTH + 1);
+    deep[DC_JSON_MAX_DEPTH * 2 + 2] = '\0';
+
+    DCJsonParser deep_jp;
+    dc_try_fail(dc_json_init(&deep_jp, deep, strlen(deep), &arena));
+
+    DCRes deep_res = dc_json_parse(&deep_jp);
+    if (dc_is_ok2(deep_res)) dc_ret_e(5, "too deep JSON must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(deep_res));
+    dc_try_fail(dc_result_free(&deep_res));
+
+    free(deep);
+    dc_try_fail(dc_json_free(&deep_jp));
+    dc_try_fail(dc_json_free(&jp));
+
+    return dc_arena_free(&arena);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    // Escapes around the edges of the 64 byte blocks, every line is a document
+    DCStrBuilder sb;
+    dc_try_fail(dc_sb_init(&sb, 0));
+
+    usize lines = 200;
+    for (usize i = 0; i < lines; ++i)
+    {
+        dc_try_fail(dc_sb_appendf(&sb, "{\"id\": %" PRIuMAX ", \"text\": \"", (uintmax_t)i));
+        for (usize j = 0; j < i % 70; ++j) dc_try_fail(dc_sb_append_char(&sb, 'x'));
+
+        // An escaped backslash followed by an escaped quote
+        dc_try_fail(dc_sb_append_str(&sb, "\\\\\\\"\", \"tags\": [\"a\", \"b\"]}\r\n"));
+
+        if (i % 50 == 0) dc_try_fail(dc_sb_append_str(&sb, "\n   \n"));
+        if (i == 100) dc_try_fail(dc_sb_append_str(&sb, "{\"broken\": }\n"));
+    }
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCJsonParser jp;
+    dc_try_fail(dc_json_init(&jp, sb.buf, sb.len, &arena));
+
+    usize parsed = 0;
+    usize failed = 0;
+
+    while (!dc_json_done(jp))
+    {
+        DCDynVal doc;
+        DCResBool next = dc_json_next(&jp, &doc);
+
+        // A broken line doesn't stop the stream
+        if (dc_is_err2(next))
+        {
+            printf("got expected error: %s\n", dc_err_msg2(next));
+            dc_try_fail(dc_result_free(&next));
+
+            failed++;
+            continue;
+        }
+
+        if (!dc_unwrap2(next)) break;
+
+        DCDynVal* id = field(&doc, "id");
+        DCDynVal* doc_text = field(&doc, "text");
+        if (!id || (usize)dc_dv_as(*id, i64) != parsed) dc_ret_e(5, "wrong document id");
+
+        DCStringView sv = dc_dv_as(*doc_text, DCStringView);
+        if (sv.len != parsed % 70 + 2 || sv.str[sv.len - 2] != '\\' || sv.str[sv.len - 1] != '"')
+            dc_ret_e(5, "wrong escaped text");
+
+        if (dc_dv_as(*field(&doc, "tags"), DCDynArrPtr)->count != 2) dc_ret_e(5, "wrong tags");
+
+        parsed++;
+
+        // Documents only need to live until the next one
+        dc_try_fail(dc_arena_reset(&arena));
+    }
+
+    printf("========\nParsed newline delimited JSON\n========\n");
+    printf("-- documents: '" dc_fmt(usize) "', failed: '" dc_fmt(usize) "'\n", parsed, failed);
+
+    if (parsed != lines || failed != 1) dc_ret_e(5, "wrong number of documents");
+
+    dc_try_fail(dc_json_free(&jp));
+    dc_try_fail(dc_arena_free(&arena));
+
+    return dc_sb_free(&sb);
+}
+
+DCResVoid test3()
+{
+    DC_RES_void();
+
+    DCDynArr inner;
+    dc_try_fail(dc_da_init(&inner, NULL));
+    dc_try_fail(dc_da_push(&inner, dc_dv(u8, 7)));
+    dc_try_fail(dc_da_push(&inner, dc_dv(string, NULL)));
+
+    DCDynArr empty;
+    dc_try_fail(dc_da_init(&empty, NULL));
+
+    DCPair pair = {.first = dc_dv(string, "key"), .second = dc_dv(f32, 0.1f)};
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+    dc_try_fail(dc_da_push(&darr, dc_dv(i64, INT64_MIN)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(u64, UINT64_MAX)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 0.1)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 3.0)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, -52.52)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 1e-300)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, 1e22)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f64, NAN)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(f32, 0.1f)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, "a\"b\\c\n\x01 \xc3\xa9")));
+    dc_try_fail(dc_da_push(&darr, dc_dv(char, '\t')));
+    dc_try_fail(dc_da_push(&darr, dc_dv(b1, true)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(voidptr, NULL)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCDynArrPtr, &inner)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCPairPtr, &pair)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCDynArrPtr, &empty)));
+
+    DCJsonWriter jw;
+    dc_try_fail(dc_jw_init(&jw, NULL));
+    dc_try_fail(dc_jw_write(&jw, &dc_dv(DCDynArrPtr, &darr)));
+
+    printf("========\nWritten JSON\n========\n%s\n", jw.sb.buf);
+
+    string expected = "[-9223372036854775808,18446744073709551615,0.1,3.0,-52.52,1e-300,1e+22,null,0.1,"
+                      "\"a\\\"b\\\\c\\n\\u0001 \xc3\xa9\",\"\\t\",true,null,[7,null],[\"key\",0.1],[]]";
+    if (strcmp(jw.sb.buf, expected) != 0) dc_ret_e(5, "wrong written JSON");
+
+    // What's written reads back the same
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCJsonParser jp;
+    dc_try_fail(dc_json_init(&jp, jw.sb.buf, jw.sb.len, &arena));
+
+    dc_try_or_fail_with3(DCRes, doc_res, dc_json_parse(&jp), {});
+    DCDynArr* read = dc_dv_as(dc_unwrap2(doc_res), DCDynArrPtr);
+
+    if (read->count != darr.count || dc_da_get_as(*read, 0, i64) != INT64_MIN || dc_da_get_as(*read, 4, f64) != -52.52 ||
+        dc_da_get_as(*read, 5, f64) != 1e-300 || dc_da_get_as(*read, 6, f64) != 1e22 ||
+        !sv_is(&dc_da_get2(*read, 9), "a\"b\\c\n\x01 \xc3\xa9"))
+        dc_ret_e(5, "written JSON must read back the same");
+
+    dc_try_fail(dc_json_free(&jp));
+    dc_try_fail(dc_arena_free(&arena));
+
+    // Pretty printing
+    DCHashTable no_keys;
+    dc_try_fail(dc_ht_init(&no_keys, 3, NULL, NULL, NULL));
+
+    dc_try_fail(dc_da_push(&empty, dc_dv(i32, 1)));
+    dc_try_fail(dc_da_push(&empty, dc_dv(DCHashTablePtr, &no_keys)));
+
+    DCHashTable ht;
+    dc_try_fail(dc_ht_init(&ht, 3, NULL, NULL, NULL));
+    dc_try_fail(dc_ht_set(&ht, dc_dv(string, "list"), dc_dv(DCDynArrPtr, &empty), DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_sb_clear(&jw.sb);
+    jw.indent = 2;
+
+    // Another document of the same writer goes on a new line
+    dc_try_fail(dc_jw_write(&jw, &dc_dv(DCHashTablePtr, &ht)));
+
+    printf("%s\n", jw.sb.buf);
+
+    if (strcmp(jw.sb.buf, "\n{\n  \"list\": [\n    1,\n    {}\n  ]\n}") != 0) dc_ret_e(5, "wrong pretty printed JSON");
+
+    dc_try_fail(dc_jw_free(&jw));
+
+    dc_try_fail(dc_ht_free(&ht));
+    dc_try_fail(dc_ht_free(&no_keys));
+    dc_try_fail(dc_da_free(&darr));
+    dc_try_fail(dc_da_free(&empty));
+
+    return dc_da_free(&inner);
+}
+
+DCResVoid test4()
+{
+    DC_RES_void();
+
+    usize count = 200000;
+
+    fileptr file = tmpfile();
+    if (!file) dc_ret_e(5, "cannot create a temporary file");
+
+    // A long array is streamed one element at a time
+    DCJsonWriter jw;
+    dc_try_fail(dc_jw_init(&jw, file));
+
+    dc_try_fail(dc_jw_begin_object(&jw));
+    dc_try_fail(dc_jw_key(&jw, "items", 5));
+    dc_try_fail(dc_jw_begin_array(&jw));
+
+    usize max_cap = 0;
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_fail(dc_jw_write(&jw, &dc_dv(usize, i)));
+
+        if (jw.sb.cap > max_cap) max_cap = jw.sb.cap;
+    }
+
+    dc_try_fail(dc_jw_end(&jw));
+    dc_try_fail(dc_jw_key(&jw, "done", 4));
+    dc_try_fail(dc_jw_write(&jw, &dc_dv(b1, true)));
+    dc_try_fail(dc_jw_end(&jw));
+
+    dc_try_fail(dc_jw_write(&jw, &dc_dv(string, "next")));
+    dc_try_fail(dc_jw_free(&jw));
+
+    printf("========\nStreamed JSON\n========\n");
+    printf("-- bytes: '%ld', largest buffer: '" dc_fmt(usize) "'\n", ftell(file), max_cap);
+
+    if (max_cap > 2 * DC_JSON_FLUSH_SIZE) dc_ret_e(5, "streaming must not keep the whole output");
+
+    // Both documents are read back
+    long size = ftell(file);
+    rewind(file);
+
+    string text = malloc((usize)size);
+    if (!text || fread(text, 1, (usize)size, file) != (usize)size) dc_ret_e(5, "cannot read the streamed file");
+
+    fclose(file);
+
+    DCArena arena;
+    dc_try_fail(dc_arena_init(&arena, 0));
+
+    DCJsonParser jp;
+    dc_try_fail(dc_json_init(&jp, text, (usize)size, &arena));
+
+    DCDynVal doc;
+    dc_try_fail_temp(DCResBool, dc_json_next(&jp, &doc));
+
+    DCDynArr* items = dc_dv_as(*field(&doc, "items"), DCDynArrPtr);
+    if (items->count != count || dc_da_get_as(*items, count - 1, i64) != (i64)count - 1 || !dc_dv_as(*field(&doc, "done"), b1))
+        dc_ret_e(5, "wrong streamed object");
+
+    dc_try_fail_temp(DCResBool, dc_json_next(&jp, &doc));
+    if (!sv_is(&doc, "next") || !dc_json_done(jp)) dc_ret_e(5, "wrong second document");
+
+    dc_try_fail(dc_json_free(&jp));
+    dc_try_fail(dc_arena_free(&arena));
+    free(text);
+
+    // Misuse of the streaming functions and values that can't be written
+    dc_try_fail(dc_jw_init(&jw, NULL));
+
+    DCResVoid res = dc_jw_end(&jw);
+    if (dc_is_ok2(res)) dc_ret_e(5, "ending nothing must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(res));
+
+    if (dc_is_ok2(dc_jw_key(&jw, "key", 3))) dc_ret_e(5, "keys outside of objects must fail");
+
+    dc_try_fail(dc_jw_begin_object(&jw));
+    if (dc_is_ok2(dc_jw_write(&jw, &dc_dv(i32, 1)))) dc_ret_e(5, "values without keys must fail");
+
+    dc_try_fail(dc_jw_key(&jw, "key", 3));
+    if (dc_is_ok2(dc_jw_end(&jw))) dc_ret_e(5, "keys without values must fail");
+
+    res = dc_jw_write(&jw, &dc_dv(voidptr, &count));
+    if (dc_is_ok2(res) || dc_err_code2(res) != 3) dc_ret_e(5, "addresses must not be written");
+
+    printf("got expected error: %s\n", dc_err_msg2(res));
+
+    // A pointed value pointing to itself never ends
+    DCDynVal self = dc_dv(DCDynValPtr, NULL);
+    dc_dv_as(self, DCDynValPtr) = &self;
+
+    dc_try_fail(dc_jw_key(&jw, "self", 4));
+    res = dc_jw_write(&jw, &self);
+    if (dc_is_ok2(res) || dc_err_code2(res) != 4) dc_ret_e(5, "cycles must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(res));
+
+    return dc_jw_free(&jw);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test3());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test4());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,248 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_rc.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DC_PARALLEL
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DC_HT_HASH_FN_DECL(string_hash)
+{
+    DC_RES_u32();
+
+    if (_key->type != dc_dvt(string)) dc_ret_e(dc_e_code(TYPE), dc_e_msg(TYPE));
+
+    string str = dc_dv_as(*_key, string);
+    u32 hash = 5381;
+    i32 c;
+    while ((c = *str++))
+    {
+        hash = ((hash << 5) + hash) + c; // hash * 33 + c
+    }
+
+    dc_ret_ok(hash);
+}
+
+DC_HT_KEY_CMP_FN_DECL(string_key_cmp)
+{
+    return dc_dv_eq(_key1, _key2);
+}
+
+DC_HT_PAIR_FREE_FN_DECL(string_pair_free)
+{
+    DC_RES_void();
+
+    dc_try_fail(dc_dv_free(&_pair->first, NULL));
+    dc_try_fail(dc_dv_free(&_pair->second, NULL));
+
+    dc_ret();
+}
+
+DC_DV_FREE_FN_DECL(releasing_free)
+{
+    return dc_dv_free(_value, NULL);
+}
+
+/**
+ * Takes and drops a reference of the shared array given as the context
+ */
+DC_DA_VISITOR_FN_DECL(share_and_release)
+{
+    DC_RES_void();
+
+    (void)_it;
+    (void)_idx;
+
+    dc_try_or_fail_with3(DCRes, shared, dc_rc_share((DCDynVal*)_ctx), {});
+
+    return dc_dv_free(&dc_unwrap2(shared), NULL);
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCResDa, darr_res, dc_da_new(NULL), {});
+    for (i32 i = 0; i < 5; ++i) dc_try_fail(dc_da_push(dc_unwrap2(darr_res), dc_dv(i32, i)));
+    dc_try_fail(dc_da_push(dc_unwrap2(darr_res), dc_dva(string, dc_unwrap2(dc_strdup("owned")))));
+
+    dc_try_or_fail_with3(DCRes, first, dc_rc_new_da(dc_unwrap2(darr_res)), {});
+    dc_try_or_fail_with3(DCRes, second, dc_rc_share(&dc_unwrap2(first)), {});
+
+    printf("========\nShared array\n========\n");
+    dc_dv_println(&dc_unwrap2(second));
+
+    if (dc_rc_of(dc_unwrap2(first))->refs != 2 || dc_rc_da(dc_unwrap2(first)) != dc_rc_da(dc_unwrap2(second)))
+        dc_ret_e(5, "sharing must not copy the array");
+
+    dc_try_or_fail_with3(DCResBool, eq_res, dc_dv_eq(&dc_unwrap2(first), &dc_unwrap2(second)), {});
+    if (!dc_unwrap2(eq_res)) dc_ret_e(5, "handles of the same array must be equal");
+
+    // The first write copies the array for the writer only
+    dc_try_or_fail_with3(DCResDa, mut_res, dc_rc_da_mut(&dc_unwrap2(second)), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(mut_res), dc_dv(i32, 100)));
+
+    if (dc_rc_da(dc_unwrap2(first)) == dc_rc_da(dc_unwrap2(second))) dc_ret_e(5, "writing to a shared array must copy it");
+
+    if (dc_rc_of(dc_unwrap2(first))->refs != 1 || dc_rc_of(dc_unwrap2(second))->refs != 1)
+        dc_ret_e(5, "each handle must own its own array after the copy");
+
+    if (dc_rc_da(dc_unwrap2(first))->count != 6 || dc_rc_da(dc_unwrap2(second))->count != 7)
+        dc_ret_e(5, "the original array must not see the write");
+
+    if (dc_da_get_as(*dc_rc_da(dc_unwrap2(first)), 5, string) == dc_da_get_as(*dc_rc_da(dc_unwrap2(second)), 5, string))
+        dc_ret_e(5, "owned strings must be duplicated");
+
+    printf("========\nAfter copy on write\n========\n");
+    dc_dv_println(&dc_unwrap2(first));
+    dc_dv_println(&dc_unwrap2(second));
+
+    // A sole owner is changed in place
+    DCDynArr* before = dc_rc_da(dc_unwrap2(first));
+    dc_try_or_fail_with3(DCResDa, in_place, dc_rc_da_mut(&dc_unwrap2(first)), {});
+    if (dc_unwrap2(in_place) != before) dc_ret_e(5, "a sole owner must not copy");
+
+    // Borrowed handles cannot be mutated
+    DCDynVal borrowed = dc_dv(DCRcPtr, dc_rc_of(dc_unwrap2(first)));
+    DCResDa borrowed_res = dc_rc_da_mut(&borrowed);
+    if (dc_is_ok2(borrowed_res)) dc_ret_e(5, "borrowed handles must not be mutated");
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(first), NULL));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(second), NULL));
+
+    // Elements marked in place are owned
+    dc_try_or_fail_with3(DCResDa, marked_res, dc_da_new(NULL), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(marked_res), dc_dv(i32, 0)));
+    dc_dv_set(dc_da_get2(*dc_unwrap2(marked_res), 0), string, dc_unwrap2(dc_strdup("marked")));
+    dc_da_mark_alloc(*dc_unwrap2(marked_res), 0);
+
+    dc_try_or_fail_with3(DCRes, marked, dc_rc_new_da(dc_unwrap2(marked_res)), {});
+    dc_try_or_fail_with3(DCRes, marked_copy, dc_rc_share(&dc_unwrap2(marked)), {});
+    dc_try_fail_temp(DCResDa, dc_rc_da_mut(&dc_unwrap2(marked_copy)));
+
+    if (dc_da_get_as(*dc_rc_da(dc_unwrap2(marked)), 0, string) == dc_da_get_as(*dc_rc_da(dc_unwrap2(marked_copy)), 0, string))
+        dc_ret_e(5, "strings marked in place must be duplicated");
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(marked), NULL));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(marked_copy), NULL));
+
+    // What a custom free function releases cannot be copied
+    dc_try_or_fail_with3(DCResDa, custom_res, dc_da_new(releasing_free), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(custom_res), dc_dv(i32, 1)));
+
+    dc_try_or_fail_with3(DCRes, custom, dc_rc_new_da(dc_unwrap2(custom_res)), {});
+    dc_try_or_fail_with3(DCRes, custom_copy, dc_rc_share(&dc_unwrap2(custom)), {});
+
+    DCResDa custom_mut = dc_rc_da_mut(&dc_unwrap2(custom_copy));
+    if (dc_is_ok2(custom_mut)) dc_ret_e(5, "arrays with an element free function must not be copied");
+    printf("got expected error: %s\n", dc_err_msg2(custom_mut));
+
+    if (dc_rc_da(dc_unwrap2(custom)) != dc_rc_da(dc_unwrap2(custom_copy))) dc_ret_e(5, "a failed copy must keep sharing");
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(custom), NULL));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(custom_copy), NULL));
+
+    dc_ret();
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCResHt, ht_res, dc_ht_new(7, string_hash, string_key_cmp, string_pair_free), {});
+    dc_try_fail(dc_ht_set(dc_unwrap2(ht_res), dc_dva(string, dc_unwrap2(dc_strdup("one"))), dc_dv(i32, 1),
+                          DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_try_or_fail_with3(DCResDa, nested_res, dc_da_new(NULL), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(nested_res), dc_dv(f64, 2.5)));
+    dc_try_fail(dc_ht_set(dc_unwrap2(ht_res), dc_dva(string, dc_unwrap2(dc_strdup("two"))),
+                          dc_dva(DCDynArrPtr, dc_unwrap2(nested_res)), DC_HT_SET_CREATE_OR_FAIL));
+
+    dc_try_or_fail_with3(DCRes, first, dc_rc_new_ht(dc_unwrap2(ht_res)), {});
+    dc_try_or_fail_with3(DCRes, second, dc_rc_share(&dc_unwrap2(first)), {});
+
+    dc_try_or_fail_with3(DCResHt, mut_res, dc_rc_ht_mut(&dc_unwrap2(second)), {});
+    dc_try_fail(dc_ht_set(dc_unwrap2(mut_res), dc_dva(string, dc_unwrap2(dc_strdup("three"))), dc_dv(i32, 3),
+                          DC_HT_SET_CREATE_OR_FAIL));
+
+    printf("========\nShared hash table after copy on write\n========\n");
+    dc_dv_println(&dc_unwrap2(first));
+    dc_dv_println(&dc_unwrap2(second));
+
+    if (dc_rc_ht(dc_unwrap2(first))->key_count != 2 || dc_rc_ht(dc_unwrap2(second))->key_count != 3)
+        dc_ret_e(5, "the original hash table must not see the write");
+
+    DCDynVal* found = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(dc_rc_ht(dc_unwrap2(second)), dc_dv(string, "two"), &found));
+    if (!found || dc_da_get_as(*dc_dv_as(*found, DCDynArrPtr), 0, f64) != 2.5) dc_ret_e(5, "nested array must be copied");
+
+    DCDynVal* original = NULL;
+    dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(dc_rc_ht(dc_unwrap2(first)), dc_dv(string, "two"), &original));
+    if (dc_dv_as(*original, DCDynArrPtr) == dc_dv_as(*found, DCDynArrPtr)) dc_ret_e(5, "nested array must not be shared");
+
+    // Handles are written as the container they share
+    DCBinWriter bw;
+    dc_try_fail(dc_bw_init(&bw, NULL));
+    dc_try_fail(dc_bw_write(&bw, &dc_unwrap2(second)));
+
+    printf("-- serialized bytes: '" dc_fmt(usize) "'\n", bw.len);
+    dc_try_fail(dc_bw_free(&bw));
+
+    dc_try_fail(dc_dv_free(&dc_unwrap2(first), NULL));
+    dc_try_fail(dc_dv_free(&dc_unwrap2(second), NULL));
+
+    dc_ret();
+}
+
+DCResVoid test3()
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCResDa, darr_res, dc_da_new(NULL), {});
+    dc_try_fail(dc_da_push(dc_unwrap2(darr_res), dc_dv(string, "shared between threads")));
+    dc_try_or_fail_with3(DCRes, handle, dc_rc_new_da(dc_unwrap2(darr_res)), {});
+
+    // Each visit takes and drops a reference from one of the threads
+    DCDynArr work;
+    dc_try_fail(dc_da_init2(&work, 100000, 2, NULL));
+    for (usize i = 0; i < 100000; ++i) dc_try_fail(dc_da_push(&work, dc_dv(usize, i)));
+
+    dc_try_fail(dc_da_par_for(&work, share_and_release, &dc_unwrap2(handle), 4));
+
+    printf("========\nShared from threads\n========\n");
+    printf("-- references left: '" dc_fmt(i64) "'\n", dc_rc_of(dc_unwrap2(handle))->refs);
+
+    if (dc_rc_of(dc_unwrap2(handle))->refs != 1) dc_ret_e(5, "every shared reference must be released");
+
+    dc_try_fail(dc_da_free(&work));
+
+    return dc_dv_free(&dc_unwrap2(handle), NULL);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test3());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
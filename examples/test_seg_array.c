@@ -0,0 +1,105 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_seg_array.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    DCSegArr sarr;
+    dc_try_fail(dc_sa_init(&sarr, NULL));
+
+    // Pointer taken before many growths
+    dc_try_or_fail_with3(DCResPtr, first_res, dc_sa_push2(&sarr, dc_dv(i32, 0)), {});
+    DCDynVal* first = dc_unwrap2(first_res);
+
+    for (i32 i = 1; i < 1000; ++i) dc_try_fail(dc_sa_push(&sarr, dc_dv(i32, i)));
+
+    if (first != &dc_sa_get2(sarr, 0) || dc_dv_as(*first, i32) != 0) dc_ret_e(5, "element must not move while growing");
+
+    printf("========\nSegmented array\n========\n");
+    printf("-- count: '" dc_fmt(usize) "', capacity: '" dc_fmt(usize) "', chunks: '" dc_fmt(usize) "'\n", sarr.count, sarr.cap,
+           sarr.chunk_count);
+
+    i64 sum = 0;
+    dc_sa_for(sum_loop, sarr, {
+        if (dc_dv_as(*_it, i32) != (i32)_idx) dc_ret_e(5, "wrong element while iterating");
+        sum += dc_dv_as(*_it, i32);
+    });
+
+    printf("-- sum: '" dc_fmt(i64) "'\n", sum);
+
+    // Chunk boundaries
+    usize boundaries[] = {DC_SA_FIRST_CHUNK - 1, DC_SA_FIRST_CHUNK, DC_SA_FIRST_CHUNK * 3 - 1, DC_SA_FIRST_CHUNK * 3, 999};
+    for (usize i = 0; i < dc_count(boundaries); ++i)
+    {
+        dc_try_or_fail_with3(DCResPtr, el, dc_sa_get(&sarr, boundaries[i]), {});
+        if (dc_dv_as(*dc_unwrap2(el), i32) != (i32)boundaries[i]) dc_ret_e(5, "wrong element at chunk boundary");
+    }
+
+    DCResPtr out_of_bound = dc_sa_get(&sarr, 1000);
+    if (dc_is_ok2(out_of_bound)) dc_ret_e(5, "index out of bound must fail");
+
+    DCDynVal popped;
+    dc_try_fail(dc_sa_pop(&sarr, &popped));
+    if (dc_dv_as(popped, i32) != 999) dc_ret_e(5, "wrong element popped");
+
+    while (sarr.count > DC_SA_FIRST_CHUNK) dc_try_fail(dc_sa_pop(&sarr, NULL));
+    dc_try_fail(dc_sa_trunc(&sarr));
+
+    printf("-- after trunc count: '" dc_fmt(usize) "', chunks: '" dc_fmt(usize) "'\n", sarr.count, sarr.chunk_count);
+
+    if (sarr.chunk_count != 1) dc_ret_e(5, "unused chunks must be freed");
+
+    return dc_sa_free(&sarr);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    DCSegArr sarr;
+    dc_try_fail(dc_sa_init(&sarr, NULL));
+    dc_try_fail(dc_sa_reserve(&sarr, 100));
+
+    for (usize i = 0; i < 40; ++i)
+    {
+        string str = NULL;
+        dc_sprintf(&str, "item %" PRIuMAX, i);
+        dc_try_fail(dc_sa_push(&sarr, dc_dva(string, str)));
+    }
+
+    printf("========\nSegmented array of strings\n========\n");
+    dc_try_or_fail_with3(DCResPtr, el, dc_sa_get(&sarr, 33), {});
+    dc_dv_println(dc_unwrap2(el));
+
+    return dc_sa_free(&sarr);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,117 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_str_builder.h
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    DCStrBuilder sb;
+    dc_try_fail(dc_sb_init(&sb, 0));
+
+    // Growing well past the initial capacity
+    for (i32 i = 0; i < 1000; ++i) dc_try_fail(dc_sb_appendf(&sb, "%d,", i));
+
+    printf("========\nString builder\n========\n");
+    printf("-- length: '" dc_fmt(usize) "', capacity: '" dc_fmt(usize) "'\n", sb.len, sb.cap);
+
+    if (sb.len != strlen(dc_sb_str(sb)) || strncmp(dc_sb_str(sb), "0,1,2,", 6) != 0) dc_ret_e(5, "wrong built string");
+
+    // Clearing keeps the buffer
+    usize cap = sb.cap;
+    dc_sb_clear(&sb);
+    if (sb.len != 0 || sb.cap != cap || dc_sb_str(sb)[0] != '\0') dc_ret_e(5, "clear must keep the buffer");
+
+    dc_try_fail(dc_sb_append_str(&sb, "hello"));
+    dc_try_fail(dc_sb_append_char(&sb, ' '));
+    dc_try_fail(dc_sb_append(&sb, "world!!!", 5));
+
+    dc_try_or_fail_with3(DCResString, taken, dc_sb_take(&sb), {});
+    printf("-- taken: '%s'\n", dc_unwrap2(taken));
+
+    if (strcmp(dc_unwrap2(taken), "hello world") != 0) dc_ret_e(5, "wrong taken string");
+    free(dc_unwrap2(taken));
+
+    // Taking from an empty builder gives an empty string
+    if (sb.buf != NULL || sb.len != 0) dc_ret_e(5, "builder must be empty after take");
+
+    dc_try_or_fail_with3(DCResString, empty, dc_sb_take(&sb), {});
+    if (strcmp(dc_unwrap2(empty), "") != 0) dc_ret_e(5, "empty builder must give empty string");
+    free(dc_unwrap2(empty));
+
+    // dc_sappend keeps working on plain strings
+    string str = NULL;
+    dc_try_fail_temp(DCResUsize, dc_sappend(&str, "%s", "a"));
+    for (i32 i = 0; i < 100; ++i) dc_try_fail_temp(DCResUsize, dc_sappend(&str, "%d", i % 10));
+
+    if (strlen(str) != 101 || str[100] != '9') dc_ret_e(5, "wrong appended string");
+    free(str);
+
+    return dc_sb_free(&sb);
+}
+
+DCResVoid test2()
+{
+    DC_RES_void();
+
+    DCDynArr darr;
+    dc_try_fail(dc_da_init(&darr, NULL));
+
+    DCPair pair = {.first = dc_dv(string, "pi"), .second = dc_dv(f64, 3.14)};
+
+    dc_try_fail(dc_da_push(&darr, dc_dv(i32, 42)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(b1, true)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCPairPtr, &pair)));
+    dc_try_or_fail_with3(DCRes, sv_res, dc_dv_box_sv(dc_sv("a view that is cut", 0, 6)), {});
+    dc_try_fail(dc_da_push(&darr, dc_unwrap2(sv_res)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(DCDynArrPtr, NULL)));
+    dc_try_fail(dc_da_push(&darr, dc_dv(string, NULL)));
+
+    DCStrBuilder sb;
+    dc_try_fail(dc_sb_init(&sb, 0));
+
+    // Everything ends up in the same buffer
+    dc_try_fail(dc_sb_append_str(&sb, "values: "));
+    dc_try_fail(dc_dv_write(&sb, &dc_dv(DCDynArrPtr, &darr)));
+
+    printf("========\nWritten dynamic values\n========\n");
+    printf("%s\n", dc_sb_str(sb));
+
+    if (strcmp(dc_sb_str(sb), "values: [42, true, (pi, 3.140000), a view, [], (null)]") != 0) dc_ret_e(5, "wrong written values");
+
+    dc_try_or_fail_with3(DCResString, str, dc_tostr_dv(&dc_dv(DCDynArrPtr, &darr)), {});
+    if (strcmp(dc_unwrap2(str), sb.buf + 8) != 0) dc_ret_e(5, "dc_tostr_dv must match dc_dv_write");
+    free(dc_unwrap2(str));
+
+    dc_try_fail(dc_sb_free(&sb));
+
+    return dc_da_free(&darr);
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    dc_try(test2());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,151 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: test_str_to.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description:
+// ***************************************************************************************
+
+#define DCOMMON_IMPL
+#include "../src/dcommon/dcommon.h"
+
+/**
+ * What the `strtol` family says about `str`: 0 valid, 1 not a number, 2 out of
+ * range for [min, max] (signed) or [0, max] (unsigned)
+ */
+static int reference(const string str, b1 is_signed, i64 min, u64 max, u64* out)
+{
+    string end;
+    errno = 0;
+
+    if (is_signed)
+    {
+        long long val = strtoll(str, &end, 10);
+        if (end == str || *end != '\0') return 1;
+        if (errno == ERANGE || val < min || (val > 0 && (u64)val > max)) return 2;
+
+        *out = (u64)val;
+    }
+    else
+    {
+        unsigned long long val = strtoull(str, &end, 10);
+        if (end == str || *end != '\0') return 1;
+        if (errno == ERANGE || val > max) return 2;
+
+        *out = (u64)val;
+    }
+
+    return 0;
+}
+
+#define check(TYPE, IS_SIGNED, MIN, MAX)                                                                                       \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        u64 expected = 0;                                                                                                      \
+        int kind = reference(str, IS_SIGNED, MIN, MAX, &expected);                                                             \
+        DCResType_##TYPE res = dc_str_to_##TYPE(str);                                                                          \
+        b1 same = dc_is_ok2(res) ? kind == 0 && (u64)dc_unwrap2(res) == (u64)(TYPE)expected : kind != 0;                      \
+        if (!same)                                                                                                             \
+        {                                                                                                                      \
+            printf("mismatch of '%s' for '%s'\n", #TYPE, str);                                                                 \
+            mismatches++;                                                                                                      \
+        }                                                                                                                      \
+    } while (0)
+
+typedef DCResI8 DCResType_i8;
+typedef DCResI16 DCResType_i16;
+typedef DCResI32 DCResType_i32;
+typedef DCResI64 DCResType_i64;
+typedef DCResU8 DCResType_u8;
+typedef DCResU16 DCResType_u16;
+typedef DCResU32 DCResType_u32;
+typedef DCResU64 DCResType_u64;
+
+static usize check_all(const string str)
+{
+    usize mismatches = 0;
+
+    // Empty strings are zero for the smallest types
+    if (str[0] != '\0')
+    {
+        check(i8, true, INT8_MIN, INT8_MAX);
+        check(i16, true, INT16_MIN, INT16_MAX);
+    }
+
+    check(i32, true, INT32_MIN, INT32_MAX);
+    check(i64, true, INT64_MIN, INT64_MAX);
+    check(u8, false, 0, UINT8_MAX);
+    check(u16, false, 0, UINT16_MAX);
+    check(u32, false, 0, UINT32_MAX);
+    check(u64, false, 0, UINT64_MAX);
+
+    return mismatches;
+}
+
+DCResVoid test1()
+{
+    DC_RES_void();
+
+    string cases[] = {"0", "-0", "+0", "7", "-7", "127", "128", "-128", "-129", "255", "256", "-1", "32767", "32768", "-32768",
+                      "65535", "65536", "2147483647", "2147483648", "-2147483648", "-2147483649", "4294967295",
+                      "4294967296", "9223372036854775807", "9223372036854775808", "-9223372036854775808",
+                      "-9223372036854775809", "18446744073709551615", "18446744073709551616", "-18446744073709551615",
+                      "-18446744073709551616", "99999999999999999999", "10000000000000000000", "100000000000000000000",
+                      "000000000000000000000000000042", "-00000000000000000000018446744073709551615", "  42", "\t\n\v\f\r-5",
+                      "42 ", " ", "-", "+", "+-1", "- 1", "1x", "x1", "12345678x", "1234567x8", "0x10", "1e3", "3.0",
+                      "123456789012345678901234567890x", "12345678", "123456789", "1234567890123456", "/", ":", "١"};
+
+    usize mismatches = 0;
+    for (usize i = 0; i < dc_count(cases); ++i) mismatches += check_all(cases[i]);
+
+    // Random strings mostly made of digits and signs
+    srand(42);
+    string alphabet = "0123456789012345678901234567890123456789+- 0x";
+
+    char text[32];
+    for (usize i = 0; i < 200000; ++i)
+    {
+        usize len = (usize)rand() % 24;
+        for (usize j = 0; j < len; ++j) text[j] = alphabet[rand() % (int)strlen(alphabet)];
+        text[len] = '\0';
+
+        mismatches += check_all(text);
+    }
+
+    printf("========\nInteger parsing against strtol\n========\n");
+    printf("-- mismatches: '" dc_fmt(usize) "'\n", mismatches);
+
+    if (mismatches != 0) dc_ret_e(5, "integer parsing must match the strtol family");
+
+    // Special cases of the smallest types and NULL
+    if (dc_is_err2(dc_str_to_i8("")) || dc_unwrap2(dc_str_to_i8("")) != 0) dc_ret_e(5, "empty string must be 0 for i8");
+    if (dc_is_ok2(dc_str_to_i32(""))) dc_ret_e(5, "empty string must fail for i32");
+
+    DCResU64 res = dc_str_to_u64(NULL);
+    if (dc_is_ok2(res)) dc_ret_e(5, "NULL must fail");
+
+    printf("got expected error: %s\n", dc_err_msg2(res));
+
+    res = dc_str_to_u64("18446744073709551616");
+    printf("got expected error: %s\n", dc_err_msg2(res));
+
+    dc_ret();
+}
+
+int main()
+{
+    DC_RES_void();
+
+    dc_try(test1());
+    dc_action_on(dc_is_err(), return dc_err_code(), "%s", dc_err_msg());
+
+    return 0;
+}
@@ -0,0 +1,241 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _arena.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for arena (bump allocator)
+// *               functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_arena.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Memory of a chunk starts right after its (aligned) header
+ */
+#define __dc_arena_chunk_data(CHUNK) ((u8*)(CHUNK) + dc_arena_align(sizeof(DCArenaChunk)))
+
+/**
+ * Adds a new chunk that can hold at least `size` bytes to the front of the arena
+ */
+static DCResVoid __dc_arena_add_chunk(DCArena* arena, usize size)
+{
+    DC_RES_void();
+
+    usize cap = size > arena->chunk_size ? size : arena->chunk_size;
+
+    if (cap > SIZE_MAX - dc_arena_align(sizeof(DCArenaChunk)))
+    {
+        dc_dbg_log("requested arena allocation is too big");
+
+        dc_ret_e(2, "requested arena allocation is too big");
+    }
+
+    DCArenaChunk* chunk = (DCArenaChunk*)malloc(dc_arena_align(sizeof(DCArenaChunk)) + cap);
+    if (chunk == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    chunk->next = arena->head;
+    chunk->cap = cap;
+    chunk->used = 0;
+
+    arena->head = chunk;
+
+    dc_ret();
+}
+
+/**
+ * Takes `size` (aligned) bytes from the newest chunk, NULL when it has no room
+ *
+ * NOTE: Hot paths of other modules use it before falling back to
+ * `dc_arena_alloc` so most of their allocations skip the result round trip
+ */
+static voidptr __dc_arena_bump(DCArena* arena, usize size)
+{
+    if (!arena->head || arena->head->cap - arena->head->used < size) return NULL;
+
+    voidptr memory = __dc_arena_chunk_data(arena->head) + arena->head->used;
+    arena->head->used += size;
+
+    return memory;
+}
+
+DCResVoid dc_arena_init(DCArena* arena, usize chunk_size)
+{
+    DC_RES_void();
+
+    if (!arena)
+    {
+        dc_dbg_log("got NULL DCArena");
+
+        dc_ret_e(1, "got NULL DCArena");
+    }
+
+    arena->head = NULL;
+    arena->chunk_size = chunk_size == 0 ? DC_ARENA_CHUNK_SIZE : dc_arena_align(chunk_size);
+    arena->defers = NULL;
+
+    dc_ret();
+}
+
+DCResVoidptr dc_arena_alloc(DCArena* arena, usize size)
+{
+    DC_RES_voidptr();
+
+    if (!arena)
+    {
+        dc_dbg_log("got NULL DCArena");
+
+        dc_ret_e(1, "got NULL DCArena");
+    }
+
+    if (size > SIZE_MAX - DC_ARENA_ALIGN)
+    {
+        dc_dbg_log("requested arena allocation is too big");
+
+        dc_ret_e(2, "requested arena allocation is too big");
+    }
+
+    size = dc_arena_align(size == 0 ? 1 : size);
+
+    voidptr memory = __dc_arena_bump(arena, size);
+    if (memory) dc_ret_ok(memory);
+
+    dc_try_fail_temp(DCResVoid, __dc_arena_add_chunk(arena, size));
+
+    dc_ret_ok(__dc_arena_bump(arena, size));
+}
+
+DCResVoidptr dc_arena_memdup(DCArena* arena, const voidptr src, usize size)
+{
+    DC_RES_voidptr();
+
+    if (!src && size > 0)
+    {
+        dc_dbg_log("got NULL source");
+
+        dc_ret_e(1, "got NULL source");
+    }
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(arena, size), {});
+
+    if (size > 0) memcpy(dc_unwrap2(memory), src, size);
+
+    dc_ret_ok(dc_unwrap2(memory));
+}
+
+DCResVoid dc_arena_defer(DCArena* arena, voidptr element, DCCleanupFn cleanup_fn)
+{
+    DC_RES_void();
+
+    if (!cleanup_fn)
+    {
+        dc_dbg_log("got NULL cleanup function");
+
+        dc_ret_e(1, "got NULL cleanup function");
+    }
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(arena, sizeof(DCArenaDefer)), {});
+
+    DCArenaDefer* defer = (DCArenaDefer*)dc_unwrap2(memory);
+    defer->job.element = element;
+    defer->job.cleanup_fn = cleanup_fn;
+
+    defer->next = arena->defers;
+    arena->defers = defer;
+
+    dc_ret();
+}
+
+/**
+ * Runs the registered cleanup jobs newest first, all of them run even if some
+ * fail (the last error is returned)
+ */
+static DCResVoid __dc_arena_run_defers(DCArena* arena)
+{
+    DC_RES_void();
+
+    while (arena->defers)
+    {
+        DCArenaDefer* defer = arena->defers;
+        arena->defers = defer->next;
+
+        DCResVoid res = defer->job.cleanup_fn(defer->job.element);
+        dc_err_cpy(res);
+    }
+
+    dc_ret();
+}
+
+DCResVoid dc_arena_reset(DCArena* arena)
+{
+    DC_RES_void();
+
+    if (!arena)
+    {
+        dc_dbg_log("got NULL DCArena");
+
+        dc_ret_e(1, "got NULL DCArena");
+    }
+
+    DCResVoid defers_res = __dc_arena_run_defers(arena);
+    dc_err_cpy(defers_res);
+
+    if (!arena->head) dc_ret();
+
+    // The newest chunk is kept for reuse
+    DCArenaChunk* chunk = arena->head->next;
+    while (chunk)
+    {
+        DCArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    arena->head->next = NULL;
+    arena->head->used = 0;
+
+    dc_ret();
+}
+
+DCResVoid dc_arena_free(DCArena* arena)
+{
+    DC_RES_void();
+
+    if (!arena) dc_ret();
+
+    DCResVoid defers_res = __dc_arena_run_defers(arena);
+    dc_err_cpy(defers_res);
+
+    DCArenaChunk* chunk = arena->head;
+    while (chunk)
+    {
+        DCArenaChunk* next = chunk->next;
+        free(chunk);
+        chunk = next;
+    }
+
+    arena->head = NULL;
+
+    dc_ret();
+}
+
+#undef __dc_arena_chunk_data
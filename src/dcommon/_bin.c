@@ -0,0 +1,1133 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _bin.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for binary serialization of
+// *               dynamic values
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_bin.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Every value starts with one of these tags, integers follow as LEB128 varints
+ * (zigzag encoded when signed), floats as little endian IEEE 754 bits, strings
+ * as a varint length and the bytes (plus a terminating zero for strings and
+ * inline strings), arrays and hash tables as a varint count and their elements
+ * (key and value for hash tables) and pairs as their two values
+ *
+ * A null pointer is `__DC_BIN_NULL` followed by the tag of its type
+ *
+ * Registered extra types are `__DC_BIN_EXTRA` with a varint of their position
+ * after the built-in types followed by the value their vtable converts them to
+ *
+ * Symbols are written like strings with their own tag so they can be interned
+ * again when they're read
+ *
+ * NOTE: Tags are part of the format, they must never be renumbered
+ */
+#define __DC_BIN_NULL 0x00
+#define __DC_BIN_FALSE 0x01
+#define __DC_BIN_TRUE 0x02
+#define __DC_BIN_I8 0x03
+#define __DC_BIN_I16 0x04
+#define __DC_BIN_I32 0x05
+#define __DC_BIN_I64 0x06
+#define __DC_BIN_U8 0x07
+#define __DC_BIN_U16 0x08
+#define __DC_BIN_U32 0x09
+#define __DC_BIN_U64 0x0a
+#define __DC_BIN_F32 0x0b
+#define __DC_BIN_F64 0x0c
+#define __DC_BIN_UPTR 0x0d
+#define __DC_BIN_CHAR 0x0e
+#define __DC_BIN_SIZE 0x0f
+#define __DC_BIN_USIZE 0x10
+#define __DC_BIN_STRING 0x11
+#define __DC_BIN_SV 0x12
+#define __DC_BIN_ISTR 0x13
+#define __DC_BIN_ARRAY 0x14
+#define __DC_BIN_TABLE 0x15
+#define __DC_BIN_PAIR 0x16
+#define __DC_BIN_DVPTR 0x17
+#define __DC_BIN_EXTRA 0x18
+#define __DC_BIN_SYMBOL 0x19
+
+#define __dc_bin_zigzag(VALUE) ((VALUE) < 0 ? ~((u64)(VALUE) << 1) : (u64)(VALUE) << 1)
+#define __dc_bin_unzigzag(VALUE) ((i64)(((VALUE) >> 1) ^ (0 - ((VALUE) & 1))))
+
+// ***************************************************************************************
+// * WRITER
+// ***************************************************************************************
+
+DCResVoid dc_bw_init(DCBinWriter* bw, fileptr file)
+{
+    DC_RES_void();
+
+    if (!bw)
+    {
+        dc_dbg_log("got NULL DCBinWriter");
+
+        dc_ret_e(1, "got NULL DCBinWriter");
+    }
+
+    bw->buf = NULL;
+    bw->len = 0;
+    bw->cap = 0;
+    bw->file = file;
+    bw->depth = 0;
+
+    dc_ret();
+}
+
+DCResVoid dc_bw_flush(DCBinWriter* bw)
+{
+    DC_RES_void();
+
+    if (!bw)
+    {
+        dc_dbg_log("got NULL DCBinWriter");
+
+        dc_ret_e(1, "got NULL DCBinWriter");
+    }
+
+    if (!bw->file || bw->len == 0) dc_ret();
+
+    if (fwrite(bw->buf, 1, bw->len, bw->file) != bw->len)
+    {
+        dc_dbg_log("Cannot write to the file: (code %d) %s", errno, strerror(errno));
+
+        dc_ret_ea(errno, "%s", strerror(errno));
+    }
+
+    bw->len = 0;
+
+    dc_ret();
+}
+
+DCResVoid dc_bw_free(DCBinWriter* bw)
+{
+    DC_RES_void();
+
+    if (!bw) dc_ret();
+
+    DCResVoid flush_res = dc_bw_flush(bw);
+
+    if (bw->buf) free(bw->buf);
+
+    bw->buf = NULL;
+    bw->len = 0;
+    bw->cap = 0;
+
+    return flush_res;
+}
+
+/**
+ * Makes room for `extra` more bytes, writers with a file flush what they have
+ * instead of growing past `DC_BIN_FLUSH_SIZE`
+ */
+static DCResVoid __dc_bw_reserve(DCBinWriter* bw, usize extra)
+{
+    DC_RES_void();
+
+    if (extra <= bw->cap - bw->len) dc_ret();
+
+    if (bw->file && bw->len >= DC_BIN_FLUSH_SIZE)
+    {
+        dc_try_fail(dc_bw_flush(bw));
+
+        if (extra <= bw->cap) dc_ret();
+    }
+
+    if (extra > SIZE_MAX / 2 - bw->len)
+    {
+        dc_dbg_log("binary writer buffer is too big");
+
+        dc_ret_e(2, "binary writer buffer is too big");
+    }
+
+    usize new_cap = bw->cap == 0 ? 64 : bw->cap * 2;
+    if (new_cap < bw->len + extra) new_cap = bw->len + extra;
+
+    u8* resized = (u8*)realloc(bw->buf, new_cap);
+    if (resized == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    bw->buf = resized;
+    bw->cap = new_cap;
+
+    dc_ret();
+}
+
+static DCResVoid __dc_bw_put(DCBinWriter* bw, const u8* bytes, usize count)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_bw_reserve(bw, count));
+
+    if (count > 0) memcpy(&bw->buf[bw->len], bytes, count);
+    bw->len += count;
+
+    dc_ret();
+}
+
+static DCResVoid __dc_bw_put_u8(DCBinWriter* bw, u8 byte)
+{
+    return __dc_bw_put(bw, &byte, 1);
+}
+
+static DCResVoid __dc_bw_put_varint(DCBinWriter* bw, u64 value)
+{
+    u8 bytes[10];
+    usize count = 0;
+
+    do
+    {
+        u8 byte = value & 0x7f;
+        value >>= 7;
+
+        bytes[count++] = value ? byte | 0x80 : byte;
+    } while (value);
+
+    return __dc_bw_put(bw, bytes, count);
+}
+
+/**
+ * Writes `count` little endian bytes of `bits`
+ */
+static DCResVoid __dc_bw_put_fixed(DCBinWriter* bw, u64 bits, usize count)
+{
+    u8 bytes[8];
+
+    for (usize i = 0; i < count; ++i) bytes[i] = (u8)(bits >> (i * 8));
+
+    return __dc_bw_put(bw, bytes, count);
+}
+
+static DCResVoid __dc_bw_put_tagged_varint(DCBinWriter* bw, u8 tag, u64 value)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_bw_put_u8(bw, tag));
+
+    return __dc_bw_put_varint(bw, value);
+}
+
+static DCResVoid __dc_bw_put_str(DCBinWriter* bw, u8 tag, const string str, usize len, b1 terminated)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_bw_put_tagged_varint(bw, tag, len));
+    dc_try_fail(__dc_bw_put(bw, (const u8*)str, len));
+
+    if (terminated) dc_try_fail(__dc_bw_put_u8(bw, 0));
+
+    dc_ret();
+}
+
+static DCResVoid __dc_bw_put_null(DCBinWriter* bw, u8 tag)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_bw_put_u8(bw, __DC_BIN_NULL));
+
+    return __dc_bw_put_u8(bw, tag);
+}
+
+/**
+ * Writes the `count` elements of the view as an array
+ */
+static DCResVoid __dc_bw_put_elements(DCBinWriter* bw, DCDynVal* elements, usize count, usize stride)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_bw_put_tagged_varint(bw, __DC_BIN_ARRAY, count));
+
+    for (usize i = 0; i < count; ++i) dc_try_fail(dc_bw_write(bw, &elements[i * stride]));
+
+    dc_ret();
+}
+
+/**
+ * Writes the nested values of arrays, hash tables and pairs (and pointed values)
+ * keeping track of the depth
+ */
+static DCResVoid __dc_bw_write_nested(DCBinWriter* bw, DCDynVal* dv)
+{
+    DC_RES_void();
+
+    if (bw->depth >= DC_BIN_MAX_DEPTH)
+    {
+        dc_dbg_log("values are nested too deep (or have a cycle)");
+
+        dc_ret_e(4, "values are nested too deep (or have a cycle)");
+    }
+
+    bw->depth++;
+
+    switch (dv->type)
+    {
+        case dc_dvt(DCDynValPtr):
+            __dc_res = dc_bw_write(bw, dc_dv_as(*dv, DCDynValPtr));
+            break;
+
+        case dc_dvt(DCDynArrView):
+        {
+            DCDynArrView view = dc_dv_as(*dv, DCDynArrView);
+
+            __dc_res = __dc_bw_put_elements(bw, view.elements, view.count, view.stride);
+            break;
+        }
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            DCDynArr* darr = dc_dv_as(*dv, DCDynArrPtr);
+
+            __dc_res = __dc_bw_put_elements(bw, darr->elements, darr->count, 1);
+            break;
+        }
+
+        case dc_dvt(DCHashTablePtr):
+        {
+            DCHashTable* ht = dc_dv_as(*dv, DCHashTablePtr);
+
+            __dc_res = __dc_bw_put_tagged_varint(bw, __DC_BIN_TABLE, ht->key_count);
+
+            for (usize i = 0; i < ht->cap && dc_is_ok(); ++i)
+            {
+                DCDynArr* row = &ht->container[i];
+
+                for (usize j = 0; j < row->count && dc_is_ok(); ++j)
+                {
+                    DCPair* pair = dc_dv_as(row->elements[j], DCPairPtr);
+
+                    __dc_res = dc_bw_write(bw, &pair->first);
+                    if (dc_is_ok()) __dc_res = dc_bw_write(bw, &pair->second);
+                }
+            }
+
+            break;
+        }
+
+        case dc_dvt(DCPairPtr):
+        {
+            DCPair* pair = dc_dv_as(*dv, DCPairPtr);
+
+            __dc_res = __dc_bw_put_u8(bw, __DC_BIN_PAIR);
+            if (dc_is_ok()) __dc_res = dc_bw_write(bw, &pair->first);
+            if (dc_is_ok()) __dc_res = dc_bw_write(bw, &pair->second);
+            break;
+        }
+
+        // Extra types are written as the built-in values they're converted to
+        default:
+        {
+            DCRes encoded = dc_dv_vtable(dv->type)->to_bin_fn(dv);
+            if (dc_is_err2(encoded))
+            {
+                dc_err_cpy(encoded);
+                break;
+            }
+
+            __dc_res = __dc_bw_put_tagged_varint(bw, __DC_BIN_EXTRA, (u64)(dv->type - DC_DV_LAST_BUILTIN - 1));
+            if (dc_is_ok()) __dc_res = dc_bw_write(bw, &dc_unwrap2(encoded));
+
+            dc_dv_free(&dc_unwrap2(encoded), NULL);
+            break;
+        }
+    };
+
+    bw->depth--;
+
+    dc_ret();
+}
+
+DCResVoid dc_bw_write(DCBinWriter* bw, DCDynVal* dv)
+{
+    DC_RES_void();
+
+    if (!bw || !dv)
+    {
+        dc_dbg_log("got NULL DCBinWriter or dynamic value");
+
+        dc_ret_e(1, "got NULL DCBinWriter or dynamic value");
+    }
+
+    switch (dv->type)
+    {
+        case dc_dvt(b1):
+            return __dc_bw_put_u8(bw, dc_dv_as(*dv, b1) ? __DC_BIN_TRUE : __DC_BIN_FALSE);
+
+        case dc_dvt(i8):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_I8, __dc_bin_zigzag((i64)dc_dv_as(*dv, i8)));
+
+        case dc_dvt(i16):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_I16, __dc_bin_zigzag((i64)dc_dv_as(*dv, i16)));
+
+        case dc_dvt(i32):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_I32, __dc_bin_zigzag((i64)dc_dv_as(*dv, i32)));
+
+        case dc_dvt(i64):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_I64, __dc_bin_zigzag(dc_dv_as(*dv, i64)));
+
+        case dc_dvt(u8):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_U8, dc_dv_as(*dv, u8));
+
+        case dc_dvt(u16):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_U16, dc_dv_as(*dv, u16));
+
+        case dc_dvt(u32):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_U32, dc_dv_as(*dv, u32));
+
+        case dc_dvt(u64):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_U64, dc_dv_as(*dv, u64));
+
+        case dc_dvt(f32):
+        {
+            u32 bits;
+            memcpy(&bits, &dc_dv_as(*dv, f32), sizeof(bits));
+
+            dc_try_fail(__dc_bw_put_u8(bw, __DC_BIN_F32));
+            return __dc_bw_put_fixed(bw, bits, sizeof(bits));
+        }
+
+        case dc_dvt(f64):
+        {
+            u64 bits;
+            memcpy(&bits, &dc_dv_as(*dv, f64), sizeof(bits));
+
+            dc_try_fail(__dc_bw_put_u8(bw, __DC_BIN_F64));
+            return __dc_bw_put_fixed(bw, bits, sizeof(bits));
+        }
+
+        case dc_dvt(uptr):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_UPTR, dc_dv_as(*dv, uptr));
+
+        case dc_dvt(char):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_CHAR, __dc_bin_zigzag((i64)dc_dv_as(*dv, char)));
+
+        case dc_dvt(size):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_SIZE, __dc_bin_zigzag((i64)dc_dv_as(*dv, size)));
+
+        case dc_dvt(usize):
+            return __dc_bw_put_tagged_varint(bw, __DC_BIN_USIZE, dc_dv_as(*dv, usize));
+
+        case dc_dvt(string):
+            if (dc_dv_as(*dv, string) == NULL) return __dc_bw_put_null(bw, __DC_BIN_STRING);
+
+            return __dc_bw_put_str(bw, __DC_BIN_STRING, dc_dv_as(*dv, string), strlen(dc_dv_as(*dv, string)), true);
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCStringView_box == NULL) return __dc_bw_put_str(bw, __DC_BIN_SV, "", 0, false);
+#endif
+            DCStringView sv = dc_dv_as(*dv, DCStringView);
+
+            return __dc_bw_put_str(bw, __DC_BIN_SV, sv.str, sv.len, false);
+        }
+
+        case dc_dvt(DCInlineStr):
+        {
+            dc_try_or_fail_with3(DCResUsize, len_res, dc_dv_istr_len(dv), {});
+
+            return __dc_bw_put_str(bw, __DC_BIN_ISTR, dc_dv_istr_str(*dv), dc_unwrap2(len_res), true);
+        }
+
+        case dc_dvt(DCSymbolPtr):
+            if (dc_dv_as(*dv, DCSymbolPtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_SYMBOL);
+
+            return __dc_bw_put_str(bw, __DC_BIN_SYMBOL, dc_dv_symbol_str(*dv), dc_dv_as(*dv, DCSymbolPtr)->len, true);
+
+        // Pointed values and views are written as what they refer to
+        case dc_dvt(DCDynValPtr):
+            if (dc_dv_as(*dv, DCDynValPtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_DVPTR);
+
+            return __dc_bw_write_nested(bw, dv);
+
+        // Shared containers are written as the container itself
+        case dc_dvt(DCRcPtr):
+        {
+            if (dc_dv_as(*dv, DCRcPtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_DVPTR);
+
+            DCDynVal shared = dc_rc_dv(dc_dv_as(*dv, DCRcPtr));
+            return dc_bw_write(bw, &shared);
+        }
+
+        case dc_dvt(DCDynArrView):
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCDynArrView_box == NULL) return __dc_bw_put_tagged_varint(bw, __DC_BIN_ARRAY, 0);
+#endif
+            return __dc_bw_write_nested(bw, dv);
+
+        case dc_dvt(DCDynArrPtr):
+            if (dc_dv_as(*dv, DCDynArrPtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_ARRAY);
+
+            return __dc_bw_write_nested(bw, dv);
+
+        case dc_dvt(DCHashTablePtr):
+            if (dc_dv_as(*dv, DCHashTablePtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_TABLE);
+
+            return __dc_bw_write_nested(bw, dv);
+
+        case dc_dvt(DCPairPtr):
+            if (dc_dv_as(*dv, DCPairPtr) == NULL) return __dc_bw_put_null(bw, __DC_BIN_PAIR);
+
+            return __dc_bw_write_nested(bw, dv);
+
+        // Addresses and open files mean nothing outside of this process
+        default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+            if (vtable && vtable->to_bin_fn) return __dc_bw_write_nested(bw, dv);
+
+            dc_dbg_log("cannot serialize dynamic value of type '%d'", dv->type);
+
+            dc_ret_e(3, "cannot serialize this type of dynamic value");
+        }
+    };
+}
+
+// ***************************************************************************************
+// * READER
+// ***************************************************************************************
+
+DCResVoid dc_br_init(DCBinReader* br, u8* data, usize len, DCArena* arena, b1 zero_copy)
+{
+    DC_RES_void();
+
+    if (!br || (!data && len > 0))
+    {
+        dc_dbg_log("got NULL DCBinReader or data");
+
+        dc_ret_e(1, "got NULL DCBinReader or data");
+    }
+
+    br->data = data;
+    br->len = len;
+    br->pos = 0;
+
+    br->arena = arena;
+    br->zero_copy = zero_copy;
+
+    br->hash_fn = NULL;
+    br->key_cmp_fn = NULL;
+
+    br->pool = NULL;
+
+    br->depth = 0;
+
+    dc_ret();
+}
+
+/**
+ * Takes the next `count` bytes of the input
+ */
+static DCResVoidptr __dc_br_take(DCBinReader* br, usize count)
+{
+    DC_RES_voidptr();
+
+    if (count > br->len - br->pos)
+    {
+        dc_dbg_log("unexpected end of binary data");
+
+        dc_ret_e(4, "unexpected end of binary data");
+    }
+
+    u8* bytes = &br->data[br->pos];
+    br->pos += count;
+
+    dc_ret_ok(bytes);
+}
+
+static DCResU8 __dc_br_u8(DCBinReader* br)
+{
+    DC_RES_u8();
+
+    dc_try_or_fail_with3(DCResVoidptr, byte, __dc_br_take(br, 1), {});
+
+    dc_ret_ok(*(u8*)dc_unwrap2(byte));
+}
+
+static DCResU64 __dc_br_varint(DCBinReader* br)
+{
+    DC_RES_u64();
+
+    u64 value = 0;
+
+    for (u32 shift = 0; shift < 64; shift += 7)
+    {
+        dc_try_or_fail_with3(DCResU8, byte, __dc_br_u8(br), {});
+
+        value |= (u64)(dc_unwrap2(byte) & 0x7f) << shift;
+
+        if ((dc_unwrap2(byte) & 0x80) == 0) dc_ret_ok(value);
+    }
+
+    dc_dbg_log("malformed varint in binary data");
+
+    dc_ret_e(3, "malformed varint in binary data");
+}
+
+static DCResU64 __dc_br_fixed(DCBinReader* br, usize count)
+{
+    DC_RES_u64();
+
+    dc_try_or_fail_with3(DCResVoidptr, bytes_res, __dc_br_take(br, count), {});
+
+    u8* bytes = (u8*)dc_unwrap2(bytes_res);
+    u64 bits = 0;
+
+    for (usize i = 0; i < count; ++i) bits |= (u64)bytes[i] << (i * 8);
+
+    dc_ret_ok(bits);
+}
+
+/**
+ * Reads a count of elements that still fit in the rest of the input (every
+ * element takes at least `min_size` bytes)
+ */
+static DCResUsize __dc_br_count(DCBinReader* br, usize min_size)
+{
+    DC_RES_usize();
+
+    dc_try_or_fail_with3(DCResU64, count, __dc_br_varint(br), {});
+
+    if (dc_unwrap2(count) > (br->len - br->pos) / min_size)
+    {
+        dc_dbg_log("unexpected end of binary data");
+
+        dc_ret_e(4, "unexpected end of binary data");
+    }
+
+    dc_ret_ok((usize)dc_unwrap2(count));
+}
+
+/**
+ * Allocates `size` bytes from the arena of the reader or the heap
+ */
+static DCResVoidptr __dc_br_alloc(DCBinReader* br, usize size)
+{
+    DC_RES_voidptr();
+
+    if (br->arena) return dc_arena_alloc(br->arena, size);
+
+    voidptr memory = malloc(size);
+    if (memory == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    dc_ret_ok(memory);
+}
+
+/**
+ * Reads the length and the bytes of a string like value, the bytes are still
+ * in the input buffer
+ */
+static DCResString __dc_br_str_bytes(DCBinReader* br, usize* out_len, b1 terminated)
+{
+    DC_RES_string();
+
+    dc_try_or_fail_with3(DCResUsize, len, __dc_br_count(br, 1), {});
+
+    dc_try_or_fail_with3(DCResVoidptr, bytes, __dc_br_take(br, dc_unwrap2(len) + terminated), {});
+
+    string str = (string)dc_unwrap2(bytes);
+
+    if (terminated && str[dc_unwrap2(len)] != '\0')
+    {
+        dc_dbg_log("malformed string in binary data");
+
+        dc_ret_e(3, "malformed string in binary data");
+    }
+
+    *out_len = dc_unwrap2(len);
+
+    dc_ret_ok(str);
+}
+
+static DCRes __dc_br_string(DCBinReader* br)
+{
+    DC_RES();
+
+    usize len;
+    dc_try_or_fail_with3(DCResString, str, __dc_br_str_bytes(br, &len, true), {});
+
+    if (br->zero_copy) dc_ret_ok(dc_dv(string, dc_unwrap2(str)));
+
+    dc_try_or_fail_with3(DCResVoidptr, copy, __dc_br_alloc(br, len + 1), {});
+
+    memcpy(dc_unwrap2(copy), dc_unwrap2(str), len + 1);
+
+    if (br->arena) dc_ret_ok(dc_dv(string, (string)dc_unwrap2(copy)));
+
+    dc_ret_ok(dc_dva(string, (string)dc_unwrap2(copy)));
+}
+
+/**
+ * Frees the heap memory values of a reader keep even with an arena (long inline
+ * strings and boxes of compact values) when the arena is freed
+ */
+static DCResVoid __dc_br_free_mem(voidptr memory)
+{
+    DC_RES_void();
+
+    free(memory);
+
+    dc_ret();
+}
+
+static DCRes __dc_br_sv(DCBinReader* br)
+{
+    DC_RES();
+
+    usize len;
+    dc_try_or_fail_with3(DCResString, str, __dc_br_str_bytes(br, &len, false), {});
+
+    string text = dc_unwrap2(str);
+
+    // Views can't own their text, without an arena they view the input
+    if (br->arena && !br->zero_copy)
+    {
+        dc_try_or_fail_with3(DCResVoidptr, copy, dc_arena_memdup(br->arena, text, len), {});
+
+        text = (string)dc_unwrap2(copy);
+    }
+
+#ifdef DC_DV_COMPACT
+    dc_try_or_fail_with3(DCRes, boxed, dc_dv_box_sv(dc_sv(text, 0, len)), {});
+
+    // With an arena the box is released along with the rest of the values
+    if (br->arena)
+    {
+        dc_try_or_fail_with3(DCResVoid, defer_res, dc_arena_defer(br->arena, dc_unwrap2(boxed).value.DCStringView_box, __dc_br_free_mem),
+                             dc_dv_free(&dc_unwrap2(boxed), NULL));
+
+        dc_unwrap2(boxed).allocated = false;
+    }
+
+    return boxed;
+#else
+    dc_ret_ok(dc_dv(DCStringView, dc_sv(text, 0, len)));
+#endif
+}
+
+/**
+ * Interns the text of a symbol in the pool of the reader, without one it's read
+ * as a string
+ */
+static DCRes __dc_br_symbol(DCBinReader* br)
+{
+    DC_RES();
+
+    if (!br->pool) return __dc_br_string(br);
+
+    usize len;
+    dc_try_or_fail_with3(DCResString, str, __dc_br_str_bytes(br, &len, true), {});
+
+    dc_try_or_fail_with3(DCResSymbol, symbol, dc_intern2(br->pool, dc_unwrap2(str), len), {});
+
+    dc_ret_ok(dc_dv(DCSymbolPtr, dc_unwrap2(symbol)));
+}
+
+static DCRes __dc_br_istr(DCBinReader* br)
+{
+    DC_RES();
+
+    usize len;
+    dc_try_or_fail_with3(DCResString, str, __dc_br_str_bytes(br, &len, true), {});
+
+    dc_try_or_fail_with3(DCRes, istr, dc_dv_istr2(dc_unwrap2(str), len), {});
+
+    // Long inline strings live on the heap even with an arena, which then
+    // releases them
+    if (br->arena && dc_unwrap2(istr).istr_heap)
+    {
+        dc_try_or_fail_with3(DCResVoid, defer_res, dc_arena_defer(br->arena, dc_dv_as(dc_unwrap2(istr), DCInlineStr).heap, __dc_br_free_mem),
+                             dc_dv_free(&dc_unwrap2(istr), NULL));
+
+        dc_unwrap2(istr).allocated = false;
+    }
+
+    return istr;
+}
+
+/**
+ * Releases a value that was read before failing, values in an arena are left
+ * for the arena
+ */
+static void __dc_br_discard(DCBinReader* br, DCDynVal* dv)
+{
+    if (br->arena) return;
+
+    dc_dv_free(dv, NULL);
+}
+
+/**
+ * Frees keys and values of hash tables read without an arena
+ */
+static DC_HT_PAIR_FREE_FN_DECL(__dc_br_pair_free)
+{
+    DC_RES_void();
+
+    dc_try_fail(dc_dv_free(&_pair->first, NULL));
+    dc_try_fail(dc_dv_free(&_pair->second, NULL));
+
+    dc_ret();
+}
+
+static DCRes __dc_br_value(DCBinReader* br);
+
+static DCRes __dc_br_array(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResUsize, count_res, __dc_br_count(br, 1), {});
+    usize count = dc_unwrap2(count_res);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, __dc_br_alloc(br, sizeof(DCDynArr)), {});
+    DCDynArr* darr = (DCDynArr*)dc_unwrap2(memory);
+
+    DCResVoid init_res = br->arena ? dc_da_init_arena(darr, br->arena, count, NULL)
+                                   : dc_da_init2(darr, count > 0 ? count : 1, DC_DA_CAP_MULTIPLIER, NULL);
+
+    if (dc_is_err2(init_res))
+    {
+        if (!br->arena) free(darr);
+
+        dc_err_cpy(init_res);
+        dc_ret();
+    }
+
+    DCDynVal result = br->arena ? dc_dv(DCDynArrPtr, darr) : dc_dva(DCDynArrPtr, darr);
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCRes, element, __dc_br_value(br), __dc_br_discard(br, &result));
+
+        DCResVoid push_res = dc_da_push(darr, dc_unwrap2(element));
+        if (dc_is_err2(push_res))
+        {
+            __dc_br_discard(br, &dc_unwrap2(element));
+            __dc_br_discard(br, &result);
+
+            dc_err_cpy(push_res);
+            dc_ret();
+        }
+    }
+
+    dc_ret_ok(result);
+}
+
+static DCRes __dc_br_table(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResUsize, count_res, __dc_br_count(br, 2), {});
+    usize count = dc_unwrap2(count_res);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, __dc_br_alloc(br, sizeof(DCHashTable)), {});
+    DCHashTable* ht = (DCHashTable*)dc_unwrap2(memory);
+
+    DCResVoid init_res =
+        dc_ht_init(ht, count > 0 ? count : 1, br->hash_fn, br->key_cmp_fn, br->arena ? NULL : __dc_br_pair_free);
+
+    // Buckets are managed by the hash table itself, with an arena they're freed along with it
+    if (dc_is_ok2(init_res) && br->arena)
+    {
+        init_res = dc_arena_defer(br->arena, ht, __dc_ht_free);
+        if (dc_is_err2(init_res)) dc_ht_free(ht);
+    }
+
+    if (dc_is_err2(init_res))
+    {
+        if (!br->arena) free(ht);
+
+        dc_err_cpy(init_res);
+        dc_ret();
+    }
+
+    DCDynVal result = br->arena ? dc_dv(DCHashTablePtr, ht) : dc_dva(DCHashTablePtr, ht);
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCRes, key, __dc_br_value(br), __dc_br_discard(br, &result));
+        dc_try_or_fail_with3(DCRes, value, __dc_br_value(br), {
+            __dc_br_discard(br, &dc_unwrap2(key));
+            __dc_br_discard(br, &result);
+        });
+
+        DCResVoid set_res = dc_ht_set(ht, dc_unwrap2(key), dc_unwrap2(value), DC_HT_SET_CREATE_OR_FAIL);
+        if (dc_is_err2(set_res))
+        {
+            __dc_br_discard(br, &dc_unwrap2(key));
+            __dc_br_discard(br, &dc_unwrap2(value));
+            __dc_br_discard(br, &result);
+
+            dc_err_cpy(set_res);
+            dc_ret();
+        }
+    }
+
+    dc_ret_ok(result);
+}
+
+static DCRes __dc_br_pair(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCRes, first, __dc_br_value(br), {});
+    dc_try_or_fail_with3(DCRes, second, __dc_br_value(br), __dc_br_discard(br, &dc_unwrap2(first)));
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, __dc_br_alloc(br, sizeof(DCPair)), {
+        __dc_br_discard(br, &dc_unwrap2(first));
+        __dc_br_discard(br, &dc_unwrap2(second));
+    });
+
+    DCPair* pair = (DCPair*)dc_unwrap2(memory);
+    pair->first = dc_unwrap2(first);
+    pair->second = dc_unwrap2(second);
+
+    if (br->arena) dc_ret_ok(dc_dv(DCPairPtr, pair));
+
+    dc_ret_ok(dc_dva(DCPairPtr, pair));
+}
+
+static DCRes __dc_br_null(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResU8, tag, __dc_br_u8(br), {});
+
+    switch (dc_unwrap2(tag))
+    {
+        case __DC_BIN_STRING:
+            dc_ret_ok(dc_dv(string, NULL));
+
+        case __DC_BIN_DVPTR:
+            dc_ret_ok(dc_dv(DCDynValPtr, NULL));
+
+        case __DC_BIN_ARRAY:
+            dc_ret_ok(dc_dv(DCDynArrPtr, NULL));
+
+        case __DC_BIN_TABLE:
+            dc_ret_ok(dc_dv(DCHashTablePtr, NULL));
+
+        case __DC_BIN_PAIR:
+            dc_ret_ok(dc_dv(DCPairPtr, NULL));
+
+        case __DC_BIN_SYMBOL:
+            if (br->pool) dc_ret_ok(dc_dv(DCSymbolPtr, NULL));
+
+            dc_ret_ok(dc_dv(string, NULL));
+
+        default:
+            dc_dbg_log("unknown null tag '%d' in binary data", dc_unwrap2(tag));
+
+            dc_ret_e(3, "unknown tag in binary data");
+    }
+}
+
+/**
+ * Reads a nested value keeping track of the depth
+ */
+static DCRes __dc_br_nested(DCBinReader* br, DCRes (*read_fn)(DCBinReader*))
+{
+    DC_RES();
+
+    if (br->depth >= DC_BIN_MAX_DEPTH)
+    {
+        dc_dbg_log("binary data is nested too deep");
+
+        dc_ret_e(4, "binary data is nested too deep");
+    }
+
+    br->depth++;
+    __dc_res = read_fn(br);
+    br->depth--;
+
+    dc_ret();
+}
+
+/**
+ * Reads the built-in values an extra type was converted to and converts them
+ * back with the registered vtable
+ */
+static DCRes __dc_br_extra(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResU64, index, __dc_br_varint(br), {});
+
+    const DCDvVTable* vtable = NULL;
+    if (dc_unwrap2(index) < DC_DV_MAX_EXTRA_TYPES)
+        vtable = dc_dv_vtable((DCDynValType)(DC_DV_LAST_BUILTIN + 1 + dc_unwrap2(index)));
+
+    if (!vtable || !vtable->from_bin_fn)
+    {
+        dc_dbg_log("extra type '%" PRIu64 "' in binary data is not registered", dc_unwrap2(index));
+
+        dc_ret_e(3, "extra type in binary data is not registered");
+    }
+
+    dc_try_or_fail_with3(DCRes, encoded, __dc_br_value(br), {});
+
+    __dc_res = vtable->from_bin_fn(&dc_unwrap2(encoded));
+
+    __dc_br_discard(br, &dc_unwrap2(encoded));
+
+    dc_ret();
+}
+
+static DCRes __dc_br_value(DCBinReader* br)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResU8, tag_res, __dc_br_u8(br), {});
+    u8 tag = dc_unwrap2(tag_res);
+
+    if (tag == __DC_BIN_FALSE || tag == __DC_BIN_TRUE) dc_ret_ok(dc_dv(b1, tag == __DC_BIN_TRUE));
+
+    if (tag == __DC_BIN_F32)
+    {
+        dc_try_or_fail_with3(DCResU64, bits, __dc_br_fixed(br, sizeof(u32)), {});
+
+        u32 bits32 = (u32)dc_unwrap2(bits);
+        f32 value;
+        memcpy(&value, &bits32, sizeof(value));
+
+        dc_ret_ok(dc_dv(f32, value));
+    }
+
+    if (tag == __DC_BIN_F64)
+    {
+        dc_try_or_fail_with3(DCResU64, bits, __dc_br_fixed(br, sizeof(u64)), {});
+
+        f64 value;
+        memcpy(&value, &dc_unwrap2(bits), sizeof(value));
+
+        dc_ret_ok(dc_dv(f64, value));
+    }
+
+    switch (tag)
+    {
+        case __DC_BIN_NULL:
+            return __dc_br_null(br);
+
+        case __DC_BIN_STRING:
+            return __dc_br_string(br);
+
+        case __DC_BIN_SV:
+            return __dc_br_sv(br);
+
+        case __DC_BIN_ISTR:
+            return __dc_br_istr(br);
+
+        case __DC_BIN_SYMBOL:
+            return __dc_br_symbol(br);
+
+        case __DC_BIN_ARRAY:
+            return __dc_br_nested(br, __dc_br_array);
+
+        case __DC_BIN_TABLE:
+            return __dc_br_nested(br, __dc_br_table);
+
+        case __DC_BIN_PAIR:
+            return __dc_br_nested(br, __dc_br_pair);
+
+        case __DC_BIN_EXTRA:
+            return __dc_br_nested(br, __dc_br_extra);
+
+        default:
+            break;
+    }
+
+    // What's left are integers
+    dc_try_or_fail_with3(DCResU64, varint, __dc_br_varint(br), {});
+    u64 value = dc_unwrap2(varint);
+
+    switch (tag)
+    {
+        case __DC_BIN_I8:
+            dc_ret_ok(dc_dv(i8, (i8)__dc_bin_unzigzag(value)));
+
+        case __DC_BIN_I16:
+            dc_ret_ok(dc_dv(i16, (i16)__dc_bin_unzigzag(value)));
+
+        case __DC_BIN_I32:
+            dc_ret_ok(dc_dv(i32, (i32)__dc_bin_unzigzag(value)));
+
+        case __DC_BIN_I64:
+            dc_ret_ok(dc_dv(i64, __dc_bin_unzigzag(value)));
+
+        case __DC_BIN_U8:
+            dc_ret_ok(dc_dv(u8, (u8)value));
+
+        case __DC_BIN_U16:
+            dc_ret_ok(dc_dv(u16, (u16)value));
+
+        case __DC_BIN_U32:
+            dc_ret_ok(dc_dv(u32, (u32)value));
+
+        case __DC_BIN_U64:
+            dc_ret_ok(dc_dv(u64, value));
+
+        case __DC_BIN_UPTR:
+            dc_ret_ok(dc_dv(uptr, (uptr)value));
+
+        case __DC_BIN_CHAR:
+            dc_ret_ok(dc_dv(char, (char)__dc_bin_unzigzag(value)));
+
+        case __DC_BIN_SIZE:
+            dc_ret_ok(dc_dv(size, (size)__dc_bin_unzigzag(value)));
+
+        case __DC_BIN_USIZE:
+            dc_ret_ok(dc_dv(usize, (usize)value));
+
+        default:
+            dc_dbg_log("unknown tag '%d' in binary data", tag);
+
+            dc_ret_e(3, "unknown tag in binary data");
+    }
+}
+
+DCRes dc_br_read(DCBinReader* br)
+{
+    DC_RES();
+
+    if (!br)
+    {
+        dc_dbg_log("got NULL DCBinReader");
+
+        dc_ret_e(1, "got NULL DCBinReader");
+    }
+
+    br->depth = 0;
+
+    return __dc_br_value(br);
+}
+
+#undef __dc_bin_zigzag
+#undef __dc_bin_unzigzag
@@ -0,0 +1,724 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _btree.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for ordered map (B+tree)
+// *               functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_btree.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#if DC_BT_ORDER < 4
+#error "DC_BT_ORDER must be at least 4"
+#endif
+
+static DCResVoidptr __dc_bt_new_node(b1 leaf)
+{
+    DC_RES_voidptr();
+
+    DCBTreeNode* node = (DCBTreeNode*)malloc(sizeof(DCBTreeNode));
+    if (node == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    node->count = 0;
+    node->leaf = leaf;
+    node->next = NULL;
+
+    dc_ret_ok(node);
+}
+
+/**
+ * Frees the node and everything below it, keys and values of the leaves are
+ * only released when `release` is true
+ */
+static DCResVoid __dc_bt_free_node(DCBTree* bt, DCBTreeNode* node, b1 release)
+{
+    DC_RES_void();
+
+    if (node->leaf)
+    {
+        for (usize i = 0; release && i < node->count; ++i)
+        {
+            dc_try_fail(dc_dv_free(&node->keys[i], bt->element_free_fn));
+            dc_try_fail(dc_dv_free(&node->slots.values[i], bt->element_free_fn));
+        }
+    }
+    else
+    {
+        for (usize i = 0; i <= node->count; ++i) dc_try_fail(__dc_bt_free_node(bt, node->slots.children[i], release));
+    }
+
+    free(node);
+
+    dc_ret();
+}
+
+/**
+ * Binary search of the key in the given node, returns the first position whose
+ * key is not less than (or with `upper` greater than) the given key
+ */
+static DCResUsize __dc_bt_bound(DCBTree* bt, DCBTreeNode* node, DCDynVal* key, b1 upper, b1* out_equal)
+{
+    DC_RES_usize();
+
+    if (out_equal) *out_equal = false;
+
+    usize lo = 0;
+    usize hi = node->count;
+
+    while (lo < hi)
+    {
+        usize mid = lo + (hi - lo) / 2;
+
+        dc_try_or_fail_with3(DCResI32, cmp_res, bt->cmp_fn(&node->keys[mid], key), {});
+        i32 cmp = dc_unwrap2(cmp_res);
+
+        if (cmp < 0 || (upper && cmp == 0))
+        {
+            lo = mid + 1;
+        }
+        else
+        {
+            if (cmp == 0 && out_equal) *out_equal = true;
+            hi = mid;
+        }
+    }
+
+    dc_ret_ok(lo);
+}
+
+/**
+ * Moves the upper half of the full child at index `i` to a new sibling, the
+ * parent must not be full
+ */
+static DCResVoid __dc_bt_split_child(DCBTreeNode* parent, usize i)
+{
+    DC_RES_void();
+
+    DCBTreeNode* child = parent->slots.children[i];
+
+    dc_try_or_fail_with3(DCResVoidptr, right_res, __dc_bt_new_node(child->leaf), {});
+    DCBTreeNode* right = (DCBTreeNode*)dc_unwrap2(right_res);
+
+    usize mid = DC_BT_ORDER / 2;
+    DCDynVal separator;
+
+    if (child->leaf)
+    {
+        right->count = DC_BT_ORDER - mid;
+        memcpy(right->keys, &child->keys[mid], right->count * sizeof(DCDynVal));
+        memcpy(right->slots.values, &child->slots.values[mid], right->count * sizeof(DCDynVal));
+
+        right->next = child->next;
+        child->next = right;
+
+        separator = right->keys[0];
+    }
+    else
+    {
+        // The middle key moves up
+        right->count = DC_BT_ORDER - mid - 1;
+        memcpy(right->keys, &child->keys[mid + 1], right->count * sizeof(DCDynVal));
+        memcpy(right->slots.children, &child->slots.children[mid + 1], (right->count + 1) * sizeof(DCBTreeNode*));
+
+        separator = child->keys[mid];
+    }
+
+    child->count = mid;
+
+    memmove(&parent->keys[i + 1], &parent->keys[i], (parent->count - i) * sizeof(DCDynVal));
+    memmove(&parent->slots.children[i + 2], &parent->slots.children[i + 1], (parent->count - i) * sizeof(DCBTreeNode*));
+
+    parent->keys[i] = separator;
+    parent->slots.children[i + 1] = right;
+    parent->count++;
+
+    dc_ret();
+}
+
+/**
+ * Moves the last entry of the left sibling to the front of the child at index
+ * `i`
+ */
+static void __dc_bt_borrow_left(DCBTreeNode* parent, usize i)
+{
+    DCBTreeNode* child = parent->slots.children[i];
+    DCBTreeNode* left = parent->slots.children[i - 1];
+
+    memmove(&child->keys[1], child->keys, child->count * sizeof(DCDynVal));
+
+    if (child->leaf)
+    {
+        memmove(&child->slots.values[1], child->slots.values, child->count * sizeof(DCDynVal));
+
+        child->keys[0] = left->keys[left->count - 1];
+        child->slots.values[0] = left->slots.values[left->count - 1];
+
+        parent->keys[i - 1] = child->keys[0];
+    }
+    else
+    {
+        memmove(&child->slots.children[1], child->slots.children, (child->count + 1) * sizeof(DCBTreeNode*));
+
+        child->keys[0] = parent->keys[i - 1];
+        child->slots.children[0] = left->slots.children[left->count];
+
+        parent->keys[i - 1] = left->keys[left->count - 1];
+    }
+
+    left->count--;
+    child->count++;
+}
+
+/**
+ * Moves the first entry of the right sibling to the end of the child at index
+ * `i`
+ */
+static void __dc_bt_borrow_right(DCBTreeNode* parent, usize i)
+{
+    DCBTreeNode* child = parent->slots.children[i];
+    DCBTreeNode* right = parent->slots.children[i + 1];
+
+    if (child->leaf)
+    {
+        child->keys[child->count] = right->keys[0];
+        child->slots.values[child->count] = right->slots.values[0];
+
+        memmove(right->slots.values, &right->slots.values[1], (right->count - 1) * sizeof(DCDynVal));
+        memmove(right->keys, &right->keys[1], (right->count - 1) * sizeof(DCDynVal));
+
+        parent->keys[i] = right->keys[0];
+    }
+    else
+    {
+        child->keys[child->count] = parent->keys[i];
+        child->slots.children[child->count + 1] = right->slots.children[0];
+
+        parent->keys[i] = right->keys[0];
+
+        memmove(right->keys, &right->keys[1], (right->count - 1) * sizeof(DCDynVal));
+        memmove(right->slots.children, &right->slots.children[1], right->count * sizeof(DCBTreeNode*));
+    }
+
+    right->count--;
+    child->count++;
+}
+
+/**
+ * Merges the child at index `i + 1` into the child at index `i`
+ */
+static void __dc_bt_merge(DCBTreeNode* parent, usize i)
+{
+    DCBTreeNode* left = parent->slots.children[i];
+    DCBTreeNode* right = parent->slots.children[i + 1];
+
+    if (left->leaf)
+    {
+        memcpy(&left->keys[left->count], right->keys, right->count * sizeof(DCDynVal));
+        memcpy(&left->slots.values[left->count], right->slots.values, right->count * sizeof(DCDynVal));
+
+        left->count += right->count;
+        left->next = right->next;
+    }
+    else
+    {
+        left->keys[left->count] = parent->keys[i];
+
+        memcpy(&left->keys[left->count + 1], right->keys, right->count * sizeof(DCDynVal));
+        memcpy(&left->slots.children[left->count + 1], right->slots.children, (right->count + 1) * sizeof(DCBTreeNode*));
+
+        left->count += right->count + 1;
+    }
+
+    free(right);
+
+    memmove(&parent->keys[i], &parent->keys[i + 1], (parent->count - i - 1) * sizeof(DCDynVal));
+    memmove(&parent->slots.children[i + 1], &parent->slots.children[i + 2], (parent->count - i - 1) * sizeof(DCBTreeNode*));
+
+    parent->count--;
+}
+
+/**
+ * Makes sure the child at index `i` has more than the minimum number of keys
+ * so one can be deleted from it, returns the index of the child that now
+ * covers the same keys
+ */
+static usize __dc_bt_fill_child(DCBTreeNode* parent, usize i)
+{
+    if (parent->slots.children[i]->count > DC_BT_MIN_KEYS) return i;
+
+    if (i > 0 && parent->slots.children[i - 1]->count > DC_BT_MIN_KEYS)
+    {
+        __dc_bt_borrow_left(parent, i);
+        return i;
+    }
+
+    if (i < parent->count && parent->slots.children[i + 1]->count > DC_BT_MIN_KEYS)
+    {
+        __dc_bt_borrow_right(parent, i);
+        return i;
+    }
+
+    if (i > 0)
+    {
+        __dc_bt_merge(parent, i - 1);
+        return i - 1;
+    }
+
+    __dc_bt_merge(parent, i);
+    return i;
+}
+
+DCResVoid dc_bt_init(DCBTree* bt, DCDvCmpFn cmp_fn, DCDynValFreeFn element_free_fn)
+{
+    DC_RES_void();
+
+    if (!bt)
+    {
+        dc_dbg_log("got NULL DCBTree");
+
+        dc_ret_e(1, "got NULL DCBTree");
+    }
+
+    bt->root = NULL;
+    bt->count = 0;
+
+    bt->cmp_fn = cmp_fn ? cmp_fn : dc_dv_cmp;
+    bt->element_free_fn = element_free_fn;
+
+    dc_ret();
+}
+
+DCResVoid dc_bt_free(DCBTree* bt)
+{
+    DC_RES_void();
+
+    if (!bt)
+    {
+        dc_dbg_log("got NULL DCBTree");
+
+        dc_ret_e(1, "got NULL DCBTree");
+    }
+
+    if (bt->root) dc_try_fail(__dc_bt_free_node(bt, bt->root, true));
+
+    bt->root = NULL;
+    bt->count = 0;
+
+    dc_ret();
+}
+
+DCResVoid __dc_bt_free(voidptr bt)
+{
+    return dc_bt_free((DCBTree*)bt);
+}
+
+DCResVoid dc_bt_find(DCBTree* bt, DCDynVal key, DCDynVal** out_value)
+{
+    DC_RES_void();
+
+    if (!bt || !out_value)
+    {
+        dc_dbg_log("got NULL DCBTree or output");
+
+        dc_ret_e(1, "got NULL DCBTree or output");
+    }
+
+    *out_value = NULL;
+
+    DCBTreeNode* node = bt->root;
+    if (!node) dc_ret();
+
+    while (!node->leaf)
+    {
+        dc_try_or_fail_with3(DCResUsize, child, __dc_bt_bound(bt, node, &key, true, NULL), {});
+        node = node->slots.children[dc_unwrap2(child)];
+    }
+
+    b1 found;
+    dc_try_or_fail_with3(DCResUsize, pos, __dc_bt_bound(bt, node, &key, false, &found), {});
+
+    if (found) *out_value = &node->slots.values[dc_unwrap2(pos)];
+
+    dc_ret();
+}
+
+DCResVoid dc_bt_set(DCBTree* bt, DCDynVal key, DCDynVal value, DCHashTableSetStatus set_status)
+{
+    DC_RES_void();
+
+    if (!bt)
+    {
+        dc_dbg_log("got NULL DCBTree");
+
+        dc_ret_e(1, "got NULL DCBTree");
+    }
+
+    if (!bt->root)
+    {
+        dc_try_or_fail_with3(DCResVoidptr, root_res, __dc_bt_new_node(true), {});
+        bt->root = (DCBTreeNode*)dc_unwrap2(root_res);
+    }
+
+    // Full nodes are split on the way down so a split never goes back up
+    if (bt->root->count == DC_BT_ORDER)
+    {
+        dc_try_or_fail_with3(DCResVoidptr, root_res, __dc_bt_new_node(false), {});
+        DCBTreeNode* root = (DCBTreeNode*)dc_unwrap2(root_res);
+
+        root->slots.children[0] = bt->root;
+
+        dc_try_or_fail_with3(DCResVoid, split_res, __dc_bt_split_child(root, 0), { free(root); });
+
+        bt->root = root;
+    }
+
+    DCBTreeNode* node = bt->root;
+    while (!node->leaf)
+    {
+        dc_try_or_fail_with3(DCResUsize, child_res, __dc_bt_bound(bt, node, &key, true, NULL), {});
+        usize i = dc_unwrap2(child_res);
+
+        if (node->slots.children[i]->count == DC_BT_ORDER)
+        {
+            dc_try_fail_temp(DCResVoid, __dc_bt_split_child(node, i));
+
+            dc_try_or_fail_with3(DCResI32, cmp_res, bt->cmp_fn(&key, &node->keys[i]), {});
+            if (dc_unwrap2(cmp_res) >= 0) ++i;
+        }
+
+        node = node->slots.children[i];
+    }
+
+    b1 found;
+    dc_try_or_fail_with3(DCResUsize, pos_res, __dc_bt_bound(bt, node, &key, false, &found), {});
+    usize pos = dc_unwrap2(pos_res);
+
+    if (found)
+    {
+        if (set_status == DC_HT_SET_CREATE_OR_FAIL)
+            dc_ret_e(dc_e_code(HT_SET), "can only create b-tree entry, provided key already exists");
+
+        if (set_status == DC_HT_SET_CREATE_OR_NOTHING) dc_ret();
+
+        // Internal nodes may refer to the stored key so it stays and the
+        // given one is released
+        dc_try_fail(dc_dv_free(&node->slots.values[pos], bt->element_free_fn));
+        node->slots.values[pos] = value;
+
+        dc_try_fail(dc_dv_free(&key, bt->element_free_fn));
+
+        dc_ret();
+    }
+
+    if (set_status == DC_HT_SET_UPDATE_OR_FAIL)
+        dc_ret_e(dc_e_code(HT_SET), "can only update existing b-tree entry, provided key not found");
+
+    if (set_status == DC_HT_SET_UPDATE_OR_NOTHING) dc_ret();
+
+    memmove(&node->keys[pos + 1], &node->keys[pos], (node->count - pos) * sizeof(DCDynVal));
+    memmove(&node->slots.values[pos + 1], &node->slots.values[pos], (node->count - pos) * sizeof(DCDynVal));
+
+    node->keys[pos] = key;
+    node->slots.values[pos] = value;
+    node->count++;
+
+    bt->count++;
+
+    dc_ret();
+}
+
+DCResBool dc_bt_delete(DCBTree* bt, DCDynVal key)
+{
+    DC_RES_bool();
+
+    if (!bt)
+    {
+        dc_dbg_log("got NULL DCBTree");
+
+        dc_ret_e(1, "got NULL DCBTree");
+    }
+
+    if (!bt->root) dc_ret_ok(false);
+
+    // The deepest separator on the way down, it holds the smallest key of the
+    // subtree the leaf is the leftmost leaf of
+    DCDynVal* separator = NULL;
+
+    DCBTreeNode* node = bt->root;
+    while (!node->leaf)
+    {
+        dc_try_or_fail_with3(DCResUsize, child_res, __dc_bt_bound(bt, node, &key, true, NULL), {});
+
+        // Nodes on the way down keep one spare key so deleting never goes back up
+        usize i = __dc_bt_fill_child(node, dc_unwrap2(child_res));
+
+        if (node == bt->root && node->count == 0)
+        {
+            bt->root = node->slots.children[0];
+            free(node);
+
+            node = bt->root;
+            continue;
+        }
+
+        if (i > 0) separator = &node->keys[i - 1];
+
+        node = node->slots.children[i];
+    }
+
+    b1 found;
+    dc_try_or_fail_with3(DCResUsize, pos_res, __dc_bt_bound(bt, node, &key, false, &found), {});
+    usize pos = dc_unwrap2(pos_res);
+
+    if (!found) dc_ret_ok(false);
+
+    DCDynVal removed_key = node->keys[pos];
+    DCDynVal removed_value = node->slots.values[pos];
+
+    memmove(&node->keys[pos], &node->keys[pos + 1], (node->count - pos - 1) * sizeof(DCDynVal));
+    memmove(&node->slots.values[pos], &node->slots.values[pos + 1], (node->count - pos - 1) * sizeof(DCDynVal));
+    node->count--;
+
+    bt->count--;
+
+    if (pos == 0 && separator) *separator = node->keys[0];
+
+    if (node == bt->root && node->count == 0)
+    {
+        free(node);
+        bt->root = NULL;
+    }
+
+    dc_try_fail_temp(DCResVoid, dc_dv_free(&removed_key, bt->element_free_fn));
+    dc_try_fail_temp(DCResVoid, dc_dv_free(&removed_value, bt->element_free_fn));
+
+    dc_ret_ok(true);
+}
+
+DCResVoid dc_bt_iter(DCBTree* bt, DCDynVal* from, DCDynVal* to, DCBTreeIter* out_it)
+{
+    DC_RES_void();
+
+    if (!bt || !out_it)
+    {
+        dc_dbg_log("got NULL DCBTree or iterator");
+
+        dc_ret_e(1, "got NULL DCBTree or iterator");
+    }
+
+    out_it->bt = bt;
+    out_it->leaf = bt->root;
+    out_it->pos = 0;
+    out_it->to = to;
+
+    if (!out_it->leaf) dc_ret();
+
+    while (!out_it->leaf->leaf)
+    {
+        usize i = 0;
+
+        if (from)
+        {
+            dc_try_or_fail_with3(DCResUsize, child_res, __dc_bt_bound(bt, out_it->leaf, from, true, NULL), {});
+            i = dc_unwrap2(child_res);
+        }
+
+        out_it->leaf = out_it->leaf->slots.children[i];
+    }
+
+    if (from)
+    {
+        dc_try_or_fail_with3(DCResUsize, pos_res, __dc_bt_bound(bt, out_it->leaf, from, false, NULL), {});
+        out_it->pos = dc_unwrap2(pos_res);
+    }
+
+    dc_ret();
+}
+
+DCResBool dc_bt_next(DCBTreeIter* it, DCDynVal** out_key, DCDynVal** out_value)
+{
+    DC_RES_bool();
+
+    if (!it)
+    {
+        dc_dbg_log("got NULL DCBTreeIter");
+
+        dc_ret_e(1, "got NULL DCBTreeIter");
+    }
+
+    while (it->leaf && it->pos >= it->leaf->count)
+    {
+        it->leaf = it->leaf->next;
+        it->pos = 0;
+    }
+
+    if (!it->leaf) dc_ret_ok(false);
+
+    DCDynVal* key = &it->leaf->keys[it->pos];
+
+    if (it->to)
+    {
+        dc_try_or_fail_with3(DCResI32, cmp_res, it->bt->cmp_fn(key, it->to), {});
+
+        if (dc_unwrap2(cmp_res) > 0)
+        {
+            it->leaf = NULL;
+            dc_ret_ok(false);
+        }
+    }
+
+    if (out_key) *out_key = key;
+    if (out_value) *out_value = &it->leaf->slots.values[it->pos];
+
+    it->pos++;
+
+    dc_ret_ok(true);
+}
+
+DCResVoid dc_bt_bulk_load(DCBTree* bt, usize count, DCPair pairs[])
+{
+    DC_RES_void();
+
+    if (!bt || (!pairs && count > 0))
+    {
+        dc_dbg_log("got NULL DCBTree or pairs");
+
+        dc_ret_e(1, "got NULL DCBTree or pairs");
+    }
+
+    if (bt->root)
+    {
+        dc_dbg_log("bulk loading needs an empty DCBTree");
+
+        dc_ret_e(1, "bulk loading needs an empty DCBTree");
+    }
+
+    for (usize i = 1; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCResI32, cmp_res, bt->cmp_fn(&pairs[i - 1].first, &pairs[i].first), {});
+
+        if (dc_unwrap2(cmp_res) >= 0)
+        {
+            dc_dbg_log("pairs are not sorted by unique keys at index: " dc_fmt(usize), i);
+
+            dc_ret_ea(1, "pairs are not sorted by unique keys at index: " dc_fmt(usize), i);
+        }
+    }
+
+    if (count == 0) dc_ret();
+
+    usize level_count = (count + DC_BT_ORDER - 1) / DC_BT_ORDER;
+
+    // Nodes of the level being built and the smallest key of each
+    DCBTreeNode** level = (DCBTreeNode**)malloc(level_count * sizeof(DCBTreeNode*));
+    DCDynVal** mins = (DCDynVal**)malloc(level_count * sizeof(DCDynVal*));
+    if (level == NULL || mins == NULL)
+    {
+        free(level);
+        free(mins);
+
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    // Leaves are filled evenly so all of them have at least the minimum keys
+    usize taken = 0;
+    for (usize i = 0; i < level_count; ++i)
+    {
+        DCResVoidptr leaf_res = __dc_bt_new_node(true);
+        if (dc_is_err2(leaf_res))
+        {
+            for (usize j = 0; j < i; ++j) free(level[j]);
+            free(level);
+            free(mins);
+
+            dc_err_cpy(leaf_res);
+            dc_ret();
+        }
+
+        DCBTreeNode* leaf = (DCBTreeNode*)dc_unwrap2(leaf_res);
+        leaf->count = count / level_count + (i < count % level_count);
+
+        for (usize j = 0; j < leaf->count; ++j)
+        {
+            leaf->keys[j] = pairs[taken + j].first;
+            leaf->slots.values[j] = pairs[taken + j].second;
+        }
+
+        taken += leaf->count;
+
+        if (i > 0) level[i - 1]->next = leaf;
+        level[i] = leaf;
+        mins[i] = &leaf->keys[0];
+    }
+
+    while (level_count > 1)
+    {
+        usize groups = (level_count + DC_BT_ORDER) / (DC_BT_ORDER + 1);
+        usize next = 0;
+
+        for (usize g = 0; g < groups; ++g)
+        {
+            usize children = level_count / groups + (g < level_count % groups);
+
+            DCResVoidptr node_res = __dc_bt_new_node(false);
+            if (dc_is_err2(node_res))
+            {
+                // Built nodes sit before `next`, the rest are not grouped yet
+                for (usize j = 0; j < g; ++j) __dc_bt_free_node(bt, level[j], false);
+                for (usize j = next; j < level_count; ++j) __dc_bt_free_node(bt, level[j], false);
+                free(level);
+                free(mins);
+
+                dc_err_cpy(node_res);
+                dc_ret();
+            }
+
+            DCBTreeNode* node = (DCBTreeNode*)dc_unwrap2(node_res);
+            node->count = children - 1;
+
+            for (usize j = 0; j < children; ++j)
+            {
+                node->slots.children[j] = level[next + j];
+                if (j > 0) node->keys[j - 1] = *mins[next + j];
+            }
+
+            level[g] = node;
+            mins[g] = mins[next];
+
+            next += children;
+        }
+
+        level_count = groups;
+    }
+
+    bt->root = level[0];
+    bt->count = count;
+
+    free(level);
+    free(mins);
+
+    dc_ret();
+}
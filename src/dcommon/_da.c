@@ -24,6 +24,22 @@
 #include "_headers/general.h"
 #include "_headers/macros.h"
 
+#if !defined(DC_WINDOWS)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#if defined(MAP_ANONYMOUS) || defined(MAP_ANON)
+#define __DC_DA_MMAP
+
+#ifndef MAP_ANONYMOUS
+#define MAP_ANONYMOUS MAP_ANON
+#endif
+
+#endif
+#endif
+
 
 DCResVoid dc_da_init(DCDynArr* darr, DCDynValFreeFn element_free_fn)
 {
@@ -42,6 +58,13 @@ DCResVoid dc_da_init(DCDynArr* darr, DCDynValFreeFn element_free_fn)
 
     darr->element_free_fn = element_free_fn;
 
+    darr->growth = DC_DA_GROW_MULTIPLIER;
+    darr->growth_factor = (f32)DC_DA_CAP_MULTIPLIER;
+
+    darr->owned_count = 0;
+
+    darr->backing = NULL;
+
     darr->elements = malloc(DC_DA_INITIAL_CAP * sizeof(DCDynVal));
     if (darr->elements == NULL)
     {
@@ -70,6 +93,13 @@ DCResVoid dc_da_init2(DCDynArr* darr, usize capacity, usize capacity_grow_multip
 
     darr->element_free_fn = element_free_fn;
 
+    darr->growth = DC_DA_GROW_MULTIPLIER;
+    darr->growth_factor = (f32)DC_DA_CAP_MULTIPLIER;
+
+    darr->owned_count = 0;
+
+    darr->backing = NULL;
+
     darr->elements = malloc(capacity * sizeof(DCDynVal));
 
     if (darr->elements == NULL)
@@ -82,6 +112,52 @@ DCResVoid dc_da_init2(DCDynArr* darr, usize capacity, usize capacity_grow_multip
     dc_ret();
 }
 
+DCResVoid dc_da_init_arena(DCDynArr* darr, DCArena* arena, usize capacity, DCDynValFreeFn element_free_fn)
+{
+    DC_RES_void();
+
+    if (!darr || !arena)
+    {
+        dc_dbg_log("got NULL DCDynArr or DCArena");
+
+        dc_ret_e(1, "got NULL DCDynArr or DCArena");
+    }
+
+    if (capacity > SIZE_MAX / sizeof(DCDynVal))
+    {
+        dc_dbg_log("requested capacity is too big");
+
+        dc_ret_e(2, "requested capacity is too big");
+    }
+
+    // Empty arrays (e.g. rows of hash tables) take nothing until they grow
+    DCDynVal* elements = NULL;
+    if (capacity > 0)
+    {
+        dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(arena, capacity * sizeof(DCDynVal)), {});
+
+        elements = (DCDynVal*)dc_unwrap2(memory);
+    }
+
+    darr->cap = capacity;
+    darr->count = 0;
+    darr->multiplier = DC_DA_CAP_MULTIPLIER;
+
+    darr->element_free_fn = element_free_fn;
+
+    darr->growth = DC_DA_GROW_MULTIPLIER;
+    darr->growth_factor = (f32)DC_DA_CAP_MULTIPLIER;
+
+    darr->owned_count = 0;
+
+    // Set up here so it stays right even if the arena was moved after its init
+    arena->da_backing = (DCDynArrBacking){DC_DA_STORAGE_ARENA, arena};
+    darr->backing = &arena->da_backing;
+    darr->elements = elements;
+
+    dc_ret();
+}
+
 
 DCResDa dc_da_new(DCDynValFreeFn element_free_fn)
 {
@@ -116,6 +192,28 @@ DCResDa dc_da_new2(usize capacity, usize capacity_grow_multiplier, DCDynValFreeF
 
     dc_ret_ok(darr);
 }
+/**
+ * Keeps `owned_count` up to date for the values that are about to be added
+ */
+static void __dc_da_track_values(DCDynArr* darr, DCDynVal* values, usize count)
+{
+    for (usize i = 0; i < count; ++i) darr->owned_count += dc_dv_is_owning(values[i]);
+}
+
+/**
+ * Frees the given element of the array keeping `owned_count` up to date,
+ * elements with nothing to release are skipped without calling `dc_dv_free`
+ */
+static DCResVoid __dc_da_free_element(DCDynArr* darr, DCDynVal* element)
+{
+    DC_RES_void();
+
+    if (!dc_dv_is_owning(*element) && darr->element_free_fn == NULL) dc_ret();
+
+    if (dc_dv_is_owning(*element) && darr->owned_count > 0) darr->owned_count--;
+
+    return dc_dv_free(element, darr->element_free_fn);
+}
 
 DCResVoid __dc_da_init_with_values(DCDynArr* darr, usize count, DCDynValFreeFn element_free_fn, DCDynVal values[])
 {
@@ -128,13 +226,20 @@ DCResVoid __dc_da_init_with_values(DCDynArr* darr, usize count, DCDynValFreeFn e
         dc_ret_e(1, "got NULL DCDynArr");
     }
 
-    darr->cap = count;
+    darr->cap = (count == 0 ? DC_DA_INITIAL_CAP : count);
     darr->count = 0;
     darr->multiplier = DC_DA_CAP_MULTIPLIER;
 
     darr->element_free_fn = element_free_fn;
 
-    darr->elements = malloc((count == 0 ? DC_DA_INITIAL_CAP : count) * sizeof(DCDynVal));
+    darr->growth = DC_DA_GROW_MULTIPLIER;
+    darr->growth_factor = (f32)DC_DA_CAP_MULTIPLIER;
+
+    darr->owned_count = 0;
+
+    darr->backing = NULL;
+
+    darr->elements = malloc(darr->cap * sizeof(DCDynVal));
     if (darr->elements == NULL)
     {
         dc_dbg_log("Memory allocation failed");
@@ -142,257 +247,1405 @@ DCResVoid __dc_da_init_with_values(DCDynArr* darr, usize count, DCDynValFreeFn e
         dc_ret_e(2, "Memory allocation failed");
     }
 
-    for (usize i = 0; i < count; ++i)
-    {
-        dc_try_fail(dc_da_push(darr, values[i]));
-    }
+    __dc_da_track_values(darr, values, count);
+
+    if (count > 0) memcpy(darr->elements, values, count * sizeof(DCDynVal));
+
+    darr->count = count;
 
     dc_ret();
 }
 
-DCResVoid dc_da_grow(DCDynArr* darr)
+#ifdef __DC_DA_MMAP
+
+/**
+ * Rounds `bytes` up to whole pages
+ */
+static usize __dc_da_page_round(usize bytes)
 {
-    DC_RES_void();
+    long page_size = sysconf(_SC_PAGESIZE);
+    usize page = page_size > 0 ? (usize)page_size : 4096;
 
-    if (!darr)
-    {
-        dc_dbg_log("got NULL DCDynArr");
+    return ((bytes + page - 1) / page) * page;
+}
 
-        dc_ret_e(1, "got NULL DCDynArr");
-    }
+/**
+ * Size of the memory mapping needed for `cap` elements (whole pages)
+ */
+static usize __dc_da_mmap_size(usize cap)
+{
+    return __dc_da_page_round(cap * sizeof(DCDynVal));
+}
 
-    if (darr->cap > (SIZE_MAX / darr->multiplier) / sizeof(DCDynVal))
-    {
-        dc_dbg_log("Array size too large, cannot allocate more memory");
+/**
+ * Memory mapped arrays have nothing but their storage kind to keep out of line
+ */
+static DCDynArrBacking __dc_da_mmap_backing = {DC_DA_STORAGE_MMAP, NULL};
+
+/**
+ * Moves the elements into a new memory mapping big enough for `new_cap`
+ * elements, the previous heap block (if any) is released
+ *
+ * NOTE: The whole mapping is used so the capacity might end up bigger than
+ * `new_cap`
+ */
+static DCResVoid __dc_da_mmap_move(DCDynArr* darr, usize new_cap)
+{
+    DC_RES_void();
 
-        dc_ret_e(2, "Array size too large, cannot allocate more memory");
-    }
+    usize map_size = __dc_da_mmap_size(new_cap);
 
-    // Resize the array if needed (double the capacity by default or custom
-    // multiplier of provided beforehand)
-    DCDynVal* resized = realloc(darr->elements, darr->cap * darr->multiplier * sizeof(DCDynVal));
-    if (resized == NULL)
+    voidptr mapped = mmap(NULL, map_size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (mapped == MAP_FAILED)
     {
-        dc_dbg_log("Memory re-allocation failed");
+        dc_dbg_log("Memory mapping failed");
 
-        dc_ret_e(2, "Memory re-allocation failed");
+        dc_ret_e(2, "Memory mapping failed");
     }
 
-    darr->elements = resized;
-    darr->cap *= darr->multiplier;
+#ifdef MADV_HUGEPAGE
+    madvise(mapped, map_size, MADV_HUGEPAGE);
+#endif
+
+    if (darr->count > 0) memcpy(mapped, darr->elements, darr->count * sizeof(DCDynVal));
+
+    if (dc_da_storage(*darr) == DC_DA_STORAGE_HEAP) free(darr->elements);
+
+    darr->backing = &__dc_da_mmap_backing;
+    darr->elements = (DCDynVal*)mapped;
+    darr->cap = map_size / sizeof(DCDynVal);
 
     dc_ret();
 }
 
-DCResVoid dc_da_grow_by(DCDynArr* darr, usize amount)
+/**
+ * Resizes memory mapped storage, on linux the pages are remapped so the
+ * elements are never copied
+ */
+static DCResVoid __dc_da_mmap_resize(DCDynArr* darr, usize new_cap)
 {
     DC_RES_void();
 
-    if (!darr)
+    usize old_size = __dc_da_mmap_size(darr->cap);
+
+    if (new_cap == 0)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        munmap(darr->elements, old_size);
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        darr->backing = NULL;
+        darr->elements = NULL;
+        darr->cap = 0;
+
+        dc_ret();
     }
 
-    DCDynVal* resized = realloc(darr->elements, (darr->cap + amount) * sizeof(DCDynVal));
+    usize new_size = __dc_da_mmap_size(new_cap);
 
-    if (resized == NULL)
+    if (new_size == old_size) dc_ret();
+
+#ifdef MREMAP_MAYMOVE
+    voidptr remapped = mremap(darr->elements, old_size, new_size, MREMAP_MAYMOVE);
+    if (remapped == MAP_FAILED)
     {
-        dc_dbg_log("Memory re-allocation failed");
+        dc_dbg_log("Memory re-mapping failed");
 
-        dc_ret_e(2, "Memory re-allocation failed");
+        dc_ret_e(2, "Memory re-mapping failed");
     }
 
-    darr->cap += amount;
-    darr->elements = resized;
+#ifdef MADV_HUGEPAGE
+    madvise(remapped, new_size, MADV_HUGEPAGE);
+#endif
+
+    darr->elements = (DCDynVal*)remapped;
+    darr->cap = new_size / sizeof(DCDynVal);
+#else
+    DCDynVal* old_elements = darr->elements;
+
+    dc_try_fail(__dc_da_mmap_move(darr, new_cap));
+
+    munmap(old_elements, old_size);
+#endif
 
     dc_ret();
 }
 
-DCResVoid dc_da_grow_to(DCDynArr* darr, usize amount)
+/**
+ * Header at the beginning of files backing dynamic arrays, `count` and
+ * `heap_used` are only updated by `dc_da_sync`, `heap_base` is the address the
+ * side heap was mapped at so string pointers can be relocated on reopening
+ */
+typedef struct
+{
+    char magic[8];
+    u64 version;
+    u64 count;
+    u64 elem_size;
+    u64 heap_used;
+    u64 heap_base;
+    u64 reserved[2];
+} __DCDaFileHeader;
+
+#define __DC_DA_FILE_MAGIC "DCDAFILE"
+#define __DC_DA_FILE_VERSION 1
+
+/**
+ * State of a file backed dynamic array, `map` is the whole element file and
+ * `heap` is the side heap file mapped with `DC_DA_FILE_HEAP_RESERVE` bytes of
+ * address space so stored strings never move while the array is open
+ */
+typedef struct
+{
+    DCDynArrBacking backing;
+
+    int fd;
+    int heap_fd;
+
+    u8* map;
+    usize map_size;
+
+    char* heap;
+    usize heap_size;
+    usize heap_used;
+} __DCDaFile;
+
+/**
+ * Size of the element file needed for `cap` elements (header included, whole
+ * pages)
+ */
+static usize __dc_da_file_map_size(usize cap)
+{
+    return __dc_da_page_round(sizeof(__DCDaFileHeader) + cap * sizeof(DCDynVal));
+}
+
+/**
+ * Points the array to the elements inside the current mapping of its file
+ */
+static void __dc_da_file_attach(DCDynArr* darr, __DCDaFile* file)
+{
+    darr->elements = (DCDynVal*)(file->map + sizeof(__DCDaFileHeader));
+    darr->cap = (file->map_size - sizeof(__DCDaFileHeader)) / sizeof(DCDynVal);
+}
+
+/**
+ * Unmaps, closes and releases whatever part of `file` is set up
+ */
+static void __dc_da_file_close(__DCDaFile* file)
+{
+    if (file->heap) munmap(file->heap, DC_DA_FILE_HEAP_RESERVE);
+    if (file->map) munmap(file->map, file->map_size);
+
+    if (file->heap_fd >= 0) close(file->heap_fd);
+    if (file->fd >= 0) close(file->fd);
+
+    free(file);
+}
+
+/**
+ * Resizes the file backing the array and remaps it, on linux the pages are
+ * remapped so the elements are never copied
+ */
+static DCResVoid __dc_da_file_resize(DCDynArr* darr, usize new_cap)
 {
     DC_RES_void();
 
-    if (!darr)
+    __DCDaFile* file = (__DCDaFile*)darr->backing->data;
+
+    usize new_size = __dc_da_file_map_size(new_cap);
+
+    if (new_size == file->map_size) dc_ret();
+
+    if (ftruncate(file->fd, (off_t)new_size) != 0)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        dc_dbg_log("Cannot resize the backing file: (code %d) %s", errno, strerror(errno));
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        dc_ret_ea(errno, "%s", strerror(errno));
     }
 
-    DCDynVal* resized = realloc(darr->elements, amount * sizeof(DCDynVal));
+#ifdef MREMAP_MAYMOVE
+    voidptr remapped = mremap(file->map, file->map_size, new_size, MREMAP_MAYMOVE);
+#else
+    munmap(file->map, file->map_size);
+    file->map = NULL;
 
-    if (resized == NULL)
+    voidptr remapped = mmap(NULL, new_size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+#endif
+    if (remapped == MAP_FAILED)
     {
-        dc_dbg_log("Memory re-allocation failed");
+        dc_dbg_log("Memory re-mapping failed");
 
-        dc_ret_e(2, "Memory re-allocation failed");
+        dc_ret_e(2, "Memory re-mapping failed");
     }
 
-    darr->cap = amount;
-    darr->elements = resized;
+    file->map = (u8*)remapped;
+    file->map_size = new_size;
+
+    __dc_da_file_attach(darr, file);
 
     dc_ret();
 }
 
-DCResVoid dc_da_trunc(DCDynArr* darr)
+/**
+ * Copies `str` (including the terminating zero) to the end of the side heap
+ * file and returns where it's stored
+ */
+static DCResString __dc_da_file_heap_store(__DCDaFile* file, string str)
 {
-    DC_RES_void();
+    DC_RES_string();
 
-    if (!darr)
+    usize len = strlen(str) + 1;
+
+    if (len > DC_DA_FILE_HEAP_RESERVE - file->heap_used)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        dc_dbg_log("side heap file is full");
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        dc_ret_e(2, "side heap file is full");
     }
 
-    if (darr->count < darr->cap)
+    if (file->heap_used + len > file->heap_size)
     {
-        DCDynVal* resized = realloc(darr->elements, darr->count * sizeof(DCDynVal));
+        usize new_size = file->heap_size * 2;
+        if (new_size < file->heap_used + len) new_size = file->heap_used + len;
 
-        if (resized == NULL)
+        new_size = __dc_da_page_round(new_size);
+        if (new_size > DC_DA_FILE_HEAP_RESERVE) new_size = DC_DA_FILE_HEAP_RESERVE;
+
+        if (ftruncate(file->heap_fd, (off_t)new_size) != 0)
         {
-            dc_dbg_log("Memory re-allocation failed");
+            dc_dbg_log("Cannot resize the side heap file: (code %d) %s", errno, strerror(errno));
 
-            dc_ret_e(2, "Memory re-allocation failed");
+            dc_ret_ea(errno, "%s", strerror(errno));
         }
 
-        darr->cap = darr->count;
-        darr->elements = resized;
+        file->heap_size = new_size;
     }
 
-    dc_ret();
+    string stored = file->heap + file->heap_used;
+    memcpy(stored, str, len);
+    file->heap_used += len;
+
+    dc_ret_ok(stored);
 }
 
-DCResVoid dc_da_pop(DCDynArr* darr, usize count, DCDynVal** out_popped, b1 truncate)
+/**
+ * Moves string pointers saved relative to the previous mapping of the side
+ * heap (`old_base`) to the current one, pointers outside of the used part of
+ * the heap (e.g. written after the last sync) become NULL
+ */
+static void __dc_da_file_relocate(DCDynArr* darr, __DCDaFile* file, uptr old_base)
+{
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        DCDynVal* el = &darr->elements[i];
+
+        if (!dc_dv_is(*el, string) || dc_dv_as(*el, string) == NULL) continue;
+
+        uptr ptr = (uptr)dc_dv_as(*el, string);
+
+        if (ptr >= old_base && ptr < old_base + file->heap_used)
+            dc_dv_set(*el, string, file->heap + (ptr - old_base));
+        else
+            dc_dv_set(*el, string, NULL);
+    }
+}
+
+#endif
+
+/**
+ * Rejects values that cannot be persisted by file backed arrays, only plain
+ * scalars, strings and inline strings stored in place are accepted
+ */
+static DCResVoid __dc_da_file_check(DCDynArr* darr, DCDynVal* values, usize count)
 {
     DC_RES_void();
 
-    if (!darr)
+    if (dc_da_storage(*darr) != DC_DA_STORAGE_FILE) dc_ret();
+
+    for (usize i = 0; i < count; ++i)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        switch (values[i].type)
+        {
+            case dc_dvt(b1):
+            case dc_dvt(i8):
+            case dc_dvt(i16):
+            case dc_dvt(i32):
+            case dc_dvt(i64):
+            case dc_dvt(u8):
+            case dc_dvt(u16):
+            case dc_dvt(u32):
+            case dc_dvt(u64):
+            case dc_dvt(f32):
+            case dc_dvt(f64):
+            case dc_dvt(uptr):
+            case dc_dvt(char):
+            case dc_dvt(size):
+            case dc_dvt(usize):
+            case dc_dvt(string):
+                break;
 
-        dc_ret_e(1, "got NULL DCDynArr");
+            case dc_dvt(DCInlineStr):
+                if (!values[i].istr_heap) break;
+
+                // fall through
+
+            default:
+                dc_dbg_log("file backed dynamic arrays cannot persist values of type '%d'", values[i].type);
+
+                dc_ret_e(3, "file backed dynamic arrays cannot persist this type of value");
+        }
     }
 
-    if (count > darr->count)
+    dc_ret();
+}
+
+/**
+ * Copies string payloads of the values that are about to be added to the side
+ * heap file, must be called before changing the array so a full side heap
+ * leaves it untouched, the copies are next to each other in the order of the
+ * values starting at the returned offset (see `__dc_da_file_adopt`)
+ */
+static DCResUsize __dc_da_file_store(DCDynArr* darr, DCDynVal* values, usize count)
+{
+    DC_RES_usize();
+
+    if (dc_da_storage(*darr) != DC_DA_STORAGE_FILE) dc_ret_ok(0);
+
+#ifdef __DC_DA_MMAP
+    __DCDaFile* file = (__DCDaFile*)darr->backing->data;
+
+    usize heap_offset = file->heap_used;
+
+    for (usize i = 0; i < count; ++i)
     {
-        dc_dbg_log("Try to pop elements more than actual number of elements");
+        if (!dc_dv_is(values[i], string) || dc_dv_as(values[i], string) == NULL) continue;
 
-        dc_ret_e(4, "Try to pop elements more than actual number of elements");
+        // Copies made so far are dropped
+        dc_try_or_fail_with3(DCResString, stored, __dc_da_file_heap_store(file, dc_dv_as(values[i], string)),
+                             file->heap_used = heap_offset);
     }
 
-    if (out_popped != NULL)
+    dc_ret_ok(heap_offset);
+#else
+    (void)values;
+    (void)count;
+
+    dc_ret_ok(0);
+#endif
+}
+
+/**
+ * Points the string elements among the `count` ones starting at `start` to
+ * their copies in the side heap file made by `__dc_da_file_store` (starting at
+ * `heap_offset`), allocated strings are released as the array owned them
+ */
+static void __dc_da_file_adopt(DCDynArr* darr, usize start, usize count, usize heap_offset)
+{
+    if (dc_da_storage(*darr) != DC_DA_STORAGE_FILE) return;
+
+#ifdef __DC_DA_MMAP
+    __DCDaFile* file = (__DCDaFile*)darr->backing->data;
+
+    for (usize i = start; i < start + count; ++i)
     {
-        *out_popped = (DCDynVal*)malloc(count * sizeof(DCDynVal));
+        DCDynVal* el = &darr->elements[i];
 
-        if (!out_popped)
+        if (!dc_dv_is(*el, string) || dc_dv_as(*el, string) == NULL) continue;
+
+        string stored = file->heap + heap_offset;
+        heap_offset += strlen(stored) + 1;
+
+        if (el->allocated)
         {
-            dc_dbg_log("Memory re-allocation failed");
+            free(dc_dv_as(*el, string));
 
-            dc_ret_e(2, "Memory re-allocation failed");
+            el->allocated = false;
+            if (darr->owned_count > 0) darr->owned_count--;
         }
+
+        dc_dv_set(*el, string, stored);
     }
+#else
+    (void)start;
+    (void)count;
+    (void)heap_offset;
+#endif
+}
 
-    usize last_item_index = darr->count - 1;
+/**
+ * Changes capacity of the array to `new_cap` elements according to its storage,
+ * arena arrays grow inside their arena and heap arrays growing past
+ * `DC_DA_MMAP_THRESHOLD` move to a memory mapping here
+ */
+static DCResVoid __dc_da_resize(DCDynArr* darr, usize new_cap)
+{
+    DC_RES_void();
 
-    for (i32 i = count - 1; i >= 0; --i)
+    if (new_cap > SIZE_MAX / sizeof(DCDynVal))
     {
-        if (out_popped) (*out_popped)[i] = darr->elements[last_item_index - i];
+        dc_dbg_log("Array size too large, cannot allocate more memory");
 
-        dc_try_fail(dc_dv_free(&darr->elements[last_item_index - i], darr->element_free_fn));
+        dc_ret_e(2, "Array size too large, cannot allocate more memory");
+    }
 
-        darr->count--;
+    if (dc_da_storage(*darr) == DC_DA_STORAGE_ARENA)
+    {
+        // Arena memory is never given back, the old elements stay until the arena is reset
+        if (new_cap <= darr->cap) dc_ret();
+
+        dc_try_or_fail_with3(DCResVoidptr, grown, dc_arena_alloc((DCArena*)darr->backing->data, new_cap * sizeof(DCDynVal)), {});
+
+        if (darr->count > 0) memcpy(dc_unwrap2(grown), darr->elements, darr->count * sizeof(DCDynVal));
+
+        darr->elements = (DCDynVal*)dc_unwrap2(grown);
+        darr->cap = new_cap;
+
+        dc_ret();
     }
 
-    if (truncate) dc_try_fail(dc_da_trunc(darr));
+#ifdef __DC_DA_MMAP
+    if (dc_da_storage(*darr) == DC_DA_STORAGE_FILE) return __dc_da_file_resize(darr, new_cap);
+
+    if (dc_da_storage(*darr) == DC_DA_STORAGE_MMAP) return __dc_da_mmap_resize(darr, new_cap);
+
+    if (DC_DA_MMAP_THRESHOLD > 0 && new_cap > darr->cap && new_cap * sizeof(DCDynVal) >= DC_DA_MMAP_THRESHOLD)
+        return __dc_da_mmap_move(darr, new_cap);
+#endif
+
+    // realloc with zero size might free the memory and return NULL
+    if (new_cap == 0)
+    {
+        free(darr->elements);
+
+        darr->elements = NULL;
+        darr->cap = 0;
+
+        dc_ret();
+    }
+
+    DCDynVal* resized = realloc(darr->elements, new_cap * sizeof(DCDynVal));
+    if (resized == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    darr->elements = resized;
+    darr->cap = new_cap;
 
     dc_ret();
 }
 
-DCResVoid dc_da_push(DCDynArr* darr, DCDynVal value)
+/**
+ * Computes the capacity needed for holding at least `needed` elements based on
+ * the growth policy of the array
+ *
+ * NOTE: The result is always bigger than the current capacity, so policies
+ * like a multiplier of 1 still make room for new elements
+ *
+ * @return new capacity or error
+ */
+static DCResUsize __dc_da_next_cap(DCDynArr* darr, usize needed)
 {
-    DC_RES_void();
+    DC_RES_usize();
 
-    if (!darr)
+    usize max_cap = SIZE_MAX / sizeof(DCDynVal);
+
+    if (needed > max_cap || darr->cap >= max_cap)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        dc_dbg_log("Array size too large, cannot allocate more memory");
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        dc_ret_e(2, "Array size too large, cannot allocate more memory");
     }
 
-    if (darr->count >= darr->cap) dc_try_fail(dc_da_grow(darr));
+    if (darr->cap == 0) dc_ret_ok(needed > DC_DA_INITIAL_CAP ? needed : DC_DA_INITIAL_CAP);
+
+    f64 factor;
+
+    switch (darr->growth)
+    {
+        case DC_DA_GROW_FACTOR:
+            factor = (f64)darr->growth_factor;
+            break;
+
+        case DC_DA_GROW_SCHEDULE:
+        {
+            usize bytes = darr->cap * sizeof(DCDynVal);
+
+            if (bytes < ((usize)1 << 20))
+                factor = 2.0;
+            else if (bytes < ((usize)1 << 26))
+                factor = 1.5;
+            else if (bytes < ((usize)1 << 30))
+                factor = 1.25;
+            else
+                factor = 1.125;
+
+            break;
+        }
+
+        default:
+            factor = (f64)darr->multiplier;
+            break;
+    }
+
+    f64 grown = (f64)darr->cap * factor;
+    usize new_cap = grown >= (f64)max_cap ? max_cap : (usize)grown;
+
+    if (new_cap <= darr->cap) new_cap = darr->cap + 1;
+    if (new_cap < needed) new_cap = needed;
+
+    dc_ret_ok(new_cap);
+}
+
+/**
+ * Makes sure there is room for at least `needed` elements, growing according to
+ * the growth policy (or straight to `needed` if that is not enough) so that
+ * consecutive bulk operations stay amortized
+ */
+static DCResVoid __dc_da_reserve(DCDynArr* darr, usize needed)
+{
+    DC_RES_void();
+
+    if (needed <= darr->cap) dc_ret();
+
+    dc_try_or_fail_with3(DCResUsize, cap_res, __dc_da_next_cap(darr, needed), {});
+
+    return __dc_da_resize(darr, dc_unwrap2(cap_res));
+}
+
+DCResVoid dc_da_set_growth(DCDynArr* darr, DCDynArrGrowth growth, f32 growth_factor)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (growth == DC_DA_GROW_FACTOR && !(growth_factor > 1.0f))
+    {
+        dc_dbg_log("growth factor must be greater than 1, got: %f", growth_factor);
+
+        dc_ret_e(1, "growth factor must be greater than 1");
+    }
+
+    darr->growth = growth;
+    if (growth == DC_DA_GROW_FACTOR) darr->growth_factor = growth_factor;
+
+    dc_ret();
+}
+
+DCResVoid dc_da_grow(DCDynArr* darr)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, cap_res, __dc_da_next_cap(darr, darr->cap + 1), {});
+
+    return __dc_da_resize(darr, dc_unwrap2(cap_res));
+}
+
+DCResVoid dc_da_grow_by(DCDynArr* darr, usize amount)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (amount > SIZE_MAX / sizeof(DCDynVal) - darr->cap)
+    {
+        dc_dbg_log("Array size too large, cannot allocate more memory");
+
+        dc_ret_e(2, "Array size too large, cannot allocate more memory");
+    }
+
+    return __dc_da_resize(darr, darr->cap + amount);
+}
+
+DCResVoid dc_da_grow_to(DCDynArr* darr, usize amount)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    return __dc_da_resize(darr, amount);
+}
+
+DCResVoid dc_da_trunc(DCDynArr* darr)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (darr->count < darr->cap) dc_try_fail(__dc_da_resize(darr, darr->count));
+
+    dc_ret();
+}
+
+DCResVoid dc_da_pop(DCDynArr* darr, usize count, DCDynVal** out_popped, b1 truncate)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (count > darr->count)
+    {
+        dc_dbg_log("Try to pop elements more than actual number of elements");
+
+        dc_ret_e(4, "Try to pop elements more than actual number of elements");
+    }
+
+    if (out_popped != NULL)
+    {
+        *out_popped = (DCDynVal*)malloc(count * sizeof(DCDynVal));
+
+        if (!out_popped)
+        {
+            dc_dbg_log("Memory re-allocation failed");
+
+            dc_ret_e(2, "Memory re-allocation failed");
+        }
+    }
+
+    usize last_item_index = darr->count - 1;
+
+    for (i32 i = count - 1; i >= 0; --i)
+    {
+        if (out_popped) (*out_popped)[i] = darr->elements[last_item_index - i];
+
+        if (dc_da_has_owned(*darr)) dc_try_fail(__dc_da_free_element(darr, &darr->elements[last_item_index - i]));
+
+        darr->count--;
+    }
+
+    if (truncate) dc_try_fail(dc_da_trunc(darr));
+
+    dc_ret();
+}
+
+DCResVoid dc_da_push(DCDynArr* darr, DCDynVal value)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    dc_try_fail(__dc_da_file_check(darr, &value, 1));
+
+    if (darr->count >= darr->cap) dc_try_fail(dc_da_grow(darr));
+
+    dc_try_or_fail_with3(DCResUsize, heap_offset, __dc_da_file_store(darr, &value, 1), {});
+
+    __dc_da_track_values(darr, &value, 1);
+
+    // Add the new element with its type and value
+    darr->elements[darr->count] = value;
+    darr->count++;
+
+    __dc_da_file_adopt(darr, darr->count - 1, 1, dc_unwrap2(heap_offset));
+
+    dc_ret();
+}
+
+DCResVoid __dc_da_append_values(DCDynArr* darr, usize count, DCDynVal values[])
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (count == 0) dc_ret();
+
+    dc_try_fail(__dc_da_file_check(darr, values, count));
+
+    dc_try_fail(__dc_da_reserve(darr, darr->count + count));
+
+    dc_try_or_fail_with3(DCResUsize, heap_offset, __dc_da_file_store(darr, values, count), {});
+
+    __dc_da_track_values(darr, values, count);
+
+    memcpy(&darr->elements[darr->count], values, count * sizeof(DCDynVal));
+    darr->count += count;
+
+    __dc_da_file_adopt(darr, darr->count - count, count, dc_unwrap2(heap_offset));
+
+    dc_ret();
+}
+
+DCResVoid dc_da_append(DCDynArr* darr, DCDynArr* from)
+{
+    DC_RES_void();
+
+    if (!darr || !from)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    // Reserving before taking `from->elements` keeps self-appending safe
+    dc_try_fail(__dc_da_reserve(darr, darr->count + from->count));
+
+    dc_try_fail(__dc_da_append_values(darr, from->count, from->elements));
+
+    dc_ret();
+}
+
+DCResPtr dc_da_get(DCDynArr* darr, usize index)
+{
+    DC_RES_dv();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (index >= darr->count)
+    {
+        dc_dbg_log("Index out of bound - try to get index='" dc_fmt(usize) "' out of actual '" dc_fmt(usize) "' elements.",
+                   index, darr->count);
+
+        dc_ret_e(4, "Index out of bound");
+    }
+
+    dc_ret_ok(&darr->elements[index]);
+}
+
+DCResVoid dc_da_set(DCDynArr* darr, usize index, DCDynVal value)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (index >= darr->count)
+    {
+        dc_dbg_log("Index out of bound - try to get index='" dc_fmt(usize) "' out of actual '" dc_fmt(usize) "' elements.",
+                   index, darr->count);
+
+        dc_ret_e(4, "Index out of bound");
+    }
+
+    dc_try_fail(__dc_da_file_check(darr, &value, 1));
+
+    dc_try_or_fail_with3(DCResUsize, heap_offset, __dc_da_file_store(darr, &value, 1), {});
+
+    dc_try_fail(__dc_da_free_element(darr, &darr->elements[index]));
+
+    darr->elements[index] = value;
+    darr->owned_count += dc_dv_is_owning(value);
+
+    __dc_da_file_adopt(darr, index, 1, dc_unwrap2(heap_offset));
+
+    dc_ret();
+}
+
+DCResUsize dc_da_update_owned(DCDynArr* darr)
+{
+    DC_RES_usize();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    darr->owned_count = 0;
+
+    for (usize i = 0; i < darr->count; ++i) darr->owned_count += dc_dv_is_owning(darr->elements[i]);
+
+    dc_ret_ok(darr->owned_count);
+}
+
+/**
+ * Number of elements that are compared at once by the scan kernels
+ *
+ * NOTE: The comparisons of a block are branchless and collected into a bit mask
+ * so only one branch is taken per block
+ */
+#define __DC_DA_SCAN_BLOCK 8
+
+/**
+ * Defines a scan kernel that looks for `key` among the `TYPE` elements (each `stride`
+ * elements apart) starting from `start`, returns the found index or `count` when
+ * there is no match
+ *
+ * NOTE: The value of an element is only read after its type is known to be `TYPE`
+ * so other members of the union (e.g. arbitrary bytes as `b1`) are never touched
+ */
+#define __DC_DA_SCAN_KERNEL(TYPE)                                                                                              \
+    static usize __dc_da_scan_##TYPE(DCDynVal* elements, usize stride, usize start, usize count, TYPE key)                     \
+    {                                                                                                                          \
+        usize i = start;                                                                                                       \
+        if (stride == 1)                                                                                                       \
+        {                                                                                                                      \
+            for (; i + __DC_DA_SCAN_BLOCK <= count; i += __DC_DA_SCAN_BLOCK)                                                   \
+            {                                                                                                                  \
+                u64 mask = 0;                                                                                                  \
+                for (usize j = 0; j < __DC_DA_SCAN_BLOCK; ++j)                                                                 \
+                {                                                                                                              \
+                    DCDynVal* element = &elements[i + j];                                                                      \
+                    u64 matched = element->type == dc_dvt(TYPE) && element->value.dc_dvf(TYPE) == key;                         \
+                    mask |= matched << j;                                                                                      \
+                }                                                                                                              \
+                if (mask != 0) return i + dc_ctz64(mask);                                                                      \
+            }                                                                                                                  \
+        }                                                                                                                      \
+        for (; i < count; ++i)                                                                                                 \
+        {                                                                                                                      \
+            DCDynVal* element = &elements[i * stride];                                                                         \
+            if (element->type == dc_dvt(TYPE) && element->value.dc_dvf(TYPE) == key) return i;                                 \
+        }                                                                                                                      \
+        return count;                                                                                                          \
+    }
+
+__DC_DA_SCAN_KERNEL(b1)
+
+__DC_DA_SCAN_KERNEL(i8)
+__DC_DA_SCAN_KERNEL(i16)
+__DC_DA_SCAN_KERNEL(i32)
+__DC_DA_SCAN_KERNEL(i64)
+
+__DC_DA_SCAN_KERNEL(u8)
+__DC_DA_SCAN_KERNEL(u16)
+__DC_DA_SCAN_KERNEL(u32)
+__DC_DA_SCAN_KERNEL(u64)
+
+__DC_DA_SCAN_KERNEL(f32)
+__DC_DA_SCAN_KERNEL(f64)
+
+__DC_DA_SCAN_KERNEL(uptr)
+__DC_DA_SCAN_KERNEL(char)
+__DC_DA_SCAN_KERNEL(size)
+__DC_DA_SCAN_KERNEL(usize)
+
+__DC_DA_SCAN_KERNEL(voidptr)
+__DC_DA_SCAN_KERNEL(fileptr)
+
+#undef __DC_DA_SCAN_KERNEL
+
+/**
+ * Looks for the first element of the view equal to `el` starting from `start`
+ *
+ * NOTE: Elements are always type checked, arrays may hold values of any type
+ *
+ * @return index of the found element or `view->count` if there is no match
+ */
+static DCResUsize __dc_dav_scan(DCDynArrView* view, usize start, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DC_RES_usize();
+
+#define scan_case(TYPE)                                                                                                        \
+    case dc_dvt(TYPE):                                                                                                         \
+        dc_ret_ok(__dc_da_scan_##TYPE(view->elements, view->stride, start, view->count, el->value.dc_dvf(TYPE)))
+
+    switch (el->type)
+    {
+        scan_case(b1);
+
+        scan_case(i8);
+        scan_case(i16);
+        scan_case(i32);
+        scan_case(i64);
+
+        scan_case(u8);
+        scan_case(u16);
+        scan_case(u32);
+        scan_case(u64);
+
+        scan_case(f32);
+        scan_case(f64);
+
+        scan_case(uptr);
+        scan_case(char);
+        scan_case(size);
+        scan_case(usize);
+
+        scan_case(voidptr);
+        scan_case(fileptr);
+
+        default:
+            break;
+    }
+
+#undef scan_case
+
+    // Extra types fall back to their registered equality
+    if (!dv_eq_fn && dc_dv_vtable(el->type)) dv_eq_fn = dc_dv_vtable(el->type)->eq_fn;
+
+    for (usize i = start; i < view->count; i++)
+    {
+        DCDynVal* element = dc_dav_get(*view, i);
+        if (element->type != el->type)
+        {
+            continue; // Skip if the type doesn't match
+        }
+
+        // check the actual value based on the type
+        switch (el->type)
+        {
+            case dc_dvt(string):
+            {
+                string a = dc_dv_as(*element, string);
+                string b = dc_dv_as(*el, string);
+
+                if (a == b || (a && b && strcmp(a, b) == 0)) dc_ret_ok(i);
+                break;
+            }
+
+            case dc_dvt(DCInlineStr):
+                if (__dc_dv_istr_eq(element, el)) dc_ret_ok(i);
+                break;
+
+                // clang-format off
+            case dc_dvt(DCStringView):
+            {
+                if (dc_dv_as(*element, DCStringView).str && dc_dv_as(*el, DCStringView).str 
+                && (dc_dv_as(*element, DCStringView).str == dc_dv_as(*el, DCStringView).str) 
+                && (dc_dv_as(*element, DCStringView).len == dc_dv_as(*el, DCStringView).len)) dc_ret_ok(i);
+
+                break;
+            }
+                // clang-format on
+
+            default:
+                if (dv_eq_fn)
+                {
+                    dc_try_or_fail_with3(DCResBool, cmp_res, dv_eq_fn(element, el), {});
+
+                    if (dc_unwrap2(cmp_res) == true) dc_ret_ok(i);
+                }
+                break;
+        }
+    }
+
+    dc_ret_ok(view->count);
+}
+
+/**
+ * Looks for the first element equal to `el` starting from `start`
+ *
+ * @return index of the found element or `darr->count` if there is no match
+ */
+static DCResUsize __dc_da_scan(DCDynArr* darr, usize start, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DCDynArrView view = dc_da_as_view(*darr);
+
+    return __dc_dav_scan(&view, start, el, dv_eq_fn);
+}
+
+DCResUsize dc_da_find2(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DC_RES_usize();
+
+    if (!darr || !el)
+    {
+        dc_dbg_log("got NULL DCDynArr or element");
+
+        dc_ret_e(1, "got NULL DCDynArr or element");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, found_res, __dc_da_scan(darr, 0, el, dv_eq_fn), {});
+
+    if (dc_unwrap2(found_res) < darr->count) dc_ret_ok(dc_unwrap2(found_res));
+
+    dc_dbg_log("Not Found");
+
+    dc_ret_e(6, "Not Found");
+}
+
+DCResUsize dc_da_find_all(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn, usize** out_indexes)
+{
+    DC_RES_usize();
+
+    if (!darr || !el || !out_indexes)
+    {
+        dc_dbg_log("got NULL DCDynArr, element or output");
+
+        dc_ret_e(1, "got NULL DCDynArr, element or output");
+    }
+
+    usize cap = DC_DA_INITIAL_CAP;
+    usize found = 0;
+
+    // One extra slot is always kept for the stopper
+    *out_indexes = malloc((cap + 1) * sizeof(usize));
+    if (*out_indexes == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    usize start = 0;
+
+    while (start < darr->count)
+    {
+        DCResUsize scan_res = __dc_da_scan(darr, start, el, dv_eq_fn);
+        if (dc_is_err2(scan_res))
+        {
+            free(*out_indexes);
+            *out_indexes = NULL;
+
+            dc_err_cpy(scan_res);
+            dc_ret();
+        }
+
+        usize index = dc_unwrap2(scan_res);
+        if (index >= darr->count) break;
+
+        if (found == cap)
+        {
+            usize* resized = realloc(*out_indexes, (cap * 2 + 1) * sizeof(usize));
+            if (resized == NULL)
+            {
+                free(*out_indexes);
+                *out_indexes = NULL;
+
+                dc_dbg_log("Memory re-allocation failed");
+
+                dc_ret_e(2, "Memory re-allocation failed");
+            }
+
+            *out_indexes = resized;
+            cap *= 2;
+        }
+
+        (*out_indexes)[found++] = index;
+        start = index + 1;
+    }
+
+    (*out_indexes)[found] = dc_stopper(usize);
+
+    dc_ret_ok(found);
+}
+
+DCResUsize dc_da_count(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DC_RES_usize();
+
+    if (!darr || !el)
+    {
+        dc_dbg_log("got NULL DCDynArr or element");
+
+        dc_ret_e(1, "got NULL DCDynArr or element");
+    }
+
+    usize found = 0;
+    usize start = 0;
+
+    while (start < darr->count)
+    {
+        dc_try_or_fail_with3(DCResUsize, scan_res, __dc_da_scan(darr, start, el, dv_eq_fn), {});
+
+        usize index = dc_unwrap2(scan_res);
+        if (index >= darr->count) break;
+
+        found++;
+        start = index + 1;
+    }
+
+    dc_ret_ok(found);
+}
+
+DCResUsize dc_da_find(DCDynArr* darr, DCDynVal el, DCDvEqFn dv_eq_fn)
+{
+    return dc_da_find2(darr, &el, dv_eq_fn);
+}
+
+DCResDav dc_da_view(DCDynArr* darr, usize start, usize count)
+{
+    return dc_da_view2(darr, start, count, 1);
+}
+
+DCResDav dc_da_view2(DCDynArr* darr, usize start, usize count, usize stride)
+{
+    DC_RES_dav();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (stride == 0)
+    {
+        dc_dbg_log("stride cannot be zero");
+
+        dc_ret_e(1, "stride cannot be zero");
+    }
+
+    // The last element of the view is at start + (count - 1) * stride
+    if (count > 0 && (start >= darr->count || (count - 1) > (darr->count - 1 - start) / stride))
+    {
+        dc_dbg_log("view is out of the array bounds");
+
+        dc_ret_e(4, "view is out of the array bounds");
+    }
+
+    dc_ret_ok(((DCDynArrView){.elements = count > 0 ? &darr->elements[start] : NULL, .count = count, .stride = stride}));
+}
+
+DCResDav dc_dav_view(DCDynArrView* view, usize start, usize count)
+{
+    DC_RES_dav();
+
+    if (!view)
+    {
+        dc_dbg_log("got NULL DCDynArrView");
+
+        dc_ret_e(1, "got NULL DCDynArrView");
+    }
+
+    if (count > 0 && (start >= view->count || count > view->count - start))
+    {
+        dc_dbg_log("view is out of the view bounds");
+
+        dc_ret_e(4, "view is out of the view bounds");
+    }
+
+    dc_ret_ok(((DCDynArrView){.elements = count > 0 ? dc_dav_get(*view, start) : NULL, .count = count, .stride = view->stride}));
+}
+
+DCResUsize dc_dav_find2(DCDynArrView* view, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DC_RES_usize();
+
+    if (!view || !el)
+    {
+        dc_dbg_log("got NULL DCDynArrView or element");
+
+        dc_ret_e(1, "got NULL DCDynArrView or element");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, found_res, __dc_dav_scan(view, 0, el, dv_eq_fn), {});
+
+    if (dc_unwrap2(found_res) < view->count) dc_ret_ok(dc_unwrap2(found_res));
+
+    dc_dbg_log("Not Found");
+
+    dc_ret_e(6, "Not Found");
+}
+
+DCResUsize dc_dav_find(DCDynArrView* view, DCDynVal el, DCDvEqFn dv_eq_fn)
+{
+    return dc_dav_find2(view, &el, dv_eq_fn);
+}
+
+DCResUsize dc_dav_count(DCDynArrView* view, DCDynVal* el, DCDvEqFn dv_eq_fn)
+{
+    DC_RES_usize();
+
+    if (!view || !el)
+    {
+        dc_dbg_log("got NULL DCDynArrView or element");
+
+        dc_ret_e(1, "got NULL DCDynArrView or element");
+    }
+
+    usize found = 0;
+    usize start = 0;
+
+    while (start < view->count)
+    {
+        dc_try_or_fail_with3(DCResUsize, scan_res, __dc_dav_scan(view, start, el, dv_eq_fn), {});
+
+        usize index = dc_unwrap2(scan_res);
+        if (index >= view->count) break;
+
+        found++;
+        start = index + 1;
+    }
+
+    dc_ret_ok(found);
+}
+
+DCResVoid dc_da_open_file(DCDynArr* darr, string path)
+{
+    DC_RES_void();
+
+    if (!darr || !path)
+    {
+        dc_dbg_log("got NULL DCDynArr or path");
+
+        dc_ret_e(1, "got NULL DCDynArr or path");
+    }
+
+#ifdef __DC_DA_MMAP
+    __DCDaFile* file = (__DCDaFile*)malloc(sizeof(__DCDaFile));
+    if (file == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    file->map = NULL;
+    file->heap = NULL;
+    file->heap_fd = -1;
+
+    string heap_path = NULL;
+    dc_try_or_fail_with3(DCResUsize, path_res, dc_sprintf(&heap_path, "%s.heap", path), { free(file); });
+
+    file->fd = open(path, O_RDWR | O_CREAT, 0644);
+    if (file->fd >= 0) file->heap_fd = open(heap_path, O_RDWR | O_CREAT, 0644);
+
+    free(heap_path);
+
+    struct stat file_stat;
+    struct stat heap_stat;
+
+    if (file->fd < 0 || file->heap_fd < 0 || fstat(file->fd, &file_stat) != 0 || fstat(file->heap_fd, &heap_stat) != 0)
+    {
+        int code = errno;
+
+        dc_dbg_log("Cannot open file '%s': (code %d) %s", path, code, strerror(code));
+
+        __dc_da_file_close(file);
+
+        dc_ret_ea(code, "%s", strerror(code));
+    }
+
+    // A brand new file starts with a header and the default capacity
+    b1 is_new = file_stat.st_size == 0;
+
+    file->map_size = is_new ? __dc_da_file_map_size(DC_DA_INITIAL_CAP) : (usize)file_stat.st_size;
+
+    if (is_new && ftruncate(file->fd, (off_t)file->map_size) != 0)
+    {
+        int code = errno;
+
+        dc_dbg_log("Cannot resize the backing file: (code %d) %s", code, strerror(code));
+
+        __dc_da_file_close(file);
+
+        dc_ret_ea(code, "%s", strerror(code));
+    }
+
+    if (file->map_size < sizeof(__DCDaFileHeader))
+    {
+        dc_dbg_log("'%s' is not a dynamic array file", path);
+
+        __dc_da_file_close(file);
 
-    // Add the new element with its type and value
-    darr->elements[darr->count] = value;
-    darr->count++;
+        dc_ret_e(3, "not a dynamic array file");
+    }
 
-    dc_ret();
-}
+    voidptr mapped = mmap(NULL, file->map_size, PROT_READ | PROT_WRITE, MAP_SHARED, file->fd, 0);
+    voidptr heap = mmap(NULL, DC_DA_FILE_HEAP_RESERVE, PROT_READ | PROT_WRITE, MAP_SHARED, file->heap_fd, 0);
 
-DCResVoid __dc_da_append_values(DCDynArr* darr, usize count, DCDynVal values[])
-{
-    DC_RES_void();
+    file->map = mapped == MAP_FAILED ? NULL : (u8*)mapped;
+    file->heap = heap == MAP_FAILED ? NULL : (char*)heap;
 
-    if (!darr)
+    if (file->map == NULL || file->heap == NULL)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        dc_dbg_log("Memory mapping failed");
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        __dc_da_file_close(file);
+
+        dc_ret_e(2, "Memory mapping failed");
     }
 
-    if ((count + darr->count) > darr->cap) dc_try_fail(dc_da_grow_to(darr, count + darr->count));
+    __DCDaFileHeader* header = (__DCDaFileHeader*)file->map;
 
-    for (usize i = 0; i < count; ++i)
+    if (is_new)
     {
-        dc_try_fail(dc_da_push(darr, values[i]));
+        memcpy(header->magic, __DC_DA_FILE_MAGIC, sizeof(header->magic));
+        header->version = __DC_DA_FILE_VERSION;
+        header->count = 0;
+        header->elem_size = sizeof(DCDynVal);
+        header->heap_used = 0;
+        header->heap_base = (u64)(uptr)file->heap;
     }
 
-    dc_ret();
-}
-
-DCResVoid dc_da_append(DCDynArr* darr, DCDynArr* from)
-{
-    DC_RES_void();
+    usize file_cap = (file->map_size - sizeof(__DCDaFileHeader)) / sizeof(DCDynVal);
 
-    if (!darr || !from)
+    // Element layout depends on the build (e.g. `DC_DV_COMPACT`), so does the file
+    if (memcmp(header->magic, __DC_DA_FILE_MAGIC, sizeof(header->magic)) != 0 || header->version != __DC_DA_FILE_VERSION ||
+        header->elem_size != sizeof(DCDynVal) || header->count > file_cap || header->heap_used > (u64)heap_stat.st_size)
     {
-        dc_dbg_log("got NULL DCDynArr");
+        dc_dbg_log("'%s' is not a compatible dynamic array file", path);
 
-        dc_ret_e(1, "got NULL DCDynArr");
+        __dc_da_file_close(file);
+
+        dc_ret_e(3, "not a compatible dynamic array file");
     }
 
-    dc_try_fail(__dc_da_append_values(darr, from->count, from->elements));
+    file->heap_size = (usize)heap_stat.st_size;
+    file->heap_used = (usize)header->heap_used;
 
-    dc_ret();
-}
+    darr->count = (usize)header->count;
+    darr->multiplier = DC_DA_CAP_MULTIPLIER;
 
-DCResPtr dc_da_get(DCDynArr* darr, usize index)
-{
-    DC_RES_dv();
+    darr->element_free_fn = NULL;
 
-    if (!darr)
-    {
-        dc_dbg_log("got NULL DCDynArr");
+    darr->growth = DC_DA_GROW_MULTIPLIER;
+    darr->growth_factor = (f32)DC_DA_CAP_MULTIPLIER;
 
-        dc_ret_e(1, "got NULL DCDynArr");
-    }
+    file->backing = (DCDynArrBacking){DC_DA_STORAGE_FILE, file};
+    darr->backing = &file->backing;
 
-    if (index >= darr->count)
-    {
-        dc_dbg_log("Index out of bound - try to get index='" dc_fmt(usize) "' out of actual '" dc_fmt(usize) "' elements.",
-                   index, darr->count);
+    __dc_da_file_attach(darr, file);
 
-        dc_ret_e(4, "Index out of bound");
-    }
+    __dc_da_file_relocate(darr, file, (uptr)header->heap_base);
+    header->heap_base = (u64)(uptr)file->heap;
 
-    dc_ret_ok(&darr->elements[index]);
+    dc_try_fail_temp(DCResUsize, dc_da_update_owned(darr));
+
+    dc_ret();
+#else
+    dc_dbg_log("file backed dynamic arrays are not supported on this platform");
+
+    dc_ret_e(5, "file backed dynamic arrays are not supported on this platform");
+#endif
 }
 
-DCResUsize dc_da_find2(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn)
+DCResVoid dc_da_sync(DCDynArr* darr)
 {
-    DC_RES_usize();
+    DC_RES_void();
 
     if (!darr)
     {
@@ -401,81 +1654,38 @@ DCResUsize dc_da_find2(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn)
         dc_ret_e(1, "got NULL DCDynArr");
     }
 
-#define find_if(TYPE, INDEX)                                                                                                   \
-    case dc_dvt(TYPE):                                                                                                         \
-        if (element->value.dc_dvf(TYPE) == el->value.dc_dvf(TYPE)) dc_ret_ok(INDEX);                                           \
-        break
-
-    for (usize i = 0; i < darr->count; i++)
+    if (dc_da_storage(*darr) != DC_DA_STORAGE_FILE)
     {
-        DCDynVal* element = &darr->elements[i];
-        if (element->type != el->type)
-        {
-            continue; // Skip if the type doesn't match
-        }
-
-        // check the actual value based on the type
-        switch (el->type)
-        {
-            find_if(i8, i);
-            find_if(i16, i);
-            find_if(i32, i);
-            find_if(i64, i);
-
-            find_if(u8, i);
-            find_if(u16, i);
-            find_if(u32, i);
-            find_if(u64, i);
-
-            find_if(f32, i);
-            find_if(f64, i);
-
-            find_if(uptr, i);
-            find_if(char, i);
-
-            case dc_dvt(string):
-            {
-                if (strcmp(dc_dv_as(*element, string), dc_dv_as(*el, string)) == 0) dc_ret_ok(i);
-                break;
-            }
+        dc_dbg_log("dynamic array is not file backed");
 
-                // clang-format off
-            find_if(voidptr, i);
-            find_if(fileptr, i);
-            find_if(size, i);
-            find_if(usize, i);
-
-            case dc_dvt(DCStringView):
-            {
-                if (dc_dv_as(*element, DCStringView).str && dc_dv_as(*el, DCStringView).str 
-                && (dc_dv_as(*element, DCStringView).str == dc_dv_as(*el, DCStringView).str) 
-                && (dc_dv_as(*element, DCStringView).len == dc_dv_as(*el, DCStringView).len)) dc_ret_ok(i);
+        dc_ret_e(3, "dynamic array is not file backed");
+    }
 
-                break;
-            }
-                // clang-format on
+#ifdef __DC_DA_MMAP
+    __DCDaFile* file = (__DCDaFile*)darr->backing->data;
+    __DCDaFileHeader* header = (__DCDaFileHeader*)file->map;
 
-            default:
-                if (dv_eq_fn)
-                {
-                    dc_try_or_fail_with3(DCResBool, cmp_res, dv_eq_fn(element, el), {});
+    // Payloads go first so the header never points past what's on disk
+    if (file->heap_size > 0 && msync(file->heap, file->heap_size, MS_SYNC) != 0)
+    {
+        dc_dbg_log("Cannot sync the side heap file: (code %d) %s", errno, strerror(errno));
 
-                    if (dc_unwrap2(cmp_res) == true) dc_ret_ok(i);
-                }
-                break;
-        }
+        dc_ret_ea(errno, "%s", strerror(errno));
     }
 
-#undef find_if
+    header->count = darr->count;
+    header->heap_used = file->heap_used;
+    header->heap_base = (u64)(uptr)file->heap;
 
-    dc_dbg_log("Not Found");
+    if (msync(file->map, file->map_size, MS_SYNC) != 0)
+    {
+        dc_dbg_log("Cannot sync the backing file: (code %d) %s", errno, strerror(errno));
 
-    dc_ret_e(6, "Not Found");
-}
+        dc_ret_ea(errno, "%s", strerror(errno));
+    }
+#endif
 
-DCResUsize dc_da_find(DCDynArr* darr, DCDynVal el, DCDvEqFn dv_eq_fn)
-{
-    return dc_da_find2(darr, &el, dv_eq_fn);
+    dc_ret();
 }
 
 DCResVoid dc_da_free(DCDynArr* darr)
@@ -484,16 +1694,36 @@ DCResVoid dc_da_free(DCDynArr* darr)
 
     if (!darr) dc_ret();
 
-    for (usize i = 0; i < darr->count; ++i)
+    // Nothing to release per element, only the storage itself
+    if (dc_da_has_owned(*darr))
     {
-        dc_try_fail_temp(DCResVoid, dc_dv_free(&darr->elements[i], darr->element_free_fn));
+        for (usize i = 0; i < darr->count; ++i)
+        {
+            dc_try_fail_temp(DCResVoid, __dc_da_free_element(darr, &darr->elements[i]));
+        }
     }
 
-    free(darr->elements);
+    DCDynArrStorage storage = dc_da_storage(*darr);
+
+    if (storage == DC_DA_STORAGE_HEAP)
+        free(darr->elements);
+    else if (storage == DC_DA_STORAGE_MMAP)
+        dc_try_fail(__dc_da_resize(darr, 0));
+#ifdef __DC_DA_MMAP
+    else if (storage == DC_DA_STORAGE_FILE)
+    {
+        // The file is closed even if syncing fails, the error is returned at the end
+        dc_try(dc_da_sync(darr));
+
+        __dc_da_file_close((__DCDaFile*)darr->backing->data);
+    }
+#endif
 
     darr->elements = NULL;
     darr->cap = 0;
     darr->count = 0;
+    darr->owned_count = 0;
+    darr->backing = NULL;
 
     dc_ret();
 }
@@ -532,7 +1762,7 @@ DCResVoid dc_da_delete(DCDynArr* darr, usize index)
     }
 
     // Free the element at the specified index
-    dc_try_fail_temp(DCResVoid, dc_dv_free(&darr->elements[index], darr->element_free_fn));
+    if (dc_da_has_owned(*darr)) dc_try_fail_temp(DCResVoid, __dc_da_free_element(darr, &darr->elements[index]));
 
     // Shift the elements after the deleted one to fill the gap
     memmove(&darr->elements[index], &darr->elements[index + 1], (darr->count - index - 1) * sizeof(DCDynVal));
@@ -542,6 +1772,108 @@ DCResVoid dc_da_delete(DCDynArr* darr, usize index)
     dc_ret();
 }
 
+DCResVoid dc_da_delete_range(DCDynArr* darr, usize start_index, usize count)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (start_index > darr->count || count > darr->count - start_index)
+    {
+        dc_dbg_log("Index out of bound - try to delete '" dc_fmt(usize) "' elements from index='" dc_fmt(
+                       usize) "' out of actual '" dc_fmt(usize) "' elements.",
+                   count, start_index, darr->count);
+
+        dc_ret_e(4, "Index out of bound");
+    }
+
+    if (count == 0) dc_ret();
+
+    usize end_index = start_index + count;
+
+    for (usize i = start_index; i < end_index && dc_da_has_owned(*darr); ++i)
+    {
+        dc_try(__dc_da_free_element(darr, &darr->elements[i]));
+
+        if (dc_is_err())
+        {
+            // Drop what has already been freed so the array never holds dangling values
+            end_index = i + 1;
+            break;
+        }
+    }
+
+    // One shift for the whole range
+    memmove(&darr->elements[start_index], &darr->elements[end_index], (darr->count - end_index) * sizeof(DCDynVal));
+
+    darr->count -= end_index - start_index;
+
+    dc_ret();
+}
+
+DCResUsize dc_da_retain(DCDynArr* darr, DCDvPredicateFn predicate)
+{
+    DC_RES_usize();
+
+    if (!darr || !predicate)
+    {
+        dc_dbg_log("got NULL DCDynArr or predicate");
+
+        dc_ret_e(1, "got NULL DCDynArr or predicate");
+    }
+
+    usize write_index = 0;
+    usize read_index = 0;
+
+    for (; read_index < darr->count; ++read_index)
+    {
+        DCDynVal* element = &darr->elements[read_index];
+
+        DCResBool keep_res = predicate(element);
+
+        if (dc_is_err2(keep_res))
+        {
+            dc_err_cpy(keep_res);
+            break;
+        }
+
+        if (dc_unwrap2(keep_res))
+        {
+            if (write_index != read_index) darr->elements[write_index] = *element;
+
+            write_index++;
+            continue;
+        }
+
+        DCResVoid free_res = __dc_da_free_element(darr, element);
+
+        if (dc_is_err2(free_res))
+        {
+            // The element is already (partially) released so it doesn't survive
+            dc_err_cpy(free_res);
+            read_index++;
+            break;
+        }
+    }
+
+    usize removed = read_index - write_index;
+
+    // In case of an error the unvisited tail must be kept intact
+    if (removed > 0 && read_index < darr->count)
+        memmove(&darr->elements[write_index], &darr->elements[read_index], (darr->count - read_index) * sizeof(DCDynVal));
+
+    darr->count -= removed;
+
+    dc_fail_if_err();
+
+    dc_ret_ok(removed);
+}
+
 DCResVoid dc_da_delete_elp(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn)
 {
     DC_RES_void();
@@ -586,8 +1918,12 @@ DCResVoid dc_da_insert(DCDynArr* darr, usize index, DCDynVal value)
         dc_ret_e(4, "Index out of bound");
     }
 
+    dc_try_fail(__dc_da_file_check(darr, &value, 1));
+
     if (darr->count >= darr->cap) dc_try_fail_temp(DCResVoid, dc_da_grow(darr));
 
+    dc_try_or_fail_with3(DCResUsize, heap_offset, __dc_da_file_store(darr, &value, 1), {});
+
     // No need to memmove if inserting at the end
     if (index < darr->count)
     {
@@ -595,10 +1931,14 @@ DCResVoid dc_da_insert(DCDynArr* darr, usize index, DCDynVal value)
         memmove(&darr->elements[index + 1], &darr->elements[index], (darr->count - index) * sizeof(DCDynVal));
     }
 
+    __dc_da_track_values(darr, &value, 1);
+
     // Add the new value at the desired index
     darr->elements[index] = value;
     darr->count++;
 
+    __dc_da_file_adopt(darr, index, 1, dc_unwrap2(heap_offset));
+
     dc_ret();
 }
 
@@ -621,23 +1961,30 @@ DCResVoid __dc_da_insert_values(DCDynArr* darr, usize start_index, usize count,
         dc_ret_e(4, "Index out of bound");
     }
 
-    if ((count + darr->count) > darr->cap) dc_try_fail_temp(DCResVoid, dc_da_grow_to(darr, count + darr->count));
+    if (count == 0) dc_ret();
+
+    dc_try_fail(__dc_da_file_check(darr, values, count));
+
+    dc_try_fail(__dc_da_reserve(darr, darr->count + count));
+
+    dc_try_or_fail_with3(DCResUsize, heap_offset, __dc_da_file_store(darr, values, count), {});
 
     // No need to memmove if inserting at the end
     if (start_index < darr->count)
     {
-        // Shift elements starting from index to index + 1
+        // Shift elements starting from index to index + count
         memmove(&darr->elements[start_index + count], &darr->elements[start_index],
                 (darr->count - start_index) * sizeof(DCDynVal));
     }
 
-    for (usize i = 0; i < count; ++i)
-    {
-        darr->elements[start_index + i] = values[i];
-    }
+    __dc_da_track_values(darr, values, count);
+
+    memcpy(&darr->elements[start_index], values, count * sizeof(DCDynVal));
 
     darr->count += count;
 
+    __dc_da_file_adopt(darr, start_index, count, dc_unwrap2(heap_offset));
+
     dc_ret();
 }
 
@@ -746,3 +2093,142 @@ DCResUsize dc_DCStringView_da_to_flat_arr(DCDynArr* arr, DCStringView** out_arr,
 {
     __DC_DA_CONVERT_IMPL(DCStringView);
 }
+
+DCResUsize dc_i8_dav_to_flat_arr(DCDynArrView* arr, i8** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(i8);
+}
+
+DCResUsize dc_i16_dav_to_flat_arr(DCDynArrView* arr, i16** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(i16);
+}
+
+DCResUsize dc_i32_dav_to_flat_arr(DCDynArrView* arr, i32** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(i32);
+}
+
+DCResUsize dc_i64_dav_to_flat_arr(DCDynArrView* arr, i64** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(i64);
+}
+
+DCResUsize dc_u8_dav_to_flat_arr(DCDynArrView* arr, u8** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(u8);
+}
+
+DCResUsize dc_u16_dav_to_flat_arr(DCDynArrView* arr, u16** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(u16);
+}
+
+DCResUsize dc_u32_dav_to_flat_arr(DCDynArrView* arr, u32** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(u32);
+}
+
+DCResUsize dc_u64_dav_to_flat_arr(DCDynArrView* arr, u64** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(u64);
+}
+
+DCResUsize dc_f32_dav_to_flat_arr(DCDynArrView* arr, f32** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(f32);
+}
+
+DCResUsize dc_f64_dav_to_flat_arr(DCDynArrView* arr, f64** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(f64);
+}
+
+DCResUsize dc_uptr_dav_to_flat_arr(DCDynArrView* arr, uptr** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(uptr);
+}
+
+DCResUsize dc_char_dav_to_flat_arr(DCDynArrView* arr, char** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(char);
+}
+
+DCResUsize dc_size_dav_to_flat_arr(DCDynArrView* arr, size** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(size);
+}
+
+DCResUsize dc_usize_dav_to_flat_arr(DCDynArrView* arr, usize** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(usize);
+}
+
+DCResUsize dc_string_dav_to_flat_arr(DCDynArrView* arr, string** out_arr, b1 must_fail)
+{
+    DC_RES_usize();
+
+    if (!arr || arr->count == 0 || !out_arr)
+    {
+        dc_dbg_log("arr is empty or not provided/initialized or out_var is not provided");
+
+        dc_ret_e(1, "arr is empty or not provided/initialized or out_var is not provided");
+    }
+
+    *out_arr = (string*)malloc((arr->count + 1) * sizeof(string));
+    if (!(*out_arr))
+    {
+        dc_dbg_log("memory allocation failed");
+
+        dc_ret_e(2, "memory allocation failed");
+    }
+
+    usize dest_index = 0;
+    for (usize i = 0; i < arr->count; ++i)
+    {
+        DCDynVal* elem = dc_dav_get(*arr, i);
+
+        // Inline strings are exported as pointers to their characters
+        if (elem->type == dc_dvt(DCInlineStr))
+        {
+            (*out_arr)[dest_index++] = dc_dv_istr_str(*elem);
+            continue;
+        }
+
+        if (elem->type != dc_dvt(string))
+        {
+            if (must_fail)
+            {
+                free(*out_arr);
+                *out_arr = NULL;
+
+                dc_dbg_log("failed as it got type other than 'string'");
+
+                dc_ret_e(3, "failed as it got type other than 'string'");
+            }
+
+            continue;
+        }
+
+        (*out_arr)[dest_index++] = dc_dv_as(*elem, string);
+    }
+
+    (*out_arr)[dest_index] = dc_stopper(string);
+
+    dc_ret_ok(dest_index);
+}
+
+DCResUsize dc_voidptr_dav_to_flat_arr(DCDynArrView* arr, voidptr** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(voidptr);
+}
+
+DCResUsize dc_fileptr_dav_to_flat_arr(DCDynArrView* arr, fileptr** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(fileptr);
+}
+
+DCResUsize dc_DCStringView_dav_to_flat_arr(DCDynArrView* arr, DCStringView** out_arr, b1 must_fail)
+{
+    __DC_DAV_CONVERT_IMPL(DCStringView);
+}
@@ -0,0 +1,462 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _da_par.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for parallel dynamic array
+// *               functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_da_par.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Runs task number `index` out of an array of tasks
+ */
+typedef void (*__DCDaParTaskFn)(voidptr tasks, usize index);
+
+typedef struct
+{
+    __DCDaParTaskFn fn;
+    voidptr tasks;
+    usize task_count;
+    usize first;
+    usize stride;
+} __DCDaParWorker;
+
+/**
+ * Copies the first error of the given tasks into the main result variable
+ * (__dc_res) and frees the rest, tasks are checked in order so the reported
+ * error doesn't depend on thread scheduling
+ */
+#define __dc_da_par_collect_errors(TASKS, COUNT)                                                                               \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        for (usize __i = 0; __i < (COUNT); ++__i)                                                                              \
+        {                                                                                                                      \
+            if (dc_is_ok2((TASKS)[__i].result)) continue;                                                                      \
+                                                                                                                               \
+            if (dc_is_ok())                                                                                                    \
+                dc_err_cpy((TASKS)[__i].result);                                                                               \
+            else                                                                                                               \
+                dc_result_free(&(TASKS)[__i].result);                                                                          \
+        }                                                                                                                      \
+    } while (0)
+
+static void __dc_da_par_work(__DCDaParWorker* worker)
+{
+    for (usize i = worker->first; i < worker->task_count; i += worker->stride) worker->fn(worker->tasks, i);
+}
+
+static __DC_THREAD_FN_DECL(__dc_da_par_thread_main)
+{
+    __dc_da_par_work((__DCDaParWorker*)_arg);
+
+    __DC_THREAD_FN_RET();
+}
+
+/**
+ * Runs all the tasks using up to `thread_count` threads (including the calling
+ * thread), worker `w` runs tasks `w`, `w + thread_count`, ...
+ *
+ * NOTE: If threads can't be created the remaining work is done on the calling
+ * thread, so all the tasks are always run
+ *
+ * NOTE: There is no pool, the threads are joined before returning so nothing
+ * is left running between calls and callers on different threads never share
+ * any state
+ */
+static void __dc_da_par_run(__DCDaParTaskFn fn, voidptr tasks, usize task_count, usize thread_count)
+{
+    if (thread_count > task_count) thread_count = task_count;
+
+    __DCDaParWorker* workers = thread_count > 1 ? malloc(thread_count * sizeof(__DCDaParWorker)) : NULL;
+    __DCThread* threads = workers ? malloc((thread_count - 1) * sizeof(__DCThread)) : NULL;
+
+    if (!workers || !threads)
+    {
+        free(workers);
+
+        for (usize i = 0; i < task_count; ++i) fn(tasks, i);
+
+        return;
+    }
+
+    for (usize w = 0; w < thread_count; ++w) workers[w] = (__DCDaParWorker){fn, tasks, task_count, w, thread_count};
+
+    usize started = 0;
+    for (; started < thread_count - 1; ++started)
+    {
+        if (!__dc_thread_start(&threads[started], __dc_da_par_thread_main, &workers[started + 1])) break;
+    }
+
+    __dc_da_par_work(&workers[0]);
+
+    for (usize w = started + 1; w < thread_count; ++w) __dc_da_par_work(&workers[w]);
+
+    for (usize i = 0; i < started; ++i) __dc_thread_join(threads[i]);
+
+    free(threads);
+    free(workers);
+}
+
+/**
+ * Decides how many chunks (one per thread) the array is split into
+ *
+ * NOTE: Chunk sizes are multiples of the number of elements in a cache line so
+ * that threads don't write to the same cache lines
+ */
+static usize __dc_da_par_split(usize count, usize thread_count, usize* out_chunk_size)
+{
+    if (thread_count == 0) thread_count = dc_cpu_count();
+
+    usize max_chunks = count / DC_DA_PAR_MIN_CHUNK;
+    if (max_chunks == 0) max_chunks = 1;
+
+    usize chunk_count = thread_count < max_chunks ? thread_count : max_chunks;
+
+    usize per_line = DC_CACHE_LINE_SIZE / sizeof(DCDynVal);
+    if (per_line == 0) per_line = 1;
+
+    usize chunk_size = (count + chunk_count - 1) / chunk_count;
+    chunk_size = ((chunk_size + per_line - 1) / per_line) * per_line;
+
+    *out_chunk_size = chunk_size;
+
+    return (count + chunk_size - 1) / chunk_size;
+}
+
+// ***************************************************************************************
+// * PARALLEL FOR
+// ***************************************************************************************
+
+typedef struct
+{
+    DCDynVal* elements;
+    usize start;
+    usize end;
+
+    DCDaVisitorFn visitor;
+    voidptr ctx;
+
+    DCResVoid result;
+} __DCDaParForTask;
+
+static void __dc_da_par_for_task(voidptr tasks, usize index)
+{
+    __DCDaParForTask* task = &((__DCDaParForTask*)tasks)[index];
+
+    task->result = (DCResVoid){.status = DC_RES_OK};
+
+    for (usize i = task->start; i < task->end; ++i)
+    {
+        task->result = task->visitor(&task->elements[i], i, task->ctx);
+
+        if (dc_is_err2(task->result)) break;
+    }
+}
+
+DCResVoid dc_da_par_for(DCDynArr* darr, DCDaVisitorFn visitor, voidptr ctx, usize thread_count)
+{
+    DC_RES_void();
+
+    if (!darr || !visitor)
+    {
+        dc_dbg_log("got NULL DCDynArr or visitor");
+
+        dc_ret_e(1, "got NULL DCDynArr or visitor");
+    }
+
+    if (darr->count == 0) dc_ret();
+
+    usize chunk_size;
+    usize chunk_count = __dc_da_par_split(darr->count, thread_count, &chunk_size);
+
+    __DCDaParForTask* tasks = malloc(chunk_count * sizeof(__DCDaParForTask));
+    if (tasks == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    for (usize i = 0; i < chunk_count; ++i)
+    {
+        usize start = i * chunk_size;
+        usize end = start + chunk_size < darr->count ? start + chunk_size : darr->count;
+
+        tasks[i] = (__DCDaParForTask){darr->elements, start, end, visitor, ctx, {.status = DC_RES_OK}};
+    }
+
+    __dc_da_par_run(__dc_da_par_for_task, tasks, chunk_count, chunk_count);
+
+    __dc_da_par_collect_errors(tasks, chunk_count);
+
+    free(tasks);
+
+    dc_ret();
+}
+
+// ***************************************************************************************
+// * PARALLEL SORT
+// ***************************************************************************************
+
+typedef struct
+{
+    DCDynArr chunk;
+    DCDvCmpFn cmp_fn;
+
+    DCResVoid result;
+} __DCDaParSortTask;
+
+static void __dc_da_par_sort_task(voidptr tasks, usize index)
+{
+    __DCDaParSortTask* task = &((__DCDaParSortTask*)tasks)[index];
+
+    task->result = dc_da_sort_stable(&task->chunk, task->cmp_fn);
+}
+
+/**
+ * Part of merging two sorted runs `a` and `b` into `dst`, each part produces
+ * output positions [d_start, d_end) so all the threads can work on a single
+ * merge
+ */
+typedef struct
+{
+    DCDynVal* a;
+    usize a_count;
+    DCDynVal* b;
+    usize b_count;
+    DCDynVal* dst;
+
+    usize d_start;
+    usize d_end;
+
+    DCDvCmpFn cmp_fn;
+
+    DCResVoid result;
+} __DCDaParMergeTask;
+
+/**
+ * Finds how many elements of `a` come before output position `d` in a stable
+ * merge of `a` and `b` (ties are taken from `a` first)
+ *
+ * @return number of elements from `a` or error
+ */
+static DCResUsize __dc_da_par_co_rank(__DCDaParMergeTask* task, usize d)
+{
+    DC_RES_usize();
+
+    usize lo = d > task->b_count ? d - task->b_count : 0;
+    usize hi = d < task->a_count ? d : task->a_count;
+
+    while (lo < hi)
+    {
+        usize i = lo + (hi - lo) / 2;
+        usize j = d - i;
+
+        if (i > 0 && j < task->b_count)
+        {
+            dc_try_or_fail_with3(DCResI32, cmp_res, task->cmp_fn(&task->a[i - 1], &task->b[j]), {});
+
+            if (dc_unwrap2(cmp_res) > 0)
+            {
+                hi = i - 1;
+                continue;
+            }
+        }
+
+        if (j > 0 && i < task->a_count)
+        {
+            dc_try_or_fail_with3(DCResI32, cmp_res, task->cmp_fn(&task->b[j - 1], &task->a[i]), {});
+
+            if (dc_unwrap2(cmp_res) >= 0)
+            {
+                lo = i + 1;
+                continue;
+            }
+        }
+
+        dc_ret_ok(i);
+    }
+
+    dc_ret_ok(lo);
+}
+
+static DCResVoid __dc_da_par_merge_part(__DCDaParMergeTask* task)
+{
+    DC_RES_void();
+
+    dc_try_or_fail_with3(DCResUsize, start_res, __dc_da_par_co_rank(task, task->d_start), {});
+    dc_try_or_fail_with3(DCResUsize, end_res, __dc_da_par_co_rank(task, task->d_end), {});
+
+    usize i = dc_unwrap2(start_res);
+    usize j = task->d_start - i;
+    usize i_end = dc_unwrap2(end_res);
+    usize j_end = task->d_end - i_end;
+
+    DCDynVal* out = &task->dst[task->d_start];
+
+    while (i < i_end && j < j_end)
+    {
+        dc_try_or_fail_with3(DCResI32, cmp_res, task->cmp_fn(&task->b[j], &task->a[i]), {});
+
+        if (dc_unwrap2(cmp_res) < 0)
+            *out++ = task->b[j++];
+        else
+            *out++ = task->a[i++];
+    }
+
+    memcpy(out, &task->a[i], (i_end - i) * sizeof(DCDynVal));
+    out += i_end - i;
+
+    memcpy(out, &task->b[j], (j_end - j) * sizeof(DCDynVal));
+
+    dc_ret();
+}
+
+static void __dc_da_par_merge_task(voidptr tasks, usize index)
+{
+    __DCDaParMergeTask* task = &((__DCDaParMergeTask*)tasks)[index];
+
+    task->result = __dc_da_par_merge_part(task);
+}
+
+DCResVoid dc_da_par_sort(DCDynArr* darr, DCDvCmpFn cmp_fn, usize thread_count)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    usize count = darr->count;
+    if (count < 2) dc_ret();
+
+    usize chunk_size;
+    usize chunk_count = __dc_da_par_split(count, thread_count, &chunk_size);
+
+    if (chunk_count == 1) return dc_da_sort_stable(darr, cmp_fn);
+
+    // Merging uses the same ordering as the sort of each chunk so that the result
+    // is exactly what dc_da_sort_stable gives regardless of the number of threads
+    DCDvCmpFn merge_cmp_fn = cmp_fn ? cmp_fn : dc_dv_cmp;
+
+    __DCDaParSortTask* sort_tasks = malloc(chunk_count * sizeof(__DCDaParSortTask));
+    if (sort_tasks == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    for (usize i = 0; i < chunk_count; ++i)
+    {
+        usize start = i * chunk_size;
+
+        // Chunks are views over the array that never grow, so no allocation is involved
+        DCDynArr chunk = *darr;
+        chunk.elements = &darr->elements[start];
+        chunk.count = start + chunk_size < count ? chunk_size : count - start;
+        chunk.cap = chunk.count;
+
+        sort_tasks[i] = (__DCDaParSortTask){chunk, cmp_fn, {.status = DC_RES_OK}};
+    }
+
+    __dc_da_par_run(__dc_da_par_sort_task, sort_tasks, chunk_count, chunk_count);
+
+    __dc_da_par_collect_errors(sort_tasks, chunk_count);
+
+    free(sort_tasks);
+
+    dc_fail_if_err();
+
+    // Each round merges pairs of neighbor runs, every merge is split among
+    // the threads so no round is left to a single thread
+    usize max_tasks = 2 * chunk_count;
+
+    DCDynVal* buffer = malloc(count * sizeof(DCDynVal));
+    __DCDaParMergeTask* merge_tasks = malloc(max_tasks * sizeof(__DCDaParMergeTask));
+
+    if (buffer == NULL || merge_tasks == NULL)
+    {
+        free(buffer);
+        free(merge_tasks);
+
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    DCDynVal* src = darr->elements;
+    DCDynVal* dst = buffer;
+
+    for (usize run = chunk_size; run < count; run *= 2)
+    {
+        usize pair_count = (count + 2 * run - 1) / (2 * run);
+        usize parts = chunk_count / pair_count;
+        if (parts == 0) parts = 1;
+
+        usize task_count = 0;
+
+        for (usize p = 0; p < pair_count; ++p)
+        {
+            usize lo = p * 2 * run;
+            usize mid = lo + run < count ? lo + run : count;
+            usize hi = mid + run < count ? mid + run : count;
+            usize total = hi - lo;
+
+            for (usize k = 0; k < parts; ++k)
+            {
+                merge_tasks[task_count++] = (__DCDaParMergeTask){
+                    .a = &src[lo],
+                    .a_count = mid - lo,
+                    .b = &src[mid],
+                    .b_count = hi - mid,
+                    .dst = &dst[lo],
+                    .d_start = total * k / parts,
+                    .d_end = total * (k + 1) / parts,
+                    .cmp_fn = merge_cmp_fn,
+                    .result = {.status = DC_RES_OK},
+                };
+            }
+        }
+
+        __dc_da_par_run(__dc_da_par_merge_task, merge_tasks, task_count, chunk_count);
+
+        __dc_da_par_collect_errors(merge_tasks, task_count);
+
+        // Merging never touches the source, so it still holds every element
+        if (dc_is_err()) break;
+
+        DCDynVal* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    if (src != darr->elements) memcpy(darr->elements, src, count * sizeof(DCDynVal));
+
+    free(buffer);
+    free(merge_tasks);
+
+    dc_ret();
+}
+
+#undef __dc_da_par_collect_errors
@@ -0,0 +1,705 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _da_sort.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for sorting dynamic arrays
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_da_sort.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Sub-arrays smaller than this are sorted with insertion sort
+ */
+#define __DC_DA_SORT_SMALL 16
+
+/**
+ * Homogeneous numeric arrays smaller than this don't benefit from radix sort
+ */
+#define __DC_DA_SORT_RADIX_MIN 64
+
+/**
+ * Key and original index of an element, radix sort only moves these around and
+ * the elements are permuted once at the end
+ */
+typedef struct
+{
+    u64 key;
+    usize index;
+} __DCDaSortItem;
+
+#define __dc_da_swap(A, B)                                                                                                     \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        DCDynVal __tmp = (A);                                                                                                  \
+        (A) = (B);                                                                                                             \
+        (B) = __tmp;                                                                                                           \
+    } while (0)
+
+/**
+ * Compares A and B using `cmp_fn` and stores the result in OUT, returns the
+ * error of the comparator if there is any
+ */
+#define __dc_da_cmp(OUT, A, B)                                                                                                 \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        DCResI32 __cmp_res = cmp_fn((A), (B));                                                                                 \
+        dc_ret_if_err2(__cmp_res, {});                                                                                         \
+        (OUT) = dc_unwrap2(__cmp_res);                                                                                         \
+    } while (0)
+
+/**
+ * Maps a f64 to an unsigned key with the same (IEEE total) order
+ */
+static u64 __dc_da_f64_key(f64 value)
+{
+    u64 bits;
+    memcpy(&bits, &value, sizeof(bits));
+
+    u64 mask = (u64)(-(i64)(bits >> 63)) | ((u64)1 << 63);
+
+    return bits ^ mask;
+}
+
+static b1 __dc_da_is_radix_type(DCDynValType type)
+{
+    switch (type)
+    {
+        case dc_dvt(b1):
+        case dc_dvt(i8):
+        case dc_dvt(i16):
+        case dc_dvt(i32):
+        case dc_dvt(i64):
+        case dc_dvt(u8):
+        case dc_dvt(u16):
+        case dc_dvt(u32):
+        case dc_dvt(u64):
+        case dc_dvt(f32):
+        case dc_dvt(f64):
+        case dc_dvt(uptr):
+        case dc_dvt(char):
+        case dc_dvt(size):
+        case dc_dvt(usize):
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Maps a numeric dynamic value to an unsigned key with the same order
+ *
+ * NOTE: Only types accepted by `__dc_da_is_radix_type` are allowed
+ */
+static u64 __dc_da_radix_key(DCDynVal* el)
+{
+#define signed_key(TYPE)                                                                                                       \
+    case dc_dvt(TYPE):                                                                                                         \
+        return (u64)(i64)dc_dv_as(*el, TYPE) ^ ((u64)1 << 63)
+
+#define unsigned_key(TYPE)                                                                                                     \
+    case dc_dvt(TYPE):                                                                                                         \
+        return (u64)dc_dv_as(*el, TYPE)
+
+    switch (el->type)
+    {
+        unsigned_key(b1);
+
+        signed_key(i8);
+        signed_key(i16);
+        signed_key(i32);
+        signed_key(i64);
+
+        unsigned_key(u8);
+        unsigned_key(u16);
+        unsigned_key(u32);
+        unsigned_key(u64);
+
+        case dc_dvt(f32):
+            return __dc_da_f64_key((f64)dc_dv_as(*el, f32));
+
+        case dc_dvt(f64):
+            return __dc_da_f64_key(dc_dv_as(*el, f64));
+
+        unsigned_key(uptr);
+        signed_key(char);
+        signed_key(size);
+        unsigned_key(usize);
+
+        default:
+            return 0;
+    }
+
+#undef signed_key
+#undef unsigned_key
+}
+
+/**
+ * Stable LSD radix sort of the items by their keys, one byte per pass, passes
+ * where all the keys share the same byte are skipped
+ *
+ * NOTE: `buffer` must have room for `count` items, the result might end up
+ * in either `items` or `buffer` and is returned
+ */
+static __DCDaSortItem* __dc_da_radix_sort_items(__DCDaSortItem* items, __DCDaSortItem* buffer, usize count)
+{
+    usize histograms[8][256] = {0};
+
+    for (usize i = 0; i < count; ++i)
+    {
+        u64 key = items[i].key;
+        for (usize b = 0; b < 8; ++b) histograms[b][(key >> (b * 8)) & 0xff]++;
+    }
+
+    __DCDaSortItem* src = items;
+    __DCDaSortItem* dst = buffer;
+
+    for (usize b = 0; b < 8; ++b)
+    {
+        usize shift = b * 8;
+        usize* histogram = histograms[b];
+
+        if (histogram[(src[0].key >> shift) & 0xff] == count) continue;
+
+        usize offset = 0;
+        for (usize d = 0; d < 256; ++d)
+        {
+            usize bucket_count = histogram[d];
+            histogram[d] = offset;
+            offset += bucket_count;
+        }
+
+        for (usize i = 0; i < count; ++i) dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+
+        __DCDaSortItem* tmp = src;
+        src = dst;
+        dst = tmp;
+    }
+
+    return src;
+}
+
+/**
+ * Reorders the elements so that the i'th element becomes the element that was
+ * at `sorted[i].index`
+ *
+ * NOTE: Elements are gathered into a temporary buffer which is much more cache
+ * friendly than following the permutation cycles, cycles are only used when
+ * the buffer can't be allocated (indexes in `sorted` are consumed then)
+ */
+static void __dc_da_apply_order(DCDynVal* elements, __DCDaSortItem* sorted, usize count)
+{
+    DCDynVal* gathered = malloc(count * sizeof(DCDynVal));
+
+    if (gathered)
+    {
+        for (usize i = 0; i < count; ++i) gathered[i] = elements[sorted[i].index];
+
+        memcpy(elements, gathered, count * sizeof(DCDynVal));
+        free(gathered);
+
+        return;
+    }
+
+    for (usize start = 0; start < count; ++start)
+    {
+        if (sorted[start].index == start) continue;
+
+        DCDynVal tmp = elements[start];
+        usize current = start;
+
+        for (;;)
+        {
+            usize next = sorted[current].index;
+            sorted[current].index = current;
+
+            if (next == start)
+            {
+                elements[current] = tmp;
+                break;
+            }
+
+            elements[current] = elements[next];
+            current = next;
+        }
+    }
+}
+
+/**
+ * Sorts given keys (one per element) and reorders the elements accordingly
+ *
+ * NOTE: `items` must have room for 2 * darr->count items, it's freed afterward
+ */
+static void __dc_da_sort_by_items(DCDynArr* darr, __DCDaSortItem* items)
+{
+    __DCDaSortItem* sorted = __dc_da_radix_sort_items(items, items + darr->count, darr->count);
+
+    __dc_da_apply_order(darr->elements, sorted, darr->count);
+
+    free(items);
+}
+
+static DCResVoid __dc_da_radix_sort(DCDynArr* darr)
+{
+    DC_RES_void();
+
+    __DCDaSortItem* items = malloc(2 * darr->count * sizeof(__DCDaSortItem));
+    if (items == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        items[i].key = __dc_da_radix_key(&darr->elements[i]);
+        items[i].index = i;
+    }
+
+    __dc_da_sort_by_items(darr, items);
+
+    dc_ret();
+}
+
+/**
+ * Character of the string element at the given depth, NULL strings are
+ * treated as smaller than any string
+ */
+static i32 __dc_da_str_char(DCDynVal* el, usize depth)
+{
+    string str = dc_dv_as(*el, string);
+
+    return str ? (i32)(unsigned char)str[depth] : -1;
+}
+
+static i32 __dc_da_str_cmp(DCDynVal* el1, DCDynVal* el2, usize depth)
+{
+    string str1 = dc_dv_as(*el1, string);
+    string str2 = dc_dv_as(*el2, string);
+
+    if (!str1 || !str2) return (str1 != NULL) - (str2 != NULL);
+
+    return strcmp(str1 + depth, str2 + depth);
+}
+
+/**
+ * Part of the elements left to be sorted by multikey quicksort
+ */
+typedef struct
+{
+    DCDynVal* elements;
+    usize count;
+    usize depth;
+} __DCDaMkqsPart;
+
+/**
+ * Multikey quicksort (three way radix quicksort) of string elements, all the
+ * elements are known to share their first `depth` characters
+ */
+static void __dc_da_mkqs(DCDynVal* elements, usize count, usize depth)
+{
+    while (count > 1)
+    {
+        if (count < __DC_DA_SORT_SMALL)
+        {
+            for (usize i = 1; i < count; ++i)
+                for (usize j = i; j > 0 && __dc_da_str_cmp(&elements[j - 1], &elements[j], depth) > 0; --j)
+                    __dc_da_swap(elements[j - 1], elements[j]);
+
+            return;
+        }
+
+        __dc_da_swap(elements[0], elements[count / 2]);
+
+        i32 pivot = __dc_da_str_char(&elements[0], depth);
+
+        usize lt = 0;
+        usize i = 1;
+        usize gt = count;
+
+        while (i < gt)
+        {
+            i32 c = __dc_da_str_char(&elements[i], depth);
+
+            if (c < pivot)
+            {
+                __dc_da_swap(elements[lt], elements[i]);
+                lt++;
+                i++;
+            }
+            else if (c > pivot)
+            {
+                gt--;
+                __dc_da_swap(elements[i], elements[gt]);
+            }
+            else
+                i++;
+        }
+
+        // Equal ones either ended (terminator or NULL) or share one more character
+        __DCDaMkqsPart parts[3] = {
+            {.elements = elements, .count = lt, .depth = depth},
+            {.elements = &elements[lt], .count = pivot > 0 ? gt - lt : 0, .depth = depth + 1},
+            {.elements = &elements[gt], .count = count - gt, .depth = depth},
+        };
+
+        // Recursing on the two smaller parts and looping on the biggest one keeps the
+        // stack usage logarithmic even for long shared prefixes
+        usize biggest = 0;
+        for (usize p = 1; p < 3; ++p)
+            if (parts[p].count > parts[biggest].count) biggest = p;
+
+        for (usize p = 0; p < 3; ++p)
+            if (p != biggest) __dc_da_mkqs(parts[p].elements, parts[p].count, parts[p].depth);
+
+        elements = parts[biggest].elements;
+        count = parts[biggest].count;
+        depth = parts[biggest].depth;
+    }
+}
+
+/**
+ * Checks that every element of the array is of the given type before picking a
+ * type specific sort
+ */
+static b1 __dc_da_all_of_type(DCDynArr* darr, DCDynValType type)
+{
+    for (usize i = 0; i < darr->count; ++i)
+        if (darr->elements[i].type != type) return false;
+
+    return true;
+}
+
+/**
+ * Stable insertion sort for small sub-arrays
+ */
+static DCResVoid __dc_da_insertion_sort(DCDynVal* elements, usize count, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    for (usize i = 1; i < count; ++i)
+    {
+        for (usize j = i; j > 0; --j)
+        {
+            i32 order;
+            __dc_da_cmp(order, &elements[j - 1], &elements[j]);
+
+            if (order <= 0) break;
+
+            __dc_da_swap(elements[j - 1], elements[j]);
+        }
+    }
+
+    dc_ret();
+}
+
+static DCResVoid __dc_da_sift_down(DCDynVal* elements, usize root, usize count, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    for (;;)
+    {
+        usize child = root * 2 + 1;
+        if (child >= count) break;
+
+        i32 order;
+
+        if (child + 1 < count)
+        {
+            __dc_da_cmp(order, &elements[child], &elements[child + 1]);
+            if (order < 0) child++;
+        }
+
+        __dc_da_cmp(order, &elements[root], &elements[child]);
+        if (order >= 0) break;
+
+        __dc_da_swap(elements[root], elements[child]);
+        root = child;
+    }
+
+    dc_ret();
+}
+
+static DCResVoid __dc_da_heap_sort(DCDynVal* elements, usize count, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    for (usize i = count / 2; i > 0; --i) dc_try_fail(__dc_da_sift_down(elements, i - 1, count, cmp_fn));
+
+    for (usize end = count - 1; end > 0; --end)
+    {
+        __dc_da_swap(elements[0], elements[end]);
+        dc_try_fail(__dc_da_sift_down(elements, 0, end, cmp_fn));
+    }
+
+    dc_ret();
+}
+
+/**
+ * Quicksort with median of three pivot, falls back to heap sort when the
+ * recursion gets too deep and to insertion sort for small sub-arrays
+ */
+static DCResVoid __dc_da_introsort(DCDynVal* elements, usize count, usize depth_limit, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    while (count > __DC_DA_SORT_SMALL)
+    {
+        if (depth_limit == 0) return __dc_da_heap_sort(elements, count, cmp_fn);
+
+        depth_limit--;
+
+        usize mid = count / 2;
+        i32 order;
+
+        __dc_da_cmp(order, &elements[0], &elements[mid]);
+        if (order > 0) __dc_da_swap(elements[0], elements[mid]);
+
+        __dc_da_cmp(order, &elements[mid], &elements[count - 1]);
+        if (order > 0) __dc_da_swap(elements[mid], elements[count - 1]);
+
+        __dc_da_cmp(order, &elements[0], &elements[mid]);
+        if (order > 0) __dc_da_swap(elements[0], elements[mid]);
+
+        DCDynVal pivot = elements[mid];
+
+        usize i = 0;
+        usize j = count - 1;
+
+        // Bounds are checked as well so that inconsistent comparators can't run off the array
+        for (;;)
+        {
+            for (;;)
+            {
+                __dc_da_cmp(order, &elements[i], &pivot);
+                if (order >= 0 || i == count - 1) break;
+                i++;
+            }
+
+            for (;;)
+            {
+                __dc_da_cmp(order, &pivot, &elements[j]);
+                if (order >= 0 || j == 0) break;
+                j--;
+            }
+
+            if (i >= j) break;
+
+            __dc_da_swap(elements[i], elements[j]);
+            i++;
+            j--;
+        }
+
+        usize left_count = j + 1;
+
+        // Recursing on the smaller part keeps the stack usage logarithmic
+        if (left_count < count - left_count)
+        {
+            dc_try_fail(__dc_da_introsort(elements, left_count, depth_limit, cmp_fn));
+
+            elements = &elements[left_count];
+            count -= left_count;
+        }
+        else
+        {
+            dc_try_fail(__dc_da_introsort(&elements[left_count], count - left_count, depth_limit, cmp_fn));
+
+            count = left_count;
+        }
+    }
+
+    return __dc_da_insertion_sort(elements, count, cmp_fn);
+}
+
+/**
+ * Merges sorted runs [lo, mid) and [mid, hi), only the left run is copied to
+ * the buffer
+ *
+ * NOTE: In case of a comparator error what is left from the buffer is put
+ * back so the array still holds every element exactly once
+ */
+static DCResVoid __dc_da_merge(DCDynVal* elements, DCDynVal* buffer, usize lo, usize mid, usize hi, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    usize left_count = mid - lo;
+
+    memcpy(buffer, &elements[lo], left_count * sizeof(DCDynVal));
+
+    usize left = 0;
+    usize right = mid;
+    usize dest = lo;
+
+    while (left < left_count && right < hi)
+    {
+        DCResI32 cmp_res = cmp_fn(&elements[right], &buffer[left]);
+
+        if (dc_is_err2(cmp_res))
+        {
+            dc_err_cpy(cmp_res);
+            break;
+        }
+
+        // Taking from the left run on ties keeps the sort stable
+        if (dc_unwrap2(cmp_res) < 0)
+            elements[dest++] = elements[right++];
+        else
+            elements[dest++] = buffer[left++];
+    }
+
+    memcpy(&elements[dest], &buffer[left], (left_count - left) * sizeof(DCDynVal));
+
+    dc_ret();
+}
+
+static DCResVoid __dc_da_merge_sort(DCDynVal* elements, usize count, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    for (usize lo = 0; lo < count; lo += __DC_DA_SORT_SMALL)
+    {
+        usize run = count - lo < __DC_DA_SORT_SMALL ? count - lo : __DC_DA_SORT_SMALL;
+        dc_try_fail(__dc_da_insertion_sort(&elements[lo], run, cmp_fn));
+    }
+
+    if (count <= __DC_DA_SORT_SMALL) dc_ret();
+
+    DCDynVal* buffer = malloc(count * sizeof(DCDynVal));
+    if (buffer == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    for (usize width = __DC_DA_SORT_SMALL; width < count; width *= 2)
+    {
+        for (usize lo = 0; lo + width < count; lo += 2 * width)
+        {
+            usize mid = lo + width;
+            usize hi = count - mid < width ? count : mid + width;
+
+            // Already ordered runs need no merging
+            DCResI32 cmp_res = cmp_fn(&elements[mid - 1], &elements[mid]);
+            dc_ret_if_err2(cmp_res, free(buffer));
+
+            if (dc_unwrap2(cmp_res) <= 0) continue;
+
+            dc_try(__dc_da_merge(elements, buffer, lo, mid, hi, cmp_fn));
+            dc_ret_if_err(free(buffer));
+        }
+    }
+
+    free(buffer);
+
+    dc_ret();
+}
+
+DCResVoid dc_da_sort(DCDynArr* darr, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (darr->count < 2) dc_ret();
+
+    DCDynValType type = darr->elements[0].type;
+
+    if (!cmp_fn && __dc_da_all_of_type(darr, type))
+    {
+        if (darr->count >= __DC_DA_SORT_RADIX_MIN && __dc_da_is_radix_type(type)) return __dc_da_radix_sort(darr);
+
+        if (type == dc_dvt(string))
+        {
+            __dc_da_mkqs(darr->elements, darr->count, 0);
+
+            dc_ret();
+        }
+    }
+
+    usize depth_limit = 2 * (64 - dc_clz64(darr->count));
+
+    return __dc_da_introsort(darr->elements, darr->count, depth_limit, cmp_fn ? cmp_fn : dc_dv_cmp);
+}
+
+DCResVoid dc_da_sort_stable(DCDynArr* darr, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    if (!darr)
+    {
+        dc_dbg_log("got NULL DCDynArr");
+
+        dc_ret_e(1, "got NULL DCDynArr");
+    }
+
+    if (darr->count < 2) dc_ret();
+
+    // LSD radix sort is stable by nature
+    DCDynValType type = darr->elements[0].type;
+
+    if (!cmp_fn && darr->count >= __DC_DA_SORT_RADIX_MIN && __dc_da_is_radix_type(type) && __dc_da_all_of_type(darr, type))
+        return __dc_da_radix_sort(darr);
+
+    return __dc_da_merge_sort(darr->elements, darr->count, cmp_fn ? cmp_fn : dc_dv_cmp);
+}
+
+DCResVoid dc_da_sort_by_key(DCDynArr* darr, DCDvKeyFn key_fn)
+{
+    DC_RES_void();
+
+    if (!darr || !key_fn)
+    {
+        dc_dbg_log("got NULL DCDynArr or key function");
+
+        dc_ret_e(1, "got NULL DCDynArr or key function");
+    }
+
+    if (darr->count < 2) dc_ret();
+
+    __DCDaSortItem* items = malloc(2 * darr->count * sizeof(__DCDaSortItem));
+    if (items == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    // Keys are extracted exactly once per element
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        dc_try_or_fail_with3(DCResI64, key_res, key_fn(&darr->elements[i]), free(items));
+
+        items[i].key = (u64)dc_unwrap2(key_res) ^ ((u64)1 << 63);
+        items[i].index = i;
+    }
+
+    __dc_da_sort_by_items(darr, items);
+
+    dc_ret();
+}
+
+#undef __dc_da_swap
+#undef __dc_da_cmp
@@ -0,0 +1,374 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _deque.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for deque (circular buffer)
+// *               functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_deque.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Physical index of the logical element `index`
+ */
+#define __dc_dq_pos(DQ, INDEX) (((DQ)->head + (INDEX)) & ((DQ)->cap - 1))
+
+/**
+ * Copies `count` values into the buffer starting at physical index `pos`,
+ * wrapping around at the end of the buffer (at most two copies)
+ */
+static void __dc_dq_copy_in(DCDeque* dq, usize pos, DCDynVal* values, usize count)
+{
+    usize first = count < dq->cap - pos ? count : dq->cap - pos;
+
+    memcpy(&dq->elements[pos], values, first * sizeof(DCDynVal));
+    if (count > first) memcpy(dq->elements, &values[first], (count - first) * sizeof(DCDynVal));
+}
+
+/**
+ * Copies `count` elements out of the buffer starting at physical index `pos`,
+ * wrapping around at the end of the buffer (at most two copies)
+ */
+static void __dc_dq_copy_out(DCDeque* dq, usize pos, DCDynVal* out, usize count)
+{
+    usize first = count < dq->cap - pos ? count : dq->cap - pos;
+
+    memcpy(out, &dq->elements[pos], first * sizeof(DCDynVal));
+    if (count > first) memcpy(&out[first], dq->elements, (count - first) * sizeof(DCDynVal));
+}
+
+/**
+ * Moves the elements to a new buffer of `new_cap` (a power of two not less than
+ * the current count), the elements are unwrapped so the head becomes zero
+ */
+static DCResVoid __dc_dq_resize(DCDeque* dq, usize new_cap)
+{
+    DC_RES_void();
+
+    DCDynVal* resized = (DCDynVal*)malloc(new_cap * sizeof(DCDynVal));
+    if (resized == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    if (dq->count > 0) __dc_dq_copy_out(dq, dq->head, resized, dq->count);
+
+    if (dq->elements) free(dq->elements);
+
+    dq->elements = resized;
+    dq->cap = new_cap;
+    dq->head = 0;
+
+    dc_ret();
+}
+
+/**
+ * Smallest power of two capacity (not less than `DC_DQ_INITIAL_CAP`) that can
+ * hold `needed` elements
+ */
+static DCResUsize __dc_dq_cap_for(usize needed)
+{
+    DC_RES_usize();
+
+    usize cap = DC_DQ_INITIAL_CAP;
+
+    while (cap < needed)
+    {
+        if (cap > SIZE_MAX / 2 / sizeof(DCDynVal))
+        {
+            dc_dbg_log("requested deque capacity is too big");
+
+            dc_ret_e(2, "requested deque capacity is too big");
+        }
+
+        cap <<= 1;
+    }
+
+    dc_ret_ok(cap);
+}
+
+DCResVoid dc_dq_init(DCDeque* dq, usize capacity, DCDynValFreeFn element_free_fn)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    dq->elements = NULL;
+    dq->cap = 0;
+    dq->head = 0;
+    dq->count = 0;
+    dq->element_free_fn = element_free_fn;
+
+    dc_try_or_fail_with3(DCResUsize, cap_res, __dc_dq_cap_for(capacity), {});
+
+    return __dc_dq_resize(dq, dc_unwrap2(cap_res));
+}
+
+DCResVoid dc_dq_clear(DCDeque* dq)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    return dc_dq_pop_front_values(dq, dq->count, NULL);
+}
+
+DCResVoid dc_dq_free(DCDeque* dq)
+{
+    DC_RES_void();
+
+    if (!dq) dc_ret();
+
+    dc_try_fail(dc_dq_clear(dq));
+
+    if (dq->elements) free(dq->elements);
+
+    dq->elements = NULL;
+    dq->cap = 0;
+    dq->head = 0;
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_reserve(DCDeque* dq, usize capacity)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (capacity <= dq->cap) dc_ret();
+
+    dc_try_or_fail_with3(DCResUsize, cap_res, __dc_dq_cap_for(capacity), {});
+
+    return __dc_dq_resize(dq, dc_unwrap2(cap_res));
+}
+
+DCResVoid dc_dq_push_back(DCDeque* dq, DCDynVal value)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (dq->count == dq->cap) dc_try_fail(dc_dq_reserve(dq, dq->count + 1));
+
+    dq->elements[__dc_dq_pos(dq, dq->count)] = value;
+    dq->count++;
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_push_front(DCDeque* dq, DCDynVal value)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (dq->count == dq->cap) dc_try_fail(dc_dq_reserve(dq, dq->count + 1));
+
+    dq->head = (dq->head - 1) & (dq->cap - 1);
+    dq->elements[dq->head] = value;
+    dq->count++;
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_pop_back(DCDeque* dq, DCDynVal* out_popped)
+{
+    return dc_dq_pop_back_values(dq, 1, out_popped);
+}
+
+DCResVoid dc_dq_pop_front(DCDeque* dq, DCDynVal* out_popped)
+{
+    return dc_dq_pop_front_values(dq, 1, out_popped);
+}
+
+DCResPtr dc_dq_get(DCDeque* dq, usize index)
+{
+    DC_RES_dv();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (index >= dq->count)
+    {
+        dc_dbg_log("Index out of bound");
+
+        dc_ret_e(4, "Index out of bound");
+    }
+
+    dc_ret_ok(&dq->elements[__dc_dq_pos(dq, index)]);
+}
+
+DCResVoid dc_dq_push_back_values(DCDeque* dq, usize count, DCDynVal* values)
+{
+    DC_RES_void();
+
+    if (!dq || (count > 0 && !values))
+    {
+        dc_dbg_log("got NULL DCDeque or values");
+
+        dc_ret_e(1, "got NULL DCDeque or values");
+    }
+
+    if (count == 0) dc_ret();
+
+    if (count > dq->cap - dq->count) dc_try_fail(dc_dq_reserve(dq, dq->count + count));
+
+    __dc_dq_copy_in(dq, __dc_dq_pos(dq, dq->count), values, count);
+    dq->count += count;
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_push_front_values(DCDeque* dq, usize count, DCDynVal* values)
+{
+    DC_RES_void();
+
+    if (!dq || (count > 0 && !values))
+    {
+        dc_dbg_log("got NULL DCDeque or values");
+
+        dc_ret_e(1, "got NULL DCDeque or values");
+    }
+
+    if (count == 0) dc_ret();
+
+    if (count > dq->cap - dq->count) dc_try_fail(dc_dq_reserve(dq, dq->count + count));
+
+    dq->head = (dq->head - count) & (dq->cap - 1);
+    __dc_dq_copy_in(dq, dq->head, values, count);
+    dq->count += count;
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_pop_front_values(DCDeque* dq, usize count, DCDynVal* out_popped)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (count > dq->count)
+    {
+        dc_dbg_log("Try to pop elements more than actual number of elements");
+
+        dc_ret_e(4, "Try to pop elements more than actual number of elements");
+    }
+
+    if (count == 0) dc_ret();
+
+    if (out_popped)
+    {
+        __dc_dq_copy_out(dq, dq->head, out_popped, count);
+
+        dq->head = __dc_dq_pos(dq, count);
+        dq->count -= count;
+
+        dc_ret();
+    }
+
+    for (usize i = 0; i < count; ++i)
+    {
+        DCDynVal* element = &dq->elements[dq->head];
+
+        dq->head = __dc_dq_pos(dq, 1);
+        dq->count--;
+
+        dc_try_fail(dc_dv_free(element, dq->element_free_fn));
+    }
+
+    dc_ret();
+}
+
+DCResVoid dc_dq_pop_back_values(DCDeque* dq, usize count, DCDynVal* out_popped)
+{
+    DC_RES_void();
+
+    if (!dq)
+    {
+        dc_dbg_log("got NULL DCDeque");
+
+        dc_ret_e(1, "got NULL DCDeque");
+    }
+
+    if (count > dq->count)
+    {
+        dc_dbg_log("Try to pop elements more than actual number of elements");
+
+        dc_ret_e(4, "Try to pop elements more than actual number of elements");
+    }
+
+    if (count == 0) dc_ret();
+
+    if (out_popped)
+    {
+        __dc_dq_copy_out(dq, __dc_dq_pos(dq, dq->count - count), out_popped, count);
+
+        dq->count -= count;
+
+        dc_ret();
+    }
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dq->count--;
+
+        dc_try_fail(dc_dv_free(&dq->elements[__dc_dq_pos(dq, dq->count)], dq->element_free_fn));
+    }
+
+    dc_ret();
+}
+
+#undef __dc_dq_pos
@@ -24,6 +24,54 @@
 #include "_headers/general.h"
 #include "_headers/macros.h"
 
+/**
+ * Registered vtables of extra types, the first extra type is at index 0
+ */
+static DCDvVTable __dc_dv_vtables[DC_DV_MAX_EXTRA_TYPES];
+
+#define __dc_dv_vtable_index(TYPE) ((usize)(TYPE) - (usize)DC_DV_LAST_BUILTIN - 1)
+
+DCResVoid dc_dv_register_type(DCDynValType type, const DCDvVTable* vtable)
+{
+    DC_RES_void();
+
+    if (!vtable || !vtable->name)
+    {
+        dc_dbg_log("got NULL vtable or vtable without a name");
+
+        dc_ret_e(1, "got NULL vtable or vtable without a name");
+    }
+
+    if (!dc_dvt_is_extra(type))
+    {
+        dc_dbg_log("built-in dynamic value types cannot be registered: %s", vtable->name);
+
+        dc_ret_e(3, "built-in dynamic value types cannot be registered");
+    }
+
+    if (__dc_dv_vtable_index(type) >= DC_DV_MAX_EXTRA_TYPES)
+    {
+        dc_dbg_log("too many extra types, consider defining DC_DV_MAX_EXTRA_TYPES: %s", vtable->name);
+
+        dc_ret_e(4, "too many extra types, consider defining DC_DV_MAX_EXTRA_TYPES");
+    }
+
+    __dc_dv_vtables[__dc_dv_vtable_index(type)] = *vtable;
+
+    dc_ret();
+}
+
+const DCDvVTable* dc_dv_vtable(DCDynValType type)
+{
+    if (!dc_dvt_is_extra(type) || __dc_dv_vtable_index(type) >= DC_DV_MAX_EXTRA_TYPES) return NULL;
+
+    const DCDvVTable* vtable = &__dc_dv_vtables[__dc_dv_vtable_index(type)];
+
+    return vtable->name ? vtable : NULL;
+}
+
+#undef __dc_dv_vtable_index
+
 string dc_dv_fmt(DCDynVal* dv)
 {
     if (!dv) return "";
@@ -55,10 +103,14 @@ string dc_dv_fmt(DCDynVal* dv)
         dv_fmt_case(usize);
 
         dv_fmt_case(DCStringView);
+        dv_fmt_case(DCDynArrView);
+        dv_fmt_case(DCInlineStr);
 
         dv_fmt_case(DCDynArrPtr);
         dv_fmt_case(DCHashTablePtr);
         dv_fmt_case(DCPairPtr);
+        dv_fmt_case(DCRcPtr);
+        dv_fmt_case(DCSymbolPtr);
         dv_fmt_case(DCDynValPtr);
 
         default:
@@ -98,155 +150,198 @@ string dc_tostr_dvt(DCDynVal* dv)
         dvt_case(usize);
 
         dvt_case(DCStringView);
+        dvt_case(DCDynArrView);
+        dvt_case(DCInlineStr);
 
         dvt_case(DCDynArrPtr);
         dvt_case(DCHashTablePtr);
         dvt_case(DCPairPtr);
+        dvt_case(DCRcPtr);
+        dvt_case(DCSymbolPtr);
 
         dvt_case(DCDynValPtr);
 
         default:
-            return "unknown or unimplemented";
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+
+            return vtable ? vtable->name : "unknown or unimplemented";
+        }
     };
 
 #undef dvt_case
 }
 
-DCResString dc_tostr_dv(DCDynVal* dv)
+/**
+ * Writes elements of the given view as a list
+ */
+static DCResVoid __dc_dv_write_dav(DCStrBuilder* sb, DCDynArrView* view)
 {
-    DC_RES_string();
+    DC_RES_void();
 
-    if (!dv) dc_ret_e(1, "got NULL dynamic value");
+    dc_try_fail(dc_sb_append_char(sb, '['));
 
-#define stringify(TYPE)                                                                                                        \
-    case dc_dvt(TYPE):                                                                                                         \
-        dc_sprintf(&result, dc_dv_fmt(dv), dc_dv_as(*dv, TYPE));                                                               \
-        break
+    for (usize i = 0; i < view->count; ++i)
+    {
+        if (i > 0) dc_try_fail(dc_sb_append(sb, ", ", 2));
 
-    string result = NULL;
+        dc_try_fail(dc_dv_write(sb, dc_dav_get(*view, i)));
+    }
+
+    return dc_sb_append_char(sb, ']');
+}
+
+DCResVoid dc_dv_write(DCStrBuilder* sb, DCDynVal* dv)
+{
+    DC_RES_void();
+
+    if (!sb || !dv) dc_ret_e(1, "got NULL string builder or dynamic value");
+
+#define write_fmt(TYPE)                                                                                                        \
+    case dc_dvt(TYPE):                                                                                                         \
+        return dc_sb_appendf(sb, dc_dv_fmt(dv), dc_dv_as(*dv, TYPE))
 
     switch (dv->type)
     {
-        stringify(u8);
-        stringify(u16);
-        stringify(u32);
-        stringify(u64);
-        stringify(i8);
-        stringify(i16);
-        stringify(i32);
-        stringify(i64);
-        stringify(f32);
-        stringify(f64);
-        stringify(uptr);
-        stringify(char);
-        stringify(string);
-        stringify(voidptr);
-        stringify(fileptr);
-        stringify(size);
-        stringify(usize);
+        write_fmt(u8);
+        write_fmt(u16);
+        write_fmt(u32);
+        write_fmt(u64);
+        write_fmt(i8);
+        write_fmt(i16);
+        write_fmt(i32);
+        write_fmt(i64);
+        write_fmt(f32);
+        write_fmt(f64);
+        write_fmt(uptr);
+        write_fmt(voidptr);
+        write_fmt(fileptr);
+        write_fmt(size);
+        write_fmt(usize);
+
+        case dc_dvt(char):
+            return dc_sb_append_char(sb, dc_dv_as(*dv, char));
+
+        case dc_dvt(string):
+            if (!dc_dv_as(*dv, string)) return dc_sb_append_str(sb, "(null)");
+
+            return dc_sb_append_str(sb, dc_dv_as(*dv, string));
 
         case dc_dvt(DCStringView):
-            dc_sprintf(&result, DCPRIsv, dc_sv_fmt(dc_dv_as(*dv, DCStringView)));
-            break;
+            return dc_sb_append(sb, dc_dv_as(*dv, DCStringView).str, dc_dv_as(*dv, DCStringView).len);
+
+        case dc_dvt(DCInlineStr):
+            return dc_sb_append_str(sb, dc_dv_istr_str(*dv));
+
+        case dc_dvt(DCSymbolPtr):
+            if (!dc_dv_as(*dv, DCSymbolPtr)) return dc_sb_append_str(sb, "(null)");
+
+            return dc_sb_append(sb, dc_dv_symbol_str(*dv), dc_dv_as(*dv, DCSymbolPtr)->len);
+
+        case dc_dvt(b1):
+            return dc_sb_append_str(sb, dc_tostr_bool(dc_dv_as(*dv, b1)));
 
         case dc_dvt(DCHashTablePtr):
         {
-            dc_sprintf(&result, "%s", "{");
-            if (!dc_dv_as(*dv, DCHashTablePtr))
-            {
-                dc_sappend(&result, "%s", "}");
-                break;
-            }
+            dc_try_fail(dc_sb_append_char(sb, '{'));
 
             DCHashTablePtr _ht = dc_dv_as(*dv, DCHashTablePtr);
             usize key_no = 0;
-            for (usize i = 0; i < _ht->cap; ++i)
+            for (usize i = 0; _ht && i < _ht->cap; ++i)
             {
                 DC_HT_GET_AND_DEF_CONTAINER_ROW(darr, *_ht, i);
 
-                dc_da_for(ht_pair_print, *darr, {
-                    dc_try_or_fail_with3(DCResString, pair, dc_tostr_dv(_it), {});
-                    dc_sappend(&result, "%s", dc_unwrap2(pair));
-
-                    free(dc_unwrap2(pair));
+                for (usize j = 0; j < darr->count; ++j)
+                {
+                    if (key_no++ > 0) dc_try_fail(dc_sb_append(sb, ", ", 2));
 
-                    if (key_no < _ht->key_count - 1) dc_sappend(&result, "%s", ", ");
-                    ++key_no;
-                });
+                    dc_try_fail(dc_dv_write(sb, &darr->elements[j]));
+                }
             }
 
-            dc_sappend(&result, "%s", "}");
-
-            break;
+            return dc_sb_append_char(sb, '}');
         }
 
         case dc_dvt(DCDynArrPtr):
         {
-            dc_sprintf(&result, "%s", "[");
-            if (!dc_dv_as(*dv, DCDynArrPtr))
-            {
-                dc_sappend(&result, "%s", "]");
-                break;
-            }
-
-            DCDynArrPtr _darr = dc_dv_as(*dv, DCDynArrPtr);
-            dc_da_for(da_print_elements, *_darr, {
-                dc_try_or_fail_with3(DCResString, item, dc_tostr_dv(_it), {});
-                dc_sappend(&result, "%s", dc_unwrap2(item));
-
-                free(dc_unwrap2(item));
+            if (!dc_dv_as(*dv, DCDynArrPtr)) return dc_sb_append(sb, "[]", 2);
 
-                if (_idx < _darr->count - 1) dc_sappend(&result, "%s", ", ");
-            });
-
-            dc_sappend(&result, "%s", "]");
-
-            break;
+            DCDynArrView _view = dc_da_as_view(*dc_dv_as(*dv, DCDynArrPtr));
+            return __dc_dv_write_dav(sb, &_view);
         }
 
+        case dc_dvt(DCDynArrView):
+            return __dc_dv_write_dav(sb, &dc_dv_as(*dv, DCDynArrView));
+
         case dc_dvt(DCPairPtr):
         {
             DCPairPtr _pair = dc_dv_as(*dv, DCPairPtr);
-            dc_try_or_fail_with3(DCResString, first, dc_tostr_dv(&_pair->first), {});
-            dc_try_or_fail_with3(DCResString, second, dc_tostr_dv(&_pair->second), { free(dc_unwrap2(first)); });
-
-            dc_sappend(&result, "(%s, %s)", dc_unwrap2(first), dc_unwrap2(second));
+            if (!_pair) return dc_sb_append_str(sb, "(null)");
 
-            free(dc_unwrap2(first));
-            free(dc_unwrap2(second));
+            dc_try_fail(dc_sb_append_char(sb, '('));
+            dc_try_fail(dc_dv_write(sb, &_pair->first));
+            dc_try_fail(dc_sb_append(sb, ", ", 2));
+            dc_try_fail(dc_dv_write(sb, &_pair->second));
 
-            break;
+            return dc_sb_append_char(sb, ')');
         }
 
-        case dc_dvt(b1):
-            dc_sappend(&result, "%s", dc_tostr_bool(dc_dv_as(*dv, b1)));
-            break;
+        case dc_dvt(DCRcPtr):
+        {
+            if (!dc_dv_as(*dv, DCRcPtr)) return dc_sb_append_str(sb, "(null)");
+
+            DCDynVal _shared = dc_rc_dv(dc_dv_as(*dv, DCRcPtr));
+            return dc_dv_write(sb, &_shared);
+        }
 
         case dc_dvt(DCDynValPtr):
-            return dc_tostr_dv(dc_dv_as(*dv, DCDynValPtr));
-            break;
+            if (!dc_dv_as(*dv, DCDynValPtr)) return dc_sb_append_str(sb, "(null)");
+
+            return dc_dv_write(sb, dc_dv_as(*dv, DCDynValPtr));
 
         default:
-            dc_sprintf(&result, "%s", "(unknown dynamic value)");
-            break;
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+            if (!vtable || !vtable->tostr_fn) return dc_sb_append_str(sb, "(unknown dynamic value)");
+
+            dc_try_or_fail_with3(DCResString, str, vtable->tostr_fn(dv), {});
+
+            __dc_res = dc_sb_append_str(sb, dc_unwrap2(str));
+            free(dc_unwrap2(str));
+
+            dc_ret();
+        }
     };
 
-    dc_ret_ok(result);
+#undef write_fmt
+}
+
+DCResString dc_tostr_dv(DCDynVal* dv)
+{
+    DC_RES_string();
 
-#undef stringify
+    if (!dv) dc_ret_e(1, "got NULL dynamic value");
+
+    DCStrBuilder sb;
+    dc_try_fail_temp(DCResVoid, dc_sb_init(&sb, 0));
+
+    dc_try_or_fail_with3(DCResVoid, write_res, dc_dv_write(&sb, dv), dc_sb_free(&sb));
+
+    return dc_sb_take(&sb);
 }
 
 DCResVoid dc_dv_print(DCDynVal* dv)
 {
     DC_RES_void();
 
-    dc_try_or_fail_with3(DCResString, res, dc_tostr_dv(dv), {});
+    DCStrBuilder sb;
+    dc_try_fail(dc_sb_init(&sb, 0));
 
-    printf("%s", dc_unwrap2(res));
+    dc_try_or_fail_with3(DCResVoid, write_res, dc_dv_write(&sb, dv), dc_sb_free(&sb));
 
-    if (dc_unwrap2(res)) free(dc_unwrap2(res));
+    if (sb.len > 0) fwrite(sb.buf, 1, sb.len, stdout);
 
-    dc_ret();
+    return dc_sb_free(&sb);
 }
 
 DCResVoid dc_dv_println(DCDynVal* dv)
@@ -258,7 +353,6 @@ DCResVoid dc_dv_println(DCDynVal* dv)
     dc_ret();
 }
 
-
 DCResBool dc_dv_to_bool(DCDynVal* dv)
 {
     DC_RES_bool();
@@ -293,15 +387,26 @@ DCResBool dc_dv_to_bool(DCDynVal* dv)
         type_to_bool(usize);
 
         type_to_bool(DCStringView);
+        type_to_bool(DCDynArrView);
+
+        case dc_dvt(DCInlineStr):
+            dc_ret_ok(dc_dv_istr_str(*dv)[0] != '\0');
 
         type_to_bool(DCDynArrPtr);
         type_to_bool(DCHashTablePtr);
         type_to_bool(DCPairPtr);
+        type_to_bool(DCRcPtr);
+        type_to_bool(DCSymbolPtr);
 
         type_to_bool(DCDynValPtr);
 
         default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+            if (vtable && vtable->to_bool_fn) return vtable->to_bool_fn(dv);
+
             break;
+        }
     };
 
     dc_dbg_log("Exiting Function on an unknown type");
@@ -309,6 +414,21 @@ DCResBool dc_dv_to_bool(DCDynVal* dv)
 #undef type_to_bool
 }
 
+/**
+ * Compares two inline string dynamic values, two inline ones are compared as a
+ * whole without looking for the terminator
+ */
+static b1 __dc_dv_istr_eq(DCDynVal* dv1, DCDynVal* dv2)
+{
+    if (!dv1->istr_heap && !dv2->istr_heap)
+        return memcmp(dc_dv_as(*dv1, DCInlineStr).bytes, dc_dv_as(*dv2, DCInlineStr).bytes, DC_ISTR_SIZE) == 0;
+
+    // A heap string is always longer than any inline string
+    if (dv1->istr_heap != dv2->istr_heap) return false;
+
+    return strcmp(dc_dv_as(*dv1, DCInlineStr).heap, dc_dv_as(*dv2, DCInlineStr).heap) == 0;
+}
+
 DCResBool dc_dv_eq(DCDynVal* dv1, DCDynVal* dv2)
 {
     DC_RES_bool();
@@ -355,6 +475,12 @@ DCResBool dc_dv_eq(DCDynVal* dv1, DCDynVal* dv2)
         check_eq(size);
         check_eq(usize);
 
+        // Handles are equal when they share the very same container
+        check_eq(DCRcPtr);
+
+        // Every text has only one symbol in a pool
+        check_eq(DCSymbolPtr);
+
         case dc_dvt(string):
         {
             if (strcmp(dc_dv_as(*lval, string), dc_dv_as(*rval, string)) == 0) dc_ret_ok(true);
@@ -371,6 +497,20 @@ DCResBool dc_dv_eq(DCDynVal* dv1, DCDynVal* dv2)
             break;
         }
 
+        case dc_dvt(DCInlineStr):
+            dc_ret_ok(__dc_dv_istr_eq(lval, rval));
+
+        case dc_dvt(DCDynArrView):
+        {
+            // Views are equal when they cover the very same elements
+            if ((dc_dv_as(*lval, DCDynArrView).elements == dc_dv_as(*rval, DCDynArrView).elements) &&
+                (dc_dv_as(*lval, DCDynArrView).count == dc_dv_as(*rval, DCDynArrView).count) &&
+                (dc_dv_as(*lval, DCDynArrView).stride == dc_dv_as(*rval, DCDynArrView).stride))
+                dc_ret_ok(true);
+
+            break;
+        }
+
         case dc_dvt(DCPairPtr):
         {
             DCPairPtr _pair1 = dc_dv_as(*lval, DCPairPtr);
@@ -390,7 +530,12 @@ DCResBool dc_dv_eq(DCDynVal* dv1, DCDynVal* dv2)
             return dc_dv_eq(lval, rval);
 
         default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(lval->type);
+            if (vtable && vtable->eq_fn) return vtable->eq_fn(lval, rval);
+
             break;
+        }
     }
 
     dc_ret_ok(false);
@@ -408,6 +553,118 @@ DCResBool dc_dv_eq3(DCDynVal dv1, DCDynVal dv2)
     return dc_dv_eq(&dv1, &dv2);
 }
 
+DCRes dc_dv_istr2(const string str, usize len)
+{
+    DC_RES();
+
+    if (!str)
+    {
+        dc_dbg_log("got NULL string");
+
+        dc_ret_e(1, "got NULL string");
+    }
+
+    DCDynVal dv = {.type = dc_dvt(DCInlineStr), .allocated = false};
+    memset(&dc_dv_as(dv, DCInlineStr), 0, sizeof(DCInlineStr));
+
+    if (len <= DC_ISTR_MAX_LEN)
+    {
+        memcpy(dc_dv_as(dv, DCInlineStr).bytes, str, len);
+        dc_dv_as(dv, DCInlineStr).bytes[DC_ISTR_MAX_LEN] = (char)(DC_ISTR_MAX_LEN - len);
+
+        dc_ret_ok(dv);
+    }
+
+    string heap = (string)malloc(len + 1);
+    if (heap == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    memcpy(heap, str, len);
+    heap[len] = '\0';
+
+    dc_dv_as(dv, DCInlineStr).heap = heap;
+    dv.allocated = true;
+    dv.istr_heap = true;
+
+    dc_ret_ok(dv);
+}
+
+DCRes dc_dv_istr(const string str)
+{
+    DC_RES();
+
+    if (!str)
+    {
+        dc_dbg_log("got NULL string");
+
+        dc_ret_e(1, "got NULL string");
+    }
+
+    return dc_dv_istr2(str, strlen(str));
+}
+
+DCResUsize dc_dv_istr_len(DCDynVal* dv)
+{
+    DC_RES_usize();
+
+    if (!dv || dv->type != dc_dvt(DCInlineStr))
+    {
+        dc_dbg_log("got NULL or non inline string dynamic value");
+
+        dc_ret_e(3, "got NULL or non inline string dynamic value");
+    }
+
+    if (dv->istr_heap) dc_ret_ok(strlen(dc_dv_as(*dv, DCInlineStr).heap));
+
+    dc_ret_ok(DC_ISTR_MAX_LEN - (usize)(u8)dc_dv_as(*dv, DCInlineStr).bytes[DC_ISTR_MAX_LEN]);
+}
+
+DCRes dc_dv_box_sv(DCStringView sv)
+{
+    DC_RES();
+
+#ifdef DC_DV_COMPACT
+    DCStringView* box = (DCStringView*)malloc(sizeof(DCStringView));
+    if (box == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    *box = sv;
+
+    dc_ret_ok(((DCDynVal){.type = dc_dvt(DCStringView), .value.DCStringView_box = box, .allocated = true}));
+#else
+    dc_ret_ok(dc_dv(DCStringView, sv));
+#endif
+}
+
+DCRes dc_dv_box_dav(DCDynArrView view)
+{
+    DC_RES();
+
+#ifdef DC_DV_COMPACT
+    DCDynArrView* box = (DCDynArrView*)malloc(sizeof(DCDynArrView));
+    if (box == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    *box = view;
+
+    dc_ret_ok(((DCDynVal){.type = dc_dvt(DCDynArrView), .value.DCDynArrView_box = box, .allocated = true}));
+#else
+    dc_ret_ok(dc_dv(DCDynArrView, view));
+#endif
+}
+
 DCResVoid dc_dv_free(DCDynVal* element, DCDynValFreeFn custom_free_fn)
 {
     DC_RES_void();
@@ -464,6 +721,16 @@ DCResVoid dc_dv_free(DCDynVal* element, DCDynValFreeFn custom_free_fn)
             break;
         }
 
+        case dc_dvt(DCRcPtr):
+            if (custom_free_fn) dc_try_fail(custom_free_fn(element));
+
+            // An owning handle only drops its reference
+            if (dc_dv_is_allocated(*element)) dc_try_fail(dc_rc_release(dc_dv_as(*element, DCRcPtr)));
+
+            dc_dv_set(*element, DCRcPtr, NULL);
+
+            break;
+
         case dc_dvt(DCDynArrPtr):
             if (custom_free_fn) dc_try_fail(custom_free_fn(element));
 
@@ -496,11 +763,55 @@ DCResVoid dc_dv_free(DCDynVal* element, DCDynValFreeFn custom_free_fn)
         {
             if (custom_free_fn) dc_try_fail(custom_free_fn(element));
 
+#ifdef DC_DV_COMPACT
+            if (element->value.DCStringView_box == NULL) break;
+#endif
+
             dc_try_fail(dc_sv_free(&dc_dv_as(*element, DCStringView)));
 
+#ifdef DC_DV_COMPACT
+            // Boxes that are not marked as allocated belong to someone else (e.g. an arena)
+            if (dc_dv_is_allocated(*element)) free(element->value.DCStringView_box);
+
+            element->value.DCStringView_box = NULL;
+            element->allocated = false;
+#endif
+
+            break;
+        }
+
+        case dc_dvt(DCInlineStr):
+        {
+            if (custom_free_fn) dc_try_fail(custom_free_fn(element));
+
+            // Heap copies in an arena are left to the arena
+            if (element->istr_heap && dc_dv_is_allocated(*element) && dc_dv_as(*element, DCInlineStr).heap != NULL)
+                free(dc_dv_as(*element, DCInlineStr).heap);
+
+            // Back to an empty inline string
+            element->allocated = false;
+            element->istr_heap = false;
+            memset(&dc_dv_as(*element, DCInlineStr), 0, sizeof(DCInlineStr));
+            dc_dv_as(*element, DCInlineStr).bytes[DC_ISTR_MAX_LEN] = (char)DC_ISTR_MAX_LEN;
+
             break;
         }
 
+#ifdef DC_DV_COMPACT
+        case dc_dvt(DCDynArrView):
+        {
+            if (custom_free_fn) dc_try_fail(custom_free_fn(element));
+
+            // Views never own the elements, only the box is freed (if it's marked as allocated)
+            if (dc_dv_is_allocated(*element)) free(element->value.DCDynArrView_box);
+
+            element->value.DCDynArrView_box = NULL;
+            element->allocated = false;
+
+            break;
+        }
+#endif
+
         case dc_dvt(DCDynValPtr):
             if (custom_free_fn) dc_try_fail(custom_free_fn(element));
 
@@ -515,8 +826,16 @@ DCResVoid dc_dv_free(DCDynVal* element, DCDynValFreeFn custom_free_fn)
         default:
             // This is important due to being able to manage custom types
             // They must be marked as allocated, managing there memory de-allocation should be
-            // Handled in the custom_free_fn including freeing the field itself if it's a pointer type
-            if (dc_dv_is_allocated(*element) && custom_free_fn) dc_try_fail(custom_free_fn(element));
+            // Handled in the custom_free_fn (or the registered one) including freeing the field itself if it's a pointer type
+            if (dc_dv_is_allocated(*element))
+            {
+                const DCDvVTable* vtable = dc_dv_vtable(element->type);
+
+                if (custom_free_fn)
+                    dc_try_fail(custom_free_fn(element));
+                else if (vtable && vtable->free_fn)
+                    dc_try_fail(vtable->free_fn(element));
+            }
 
             dc_dbg_log("Doesn't free anything - not allocated type");
             break;
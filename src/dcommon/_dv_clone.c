@@ -0,0 +1,527 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _dv_clone.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for deep cloning dynamic values
+// *               into an arena
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_dv_clone.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * An already cloned object, the type of the pointer is part of the key as a
+ * pair and its first value (for example) share the same address
+ */
+typedef struct
+{
+    voidptr from;
+    voidptr to;
+    DCDynValType type;
+} __DCCloneEntry;
+
+/**
+ * State of a clone, `entries` is an open addressing table from the original
+ * objects to their copies
+ */
+typedef struct
+{
+    DCArena* arena;
+
+    __DCCloneEntry* entries;
+    usize cap;
+    usize count;
+} __DCClone;
+
+#define __DC_CLONE_INITIAL_CAP 64
+
+static usize __dc_clone_slot(voidptr ptr, DCDynValType type, usize cap)
+{
+    u64 hash = ((u64)(uptr)ptr ^ (u64)type) * 0x9E3779B97F4A7C15ull;
+
+    return (usize)(hash >> 32) & (cap - 1);
+}
+
+/**
+ * Returns the copy of the given object or NULL if it's not cloned yet
+ */
+static voidptr __dc_clone_find(__DCClone* clone, voidptr from, DCDynValType type)
+{
+    if (clone->count == 0) return NULL;
+
+    usize slot = __dc_clone_slot(from, type, clone->cap);
+    while (clone->entries[slot].from)
+    {
+        if (clone->entries[slot].from == from && clone->entries[slot].type == type) return clone->entries[slot].to;
+
+        slot = (slot + 1) & (clone->cap - 1);
+    }
+
+    return NULL;
+}
+
+static DCResVoid __dc_clone_remember(__DCClone* clone, voidptr from, DCDynValType type, voidptr to)
+{
+    DC_RES_void();
+
+    // Kept at most half full
+    if ((clone->count + 1) * 2 > clone->cap)
+    {
+        usize new_cap = clone->cap == 0 ? __DC_CLONE_INITIAL_CAP : clone->cap * 2;
+
+        __DCCloneEntry* entries = (__DCCloneEntry*)calloc(new_cap, sizeof(__DCCloneEntry));
+        if (entries == NULL)
+        {
+            dc_dbg_log("Memory allocation failed");
+
+            dc_ret_e(2, "Memory allocation failed");
+        }
+
+        for (usize i = 0; i < clone->cap; ++i)
+        {
+            if (!clone->entries[i].from) continue;
+
+            usize slot = __dc_clone_slot(clone->entries[i].from, clone->entries[i].type, new_cap);
+            while (entries[slot].from) slot = (slot + 1) & (new_cap - 1);
+
+            entries[slot] = clone->entries[i];
+        }
+
+        free(clone->entries);
+
+        clone->entries = entries;
+        clone->cap = new_cap;
+    }
+
+    usize slot = __dc_clone_slot(from, type, clone->cap);
+    while (clone->entries[slot].from) slot = (slot + 1) & (clone->cap - 1);
+
+    clone->entries[slot] = (__DCCloneEntry){.from = from, .to = to, .type = type};
+    clone->count++;
+
+    dc_ret();
+}
+
+/**
+ * Frees the heap memory some values must keep (long inline strings and boxes)
+ * when the arena is released
+ */
+static DCResVoid __dc_clone_free_mem(voidptr memory)
+{
+    DC_RES_void();
+
+    free(memory);
+
+    dc_ret();
+}
+
+static DCRes __dc_clone_dv(__DCClone* clone, DCDynVal* dv);
+
+static DCResString __dc_clone_string(__DCClone* clone, string str)
+{
+    DC_RES_string();
+
+    string copy = (string)__dc_clone_find(clone, str, dc_dvt(string));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_memdup(clone->arena, str, strlen(str) + 1), {});
+
+    copy = (string)dc_unwrap2(memory);
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, str, dc_dvt(string), copy));
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Clones `count` elements of `src` (each `stride` elements apart) into `dest`
+ */
+static DCResVoid __dc_clone_elements(__DCClone* clone, DCDynVal* dest, DCDynVal* src, usize count, usize stride)
+{
+    DC_RES_void();
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCRes, element, __dc_clone_dv(clone, &src[i * stride]), {});
+
+        dest[i] = dc_unwrap2(element);
+    }
+
+    dc_ret();
+}
+
+/**
+ * Checks that all the elements are plain values (numbers, chars and pointers)
+ * that can be copied as they are
+ */
+static b1 __dc_clone_is_plain(DCDynArr* darr)
+{
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        if (darr->elements[i].type >= dc_dvt(string) || dc_dv_is_owning(darr->elements[i])) return false;
+    }
+
+    return true;
+}
+
+/**
+ * Initializes `dest` as an arena array holding the clones of the elements of
+ * `src`
+ */
+static DCResVoid __dc_clone_da_into(__DCClone* clone, DCDynArr* dest, DCDynArr* src)
+{
+    DC_RES_void();
+
+    dc_try_fail(dc_da_init_arena(dest, clone->arena, src->count > 0 ? src->count : 1, NULL));
+
+    dest->multiplier = src->multiplier;
+    dest->growth = src->growth;
+    dest->growth_factor = src->growth_factor;
+
+    // Plain values have nothing to follow
+    if (__dc_clone_is_plain(src))
+    {
+        if (src->count > 0) memcpy(dest->elements, src->elements, src->count * sizeof(DCDynVal));
+
+        dest->count = src->count;
+
+        dc_ret();
+    }
+
+    dc_try_fail_temp(DCResVoid, __dc_clone_elements(clone, dest->elements, src->elements, src->count, 1));
+
+    dest->count = src->count;
+
+    // The owned count comes from the copies, not the source
+    dc_try_fail_temp(DCResUsize, dc_da_update_owned(dest));
+
+    dc_ret();
+}
+
+static DCResDa __dc_clone_da(__DCClone* clone, DCDynArr* darr)
+{
+    DC_RES_da();
+
+    DCDynArr* copy = (DCDynArr*)__dc_clone_find(clone, darr, dc_dvt(DCDynArrPtr));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(clone->arena, sizeof(DCDynArr)), {});
+
+    copy = (DCDynArr*)dc_unwrap2(memory);
+
+    // Remembered before the elements so cycles end up here
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, darr, dc_dvt(DCDynArrPtr), copy));
+    dc_try_fail_temp(DCResVoid, __dc_clone_da_into(clone, copy, darr));
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Clones a hash table bucket by bucket so nothing is hashed again, the copy has
+ * no pair free function as the arena owns the pairs
+ */
+static DCResHt __dc_clone_ht(__DCClone* clone, DCHashTable* ht)
+{
+    DC_RES_ht();
+
+    DCHashTable* copy = (DCHashTable*)__dc_clone_find(clone, ht, dc_dvt(DCHashTablePtr));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(clone->arena, sizeof(DCHashTable)), {});
+
+    copy = (DCHashTable*)dc_unwrap2(memory);
+
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, ht, dc_dvt(DCHashTablePtr), copy));
+
+    dc_try_or_fail_with3(DCResVoidptr, container, dc_arena_alloc(clone->arena, ht->cap * sizeof(DCDynArr)), {});
+
+    copy->container = (DCDynArr*)dc_unwrap2(container);
+    copy->cap = ht->cap;
+    copy->key_count = ht->key_count;
+    copy->hash_fn = ht->hash_fn;
+    copy->key_cmp_fn = ht->key_cmp_fn;
+    copy->pair_free_fn = NULL;
+
+    // Rows that were never used are empty arena rows so keys set later never leave the arena
+    for (usize i = 0; i < ht->cap; ++i)
+    {
+        if (ht->container[i].cap == 0)
+            dc_try_fail_temp(DCResVoid, dc_da_init_arena(&copy->container[i], clone->arena, 0, NULL));
+        else
+            dc_try_fail_temp(DCResVoid, __dc_clone_da_into(clone, &copy->container[i], &ht->container[i]));
+    }
+
+    dc_ret_ok(copy);
+}
+
+static DCResVoidptr __dc_clone_pair(__DCClone* clone, DCPair* pair)
+{
+    DC_RES_voidptr();
+
+    DCPair* copy = (DCPair*)__dc_clone_find(clone, pair, dc_dvt(DCPairPtr));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(clone->arena, sizeof(DCPair)), {});
+
+    copy = (DCPair*)dc_unwrap2(memory);
+    copy->first = dc_dv(voidptr, NULL);
+    copy->second = dc_dv(voidptr, NULL);
+
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, pair, dc_dvt(DCPairPtr), copy));
+
+    dc_try_or_fail_with3(DCRes, first, __dc_clone_dv(clone, &pair->first), {});
+    copy->first = dc_unwrap2(first);
+
+    dc_try_or_fail_with3(DCRes, second, __dc_clone_dv(clone, &pair->second), {});
+    copy->second = dc_unwrap2(second);
+
+    dc_ret_ok(copy);
+}
+
+static DCResVoidptr __dc_clone_dvptr(__DCClone* clone, DCDynVal* dv)
+{
+    DC_RES_voidptr();
+
+    DCDynVal* copy = (DCDynVal*)__dc_clone_find(clone, dv, dc_dvt(DCDynValPtr));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(clone->arena, sizeof(DCDynVal)), {});
+
+    copy = (DCDynVal*)dc_unwrap2(memory);
+    *copy = dc_dv(voidptr, NULL);
+
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, dv, dc_dvt(DCDynValPtr), copy));
+
+    dc_try_or_fail_with3(DCRes, pointed, __dc_clone_dv(clone, dv), {});
+    *copy = dc_unwrap2(pointed);
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Shared handles become borrowed handles of a copy of what they share
+ */
+static DCResVoidptr __dc_clone_rc(__DCClone* clone, DCRc* rc)
+{
+    DC_RES_voidptr();
+
+    DCRc* copy = (DCRc*)__dc_clone_find(clone, rc, dc_dvt(DCRcPtr));
+    if (copy) dc_ret_ok(copy);
+
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(clone->arena, sizeof(DCRc)), {});
+
+    copy = (DCRc*)dc_unwrap2(memory);
+    copy->refs = 1;
+    copy->type = rc->type;
+    copy->data = NULL;
+
+    dc_try_fail_temp(DCResVoid, __dc_clone_remember(clone, rc, dc_dvt(DCRcPtr), copy));
+
+    if (rc->type == dc_dvt(DCDynArrPtr))
+    {
+        dc_try_or_fail_with3(DCResDa, darr, __dc_clone_da(clone, (DCDynArr*)rc->data), {});
+        copy->data = dc_unwrap2(darr);
+    }
+    else
+    {
+        dc_try_or_fail_with3(DCResHt, ht, __dc_clone_ht(clone, (DCHashTable*)rc->data), {});
+        copy->data = dc_unwrap2(ht);
+    }
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Clones a dynamic value, the copy is never marked as allocated unless its type
+ * needs the flag (long inline strings)
+ */
+static DCRes __dc_clone_dv(__DCClone* clone, DCDynVal* dv)
+{
+    DC_RES();
+
+    DCDynVal copy = *dv;
+    copy.allocated = false;
+
+    switch (dv->type)
+    {
+        case dc_dvt(string):
+        {
+            if (dc_dv_as(*dv, string) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResString, str, __dc_clone_string(clone, dc_dv_as(*dv, string)), {});
+            dc_dv_as(copy, string) = dc_unwrap2(str);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCInlineStr):
+        {
+            if (!dv->istr_heap) dc_ret_ok(copy);
+
+            // Long inline strings are kept on the heap and released by the
+            // arena, the copy doesn't own them
+            dc_try_or_fail_with3(DCRes, istr, dc_dv_istr(dc_dv_as(*dv, DCInlineStr).heap), {});
+            dc_try_or_fail_with3(DCResVoid, defer_res,
+                                 dc_arena_defer(clone->arena, dc_dv_as(dc_unwrap2(istr), DCInlineStr).heap, __dc_clone_free_mem),
+                                 dc_dv_free(&dc_unwrap2(istr), NULL));
+
+            dc_dv_as(copy, DCInlineStr) = dc_dv_as(dc_unwrap2(istr), DCInlineStr);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCStringView_box == NULL) dc_ret_ok(copy);
+#endif
+            // The cached c string belongs to the original
+            DCStringView sv = dc_dv_as(*dv, DCStringView);
+            sv.cstr = NULL;
+
+            if (sv.str != NULL)
+            {
+                dc_try_or_fail_with3(DCResVoidptr, text, dc_arena_memdup(clone->arena, sv.str, sv.len), {});
+                sv.str = (string)dc_unwrap2(text);
+            }
+
+#ifdef DC_DV_COMPACT
+            dc_try_or_fail_with3(DCRes, boxed, dc_dv_box_sv(sv), {});
+            dc_try_fail_temp(DCResVoid, dc_arena_defer(clone->arena, dc_unwrap2(boxed).value.DCStringView_box, __dc_clone_free_mem));
+
+            copy.value.DCStringView_box = dc_unwrap2(boxed).value.DCStringView_box;
+#else
+            dc_dv_as(copy, DCStringView) = sv;
+#endif
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCDynArrView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCDynArrView_box == NULL) dc_ret_ok(copy);
+#endif
+            // The viewed elements are copied next to each other
+            DCDynArrView view = dc_dv_as(*dv, DCDynArrView);
+
+            if (view.count > 0)
+            {
+                dc_try_or_fail_with3(DCResVoidptr, elements, dc_arena_alloc(clone->arena, view.count * sizeof(DCDynVal)), {});
+                dc_try_fail_temp(DCResVoid,
+                                 __dc_clone_elements(clone, (DCDynVal*)dc_unwrap2(elements), view.elements, view.count, view.stride));
+
+                view.elements = (DCDynVal*)dc_unwrap2(elements);
+            }
+
+            view.stride = 1;
+
+#ifdef DC_DV_COMPACT
+            dc_try_or_fail_with3(DCRes, boxed, dc_dv_box_dav(view), {});
+            dc_try_fail_temp(DCResVoid, dc_arena_defer(clone->arena, dc_unwrap2(boxed).value.DCDynArrView_box, __dc_clone_free_mem));
+
+            copy.value.DCDynArrView_box = dc_unwrap2(boxed).value.DCDynArrView_box;
+#else
+            dc_dv_as(copy, DCDynArrView) = view;
+#endif
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCDynValPtr):
+        {
+            if (dc_dv_as(*dv, DCDynValPtr) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResVoidptr, pointed, __dc_clone_dvptr(clone, dc_dv_as(*dv, DCDynValPtr)), {});
+            dc_dv_as(copy, DCDynValPtr) = (DCDynVal*)dc_unwrap2(pointed);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            if (dc_dv_as(*dv, DCDynArrPtr) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResDa, darr, __dc_clone_da(clone, dc_dv_as(*dv, DCDynArrPtr)), {});
+            dc_dv_as(copy, DCDynArrPtr) = dc_unwrap2(darr);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCHashTablePtr):
+        {
+            if (dc_dv_as(*dv, DCHashTablePtr) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResHt, ht, __dc_clone_ht(clone, dc_dv_as(*dv, DCHashTablePtr)), {});
+            dc_dv_as(copy, DCHashTablePtr) = dc_unwrap2(ht);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCPairPtr):
+        {
+            if (dc_dv_as(*dv, DCPairPtr) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResVoidptr, pair, __dc_clone_pair(clone, dc_dv_as(*dv, DCPairPtr)), {});
+            dc_dv_as(copy, DCPairPtr) = (DCPair*)dc_unwrap2(pair);
+
+            dc_ret_ok(copy);
+        }
+
+        case dc_dvt(DCRcPtr):
+        {
+            if (dc_dv_as(*dv, DCRcPtr) == NULL) dc_ret_ok(copy);
+
+            dc_try_or_fail_with3(DCResVoidptr, rc, __dc_clone_rc(clone, dc_dv_as(*dv, DCRcPtr)), {});
+            dc_dv_as(copy, DCRcPtr) = (DCRc*)dc_unwrap2(rc);
+
+            dc_ret_ok(copy);
+        }
+
+        default:
+            break;
+    }
+
+    if (dc_dv_is_not_allocated(*dv)) dc_ret_ok(copy);
+
+    // Allocated voidptr, fileptr and extra types cannot be duplicated
+    dc_dbg_log("cannot clone allocated value of type: %s", dc_tostr_dvt(dv));
+
+    dc_ret_ea(3, "cannot clone allocated value of type: %s", dc_tostr_dvt(dv));
+}
+
+DCRes dc_dv_clone(DCDynVal* dv, DCArena* arena)
+{
+    DC_RES();
+
+    if (!dv || !arena)
+    {
+        dc_dbg_log("got NULL DCDynVal or DCArena");
+
+        dc_ret_e(1, "got NULL DCDynVal or DCArena");
+    }
+
+    __DCClone clone = {.arena = arena, .entries = NULL, .cap = 0, .count = 0};
+
+    __dc_res = __dc_clone_dv(&clone, dv);
+
+    free(clone.entries);
+
+    return __dc_res;
+}
+
+#undef __DC_CLONE_INITIAL_CAP
@@ -0,0 +1,697 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _dv_hash.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for hashing and total ordering
+// *               of dynamic values
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_dv_hash.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#define __DC_HASH_K1 0x87c37b91114253d5ull
+#define __DC_HASH_K2 0x4cf5ad432745937full
+#define __DC_HASH_GOLDEN 0x9e3779b97f4a7c15ull
+
+#define __dc_hash_rotl(X, R) (((X) << (R)) | ((X) >> (64 - (R))))
+
+static DCResU64 __dc_dv_hash(DCDynVal* dv, u64 seed, usize depth);
+static DCResI32 __dc_dv_cmp(DCDynVal* dv1, DCDynVal* dv2, usize depth);
+
+/**
+ * Final avalanche of MurmurHash3, every bit of the input affects every bit of
+ * the output
+ */
+static u64 __dc_hash_fmix(u64 h)
+{
+    h ^= h >> 33;
+    h *= 0xff51afd7ed558ccdull;
+    h ^= h >> 33;
+    h *= 0xc4ceb9fe1a85ec53ull;
+    h ^= h >> 33;
+
+    return h;
+}
+
+/**
+ * Starting state for hashing a value of the given type, values of different
+ * types start apart
+ */
+static u64 __dc_hash_start(u64 seed, DCDynValType type)
+{
+    return seed ^ ((u64)type + 1) * __DC_HASH_GOLDEN;
+}
+
+/**
+ * Hashes a value that fits in 64 bits, different values of the same type never
+ * collide for the same seed
+ */
+static u64 __dc_hash_word(u64 seed, DCDynValType type, u64 bits)
+{
+    return __dc_hash_fmix(bits * __DC_HASH_K1 + __dc_hash_start(seed, type));
+}
+
+/**
+ * Hashes `len` bytes eight at a time (MurmurHash3 style mixing of the blocks)
+ */
+static u64 __dc_hash_bytes(u64 seed, DCDynValType type, const string bytes, usize len)
+{
+    u64 h = __dc_hash_start(seed, type);
+    usize i = 0;
+
+    for (; i + 8 <= len; i += 8)
+    {
+        u64 k;
+        memcpy(&k, bytes + i, sizeof(k));
+
+        k *= __DC_HASH_K1;
+        k = __dc_hash_rotl(k, 31);
+        k *= __DC_HASH_K2;
+
+        h ^= k;
+        h = __dc_hash_rotl(h, 27) * 5 + 0x52dce729;
+    }
+
+    if (i < len)
+    {
+        u64 k = 0;
+        memcpy(&k, bytes + i, len - i);
+
+        k *= __DC_HASH_K1;
+        k = __dc_hash_rotl(k, 31);
+        k *= __DC_HASH_K2;
+
+        h ^= k;
+    }
+
+    return __dc_hash_fmix(h ^ (u64)len);
+}
+
+/**
+ * Follows pointed values to what they point to
+ */
+static DCResPtr __dc_dv_resolve(DCDynVal* dv, usize* depth)
+{
+    DC_RES_dv();
+
+    while (dv->type == dc_dvt(DCDynValPtr) && dc_dv_as(*dv, DCDynValPtr) != NULL)
+    {
+        if (++(*depth) > DC_DV_MAX_DEPTH)
+        {
+            dc_dbg_log("dynamic value is nested too deep");
+
+            dc_ret_e(4, "dynamic value is nested too deep");
+        }
+
+        dv = dc_dv_as(*dv, DCDynValPtr);
+    }
+
+    dc_ret_ok(dv);
+}
+
+/**
+ * Hashes the elements in order, each one is hashed with the hash of the ones
+ * before it as the seed
+ */
+static DCResU64 __dc_dv_hash_elements(u64 h, DCDynVal* elements, usize count, usize stride, usize depth)
+{
+    DC_RES_u64();
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCResU64, element_hash, __dc_dv_hash(&elements[i * stride], h, depth), {});
+        h = dc_unwrap2(element_hash);
+    }
+
+    dc_ret_ok(h);
+}
+
+/**
+ * Hashes the pairs of the hash table, the hashes of the pairs are added up so
+ * the order of the buckets and the capacity don't matter
+ */
+static DCResU64 __dc_dv_hash_ht(DCHashTable* ht, u64 seed, usize depth)
+{
+    DC_RES_u64();
+
+    u64 sum = 0;
+
+    for (usize i = 0; i < ht->cap; ++i)
+    {
+        DC_HT_GET_AND_DEF_CONTAINER_ROW(darr, *ht, i);
+
+        for (usize j = 0; j < darr->count; ++j)
+        {
+            DCPair* pair = dc_dv_as(darr->elements[j], DCPairPtr);
+
+            dc_try_or_fail_with3(DCResU64, key_hash, __dc_dv_hash(&pair->first, seed, depth), {});
+            dc_try_or_fail_with3(DCResU64, pair_hash, __dc_dv_hash(&pair->second, dc_unwrap2(key_hash), depth), {});
+
+            sum += dc_unwrap2(pair_hash);
+        }
+    }
+
+    dc_ret_ok(__dc_hash_word(seed, dc_dvt(DCHashTablePtr), sum + (u64)ht->key_count * __DC_HASH_GOLDEN));
+}
+
+static DCResU64 __dc_dv_hash(DCDynVal* dv, u64 seed, usize depth)
+{
+    DC_RES_u64();
+
+    if (depth > DC_DV_MAX_DEPTH)
+    {
+        dc_dbg_log("dynamic value is nested too deep");
+
+        dc_ret_e(4, "dynamic value is nested too deep");
+    }
+
+    dc_try_or_fail_with3(DCResPtr, resolved, __dc_dv_resolve(dv, &depth), {});
+    dv = dc_unwrap2(resolved);
+
+#define hash_case(TYPE, BITS)                                                                                                  \
+    case dc_dvt(TYPE):                                                                                                         \
+        dc_ret_ok(__dc_hash_word(seed, dv->type, (u64)(BITS)))
+
+    switch (dv->type)
+    {
+        hash_case(b1, dc_dv_as(*dv, b1));
+
+        hash_case(i8, (i64)dc_dv_as(*dv, i8));
+        hash_case(i16, (i64)dc_dv_as(*dv, i16));
+        hash_case(i32, (i64)dc_dv_as(*dv, i32));
+        hash_case(i64, dc_dv_as(*dv, i64));
+
+        hash_case(u8, dc_dv_as(*dv, u8));
+        hash_case(u16, dc_dv_as(*dv, u16));
+        hash_case(u32, dc_dv_as(*dv, u32));
+        hash_case(u64, dc_dv_as(*dv, u64));
+
+        hash_case(f32, __dc_da_f64_key((f64)dc_dv_as(*dv, f32)));
+        hash_case(f64, __dc_da_f64_key(dc_dv_as(*dv, f64)));
+
+        hash_case(uptr, dc_dv_as(*dv, uptr));
+        hash_case(char, dc_dv_as(*dv, char));
+        hash_case(size, dc_dv_as(*dv, size));
+        hash_case(usize, dc_dv_as(*dv, usize));
+
+        hash_case(voidptr, (uptr)dc_dv_as(*dv, voidptr));
+        hash_case(fileptr, (uptr)dc_dv_as(*dv, fileptr));
+
+        // Only NULL ones are left after resolving
+        hash_case(DCDynValPtr, 0);
+
+        // The hash computed once by the pool is reused
+        hash_case(DCSymbolPtr, dc_dv_as(*dv, DCSymbolPtr) ? dc_dv_as(*dv, DCSymbolPtr)->hash : 0);
+
+        case dc_dvt(string):
+            if (!dc_dv_as(*dv, string)) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+
+            dc_ret_ok(__dc_hash_bytes(seed, dv->type, dc_dv_as(*dv, string), strlen(dc_dv_as(*dv, string))));
+
+        case dc_dvt(DCInlineStr):
+        {
+            string str = dc_dv_istr_str(*dv);
+
+            dc_ret_ok(__dc_hash_bytes(seed, dv->type, str, strlen(str)));
+        }
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCStringView_box == NULL) dc_ret_ok(__dc_hash_bytes(seed, dv->type, "", 0));
+#endif
+            DCStringView sv = dc_dv_as(*dv, DCStringView);
+
+            dc_ret_ok(__dc_hash_bytes(seed, dv->type, sv.str, sv.len));
+        }
+
+        case dc_dvt(DCDynArrView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCDynArrView_box == NULL) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+#endif
+            DCDynArrView view = dc_dv_as(*dv, DCDynArrView);
+
+            return __dc_dv_hash_elements(__dc_hash_word(seed, dv->type, view.count), view.elements, view.count, view.stride,
+                                         depth + 1);
+        }
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            DCDynArr* darr = dc_dv_as(*dv, DCDynArrPtr);
+            if (!darr) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+
+            return __dc_dv_hash_elements(__dc_hash_word(seed, dv->type, darr->count), darr->elements, darr->count, 1, depth + 1);
+        }
+
+        case dc_dvt(DCPairPtr):
+        {
+            DCPair* pair = dc_dv_as(*dv, DCPairPtr);
+            if (!pair) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+
+            dc_try_or_fail_with3(DCResU64, first_hash, __dc_dv_hash(&pair->first, __dc_hash_start(seed, dv->type), depth + 1), {});
+
+            return __dc_dv_hash(&pair->second, dc_unwrap2(first_hash), depth + 1);
+        }
+
+        case dc_dvt(DCHashTablePtr):
+            if (!dc_dv_as(*dv, DCHashTablePtr)) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+
+            return __dc_dv_hash_ht(dc_dv_as(*dv, DCHashTablePtr), seed, depth + 1);
+
+        case dc_dvt(DCRcPtr):
+        {
+            if (!dc_dv_as(*dv, DCRcPtr)) dc_ret_ok(__dc_hash_word(seed, dv->type, 0));
+
+            DCDynVal shared = dc_rc_dv(dc_dv_as(*dv, DCRcPtr));
+            return __dc_dv_hash(&shared, __dc_hash_start(seed, dv->type), depth + 1);
+        }
+
+        default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+            if (vtable && vtable->hash_fn) return vtable->hash_fn(dv, seed);
+
+            break;
+        }
+    }
+
+#undef hash_case
+
+    dc_dbg_log("no built-in hash for dynamic value type: %s", dc_tostr_dvt(dv));
+
+    dc_ret_e(3, "no built-in hash for the dynamic value type");
+}
+
+DCResU64 dc_dv_hash(DCDynVal* dv, u64 seed)
+{
+    DC_RES_u64();
+
+    if (!dv)
+    {
+        dc_dbg_log("got NULL DCDynVal");
+
+        dc_ret_e(1, "got NULL DCDynVal");
+    }
+
+    return __dc_dv_hash(dv, seed, 0);
+}
+
+/**
+ * Orders two NULL or non NULL pointers, NULL comes first
+ */
+#define __dc_cmp_nulls(PTR1, PTR2)                                                                                             \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        if ((PTR1) == (PTR2)) dc_ret_ok(0);                                                                                    \
+        if (!(PTR1) || !(PTR2)) dc_ret_ok((PTR1) ? 1 : -1);                                                                    \
+    } while (0)
+
+/**
+ * Compares the elements one by one, a shorter list that is the start of the
+ * other one comes first
+ */
+static DCResI32 __dc_dv_cmp_elements(DCDynVal* elements1, usize count1, usize stride1, DCDynVal* elements2, usize count2,
+                                     usize stride2, usize depth)
+{
+    DC_RES_i32();
+
+    usize count = count1 < count2 ? count1 : count2;
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_or_fail_with3(DCResI32, order, __dc_dv_cmp(&elements1[i * stride1], &elements2[i * stride2], depth), {});
+        if (dc_unwrap2(order) != 0) return order;
+    }
+
+    dc_ret_ok((count1 > count2) - (count1 < count2));
+}
+
+/**
+ * Compares two byte strings, a shorter one that is the start of the other one
+ * comes first
+ */
+static i32 __dc_cmp_bytes(const string str1, usize len1, const string str2, usize len2)
+{
+    usize len = len1 < len2 ? len1 : len2;
+    i32 result = len > 0 ? memcmp(str1, str2, len) : 0;
+
+    if (result == 0) return (len1 > len2) - (len1 < len2);
+
+    return (result > 0) - (result < 0);
+}
+
+/**
+ * Merge sorts pairs (DCPairPtr values) by key then value using `buffer` of the
+ * same size
+ */
+static DCResVoid __dc_dv_sort_pairs(DCDynVal* pairs, DCDynVal* buffer, usize count, usize depth)
+{
+    DC_RES_void();
+
+    if (count < 2) dc_ret();
+
+    usize mid = count / 2;
+
+    dc_try_fail(__dc_dv_sort_pairs(pairs, buffer, mid, depth));
+    dc_try_fail(__dc_dv_sort_pairs(pairs + mid, buffer, count - mid, depth));
+
+    memcpy(buffer, pairs, count * sizeof(DCDynVal));
+
+    usize left = 0;
+    usize right = mid;
+    usize out = 0;
+
+    while (left < mid && right < count)
+    {
+        dc_try_or_fail_with3(DCResI32, order, __dc_dv_cmp(&buffer[left], &buffer[right], depth), {});
+
+        pairs[out++] = dc_unwrap2(order) <= 0 ? buffer[left++] : buffer[right++];
+    }
+
+    while (left < mid) pairs[out++] = buffer[left++];
+    while (right < count) pairs[out++] = buffer[right++];
+
+    dc_ret();
+}
+
+/**
+ * Collects the pairs of the table into `pairs` (at most `count` of them) and
+ * sorts them, returns how many were collected
+ */
+static DCResUsize __dc_dv_sorted_pairs(DCHashTable* ht, DCDynVal* pairs, DCDynVal* buffer, usize count, usize depth)
+{
+    DC_RES_usize();
+
+    usize collected = 0;
+    for (usize i = 0; i < ht->cap; ++i)
+    {
+        DC_HT_GET_AND_DEF_CONTAINER_ROW(darr, *ht, i);
+
+        for (usize j = 0; j < darr->count && collected < count; ++j) pairs[collected++] = darr->elements[j];
+    }
+
+    dc_try_fail_temp(DCResVoid, __dc_dv_sort_pairs(pairs, buffer, collected, depth));
+
+    dc_ret_ok(collected);
+}
+
+/**
+ * Hash tables with the same pairs are equal whatever their capacity is, others
+ * are ordered by their number of keys, then their hash and at last by their
+ * pairs sorted by key then value so the order doesn't depend on where the
+ * tables live
+ */
+static DCResI32 __dc_dv_cmp_ht(DCHashTable* ht1, DCHashTable* ht2, usize depth)
+{
+    DC_RES_i32();
+
+    if (ht1->key_count != ht2->key_count) dc_ret_ok(ht1->key_count > ht2->key_count ? 1 : -1);
+
+    b1 equal = true;
+    for (usize i = 0; equal && i < ht1->cap; ++i)
+    {
+        DC_HT_GET_AND_DEF_CONTAINER_ROW(darr, *ht1, i);
+
+        for (usize j = 0; equal && j < darr->count; ++j)
+        {
+            DCPair* pair = dc_dv_as(darr->elements[j], DCPairPtr);
+
+            DCDynVal* found = NULL;
+            dc_try_fail_temp(DCResUsize, dc_ht_find_by_key(ht2, pair->first, &found));
+
+            if (!found)
+            {
+                equal = false;
+                continue;
+            }
+
+            dc_try_or_fail_with3(DCResI32, order, __dc_dv_cmp(&pair->second, found, depth), {});
+            equal = dc_unwrap2(order) == 0;
+        }
+    }
+
+    if (equal) dc_ret_ok(0);
+
+    dc_try_or_fail_with3(DCResU64, hash1, __dc_dv_hash_ht(ht1, 0, depth), {});
+    dc_try_or_fail_with3(DCResU64, hash2, __dc_dv_hash_ht(ht2, 0, depth), {});
+
+    if (dc_unwrap2(hash1) != dc_unwrap2(hash2)) dc_ret_ok(dc_unwrap2(hash1) > dc_unwrap2(hash2) ? 1 : -1);
+
+    usize count = ht1->key_count;
+
+    DCDynVal* pairs = (DCDynVal*)malloc(3 * count * sizeof(DCDynVal));
+    if (pairs == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    DCDynVal* pairs1 = pairs;
+    DCDynVal* pairs2 = pairs + count;
+    DCDynVal* buffer = pairs + 2 * count;
+
+    dc_try_or_fail_with3(DCResUsize, count1, __dc_dv_sorted_pairs(ht1, pairs1, buffer, count, depth), free(pairs));
+    dc_try_or_fail_with3(DCResUsize, count2, __dc_dv_sorted_pairs(ht2, pairs2, buffer, count, depth), free(pairs));
+
+    DCResI32 order = __dc_dv_cmp_elements(pairs1, dc_unwrap2(count1), 1, pairs2, dc_unwrap2(count2), 1, depth);
+
+    free(pairs);
+
+    return order;
+}
+
+static DCResI32 __dc_dv_cmp(DCDynVal* dv1, DCDynVal* dv2, usize depth)
+{
+    DC_RES_i32();
+
+    if (depth > DC_DV_MAX_DEPTH)
+    {
+        dc_dbg_log("dynamic value is nested too deep");
+
+        dc_ret_e(4, "dynamic value is nested too deep");
+    }
+
+    dc_try_or_fail_with3(DCResPtr, resolved1, __dc_dv_resolve(dv1, &depth), {});
+    dc_try_or_fail_with3(DCResPtr, resolved2, __dc_dv_resolve(dv2, &depth), {});
+
+    dv1 = dc_unwrap2(resolved1);
+    dv2 = dc_unwrap2(resolved2);
+
+    // Different types are ordered by their type
+    if (dv1->type != dv2->type) dc_ret_ok(dv1->type < dv2->type ? -1 : 1);
+
+#define cmp_case(TYPE)                                                                                                         \
+    case dc_dvt(TYPE):                                                                                                         \
+        dc_ret_ok((dc_dv_as(*dv1, TYPE) > dc_dv_as(*dv2, TYPE)) - (dc_dv_as(*dv1, TYPE) < dc_dv_as(*dv2, TYPE)))
+
+    switch (dv1->type)
+    {
+        cmp_case(b1);
+
+        cmp_case(i8);
+        cmp_case(i16);
+        cmp_case(i32);
+        cmp_case(i64);
+
+        cmp_case(u8);
+        cmp_case(u16);
+        cmp_case(u32);
+        cmp_case(u64);
+
+        case dc_dvt(f32):
+        case dc_dvt(f64):
+        {
+            // Total order of floats, NaNs included
+            u64 key1 = __dc_da_radix_key(dv1);
+            u64 key2 = __dc_da_radix_key(dv2);
+
+            dc_ret_ok((key1 > key2) - (key1 < key2));
+        }
+
+        cmp_case(uptr);
+        cmp_case(char);
+        cmp_case(size);
+        cmp_case(usize);
+
+        case dc_dvt(voidptr):
+        case dc_dvt(fileptr):
+        {
+            uptr ptr1 = dv1->type == dc_dvt(voidptr) ? (uptr)dc_dv_as(*dv1, voidptr) : (uptr)dc_dv_as(*dv1, fileptr);
+            uptr ptr2 = dv2->type == dc_dvt(voidptr) ? (uptr)dc_dv_as(*dv2, voidptr) : (uptr)dc_dv_as(*dv2, fileptr);
+
+            dc_ret_ok((ptr1 > ptr2) - (ptr1 < ptr2));
+        }
+
+        case dc_dvt(string):
+        {
+            i32 result = __dc_da_str_cmp(dv1, dv2, 0);
+
+            dc_ret_ok((result > 0) - (result < 0));
+        }
+
+        case dc_dvt(DCInlineStr):
+        {
+            i32 result = strcmp(dc_dv_istr_str(*dv1), dc_dv_istr_str(*dv2));
+
+            dc_ret_ok((result > 0) - (result < 0));
+        }
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (!dv1->value.DCStringView_box || !dv2->value.DCStringView_box)
+                dc_ret_ok((dv1->value.DCStringView_box != NULL) - (dv2->value.DCStringView_box != NULL));
+#endif
+            DCStringView sv1 = dc_dv_as(*dv1, DCStringView);
+            DCStringView sv2 = dc_dv_as(*dv2, DCStringView);
+
+            dc_ret_ok(__dc_cmp_bytes(sv1.str, sv1.len, sv2.str, sv2.len));
+        }
+
+        case dc_dvt(DCSymbolPtr):
+        {
+            DCSymbol* symbol1 = dc_dv_as(*dv1, DCSymbolPtr);
+            DCSymbol* symbol2 = dc_dv_as(*dv2, DCSymbolPtr);
+
+            __dc_cmp_nulls(symbol1, symbol2);
+
+            dc_ret_ok(__dc_cmp_bytes(symbol1->str, symbol1->len, symbol2->str, symbol2->len));
+        }
+
+        // Only NULL ones are left after resolving
+        case dc_dvt(DCDynValPtr):
+            dc_ret_ok(0);
+
+        case dc_dvt(DCDynArrView):
+        {
+#ifdef DC_DV_COMPACT
+            if (!dv1->value.DCDynArrView_box || !dv2->value.DCDynArrView_box)
+                dc_ret_ok((dv1->value.DCDynArrView_box != NULL) - (dv2->value.DCDynArrView_box != NULL));
+#endif
+            DCDynArrView view1 = dc_dv_as(*dv1, DCDynArrView);
+            DCDynArrView view2 = dc_dv_as(*dv2, DCDynArrView);
+
+            return __dc_dv_cmp_elements(view1.elements, view1.count, view1.stride, view2.elements, view2.count, view2.stride,
+                                        depth + 1);
+        }
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            DCDynArr* darr1 = dc_dv_as(*dv1, DCDynArrPtr);
+            DCDynArr* darr2 = dc_dv_as(*dv2, DCDynArrPtr);
+
+            __dc_cmp_nulls(darr1, darr2);
+
+            return __dc_dv_cmp_elements(darr1->elements, darr1->count, 1, darr2->elements, darr2->count, 1, depth + 1);
+        }
+
+        case dc_dvt(DCPairPtr):
+        {
+            DCPair* pair1 = dc_dv_as(*dv1, DCPairPtr);
+            DCPair* pair2 = dc_dv_as(*dv2, DCPairPtr);
+
+            __dc_cmp_nulls(pair1, pair2);
+
+            dc_try_or_fail_with3(DCResI32, order, __dc_dv_cmp(&pair1->first, &pair2->first, depth + 1), {});
+            if (dc_unwrap2(order) != 0) return order;
+
+            return __dc_dv_cmp(&pair1->second, &pair2->second, depth + 1);
+        }
+
+        case dc_dvt(DCHashTablePtr):
+        {
+            DCHashTable* ht1 = dc_dv_as(*dv1, DCHashTablePtr);
+            DCHashTable* ht2 = dc_dv_as(*dv2, DCHashTablePtr);
+
+            __dc_cmp_nulls(ht1, ht2);
+
+            return __dc_dv_cmp_ht(ht1, ht2, depth + 1);
+        }
+
+        case dc_dvt(DCRcPtr):
+        {
+            __dc_cmp_nulls(dc_dv_as(*dv1, DCRcPtr), dc_dv_as(*dv2, DCRcPtr));
+
+            DCDynVal shared1 = dc_rc_dv(dc_dv_as(*dv1, DCRcPtr));
+            DCDynVal shared2 = dc_rc_dv(dc_dv_as(*dv2, DCRcPtr));
+
+            return __dc_dv_cmp(&shared1, &shared2, depth + 1);
+        }
+
+        default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv1->type);
+            if (vtable && vtable->cmp_fn) return vtable->cmp_fn(dv1, dv2);
+
+            break;
+        }
+    }
+
+#undef cmp_case
+
+    dc_dbg_log("no built-in ordering for dynamic value type: %s", dc_tostr_dvt(dv1));
+
+    dc_ret_e(3, "no built-in ordering for the dynamic value type, a comparator is needed");
+}
+
+DCResI32 dc_dv_cmp(DCDynVal* dv1, DCDynVal* dv2)
+{
+    DC_RES_i32();
+
+    if (!dv1 || !dv2)
+    {
+        dc_dbg_log("cannot compare DCDynVal with NULL");
+
+        dc_ret_e(1, "cannot compare DCDynVal with NULL");
+    }
+
+    return __dc_dv_cmp(dv1, dv2, 0);
+}
+
+/**
+ * Default hash function of hash tables (see `dc_ht_init`)
+ */
+static DC_HT_HASH_FN_DECL(__dc_ht_dv_hash)
+{
+    DC_RES_u32();
+
+    dc_try_or_fail_with3(DCResU64, hash, dc_dv_hash(_key, 0), {});
+
+    dc_ret_ok((u32)(dc_unwrap2(hash) ^ (dc_unwrap2(hash) >> 32)));
+}
+
+/**
+ * Default key comparison function of hash tables (see `dc_ht_init`), agrees
+ * with `__dc_ht_dv_hash`
+ */
+static DC_HT_KEY_CMP_FN_DECL(__dc_ht_dv_key_cmp)
+{
+    DC_RES_bool();
+
+    dc_try_or_fail_with3(DCResI32, order, dc_dv_cmp(_key1, _key2), {});
+
+    dc_ret_ok(dc_unwrap2(order) == 0);
+}
+
+#undef __DC_HASH_K1
+#undef __DC_HASH_K2
+#undef __DC_HASH_GOLDEN
+#undef __dc_hash_rotl
+#undef __dc_cmp_nulls
@@ -39,10 +39,62 @@ struct DCStringView
     string cstr;
 };
 
+// ***************************************************************************************
+// * STRING BUILDER TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Growable string with tracked length, appending is amortized O(1) as the
+ * buffer grows geometrically
+ *
+ * NOTE: `buf` is always NULL terminated once anything is appended
+ */
+typedef struct
+{
+    string buf;
+    usize len;
+    usize cap;
+} DCStrBuilder;
+
 // ***************************************************************************************
 // * DYNAMIC ARRAY TYPE DECLARATIONS
 // ***************************************************************************************
 
+/**
+ * It is used to address a portion of a dynamic array without memory allocation
+ *
+ * The view covers `count` elements starting from `elements`, each one `stride`
+ * elements after the previous one (stride of 1 means consecutive elements)
+ *
+ * NOTE: A view does not own the elements, it is only valid as long as the
+ * array it was taken from is not grown, truncated, freed or reordered
+ */
+struct DCDynArrView
+{
+    DCDynVal* elements;
+    usize count;
+    usize stride;
+};
+
+/**
+ * Short string kept directly inside a dynamic value, up to `DC_ISTR_MAX_LEN`
+ * characters are stored in `bytes` and longer strings are copied to the heap
+ * (`heap`)
+ *
+ * NOTE: The `istr_heap` flag of the holding dynamic value tells which one is
+ * in use and the allocated flag whether the heap copy is owned by the value
+ * (it's not in an arena), create them with `dc_dv_istr` and read them with
+ * `dc_dv_istr_str`
+ *
+ * NOTE: Inline strings keep the unused bytes zeroed and the last byte holds
+ * `DC_ISTR_MAX_LEN - length` (which is zero, so a terminator, for a full one)
+ */
+typedef union
+{
+    char bytes[DC_ISTR_SIZE];
+    string heap;
+} DCInlineStr;
+
 /**
  * All the types that DCDynVal can accept
  */
@@ -74,10 +126,15 @@ typedef enum
     dc_dvt(DCDynValPtr),
 
     dc_dvt(DCStringView),
+    dc_dvt(DCDynArrView),
+    dc_dvt(DCInlineStr),
 
     dc_dvt(DCHashTablePtr),
     dc_dvt(DCDynArrPtr),
     dc_dvt(DCPairPtr),
+    dc_dvt(DCRcPtr),
+
+    dc_dvt(DCSymbolPtr),
 
 #ifdef DC_DV_EXTRA_TYPES
     DC_DV_EXTRA_TYPES
@@ -88,12 +145,20 @@ typedef enum
 /**
  * Dynamic value type with ability to keep track of holding allocated string or
  * voidptr for further cleanup
+ *
+ * NOTE: When `DC_DV_COMPACT` is defined before including `dcommon.h` the value
+ * is 16 bytes (a header word and one 8 byte slot) instead of 32, values wider
+ * than 8 bytes (DCStringView and DCDynArrView) are then kept in a heap box that
+ * is owned by the dynamic value (see `dc_dv_box_sv` and `dc_dv_box_dav`)
  */
 struct DCDynVal
 {
     DCDynValType type;
     b1 allocated;
 
+    // Only used by DCInlineStr, the text is behind `heap` (see DCInlineStr)
+    b1 istr_heap;
+
 #ifdef DC_DV_EXTRA_FIELDS
     DC_DV_EXTRA_FIELDS
 #endif
@@ -126,11 +191,22 @@ struct DCDynVal
 
         dc_dvf_decl(DCDynValPtr);
 
+        dc_dvf_decl(DCInlineStr);
+
+#ifdef DC_DV_COMPACT
+        DCStringView* DCStringView_box;
+        DCDynArrView* DCDynArrView_box;
+#else
         dc_dvf_decl(DCStringView);
+        dc_dvf_decl(DCDynArrView);
+#endif
 
         dc_dvf_decl(DCDynArrPtr);
         dc_dvf_decl(DCHashTablePtr);
         dc_dvf_decl(DCPairPtr);
+        dc_dvf_decl(DCRcPtr);
+
+        dc_dvf_decl(DCSymbolPtr);
 
 #ifdef DC_DV_EXTRA_UNION_FIELDS
         DC_DV_EXTRA_UNION_FIELDS
@@ -156,12 +232,91 @@ typedef DCResVoid (*DCDynValFreeFn)(DCDynVal*);
  */
 DCDynValOpFnType(DCResBool, DCDvEqFn);
 
+/**
+ * Function type for deciding about a single dynamic value (e.g. whether to keep
+ * it or not in `dc_da_retain`)
+ */
+typedef DCResBool (*DCDvPredicateFn)(DCDynVal*);
+
+/**
+ * Function type for ordering two given pointer to dynamic values, must return
+ * a negative number, zero or a positive number when the first value is
+ * respectively less than, equal to or greater than the second one
+ */
+DCDynValOpFnType(DCResI32, DCDvCmpFn);
+
+/**
+ * Function type for extracting a sort key out of a dynamic value (see
+ * `dc_da_sort_by_key`)
+ */
+typedef DCResI64 (*DCDvKeyFn)(DCDynVal*);
+
+/**
+ * Function type for visiting elements of a dynamic array with their index and a
+ * user provided context (see `dc_da_par_for`)
+ */
+typedef DCResVoid (*DCDaVisitorFn)(DCDynVal*, usize, voidptr);
+
+/**
+ * Where the elements of a dynamic array are stored
+ *
+ * NOTE: `DC_DA_STORAGE_FILE` arrays live in a memory mapped file and are only
+ * created by `dc_da_open_file`
+ *
+ * NOTE: `DC_DA_STORAGE_ARENA` arrays take their elements from an arena (see
+ * `dc_da_init_arena`) and keep growing inside it
+ */
+typedef enum
+{
+    DC_DA_STORAGE_HEAP,
+    DC_DA_STORAGE_MMAP,
+    DC_DA_STORAGE_FILE,
+    DC_DA_STORAGE_ARENA,
+} DCDynArrStorage;
+
+/**
+ * Storage of dynamic arrays that are not plain heap arrays, arrays only point
+ * to it (see `dc_da_storage`) so every array doesn't pay for it
+ *
+ * NOTE: Private to the implementation, `data` is the arena of arena arrays
+ * and the state of file backed arrays
+ */
+typedef struct
+{
+    DCDynArrStorage storage;
+    voidptr data;
+} DCDynArrBacking;
+
+/**
+ * How a dynamic array decides its next capacity when it's full
+ *
+ * - DC_DA_GROW_MULTIPLIER: capacity is multiplied by `multiplier` (default)
+ * - DC_DA_GROW_FACTOR: capacity is multiplied by the fractional `growth_factor`
+ * - DC_DA_GROW_SCHEDULE: factor shrinks as the array gets bigger, from 2x for
+ *   small arrays down to 1.125x for arrays over 1GB
+ */
+typedef enum
+{
+    DC_DA_GROW_MULTIPLIER,
+    DC_DA_GROW_FACTOR,
+    DC_DA_GROW_SCHEDULE,
+} DCDynArrGrowth;
+
 /**
  * Dynamic array with ability to keep any number of dynamic values
  *
  * Initial capacity and multiplication on grow is also customizable
  *
  * Dynamic arrays or Darr for short can be grown, truncated, popped, etc.
+ *
+ * NOTE: `owned_count` is the number of elements that have something to release
+ * (see `dc_dv_is_owning`), when it is zero and there is no `element_free_fn`
+ * freeing, popping or deleting elements skips them, so mark elements in place
+ * with `dc_da_mark_alloc`, replace them with `dc_da_set` or call
+ * `dc_da_update_owned` after assigning owned values through `dc_da_get2`
+ *
+ * NOTE: `backing` is private to the implementation, it's NULL for heap arrays
+ * (see `dc_da_storage`)
  */
 struct DCDynArr
 {
@@ -170,9 +325,63 @@ struct DCDynArr
     usize count;
     usize multiplier;
 
+    DCDynArrGrowth growth;
+    f32 growth_factor;
+
     DCDynValFreeFn element_free_fn;
+
+    usize owned_count;
+
+    DCDynArrBacking* backing;
 };
 
+// ***************************************************************************************
+// * DEQUE TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Double-ended queue of dynamic values kept in a circular buffer
+ *
+ * Elements can be pushed and popped at both ends in constant time, the logical
+ * element `i` lives at `elements[(head + i) & (cap - 1)]`
+ *
+ * NOTE: `cap` is always a power of two (or zero before initialization) so
+ * wrapping around is a single mask operation
+ */
+typedef struct
+{
+    DCDynVal* elements;
+    usize cap;
+    usize head;
+    usize count;
+
+    DCDynValFreeFn element_free_fn;
+} DCDeque;
+
+// ***************************************************************************************
+// * SEGMENTED ARRAY TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Array of dynamic values kept in chunks that are never moved or resized
+ *
+ * Chunk `k` holds `DC_SA_FIRST_CHUNK << k` elements so the directory stays
+ * small and the chunk (and offset) of any index is found with a single leading
+ * zero count
+ *
+ * NOTE: Unlike DCDynArr growing never copies elements, pointers to elements
+ * stay valid until the element is popped or the array is freed
+ */
+typedef struct
+{
+    DCDynVal* chunks[DC_SA_MAX_CHUNKS];
+    usize chunk_count;
+    usize cap;
+    usize count;
+
+    DCDynValFreeFn element_free_fn;
+} DCSegArr;
+
 // ***************************************************************************************
 // * HASH TABLE TYPE DECLARATIONS
 // ***************************************************************************************
@@ -235,6 +444,121 @@ struct DCHashTable
     DCHtPairFreeFn pair_free_fn;
 };
 
+// ***************************************************************************************
+// * REFERENCE COUNTING TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Shared, reference counted box around a heap allocated dynamic array or hash
+ * table
+ *
+ * Every handle (a `DCRcPtr` dynamic value marked as allocated) owns one
+ * reference, freeing a handle only drops its reference and the container is
+ * freed by the last one
+ *
+ * NOTE: `refs` is only changed atomically, the container itself is not
+ * synchronized and must be treated as read only while shared (see
+ * `dc_rc_da_mut` and `dc_rc_ht_mut` for copy on write)
+ */
+struct DCRc
+{
+    i64 refs;
+    DCDynValType type;
+    voidptr data;
+};
+
+// ***************************************************************************************
+// * B-TREE TYPE DECLARATIONS
+// ***************************************************************************************
+
+typedef struct DCBTreeNode DCBTreeNode;
+
+/**
+ * Node of a B+tree, keys of a node are kept next to each other so searching a
+ * node only touches the keys
+ *
+ * Leaves hold the values and are chained (`next`) in key order, internal nodes
+ * hold `count + 1` children where `keys[i]` is the smallest key of
+ * `children[i + 1]`
+ *
+ * NOTE: Keys of internal nodes are copies of keys stored in the leaves, they
+ * are never freed on their own
+ */
+struct DCBTreeNode
+{
+    usize count;
+    b1 leaf;
+    DCBTreeNode* next;
+
+    DCDynVal keys[DC_BT_ORDER];
+
+    union
+    {
+        DCDynVal values[DC_BT_ORDER];
+        DCBTreeNode* children[DC_BT_ORDER + 1];
+    } slots;
+};
+
+/**
+ * Ordered map of dynamic values (B+tree) with unique keys
+ *
+ * NOTE: Keys and values are owned by the tree, they are released with
+ * `dc_dv_free` (and `element_free_fn` if provided) when they are deleted or
+ * the tree is freed
+ */
+typedef struct
+{
+    DCBTreeNode* root;
+    usize count;
+
+    DCDvCmpFn cmp_fn;
+    DCDynValFreeFn element_free_fn;
+} DCBTree;
+
+/**
+ * Walks the entries of a B+tree in key order up to an optional last key (see
+ * `dc_bt_iter` and `dc_bt_next`)
+ *
+ * NOTE: Changing the tree invalidates the iterator
+ */
+typedef struct
+{
+    DCBTree* bt;
+    DCBTreeNode* leaf;
+    usize pos;
+    DCDynVal* to;
+} DCBTreeIter;
+
+// ***************************************************************************************
+// * HEAP TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Priority queue (d-ary min heap) over the elements of a dynamic array, the
+ * smallest element according to `cmp_fn` is on top
+ *
+ * Every element has a handle that stays the same while the element moves
+ * around, it is used to change the element later (decrease-key)
+ *
+ * NOTE: `handle_at` keeps the handle of the element at each index followed by
+ * the handles that are free to be reused and `pos_of` the index of each handle
+ * (`DC_HEAP_NO_POS` when it is not in the heap), they are private to the
+ * implementation
+ *
+ * NOTE: The array is only borrowed, it must not be changed other than through
+ * the `dc_heap_*` functions while the heap is in use
+ */
+typedef struct
+{
+    DCDynArr* darr;
+    DCDvCmpFn cmp_fn;
+
+    usize* handle_at;
+    usize* pos_of;
+    usize handle_count;
+    usize handle_cap;
+} DCHeap;
+
 // ***************************************************************************************
 // * MEMORY CLEANUP TYPE DECLARATIONS
 // ***************************************************************************************
@@ -277,6 +601,214 @@ typedef struct
     DCCleanupFn cleanup_fn;
 } DCCleanupJob;
 
+// ***************************************************************************************
+// * ARENA TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * A block of memory handed out by an arena, `data` follows the header
+ */
+typedef struct DCArenaChunk DCArenaChunk;
+
+struct DCArenaChunk
+{
+    DCArenaChunk* next;
+    usize cap;
+    usize used;
+};
+
+/**
+ * Cleanup job registered on an arena (see `dc_arena_defer`), kept in the arena
+ * memory itself
+ */
+typedef struct DCArenaDefer DCArenaDefer;
+
+struct DCArenaDefer
+{
+    DCArenaDefer* next;
+    DCCleanupJob job;
+};
+
+/**
+ * Bump allocator that hands out memory from chunks and releases all of it at
+ * once, allocations are aligned to `DC_ARENA_ALIGN`
+ *
+ * NOTE: Memory taken from an arena must not be freed one by one, values living
+ * in an arena are never marked as allocated, things that need cleaning up
+ * (e.g. hash tables) can be registered with `dc_arena_defer`
+ */
+typedef struct
+{
+    DCArenaChunk* head;
+    usize chunk_size;
+
+    DCArenaDefer* defers;
+
+    // What arrays of this arena point to, set up by `dc_da_init_arena`
+    DCDynArrBacking da_backing;
+} DCArena;
+
+// ***************************************************************************************
+// * STRING INTERNING TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Canonical copy of a string kept by an intern pool (see `dc_intern`), the same
+ * text always gives the very same symbol so symbols are compared by address
+ *
+ * `id` is the position of the symbol in its pool (0, 1, 2, ...) and `hash` the
+ * hash of its text, both are computed once when the string is interned
+ *
+ * NOTE: Symbols are never changed or freed on their own, they live as long as
+ * their pool
+ */
+struct DCSymbol
+{
+    string str;
+    usize len;
+    u64 hash;
+    u32 id;
+};
+
+/**
+ * Set of interned strings, symbols and their text are kept in `arena` and
+ * found by text through `slots` (open addressing) or by id through `symbols`
+ *
+ * NOTE: Every `dc_intern_*` function takes `lock` (a spin lock) so a pool can
+ * be shared between threads, symbols themselves are read only and need no
+ * locking
+ *
+ * NOTE: `slots`, `symbols` and `lock` are private to the implementation
+ */
+typedef struct
+{
+    DCArena arena;
+
+    DCSymbol** slots;
+    usize slot_cap;
+
+    DCSymbol** symbols;
+    usize count;
+    usize symbol_cap;
+
+    i32 lock;
+} DCInternPool;
+
+// ***************************************************************************************
+// * BINARY SERIALIZATION TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Streaming writer of the tagged binary format of dynamic values
+ *
+ * Encoded values are collected in `buf`, when `file` is set they are flushed
+ * to it whenever the buffer gets bigger than `DC_BIN_FLUSH_SIZE`
+ */
+typedef struct
+{
+    u8* buf;
+    usize len;
+    usize cap;
+
+    fileptr file;
+    usize depth;
+} DCBinWriter;
+
+/**
+ * Reader of the tagged binary format of dynamic values over an input buffer
+ *
+ * NOTE: When `arena` is set everything the reader creates (except hash tables)
+ * comes from it, otherwise it's allocated and marked as allocated
+ *
+ * NOTE: When `zero_copy` is true strings point into the input buffer, string
+ * views always do unless an arena is given
+ *
+ * NOTE: `hash_fn` and `key_cmp_fn` are used for the hash tables being read,
+ * NULL means the defaults of `dc_ht_init`
+ *
+ * NOTE: Symbols are interned in `pool` when it's set, otherwise they're read
+ * as strings
+ */
+typedef struct
+{
+    u8* data;
+    usize len;
+    usize pos;
+
+    DCArena* arena;
+    b1 zero_copy;
+
+    DCHashFn hash_fn;
+    DCKeyCompFn key_cmp_fn;
+
+    DCInternPool* pool;
+
+    usize depth;
+} DCBinReader;
+
+// ***************************************************************************************
+// * JSON TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Parser of JSON documents (or newline delimited JSON) over an input buffer
+ *
+ * Objects become hash tables, arrays dynamic arrays, strings string views,
+ * integers that fit i64, other numbers f64, booleans b1 and null a NULL
+ * voidptr, everything is allocated from `arena` and nothing is marked as
+ * allocated
+ *
+ * NOTE: Strings without escape sequences view the input buffer, which must
+ * then outlive the values
+ *
+ * NOTE: `indexes` (positions of structural characters) and `values` (values of
+ * the containers being built) are scratch buffers private to the
+ * implementation, they're reused from a document to the next one
+ */
+typedef struct
+{
+    string data;
+    usize len;
+    usize pos;
+
+    DCArena* arena;
+
+    u32* indexes;
+    usize index_count;
+    usize index_cap;
+
+    DCDynVal* values;
+    usize value_count;
+    usize value_cap;
+} DCJsonParser;
+
+/**
+ * Streaming writer of dynamic values as JSON text
+ *
+ * Text is collected in `sb`, when `file` is set it is flushed to it whenever
+ * the buffer gets bigger than `DC_JSON_FLUSH_SIZE` so memory stays bounded no
+ * matter how much is written
+ *
+ * NOTE: `indent` is the number of spaces per nesting level for pretty
+ * printing, 0 (the default) writes everything on one line
+ *
+ * NOTE: `depth`, `empty`, `has_key` and `objects` keep track of the arrays and
+ * objects opened by the streaming functions, they're private to the
+ * implementation
+ */
+typedef struct
+{
+    DCStrBuilder sb;
+    fileptr file;
+
+    usize indent;
+
+    usize depth;
+    b1 empty;
+    b1 has_key;
+    b1 objects[DC_JSON_MAX_DEPTH];
+} DCJsonWriter;
+
 // ***************************************************************************************
 // * DCOMMON CUSTOM TYPES RESULT TYPE DECLARATIONS
 // ***************************************************************************************
@@ -284,7 +816,57 @@ typedef struct
 DCResType(DCDynVal, DCRes);
 DCResType(DCStringView, DCResSv);
 DCResType(DCDynArr*, DCResDa);
+DCResType(DCDynArrView, DCResDav);
 DCResType(DCHashTable*, DCResHt);
 DCResType(DCDynVal*, DCResPtr);
+DCResType(DCSymbol*, DCResSymbol);
+
+// ***************************************************************************************
+// * DYNAMIC VALUE VTABLE TYPE DECLARATIONS
+// ***************************************************************************************
+
+/**
+ * Function type for stringifying a dynamic value, the result is allocated
+ */
+typedef DCResString (*DCDvToStrFn)(DCDynVal*);
+
+/**
+ * Function type for hashing a dynamic value with the given seed
+ */
+typedef DCResU64 (*DCDvHashFn)(DCDynVal*, u64);
+
+/**
+ * Function type for turning a dynamic value into another one (e.g. an extra
+ * type into built-in values that can be serialized and back)
+ */
+typedef DCRes (*DCDvConvertFn)(DCDynVal*);
+
+/**
+ * Operations of a type declared with `DC_DV_EXTRA_TYPES`, registered once with
+ * `dc_dv_register_type` and used by `dc_dv_eq`, `dc_dv_cmp`, `dc_dv_hash`,
+ * `dc_dv_to_bool`, `dc_tostr_dv`, `dc_tostr_dvt`, `dc_dv_free` and binary
+ * serialization whenever no custom function is given
+ *
+ * NOTE: Any of the functions can be NULL, the operation then behaves as it does
+ * for unknown types
+ *
+ * NOTE: `free_fn` is only called for values marked as allocated, `to_bin_fn`
+ * must return built-in values (they're freed after being written) and
+ * `from_bin_fn` gets them back from the reader
+ */
+typedef struct
+{
+    string name;
+
+    DCDvEqFn eq_fn;
+    DCDvCmpFn cmp_fn;
+    DCDvHashFn hash_fn;
+    DCDvPredicateFn to_bool_fn;
+    DCDvToStrFn tostr_fn;
+    DCDynValFreeFn free_fn;
+
+    DCDvConvertFn to_bin_fn;
+    DCDvConvertFn from_bin_fn;
+} DCDvVTable;
 
 #endif // DC_ALIASES_H
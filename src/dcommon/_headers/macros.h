@@ -117,10 +117,14 @@
 #define DC_usize_FMT "%" PRIuMAX
 
 #define DC_DCStringView_FMT DCPRIsv
+#define DC_DCDynArrView_FMT "%s"
+#define DC_DCInlineStr_FMT "%s"
 
 #define DC_DCDynArrPtr_FMT "%s"
 #define DC_DCHashTablePtr_FMT "%s"
 #define DC_DCPairPtr_FMT "%s"
+#define DC_DCRcPtr_FMT "%s"
+#define DC_DCSymbolPtr_FMT "%s"
 #define DC_DCDynValPtr_FMT "%s"
 
 // ***************************************************************************************
@@ -160,10 +164,13 @@
 #define dc_DCDynValPtr_to_bool(VAL) ((VAL) && dc_dv_is_not_null(*(VAL)))
 
 #define dc_DCStringView_to_bool(VAL) (((VAL).str) && (VAL).len != 0)
+#define dc_DCDynArrView_to_bool(VAL) (((VAL).elements) && (VAL).count != 0)
 
 #define dc_DCDynArrPtr_to_bool(VAL) ((VAL) != NULL && (VAL)->count != 0)
 #define dc_DCHashTablePtr_to_bool(VAL) ((VAL) != NULL && (VAL)->key_count != 0)
 #define dc_DCPairPtr_to_bool(VAL) ((VAL) != NULL)
+#define dc_DCRcPtr_to_bool(VAL) ((VAL) != NULL && (VAL)->data != NULL)
+#define dc_DCSymbolPtr_to_bool(VAL) ((VAL) != NULL && (VAL)->len != 0)
 
 // ***************************************************************************************
 // * DYNAMIC VALUE MACROS
@@ -174,6 +181,23 @@
  */
 #define DC_DV_FREE_FN_DECL(NAME) DCResVoid NAME(DCDynVal* _value)
 
+/**
+ * `[MACRO]` Macro to define custom predicate function for dynamic values
+ */
+#define DC_DV_PREDICATE_FN_DECL(NAME) DCResBool NAME(DCDynVal* _value)
+
+/**
+ * `[MACRO]` Macro to define custom key extractor function for dynamic values (see
+ * `dc_da_sort_by_key`)
+ */
+#define DC_DV_KEY_FN_DECL(NAME) DCResI64 NAME(DCDynVal* _value)
+
+/**
+ * `[MACRO]` Macro to define custom visitor function for dynamic array elements (see
+ * `dc_da_par_for`)
+ */
+#define DC_DA_VISITOR_FN_DECL(NAME) DCResVoid NAME(DCDynVal* _it, usize _idx, voidptr _ctx)
+
 /**
  * `[MACRO]` Macro to define custom operation function for two dynamic values
  */
@@ -200,16 +224,39 @@
  */
 #define dc_dvf_decl(TYPE) TYPE TYPE##_val
 
+#ifdef DC_DV_COMPACT
+
+/**
+ * `[MACRO]` Same as `dc_dvt` but stops the build with a clear message for types that
+ * compact values keep in a heap box (DCStringView and DCDynArrView), `dc_dv` and
+ * the like cannot create those
+ */
+#define __dc_dvt_unboxed(TYPE)                                                                                                 \
+    ((DCDynValType)(dc_dvt(TYPE) + 0 * sizeof(struct {                                                                         \
+                        int _;                                                                                                 \
+                        _Static_assert(dc_dvt(TYPE) != dc_dvt(DCStringView) && dc_dvt(TYPE) != dc_dvt(DCDynArrView),         \
+                                       "with DC_DV_COMPACT views must be created by dc_dv_box_sv or dc_dv_box_dav");          \
+                    })))
+
+#else
+
+#define __dc_dvt_unboxed(TYPE) dc_dvt(TYPE)
+
+#endif
+
 /**
  * `[MACRO]` Defines a dynamic value literal which holds given type and value and is
  * marked as not allocated
  *
  * NOTE: The value must not be an allocated value
+ *
+ * NOTE: When `DC_DV_COMPACT` is defined it does not accept DCStringView and
+ * DCDynArrView, use `dc_dv_box_sv` and `dc_dv_box_dav` instead
  */
 #define dc_dv(TYPE, VALUE)                                                                                                     \
     (DCDynVal)                                                                                                                 \
     {                                                                                                                          \
-        .type = dc_dvt(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = false                                                  \
+        .type = __dc_dvt_unboxed(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = false                                        \
     }
 
 /**
@@ -221,14 +268,14 @@
 #define dc_dva(TYPE, VALUE)                                                                                                    \
     (DCDynVal)                                                                                                                 \
     {                                                                                                                          \
-        .type = dc_dvt(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = true                                                   \
+        .type = __dc_dvt_unboxed(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = true                                         \
     }
 
 /**
  * `[MACRO]` Defines new variable of NAME with given type, value and allocation status
  */
 #define DC_DV_DEF(NAME, TYPE, VALUE, ALLOC)                                                                                    \
-    DCDynVal NAME = {.type = dc_dvt(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = ALLOC}
+    DCDynVal NAME = {.type = __dc_dvt_unboxed(TYPE), .value.dc_dvf(TYPE) = VALUE, .allocated = ALLOC}
 
 /**
  * `[MACRO]` Expands to setting type and value of an existing dynamic value variable and
@@ -239,7 +286,7 @@
 #define dc_dv_set(NAME, TYPE, VALUE)                                                                                           \
     do                                                                                                                         \
     {                                                                                                                          \
-        (NAME).type = dc_dvt(TYPE);                                                                                            \
+        (NAME).type = __dc_dvt_unboxed(TYPE);                                                                                  \
         (NAME).allocated = false;                                                                                              \
         (NAME).value.dc_dvf(TYPE) = VALUE;                                                                                     \
     } while (0)
@@ -249,6 +296,12 @@
  */
 #define dc_dv_mark_alloc(NAME) (NAME).allocated = true
 
+/**
+ * `[MACRO]` Checks if freeing the given dynamic value has anything to release (it is
+ * marked as allocated or keeps memory of its own like string views and boxed values)
+ */
+#define dc_dv_is_owning(NAME) ((NAME).allocated || (NAME).type == dc_dvt(DCStringView))
+
 /**
  * `[MACRO]` Expands to setting type and value of an existing dynamic value variable and
  * set the allocation status to true
@@ -291,6 +344,62 @@
  */
 #define dc_dv_as(NAME, TYPE) ((NAME).value.dc_dvf(TYPE))
 
+#ifdef DC_DV_COMPACT
+
+/**
+ * In compact mode wide values live in a box, these make `dc_dvf` (and so
+ * `dc_dv_as`) reach through the box so they are still usable as lvalues
+ *
+ * NOTE: `dc_dv` and `dc_dva` cannot create boxed values, use `dc_dv_box_sv` and
+ * `dc_dv_box_dav` instead, the boxes they create are marked as allocated
+ */
+#define DCStringView_val DCStringView_box[0]
+#define DCDynArrView_val DCDynArrView_box[0]
+
+/**
+ * `[MACRO]` Checks if the dynamic value keeps its value in a heap box
+ */
+#define dc_dv_is_boxed(NAME) ((NAME).type == dc_dvt(DCStringView) || (NAME).type == dc_dvt(DCDynArrView))
+
+#else
+
+/**
+ * `[MACRO]` Checks if the dynamic value keeps its value in a heap box
+ */
+#define dc_dv_is_boxed(NAME) (false)
+
+#endif
+
+#ifdef DC_DV_COMPACT
+
+/**
+ * `[MACRO]` Number of bytes available to inline strings (DCInlineStr)
+ */
+#define DC_ISTR_SIZE sizeof(u64)
+
+#else
+
+/**
+ * `[MACRO]` Number of bytes available to inline strings (DCInlineStr)
+ */
+#define DC_ISTR_SIZE sizeof(DCStringView)
+
+#endif
+
+/**
+ * `[MACRO]` Maximum length of strings kept inline in a DCInlineStr
+ */
+#define DC_ISTR_MAX_LEN (DC_ISTR_SIZE - 1)
+
+/**
+ * `[MACRO]` Retrieves the characters of an inline string dynamic value (either
+ * inline or on the heap)
+ *
+ * NOTE: The dynamic value must be of type DCInlineStr
+ */
+#define dc_dv_istr_str(NAME)                                                                                                   \
+    ((NAME).istr_heap ? dc_dv_as(NAME, DCInlineStr).heap : dc_dv_as(NAME, DCInlineStr).bytes)
+
 /**
  * `[MACRO]` Checks if the dynamic value is marked as allocated
  */
@@ -326,6 +435,57 @@
  */
 #define dc_dv_nofile() dc_dv(fileptr, NULL)
 
+/**
+ * `[MACRO]` Last built-in dynamic value type, types declared with
+ * `DC_DV_EXTRA_TYPES` come right after it
+ */
+#define DC_DV_LAST_BUILTIN dc_dvt(DCSymbolPtr)
+
+/**
+ * `[MACRO]` Checks if the given dynamic value type is declared with
+ * `DC_DV_EXTRA_TYPES`
+ */
+#define dc_dvt_is_extra(TYPE) ((TYPE) > DC_DV_LAST_BUILTIN)
+
+#ifndef DC_DV_MAX_DEPTH
+
+/**
+ * `[MACRO]` Deepest nesting `dc_dv_hash` and `dc_dv_cmp` follow, it guards
+ * against cycles
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_DV_MAX_DEPTH 256
+
+#endif
+
+#ifndef DC_DV_MAX_EXTRA_TYPES
+
+/**
+ * `[MACRO]` Maximum number of extra types that can be registered with
+ * `dc_dv_register_type`
+ *
+ * NOTE: Can be defined before including `dcommon.h`
+ */
+#define DC_DV_MAX_EXTRA_TYPES 32
+
+#endif
+
+/**
+ * `[MACRO]` Macro to define custom stringify function for dynamic values
+ */
+#define DC_DV_TOSTR_FN_DECL(NAME) DCResString NAME(DCDynVal* _value)
+
+/**
+ * `[MACRO]` Macro to define custom hash function for dynamic values
+ */
+#define DC_DV_HASH_FN_DECL(NAME) DCResU64 NAME(DCDynVal* _value, u64 _seed)
+
+/**
+ * `[MACRO]` Macro to define custom conversion function for dynamic values
+ */
+#define DC_DV_CONVERT_FN_DECL(NAME) DCRes NAME(DCDynVal* _value)
+
 // ***************************************************************************************
 // * STOPPER AND STOPPER CHECKERS
 // *    These are values that can be used as a stopping point in an array
@@ -360,6 +520,7 @@
 
 #define DC_STOPPER_DCDynVal dc_dv_nullptr()
 #define DC_STOPPER_DCStringView ((DCStringView){0})
+#define DC_STOPPER_DCDynArrView ((DCDynArrView){0})
 
 #define DC_IS_STOPPER_i8(EL) (EL == DC_STOPPER_i8)
 #define DC_IS_STOPPER_i16(EL) (EL == DC_STOPPER_i16)
@@ -386,6 +547,7 @@
 
 #define DC_IS_STOPPER_DCDynVal(EL) ((EL).type == dc_dvt(voidptr) && (EL).value.dc_dvf(voidptr) == NULL)
 #define DC_IS_STOPPER_DCStringView(EL) (!(EL).str)
+#define DC_IS_STOPPER_DCDynArrView(EL) (!(EL).elements)
 
 #define DC_IS_STOPPER_DCDynValPtr(EL) ((EL))
 #define DC_IS_STOPPER_DCDynArrPtr(EL) ((EL))
@@ -413,6 +575,32 @@
 #define __dc_attribute(A)
 #endif
 
+#if defined(__GNUC__) || defined(__clang__)
+
+/**
+ * `[MACRO]` Number of trailing zero bits of the given non-zero 64 bit value
+ */
+#define dc_ctz64(X) ((u32)__builtin_ctzll((unsigned long long)(X)))
+
+/**
+ * `[MACRO]` Number of leading zero bits of the given non-zero 64 bit value
+ */
+#define dc_clz64(X) ((u32)__builtin_clzll((unsigned long long)(X)))
+
+#else
+
+/**
+ * `[MACRO]` Number of trailing zero bits of the given non-zero 64 bit value
+ */
+#define dc_ctz64(X) __dc_ctz64((u64)(X))
+
+/**
+ * `[MACRO]` Number of leading zero bits of the given non-zero 64 bit value
+ */
+#define dc_clz64(X) __dc_clz64((u64)(X))
+
+#endif
+
 #if defined(DC_WINDOWS)
 #define DC_BASE_PATH '\\'
 #else
@@ -568,6 +756,12 @@
  */
 #define DC_RES_da() DC_RES2(DCResDa)
 
+/**
+ * `[MACRO]` Defines the main result variable (__dc_res) as DCResDav type and
+ * initiates it as DC_RES_OK
+ */
+#define DC_RES_dav() DC_RES2(DCResDav)
+
 /**
  * `[MACRO]` Defines the main result variable (__dc_res) as DCResHt type and
  * initiates it as DC_RES_OK
@@ -580,6 +774,12 @@
  */
 #define DC_RES_dv() DC_RES2(DCResPtr)
 
+/**
+ * `[MACRO]` Defines the main result variable (__dc_res) as DCResSymbol type
+ * and initiates it as DC_RES_OK
+ */
+#define DC_RES_symbol() DC_RES2(DCResSymbol)
+
 /**
  * `[MACRO]` Defines the main result variable (__dc_res) as DCResI8 type and
  * initiates it as DC_RES_OK
@@ -1333,6 +1533,60 @@
 
 #endif
 
+#ifndef DC_DA_MMAP_THRESHOLD
+
+/**
+ * `[MACRO]` Size in bytes from which dynamic array elements are kept in their own
+ * memory mapping (where supported) so they can grow without copying
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`,
+ * 0 disables memory mapped storage
+ *
+ * NOTE: On Linux such arrays grow in place with `mremap` only if you define
+ * `_GNU_SOURCE` before including any header, otherwise they are copied to a
+ * new mapping
+ */
+#define DC_DA_MMAP_THRESHOLD ((usize)64 * 1024 * 1024)
+
+#endif
+
+#ifndef DC_DA_FILE_HEAP_RESERVE
+
+/**
+ * `[MACRO]` Size in bytes of the address space reserved for the side heap file
+ * of file backed dynamic arrays (see `dc_da_open_file`), it's the upper limit
+ * of string payloads such an array can hold
+ *
+ * NOTE: Only address space is reserved, the file itself grows as needed, you
+ * can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_DA_FILE_HEAP_RESERVE ((usize)1 << (sizeof(usize) > 4 ? 36 : 28))
+
+#endif
+
+#ifndef DC_DA_PAR_MIN_CHUNK
+
+/**
+ * `[MACRO]` Minimum number of elements each thread gets in parallel dynamic array
+ * operations (`dc_da_par_*`), smaller arrays use fewer threads
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_DA_PAR_MIN_CHUNK 16384
+
+#endif
+
+#ifndef DC_CACHE_LINE_SIZE
+
+/**
+ * `[MACRO]` Cache line size in bytes used for splitting work between threads
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_CACHE_LINE_SIZE 64
+
+#endif
+
 /**
  * `[MACRO]` Checks if the given index is correct according to the dynamic array number of
  * elements
@@ -1353,6 +1607,31 @@
  */
 #define dc_da_get_as(DARR, INDEX, TYPE) dc_dv_as(dc_da_get2(DARR, INDEX), TYPE)
 
+/**
+ * `[MACRO]` Where the elements of the given dynamic array are stored (see
+ * `DCDynArrStorage`)
+ */
+#define dc_da_storage(DARR) ((DARR).backing ? (DARR).backing->storage : DC_DA_STORAGE_HEAP)
+
+/**
+ * `[MACRO]` Checks if freeing the elements of the given dynamic array has anything to
+ * release, when false freeing the array skips the elements altogether
+ */
+#define dc_da_has_owned(DARR) ((DARR).element_free_fn != NULL || (DARR).owned_count > 0)
+
+/**
+ * `[MACRO]` Marks dynamic value element at certain index as allocated keeping the
+ * owned element count of the array up to date
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_da_mark_alloc(DARR, INDEX)                                                                                          \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        if (!dc_dv_is_owning((DARR).elements[INDEX])) (DARR).owned_count++;                                                    \
+        dc_dv_mark_alloc((DARR).elements[INDEX]);                                                                              \
+    } while (0)
+
 /**
  * `[MACRO]` Checks if element at certain index is of the given type
  *
@@ -1391,6 +1670,51 @@
 
 // for (usize _idx = 0; _idx < (DARR).count; _idx++)
 
+/**
+ * `[MACRO]` Expands to a view (DCDynArrView) covering all the elements of the
+ * given dynamic array
+ *
+ * NOTE: No memory allocation or copy happens
+ */
+#define dc_da_as_view(DARR) ((DCDynArrView){.elements = (DARR).elements, .count = (DARR).count, .stride = 1})
+
+/**
+ * `[MACRO]` Retrieves pointer to the dynamic value element at certain index of a view
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_dav_get(VIEW, INDEX) (&(VIEW).elements[(INDEX) * (VIEW).stride])
+
+/**
+ * `[MACRO]` Retrieves dynamic value element at certain index of a view and
+ * return the wanted type
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_dav_get_as(VIEW, INDEX, TYPE) dc_dv_as(*dc_dav_get(VIEW, INDEX), TYPE)
+
+/**
+ * `[MACRO]` Expands to a for loop for the given dynamic array view, index (in
+ * the view) can be accessed by `_idx` and the element by `_it`
+ */
+#define dc_dav_for(LABEL, VIEW, ACTIONS)                                                                                       \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize _idx = 0;                                                                                                        \
+        DCDynVal* _it = (VIEW).elements;                                                                                       \
+        while (_idx < (VIEW).count)                                                                                            \
+        {                                                                                                                      \
+            do                                                                                                                 \
+            {                                                                                                                  \
+                ACTIONS;                                                                                                       \
+            } while (0);                                                                                                       \
+            ++_idx;                                                                                                            \
+            _it += (VIEW).stride;                                                                                              \
+        }                                                                                                                      \
+        goto __##LABEL##_exit;                                                                                                 \
+        __##LABEL##_exit :;                                                                                                    \
+    } while (0)
+
 /**
  * `[MACRO]` Macro to initialize the dynamic array with initial values without providing
  * the count
@@ -1555,8 +1879,17 @@
 
 /**
  * `[MACRO]` Internal macro to generate code for dynamic array to flat array conversion
+ *
+ * NOTE: The conversion is done on a view covering the whole array
  */
 #define __DC_DA_CONVERT_IMPL(TYPE)                                                                                             \
+    DCDynArrView __view = arr ? dc_da_as_view(*arr) : (DCDynArrView){0};                                                       \
+    return dc_##TYPE##_dav_to_flat_arr(&__view, out_arr, must_fail)
+
+/**
+ * `[MACRO]` Internal macro to generate code for dynamic array view to flat array conversion
+ */
+#define __DC_DAV_CONVERT_IMPL(TYPE)                                                                                            \
     DC_RES_usize();                                                                                                            \
     if (!arr || arr->count == 0 || !out_arr)                                                                                   \
     {                                                                                                                          \
@@ -1574,7 +1907,7 @@
     usize dest_index = 0;                                                                                                      \
     for (usize i = 0; i < arr->count; ++i)                                                                                     \
     {                                                                                                                          \
-        DCDynVal* elem = &arr->elements[i];                                                                                    \
+        DCDynVal* elem = dc_dav_get(*arr, i);                                                                                  \
         if (elem->type != dc_dvt(TYPE))                                                                                        \
         {                                                                                                                      \
             if (must_fail)                                                                                                     \
@@ -1592,6 +1925,262 @@
     (*out_arr)[dest_index] = dc_stopper(TYPE);                                                                                 \
     dc_ret_ok(dest_index)
 
+// ***************************************************************************************
+// * DEQUE MACROS
+// ***************************************************************************************
+
+#ifndef DC_DQ_INITIAL_CAP
+
+/**
+ * `[MACRO]` Default initial capacity for deque
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`,
+ * it must be a power of two
+ */
+#define DC_DQ_INITIAL_CAP 8
+
+#endif
+
+/**
+ * `[MACRO]` Retrieves dynamic value element at certain index (counted from the
+ * front) of a deque as is
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_dq_get2(DQ, INDEX) ((DQ).elements[((DQ).head + (INDEX)) & ((DQ).cap - 1)])
+
+/**
+ * `[MACRO]` Retrieves dynamic value element at certain index of a deque and
+ * return the wanted type
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_dq_get_as(DQ, INDEX, TYPE) dc_dv_as(dc_dq_get2(DQ, INDEX), TYPE)
+
+/**
+ * `[MACRO]` Expands to a for loop over the given deque from front to back, index
+ * can be accessed by `_idx` and the element by `_it`
+ */
+#define dc_dq_for(LABEL, DQ, ACTIONS)                                                                                          \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize _idx = 0;                                                                                                        \
+        while (_idx < (DQ).count)                                                                                              \
+        {                                                                                                                      \
+            DCDynVal* _it = &dc_dq_get2(DQ, _idx);                                                                             \
+            do                                                                                                                 \
+            {                                                                                                                  \
+                ACTIONS;                                                                                                       \
+            } while (0);                                                                                                       \
+            ++_idx;                                                                                                            \
+        }                                                                                                                      \
+        goto __##LABEL##_exit;                                                                                                 \
+        __##LABEL##_exit :;                                                                                                    \
+    } while (0)
+
+// ***************************************************************************************
+// * SEGMENTED ARRAY MACROS
+// ***************************************************************************************
+
+#ifndef DC_SA_FIRST_CHUNK_BITS
+
+/**
+ * `[MACRO]` Log2 of the number of elements in the first chunk of segmented
+ * arrays (every next chunk is twice as big as the previous one)
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_SA_FIRST_CHUNK_BITS 4
+
+#endif
+
+/**
+ * `[MACRO]` Number of elements in the first chunk of segmented arrays
+ */
+#define DC_SA_FIRST_CHUNK ((usize)1 << DC_SA_FIRST_CHUNK_BITS)
+
+/**
+ * `[MACRO]` Maximum number of chunks in a segmented array, enough to address
+ * the whole 64 bit space
+ */
+#define DC_SA_MAX_CHUNKS (64 - DC_SA_FIRST_CHUNK_BITS)
+
+/**
+ * `[MACRO]` Chunk number that holds the element at the given index
+ */
+#define dc_sa_chunk_of(INDEX) ((usize)(63 - dc_clz64((u64)(INDEX) + DC_SA_FIRST_CHUNK)) - DC_SA_FIRST_CHUNK_BITS)
+
+/**
+ * `[MACRO]` Index of the first element of the given chunk
+ */
+#define dc_sa_chunk_start(CHUNK) ((DC_SA_FIRST_CHUNK << (CHUNK)) - DC_SA_FIRST_CHUNK)
+
+/**
+ * `[MACRO]` Number of elements the given chunk holds
+ */
+#define dc_sa_chunk_cap(CHUNK) (DC_SA_FIRST_CHUNK << (CHUNK))
+
+/**
+ * `[MACRO]` Retrieves dynamic value element at certain index of a segmented
+ * array as is
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ *
+ * NOTE: INDEX is evaluated more than once
+ */
+#define dc_sa_get2(SA, INDEX)                                                                                                  \
+    ((SA).chunks[dc_sa_chunk_of(INDEX)][(INDEX) - dc_sa_chunk_start(dc_sa_chunk_of(INDEX))])
+
+/**
+ * `[MACRO]` Retrieves dynamic value element at certain index of a segmented
+ * array and return the wanted type
+ *
+ * NOTE: There is no boundary check in this macro, you have to do it beforehand
+ */
+#define dc_sa_get_as(SA, INDEX, TYPE) dc_dv_as(dc_sa_get2(SA, INDEX), TYPE)
+
+/**
+ * `[MACRO]` Expands to a for loop over the given segmented array walking it
+ * chunk by chunk, index can be accessed by `_idx` and the element by `_it`
+ */
+#define dc_sa_for(LABEL, SA, ACTIONS)                                                                                          \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize _idx = 0;                                                                                                        \
+        for (usize __chunk = 0; _idx < (SA).count; ++__chunk)                                                                  \
+        {                                                                                                                      \
+            DCDynVal* _it = (SA).chunks[__chunk];                                                                              \
+            usize __chunk_end = dc_sa_chunk_start(__chunk + 1);                                                                \
+            for (; _idx < (SA).count && _idx < __chunk_end; ++_idx, ++_it)                                                     \
+            {                                                                                                                  \
+                do                                                                                                             \
+                {                                                                                                              \
+                    ACTIONS;                                                                                                   \
+                } while (0);                                                                                                   \
+            }                                                                                                                  \
+        }                                                                                                                      \
+        goto __##LABEL##_exit;                                                                                                 \
+        __##LABEL##_exit :;                                                                                                    \
+    } while (0)
+
+// ***************************************************************************************
+// * ARENA MACROS
+// ***************************************************************************************
+
+#ifndef DC_ARENA_CHUNK_SIZE
+
+/**
+ * `[MACRO]` Default size in bytes of arena chunks, bigger allocations get a
+ * chunk of their own
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_ARENA_CHUNK_SIZE ((usize)64 * 1024)
+
+#endif
+
+/**
+ * `[MACRO]` Alignment of every allocation taken from an arena
+ */
+#define DC_ARENA_ALIGN ((usize)16)
+
+/**
+ * `[MACRO]` Rounds the given size up to `DC_ARENA_ALIGN`
+ */
+#define dc_arena_align(SIZE) (((SIZE) + DC_ARENA_ALIGN - 1) & ~(DC_ARENA_ALIGN - 1))
+
+// ***************************************************************************************
+// * STRING INTERNING MACROS
+// ***************************************************************************************
+
+#ifndef DC_INTERN_INITIAL_CAP
+
+/**
+ * `[MACRO]` Initial number of slots of intern pools, the slots are doubled
+ * whenever they get half full
+ *
+ * NOTE: Must be a power of two, can be defined before including `dcommon.h`
+ */
+#define DC_INTERN_INITIAL_CAP 64
+
+#endif
+
+/**
+ * `[MACRO]` Text of the symbol held by the given dynamic value
+ */
+#define dc_dv_symbol_str(NAME) (dc_dv_as(NAME, DCSymbolPtr)->str)
+
+// ***************************************************************************************
+// * BINARY SERIALIZATION MACROS
+// ***************************************************************************************
+
+#ifndef DC_BIN_FLUSH_SIZE
+
+/**
+ * `[MACRO]` Number of buffered bytes from which binary writers with a file
+ * flush their buffer
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_BIN_FLUSH_SIZE ((usize)64 * 1024)
+
+#endif
+
+#ifndef DC_BIN_MAX_DEPTH
+
+/**
+ * `[MACRO]` Deepest nesting of arrays, hash tables and pairs binary writers and
+ * readers accept, it guards against cycles and hostile input
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_BIN_MAX_DEPTH 256
+
+#endif
+
+/**
+ * `[MACRO]` Checks if the binary reader has consumed all of its input
+ */
+#define dc_br_done(BR) ((BR).pos >= (BR).len)
+
+// ***************************************************************************************
+// * JSON MACROS
+// ***************************************************************************************
+
+/**
+ * `[MACRO]` Initial capacity of the scratch buffers of JSON parsers
+ */
+#define DC_JSON_INITIAL_CAP 256
+
+#ifndef DC_JSON_MAX_DEPTH
+
+/**
+ * `[MACRO]` Deepest nesting of arrays and objects JSON parsers accept and JSON
+ * writers write, it guards against hostile input and cycles
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_JSON_MAX_DEPTH 256
+
+#endif
+
+#ifndef DC_JSON_FLUSH_SIZE
+
+/**
+ * `[MACRO]` Number of buffered bytes from which JSON writers with a file flush
+ * their buffer
+ *
+ * NOTE: You can define it with your desired amount before including `dcommon.h`
+ */
+#define DC_JSON_FLUSH_SIZE ((usize)64 * 1024)
+
+#endif
+
+/**
+ * `[MACRO]` Checks if the JSON parser has consumed all of its input
+ */
+#define dc_json_done(JP) ((JP).pos >= (JP).len)
+
 // ***************************************************************************************
 // * HASH TABLE MACROS
 // ***************************************************************************************
@@ -1744,6 +2333,89 @@
         dc_try_fail_temp(__dc_ht_set_multiple(HT, dc_count(__initial_values), __initial_values, STATUS));                      \
     } while (0)
 
+// ***************************************************************************************
+// * REFERENCE COUNTING MACROS
+// ***************************************************************************************
+
+/**
+ * `[MACRO]` Returns the reference counted box of the given handle (a DCRcPtr
+ * dynamic value)
+ */
+#define dc_rc_of(HANDLE) dc_dv_as(HANDLE, DCRcPtr)
+
+/**
+ * `[MACRO]` Returns the dynamic array behind the given handle for reading
+ *
+ * NOTE: Use `dc_rc_da_mut` to get an array that can be changed
+ */
+#define dc_rc_da(HANDLE) ((DCDynArr*)dc_rc_of(HANDLE)->data)
+
+/**
+ * `[MACRO]` Returns the hash table behind the given handle for reading
+ *
+ * NOTE: Use `dc_rc_ht_mut` to get a hash table that can be changed
+ */
+#define dc_rc_ht(HANDLE) ((DCHashTable*)dc_rc_of(HANDLE)->data)
+
+/**
+ * `[MACRO]` Creates a not allocated (borrowed) dynamic value of the container
+ * in the given reference counted box
+ */
+#define dc_rc_dv(RC)                                                                                                           \
+    ((RC)->type == dc_dvt(DCDynArrPtr) ? dc_dv(DCDynArrPtr, (DCDynArr*)(RC)->data)                                             \
+                                       : dc_dv(DCHashTablePtr, (DCHashTable*)(RC)->data))
+
+// ***************************************************************************************
+// * B-TREE MACROS
+// ***************************************************************************************
+
+#ifndef DC_BT_ORDER
+
+/**
+ * `[MACRO]` Maximum number of keys in a B+tree node, wider nodes mean a
+ * shallower tree and fewer cache misses per lookup
+ *
+ * NOTE: You can define it with your desired amount (at least 4) before
+ * including `dcommon.h`
+ */
+#define DC_BT_ORDER 32
+
+#endif
+
+/**
+ * `[MACRO]` Minimum number of keys of every B+tree node but the root
+ */
+#define DC_BT_MIN_KEYS ((DC_BT_ORDER - 1) / 2)
+
+// ***************************************************************************************
+// * HEAP MACROS
+// ***************************************************************************************
+
+/**
+ * `[MACRO]` Number of children of each heap node, four children of a node sit
+ * next to each other so a sift down touches fewer cache lines than a binary
+ * heap and the heap is half as deep
+ */
+#define DC_HEAP_ARITY 4
+
+/**
+ * `[MACRO]` Position of a heap handle that is not in the heap
+ */
+#define DC_HEAP_NO_POS SIZE_MAX
+
+/**
+ * `[MACRO]` Number of elements in the heap
+ */
+#define dc_heap_count(HEAP) ((HEAP).darr->count)
+
+/**
+ * `[MACRO]` Smallest element of the heap
+ *
+ * NOTE: There is no check for an empty heap in this macro, you have to do it
+ * beforehand
+ */
+#define dc_heap_top(HEAP) ((HEAP).darr->elements[0])
+
 // ***************************************************************************************
 // * STRING VIEW MACROS
 // ***************************************************************************************
@@ -1803,6 +2475,32 @@
  */
 #define dc_sv_sv_eq(SV1, SV2) (((SV1).len == (SV2).len) && (strncmp((SV1).str, (SV2).str, (SV1).len) == 0))
 
+// ***************************************************************************************
+// * STRING BUILDER MACROS
+// ***************************************************************************************
+
+#ifndef DC_SB_INITIAL_CAP
+
+/**
+ * `[MACRO]` Initial capacity of string builders (including the terminator)
+ *
+ * NOTE: Can be defined before including `dcommon.h`
+ */
+#define DC_SB_INITIAL_CAP 64
+
+#endif
+
+/**
+ * `[MACRO]` Content of the string builder, an empty string when nothing is
+ * appended yet
+ */
+#define dc_sb_str(SB) ((SB).buf ? (SB).buf : "")
+
+/**
+ * `[MACRO]` Appends a NULL terminated string to the string builder
+ */
+#define dc_sb_append_str(SB, STR) dc_sb_append((SB), (STR), strlen(STR))
+
 // ***************************************************************************************
 // * COLOR MACROS
 // ***************************************************************************************
@@ -0,0 +1,340 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _heap.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for heap (priority queue)
+// *               functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_heap.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#define __dc_heap_parent(INDEX) (((INDEX) - 1) / DC_HEAP_ARITY)
+#define __dc_heap_first_child(INDEX) ((INDEX) * DC_HEAP_ARITY + 1)
+
+/**
+ * Makes room for at least `needed` handles
+ */
+static DCResVoid __dc_heap_reserve_handles(DCHeap* heap, usize needed)
+{
+    DC_RES_void();
+
+    if (needed <= heap->handle_cap) dc_ret();
+
+    usize new_cap = heap->handle_cap == 0 ? DC_DA_INITIAL_CAP : heap->handle_cap;
+    while (new_cap < needed) new_cap *= 2;
+
+    usize* handle_at = (usize*)realloc(heap->handle_at, new_cap * sizeof(usize));
+    if (handle_at == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    heap->handle_at = handle_at;
+
+    usize* pos_of = (usize*)realloc(heap->pos_of, new_cap * sizeof(usize));
+    if (pos_of == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    heap->pos_of = pos_of;
+    heap->handle_cap = new_cap;
+
+    dc_ret();
+}
+
+static void __dc_heap_swap(DCHeap* heap, usize i, usize j)
+{
+    DCDynVal tmp = heap->darr->elements[i];
+    heap->darr->elements[i] = heap->darr->elements[j];
+    heap->darr->elements[j] = tmp;
+
+    usize handle = heap->handle_at[i];
+    heap->handle_at[i] = heap->handle_at[j];
+    heap->handle_at[j] = handle;
+
+    heap->pos_of[heap->handle_at[i]] = i;
+    heap->pos_of[heap->handle_at[j]] = j;
+}
+
+/**
+ * Moves the element at the given index up while it is smaller than its parent,
+ * returns its final index
+ */
+static DCResUsize __dc_heap_sift_up(DCHeap* heap, usize index)
+{
+    DC_RES_usize();
+
+    DCDynVal* elements = heap->darr->elements;
+
+    while (index > 0)
+    {
+        usize parent = __dc_heap_parent(index);
+
+        dc_try_or_fail_with3(DCResI32, cmp_res, heap->cmp_fn(&elements[index], &elements[parent]), {});
+        if (dc_unwrap2(cmp_res) >= 0) break;
+
+        __dc_heap_swap(heap, index, parent);
+        index = parent;
+    }
+
+    dc_ret_ok(index);
+}
+
+/**
+ * Moves the element at the given index down while one of its children is
+ * smaller
+ */
+static DCResVoid __dc_heap_sift_down(DCHeap* heap, usize index)
+{
+    DC_RES_void();
+
+    DCDynVal* elements = heap->darr->elements;
+    usize count = heap->darr->count;
+
+    while (true)
+    {
+        usize first = __dc_heap_first_child(index);
+        if (first >= count) break;
+
+        usize last = first + DC_HEAP_ARITY < count ? first + DC_HEAP_ARITY : count;
+
+        usize smallest = first;
+        for (usize child = first + 1; child < last; ++child)
+        {
+            dc_try_or_fail_with3(DCResI32, cmp_res, heap->cmp_fn(&elements[child], &elements[smallest]), {});
+            if (dc_unwrap2(cmp_res) < 0) smallest = child;
+        }
+
+        dc_try_or_fail_with3(DCResI32, cmp_res, heap->cmp_fn(&elements[smallest], &elements[index]), {});
+        if (dc_unwrap2(cmp_res) >= 0) break;
+
+        __dc_heap_swap(heap, index, smallest);
+        index = smallest;
+    }
+
+    dc_ret();
+}
+
+/**
+ * Returns the index of the element of the given handle
+ */
+static DCResUsize __dc_heap_pos(DCHeap* heap, usize handle)
+{
+    DC_RES_usize();
+
+    if (handle >= heap->handle_count || heap->pos_of[handle] == DC_HEAP_NO_POS)
+    {
+        dc_dbg_log("invalid heap handle: " dc_fmt(usize), handle);
+
+        dc_ret_e(4, "invalid heap handle");
+    }
+
+    dc_ret_ok(heap->pos_of[handle]);
+}
+
+DCResVoid dc_heap_init(DCHeap* heap, DCDynArr* darr, DCDvCmpFn cmp_fn)
+{
+    DC_RES_void();
+
+    if (!heap || !darr)
+    {
+        dc_dbg_log("got NULL DCHeap or DCDynArr");
+
+        dc_ret_e(1, "got NULL DCHeap or DCDynArr");
+    }
+
+    heap->darr = darr;
+    heap->cmp_fn = cmp_fn ? cmp_fn : dc_dv_cmp;
+
+    heap->handle_at = NULL;
+    heap->pos_of = NULL;
+    heap->handle_count = 0;
+    heap->handle_cap = 0;
+
+    dc_try_fail(__dc_heap_reserve_handles(heap, darr->count));
+
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        heap->handle_at[i] = i;
+        heap->pos_of[i] = i;
+    }
+
+    heap->handle_count = darr->count;
+
+    // Bottom up heap construction, O(n) as most nodes are near the leaves
+    if (darr->count < 2) dc_ret();
+
+    usize i = __dc_heap_parent(darr->count - 1) + 1;
+    while (i-- > 0) dc_try_fail(__dc_heap_sift_down(heap, i));
+
+    dc_ret();
+}
+
+DCResVoid dc_heap_free(DCHeap* heap)
+{
+    DC_RES_void();
+
+    if (!heap) dc_ret();
+
+    free(heap->handle_at);
+    free(heap->pos_of);
+
+    heap->handle_at = NULL;
+    heap->pos_of = NULL;
+    heap->handle_count = 0;
+    heap->handle_cap = 0;
+
+    dc_ret();
+}
+
+DCResUsize dc_heap_push(DCHeap* heap, DCDynVal value)
+{
+    DC_RES_usize();
+
+    if (!heap)
+    {
+        dc_dbg_log("got NULL DCHeap");
+
+        dc_ret_e(1, "got NULL DCHeap");
+    }
+
+    usize index = heap->darr->count;
+
+    // Handles of popped elements wait right after the last element
+    if (index == heap->handle_count)
+    {
+        dc_try_fail_temp(DCResVoid, __dc_heap_reserve_handles(heap, heap->handle_count + 1));
+
+        heap->handle_at[index] = heap->handle_count++;
+    }
+
+    dc_try_fail_temp(DCResVoid, dc_da_push(heap->darr, value));
+
+    usize handle = heap->handle_at[index];
+    heap->pos_of[handle] = index;
+
+    dc_try_fail_temp(DCResUsize, __dc_heap_sift_up(heap, index));
+
+    dc_ret_ok(handle);
+}
+
+DCResVoid dc_heap_pop(DCHeap* heap, DCDynVal* out_popped)
+{
+    DC_RES_void();
+
+    if (!heap)
+    {
+        dc_dbg_log("got NULL DCHeap");
+
+        dc_ret_e(1, "got NULL DCHeap");
+    }
+
+    DCDynArr* darr = heap->darr;
+
+    if (darr->count == 0)
+    {
+        dc_dbg_log("Try to pop from an empty heap");
+
+        dc_ret_e(4, "Try to pop from an empty heap");
+    }
+
+    usize last = darr->count - 1;
+    __dc_heap_swap(heap, 0, last);
+
+    heap->pos_of[heap->handle_at[last]] = DC_HEAP_NO_POS;
+
+    if (out_popped)
+    {
+        // The caller takes the ownership
+        *out_popped = darr->elements[last];
+
+        if (dc_dv_is_owning(*out_popped) && darr->owned_count > 0) darr->owned_count--;
+
+        darr->count--;
+    }
+    else
+    {
+        dc_try_fail(dc_da_pop(darr, 1, NULL, false));
+    }
+
+    if (darr->count > 1) dc_try_fail(__dc_heap_sift_down(heap, 0));
+
+    dc_ret();
+}
+
+DCResPtr dc_heap_get(DCHeap* heap, usize handle)
+{
+    DC_RES_dv();
+
+    if (!heap)
+    {
+        dc_dbg_log("got NULL DCHeap");
+
+        dc_ret_e(1, "got NULL DCHeap");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, pos, __dc_heap_pos(heap, handle), {});
+
+    dc_ret_ok(&heap->darr->elements[dc_unwrap2(pos)]);
+}
+
+DCResVoid dc_heap_fix(DCHeap* heap, usize handle)
+{
+    DC_RES_void();
+
+    if (!heap)
+    {
+        dc_dbg_log("got NULL DCHeap");
+
+        dc_ret_e(1, "got NULL DCHeap");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, pos, __dc_heap_pos(heap, handle), {});
+
+    // Only one of them moves the element
+    dc_try_or_fail_with3(DCResUsize, moved, __dc_heap_sift_up(heap, dc_unwrap2(pos)), {});
+    if (dc_unwrap2(moved) == dc_unwrap2(pos)) dc_try_fail(__dc_heap_sift_down(heap, dc_unwrap2(pos)));
+
+    dc_ret();
+}
+
+DCResVoid dc_heap_update(DCHeap* heap, usize handle, DCDynVal value)
+{
+    DC_RES_void();
+
+    if (!heap)
+    {
+        dc_dbg_log("got NULL DCHeap");
+
+        dc_ret_e(1, "got NULL DCHeap");
+    }
+
+    dc_try_or_fail_with3(DCResUsize, pos, __dc_heap_pos(heap, handle), {});
+    dc_try_fail(dc_da_set(heap->darr, dc_unwrap2(pos), value));
+
+    return dc_heap_fix(heap, handle);
+}
+
+#undef __dc_heap_parent
+#undef __dc_heap_first_child
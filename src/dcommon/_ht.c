@@ -45,8 +45,9 @@ DCResVoid dc_ht_init(DCHashTable* ht, usize capacity, DCHashFn hash_fn, DCKeyCom
     ht->cap = capacity;
     ht->key_count = 0;
 
-    ht->hash_fn = hash_fn;
-    ht->key_cmp_fn = key_cmp_fn;
+    // Defaults agree with each other, equal keys always get the same hash
+    ht->hash_fn = hash_fn ? hash_fn : __dc_ht_dv_hash;
+    ht->key_cmp_fn = key_cmp_fn ? key_cmp_fn : __dc_ht_dv_key_cmp;
     ht->pair_free_fn = pair_free_fn;
 
     dc_ret();
@@ -87,16 +88,19 @@ DCResVoid dc_ht_free(DCHashTable* ht)
     {
         DC_HT_GET_AND_DEF_CONTAINER_ROW(darr, *ht, i);
 
-        dc_da_for(ht_element_free_loop, *darr, {
-            if (ht->pair_free_fn) dc_try_fail(ht->pair_free_fn(dc_dv_as(*_it, DCPairPtr)));
+        // Rows of not allocated pairs without a pair free function have nothing to release
+        if (ht->pair_free_fn || dc_da_has_owned(*darr))
+        {
+            dc_da_for(ht_element_free_loop, *darr, {
+                if (ht->pair_free_fn) dc_try_fail(ht->pair_free_fn(dc_dv_as(*_it, DCPairPtr)));
 
-            if (dc_dv_is_allocated(*_it) && dc_dv_as(*_it, DCPairPtr) != NULL) free(dc_dv_as(*_it, DCPairPtr));
-        });
+                if (dc_dv_is_allocated(*_it) && dc_dv_as(*_it, DCPairPtr) != NULL) free(dc_dv_as(*_it, DCPairPtr));
+            });
+        }
 
-        free(darr->elements);
-        darr->elements = NULL;
-        darr->cap = 0;
+        // Pairs are already released, what's left is the row storage itself
         darr->count = 0;
+        dc_try_fail(dc_da_free(darr));
     }
 
     free(ht->container);
@@ -165,6 +169,51 @@ DCResUsize dc_ht_find_by_key(DCHashTable* ht, DCDynVal key, DCDynVal** out_resul
     dc_ret_ok(0);
 }
 
+/**
+ * Creates the pair of a new entry of `row`, rows taken from an arena (parsed or
+ * cloned tables) take their pairs from the same arena and don't mark them as
+ * allocated
+ */
+static DCRes __dc_ht_new_pair(DCDynArr* row, DCDynVal key, DCDynVal value)
+{
+    DC_RES();
+
+    DCPair* pair = NULL;
+
+    if (dc_da_storage(*row) == DC_DA_STORAGE_ARENA)
+    {
+        dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc((DCArena*)row->backing->data, sizeof(DCPair)), {});
+
+        pair = (DCPair*)dc_unwrap2(memory);
+    }
+    else
+    {
+        pair = (DCPair*)malloc(sizeof(DCPair));
+        if (pair == NULL)
+        {
+            dc_dbg_log("Memory allocation failed");
+
+            dc_ret_e(2, "Memory allocation failed");
+        }
+    }
+
+    pair->first = key;
+    pair->second = value;
+
+    if (dc_da_storage(*row) == DC_DA_STORAGE_ARENA) dc_ret_ok(dc_dv(DCPairPtr, pair));
+
+    dc_ret_ok(dc_dva(DCPairPtr, pair));
+}
+
+/**
+ * Releases a pair made by `__dc_ht_new_pair` (not its key or value), pairs of
+ * arena rows are left to the arena
+ */
+static void __dc_ht_drop_pair(DCDynVal* pair)
+{
+    if (dc_dv_is_allocated(*pair)) free(dc_dv_as(*pair, DCPairPtr));
+}
+
 DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSetStatus set_status)
 {
     DC_RES_void();
@@ -178,19 +227,10 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
 
     dc_try_fail_temp_ht_get_hash(_index, *ht, &key);
 
-    DCPair* new_pair = (DCPair*)malloc(sizeof(DCPair));
-    if (new_pair == NULL)
-    {
-        dc_dbg_log("Memory allocation failed");
-
-        dc_ret_e(2, "Memory allocation failed");
-    }
-
-    new_pair->first = key;
-    new_pair->second = value;
-
     DC_HT_GET_AND_DEF_CONTAINER_ROW(current_row, *ht, _index);
 
+    dc_try_or_fail_with3(DCRes, new_pair, __dc_ht_new_pair(current_row, key, value), {});
+
     // The row has not been initialized before
     // So the key definitely does not exist
     if (current_row->cap == 0)
@@ -202,8 +242,10 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
         if (set_status == DC_HT_SET_CREATE_OR_UPDATE || set_status == DC_HT_SET_CREATE_OR_NOTHING ||
             set_status == DC_HT_SET_CREATE_OR_FAIL)
         {
-            dc_try_fail(dc_da_init(current_row, NULL));
-            dc_try_fail(dc_da_push(current_row, dc_dva(DCPairPtr, new_pair)));
+            // Empty arena rows are already initialized and grow inside their arena
+            if (dc_da_storage(*current_row) != DC_DA_STORAGE_ARENA) dc_try_fail(dc_da_init(current_row, NULL));
+
+            dc_try_fail(dc_da_push(current_row, dc_unwrap2(new_pair)));
 
             ht->key_count++;
 
@@ -215,7 +257,7 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
         //  - DC_HT_SET_UPDATE_OR_NOTHING
         // That indicates user assumes key must already exist
         // First we need to free the allocated pair
-        free(new_pair);
+        __dc_ht_drop_pair(&dc_unwrap2(new_pair));
 
         // And if it's DC_HT_SET_UPDATE_OR_FAIL we need to return an error
         if (set_status == DC_HT_SET_UPDATE_OR_FAIL)
@@ -245,9 +287,9 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
 
             if (ht->pair_free_fn) dc_try_fail(ht->pair_free_fn(old_pair));
 
-            free(old_pair);
+            __dc_ht_drop_pair(&current_row->elements[existed_index]);
 
-            current_row->elements[existed_index] = dc_dva(DCPairPtr, new_pair);
+            current_row->elements[existed_index] = dc_unwrap2(new_pair);
 
             dc_ret();
         }
@@ -257,7 +299,7 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
         //  - DC_HT_SET_CREATE_OR_NOTHING
         // That indicates user assumes key must not exist beforehand
         // First we need to free the allocated pair
-        free(new_pair);
+        __dc_ht_drop_pair(&dc_unwrap2(new_pair));
 
         // And if it's DC_HT_SET_CREATE_OR_FAIL we need to return an error
         if (set_status == DC_HT_SET_CREATE_OR_FAIL)
@@ -275,7 +317,7 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
     if (set_status == DC_HT_SET_CREATE_OR_UPDATE || set_status == DC_HT_SET_CREATE_OR_NOTHING ||
         set_status == DC_HT_SET_CREATE_OR_FAIL)
     {
-        dc_try_fail(dc_da_push(current_row, dc_dva(DCPairPtr, new_pair)));
+        dc_try_fail(dc_da_push(current_row, dc_unwrap2(new_pair)));
         ht->key_count++;
 
         dc_ret();
@@ -286,7 +328,7 @@ DCResVoid dc_ht_set(DCHashTable* ht, DCDynVal key, DCDynVal value, DCHashTableSe
     //  - DC_HT_SET_UPDATE_OR_NOTHING
     // That indicates user assumes key must exists
     // First we need to free the allocated pair
-    free(new_pair);
+    __dc_ht_drop_pair(&dc_unwrap2(new_pair));
 
     // And if it's DC_HT_SET_UPDATE_OR_FAIL we need to return an error
     if (set_status == DC_HT_SET_UPDATE_OR_FAIL)
@@ -0,0 +1,380 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _intern.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for string interning (symbol
+// *               table) functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_intern.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#include <windows.h>
+
+#define __dc_intern_try_lock(POOL) (_InterlockedExchange((volatile long*)&(POOL)->lock, 1) == 0)
+#define __dc_intern_is_locked(POOL) (_InterlockedOr((volatile long*)&(POOL)->lock, 0) != 0)
+#define __dc_intern_unlock(POOL) _InterlockedExchange((volatile long*)&(POOL)->lock, 0)
+#define __dc_intern_yield() SwitchToThread()
+
+#else
+#include <sched.h>
+
+#define __dc_intern_try_lock(POOL) (__atomic_exchange_n(&(POOL)->lock, 1, __ATOMIC_ACQUIRE) == 0)
+#define __dc_intern_is_locked(POOL) (__atomic_load_n(&(POOL)->lock, __ATOMIC_RELAXED) != 0)
+#define __dc_intern_unlock(POOL) __atomic_store_n(&(POOL)->lock, 0, __ATOMIC_RELEASE)
+#define __dc_intern_yield() sched_yield()
+
+#endif
+
+static void __dc_intern_lock(DCInternPool* pool)
+{
+    // Waiting on a plain load keeps the lock's cache line shared until it's released
+    while (!__dc_intern_try_lock(pool))
+    {
+        while (__dc_intern_is_locked(pool)) __dc_intern_yield();
+    }
+}
+
+/**
+ * FNV-1a hash of `len` bytes of the given string
+ */
+static u64 __dc_intern_hash(const string str, usize len)
+{
+    u64 hash = 0xcbf29ce484222325ull;
+
+    for (usize i = 0; i < len; ++i)
+    {
+        hash ^= (u8)str[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash;
+}
+
+/**
+ * Returns the slot holding the symbol of the given text or the empty slot where
+ * it belongs
+ */
+static DCSymbol** __dc_intern_slot(DCSymbol** slots, usize cap, const string str, usize len, u64 hash)
+{
+    usize i = (usize)hash & (cap - 1);
+
+    while (slots[i] != NULL)
+    {
+        DCSymbol* symbol = slots[i];
+        if (symbol->hash == hash && symbol->len == len && (len == 0 || memcmp(symbol->str, str, len) == 0)) break;
+
+        i = (i + 1) & (cap - 1);
+    }
+
+    return &slots[i];
+}
+
+/**
+ * Doubles the slots and puts every symbol in its new place, nothing is compared
+ * as all the symbols are different
+ */
+static DCResVoid __dc_intern_grow_slots(DCInternPool* pool)
+{
+    DC_RES_void();
+
+    usize new_cap = pool->slot_cap * 2;
+
+    DCSymbol** slots = (DCSymbol**)calloc(new_cap, sizeof(DCSymbol*));
+    if (slots == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    for (usize i = 0; i < pool->count; ++i)
+    {
+        DCSymbol* symbol = pool->symbols[i];
+
+        usize j = (usize)symbol->hash & (new_cap - 1);
+        while (slots[j] != NULL) j = (j + 1) & (new_cap - 1);
+
+        slots[j] = symbol;
+    }
+
+    free(pool->slots);
+
+    pool->slots = slots;
+    pool->slot_cap = new_cap;
+
+    dc_ret();
+}
+
+/**
+ * Makes room for one more symbol in the id lookup
+ */
+static DCResVoid __dc_intern_grow_symbols(DCInternPool* pool)
+{
+    DC_RES_void();
+
+    if (pool->count < pool->symbol_cap) dc_ret();
+
+    usize new_cap = pool->symbol_cap == 0 ? DC_INTERN_INITIAL_CAP : pool->symbol_cap * 2;
+
+    DCSymbol** symbols = (DCSymbol**)realloc(pool->symbols, new_cap * sizeof(DCSymbol*));
+    if (symbols == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    pool->symbols = symbols;
+    pool->symbol_cap = new_cap;
+
+    dc_ret();
+}
+
+/**
+ * Finds (and when `add` is true interns) the given text, the pool must be
+ * locked
+ */
+static DCResSymbol __dc_intern_locked(DCInternPool* pool, const string str, usize len, b1 add)
+{
+    DC_RES_symbol();
+
+    u64 hash = __dc_intern_hash(str, len);
+
+    DCSymbol** slot = __dc_intern_slot(pool->slots, pool->slot_cap, str, len, hash);
+    if (*slot != NULL || !add) dc_ret_ok(*slot);
+
+    if (pool->count >= UINT32_MAX)
+    {
+        dc_dbg_log("intern pool is full");
+
+        dc_ret_e(4, "intern pool is full");
+    }
+
+    // Slots are kept at most half full so probes stay short
+    if ((pool->count + 1) * 2 > pool->slot_cap)
+    {
+        dc_try_fail_temp(DCResVoid, __dc_intern_grow_slots(pool));
+
+        slot = __dc_intern_slot(pool->slots, pool->slot_cap, str, len, hash);
+    }
+
+    dc_try_fail_temp(DCResVoid, __dc_intern_grow_symbols(pool));
+
+    // The text follows the symbol in the arena
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(&pool->arena, sizeof(DCSymbol) + len + 1), {});
+
+    DCSymbol* symbol = (DCSymbol*)dc_unwrap2(memory);
+    symbol->str = (string)(symbol + 1);
+    symbol->len = len;
+    symbol->hash = hash;
+    symbol->id = (u32)pool->count;
+
+    if (len > 0) memcpy(symbol->str, str, len);
+    symbol->str[len] = '\0';
+
+    *slot = symbol;
+    pool->symbols[pool->count++] = symbol;
+
+    dc_ret_ok(symbol);
+}
+
+DCResVoid dc_intern_init(DCInternPool* pool, usize capacity)
+{
+    DC_RES_void();
+
+    if (!pool)
+    {
+        dc_dbg_log("got NULL DCInternPool");
+
+        dc_ret_e(1, "got NULL DCInternPool");
+    }
+
+    usize slot_cap = DC_INTERN_INITIAL_CAP;
+    if (capacity > 0)
+    {
+        slot_cap = 1;
+        while (slot_cap < capacity) slot_cap *= 2;
+    }
+
+    pool->slots = (DCSymbol**)calloc(slot_cap, sizeof(DCSymbol*));
+    if (pool->slots == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    pool->slot_cap = slot_cap;
+
+    pool->symbols = NULL;
+    pool->count = 0;
+    pool->symbol_cap = 0;
+
+    pool->lock = 0;
+
+    dc_try_or_fail_with3(DCResVoid, arena_res, dc_arena_init(&pool->arena, 0), {
+        free(pool->slots);
+        pool->slots = NULL;
+    });
+
+    dc_ret();
+}
+
+DCResVoid dc_intern_free(DCInternPool* pool)
+{
+    DC_RES_void();
+
+    if (!pool) dc_ret();
+
+    free(pool->slots);
+    free(pool->symbols);
+
+    pool->slots = NULL;
+    pool->slot_cap = 0;
+
+    pool->symbols = NULL;
+    pool->count = 0;
+    pool->symbol_cap = 0;
+
+    return dc_arena_free(&pool->arena);
+}
+
+DCResSymbol dc_intern2(DCInternPool* pool, const string str, usize len)
+{
+    DC_RES_symbol();
+
+    if (!pool || (!str && len > 0))
+    {
+        dc_dbg_log("got NULL DCInternPool or string");
+
+        dc_ret_e(1, "got NULL DCInternPool or string");
+    }
+
+    __dc_intern_lock(pool);
+    __dc_res = __dc_intern_locked(pool, str, len, true);
+    __dc_intern_unlock(pool);
+
+    dc_ret();
+}
+
+DCResSymbol dc_intern(DCInternPool* pool, const string str)
+{
+    DC_RES_symbol();
+
+    if (!str)
+    {
+        dc_dbg_log("got NULL string");
+
+        dc_ret_e(1, "got NULL string");
+    }
+
+    return dc_intern2(pool, str, strlen(str));
+}
+
+DCResSymbol dc_intern_sv(DCInternPool* pool, DCStringView sv)
+{
+    return dc_intern2(pool, sv.str, sv.len);
+}
+
+DCResSymbol dc_intern_find(DCInternPool* pool, const string str, usize len)
+{
+    DC_RES_symbol();
+
+    if (!pool || (!str && len > 0))
+    {
+        dc_dbg_log("got NULL DCInternPool or string");
+
+        dc_ret_e(1, "got NULL DCInternPool or string");
+    }
+
+    __dc_intern_lock(pool);
+    __dc_res = __dc_intern_locked(pool, str, len, false);
+    __dc_intern_unlock(pool);
+
+    dc_ret();
+}
+
+DCResSymbol dc_intern_get(DCInternPool* pool, u32 id)
+{
+    DC_RES_symbol();
+
+    if (!pool)
+    {
+        dc_dbg_log("got NULL DCInternPool");
+
+        dc_ret_e(1, "got NULL DCInternPool");
+    }
+
+    __dc_intern_lock(pool);
+
+    if (id < pool->count)
+        dc_ok(pool->symbols[id]);
+    else
+        dc_e(4, "symbol id out of range");
+
+    __dc_intern_unlock(pool);
+
+    dc_ret();
+}
+
+DCRes dc_dv_intern(DCInternPool* pool, const string str)
+{
+    DC_RES();
+
+    dc_try_or_fail_with3(DCResSymbol, symbol, dc_intern(pool, str), {});
+
+    dc_ret_ok(dc_dv(DCSymbolPtr, dc_unwrap2(symbol)));
+}
+
+DCResU32 dc_symbol_hash(DCDynVal* key)
+{
+    DC_RES_u32();
+
+    if (!key || !dc_dv_is(*key, DCSymbolPtr) || dc_dv_as(*key, DCSymbolPtr) == NULL)
+    {
+        dc_dbg_log("got NULL or non DCSymbolPtr key");
+
+        dc_ret_e(3, "got NULL or non DCSymbolPtr key");
+    }
+
+    u64 hash = dc_dv_as(*key, DCSymbolPtr)->hash;
+
+    dc_ret_ok((u32)(hash ^ (hash >> 32)));
+}
+
+DCResBool dc_symbol_key_cmp(DCDynVal* key1, DCDynVal* key2)
+{
+    DC_RES_bool();
+
+    if (!key1 || !key2 || !dc_dv_is(*key1, DCSymbolPtr) || !dc_dv_is(*key2, DCSymbolPtr))
+    {
+        dc_dbg_log("got NULL or non DCSymbolPtr key");
+
+        dc_ret_e(3, "got NULL or non DCSymbolPtr key");
+    }
+
+    dc_ret_ok(dc_dv_as(*key1, DCSymbolPtr) == dc_dv_as(*key2, DCSymbolPtr));
+}
+
+#undef __dc_intern_try_lock
+#undef __dc_intern_is_locked
+#undef __dc_intern_unlock
+#undef __dc_intern_yield
@@ -0,0 +1,2232 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _json.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for parsing JSON (and newline
+// *               delimited JSON) into dynamic values and writing them back
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_json.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define __DC_JSON_SSE2
+#endif
+
+/**
+ * Parsing happens in two stages, the first one classifies the input 64 bytes
+ * at a time into bit masks (one bit per byte) and collects the positions of
+ * every structural character (`{}[]:,`), every unescaped quote and the start
+ * of every other scalar outside strings, the second one walks these positions
+ * and builds the values without looking at the bytes in between
+ */
+#define __DC_JSON_BLOCK 64
+
+#define __DC_JSON_EVEN_BITS 0x5555555555555555ull
+
+#define __DC_JSON_KEY_ROWS 32
+
+#define __DC_JSON_KEYS_PER_ROW 4
+
+/**
+ * Bit masks of one block, bit `i` stands for byte `i` of the block
+ */
+typedef struct
+{
+    u64 quote;
+    u64 backslash;
+    u64 op;
+    u64 space;
+    u64 control;
+} __DCJsonBlock;
+
+/**
+ * What the first stage carries from a block to the next one
+ */
+typedef struct
+{
+    u64 escaped;
+    u64 in_string;
+    u64 scalar;
+
+    usize error_pos;
+    b1 has_error;
+} __DCJsonScan;
+
+/**
+ * A container that is not closed yet, its values start at `start` on the value
+ * stack of the parser (keys and values one after the other for objects)
+ */
+typedef struct
+{
+    usize start;
+    b1 object;
+} __DCJsonFrame;
+
+typedef enum
+{
+    __DC_JSON_VALUE,
+    __DC_JSON_KEY,
+    __DC_JSON_NEXT,
+    __DC_JSON_CLOSE,
+} __DCJsonState;
+
+#define __dc_json_fail(CODE, MSG, POS)                                                                                         \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        dc_dbg_log(MSG " at byte " dc_fmt(usize), (usize)(POS));                                                               \
+        dc_ret_ea(CODE, MSG " at byte " dc_fmt(usize), (usize)(POS));                                                          \
+    } while (0)
+
+#define __dc_json_is_digit(C) ((u8)((C) - '0') < 10)
+
+static const f64 __dc_json_pow10[] = {1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+                                      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+
+// ***************************************************************************************
+// * FIRST STAGE (STRUCTURAL INDEX)
+// ***************************************************************************************
+
+#ifdef __DC_JSON_SSE2
+
+/**
+ * Adds the masks of 16 bytes starting at `shift` of the block
+ */
+static void __dc_json_classify_chunk(const u8* bytes, u32 shift, __DCJsonBlock* out)
+{
+    __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + shift));
+
+    // Setting the 0x20 bit folds '[' into '{' and ']' into '}'
+    __m128i lower = _mm_or_si128(chunk, _mm_set1_epi8(0x20));
+
+    __m128i op = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(lower, _mm_set1_epi8('{')), _mm_cmpeq_epi8(lower, _mm_set1_epi8('}'))),
+                              _mm_or_si128(_mm_cmpeq_epi8(chunk, _mm_set1_epi8(':')), _mm_cmpeq_epi8(chunk, _mm_set1_epi8(','))));
+
+    // Unsigned `chunk <= 0x20` and `chunk <= 0x1f`
+    __m128i space = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x20)), _mm_set1_epi8(0x20));
+    __m128i control = _mm_cmpeq_epi8(_mm_max_epu8(chunk, _mm_set1_epi8(0x1f)), _mm_set1_epi8(0x1f));
+
+    out->quote |= (u64)(u16)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('"'))) << shift;
+    out->backslash |= (u64)(u16)_mm_movemask_epi8(_mm_cmpeq_epi8(chunk, _mm_set1_epi8('\\'))) << shift;
+    out->op |= (u64)(u16)_mm_movemask_epi8(op) << shift;
+    out->space |= (u64)(u16)_mm_movemask_epi8(space) << shift;
+    out->control |= (u64)(u16)_mm_movemask_epi8(control) << shift;
+}
+
+#endif
+
+/**
+ * Classifies a block, every byte up to 0x20 counts as a space here, control
+ * characters other than tabs and new lines are rejected afterward
+ */
+static void __dc_json_classify(const u8* bytes, __DCJsonBlock* out)
+{
+    *out = (__DCJsonBlock){0};
+
+#ifdef __DC_JSON_SSE2
+    __dc_json_classify_chunk(bytes, 0, out);
+    __dc_json_classify_chunk(bytes, 16, out);
+    __dc_json_classify_chunk(bytes, 32, out);
+    __dc_json_classify_chunk(bytes, 48, out);
+#else
+    for (u32 i = 0; i < __DC_JSON_BLOCK; ++i)
+    {
+        u64 bit = 1ull << i;
+
+        switch (bytes[i])
+        {
+            case '"':
+                out->quote |= bit;
+                break;
+
+            case '\\':
+                out->backslash |= bit;
+                break;
+
+            case '{':
+            case '}':
+            case '[':
+            case ']':
+            case ':':
+            case ',':
+                out->op |= bit;
+                break;
+
+            default:
+                break;
+        }
+
+        if (bytes[i] <= 0x20) out->space |= bit;
+        if (bytes[i] <= 0x1f) out->control |= bit;
+    }
+#endif
+}
+
+/**
+ * Returns the characters escaped by a backslash, only odd runs of backslashes
+ * escape the character that follows them
+ */
+static u64 __dc_json_escaped(__DCJsonScan* scan, u64 backslash)
+{
+    // A backslash escaped by the previous block doesn't start a run
+    backslash &= ~scan->escaped;
+
+    u64 follows_escape = (backslash << 1) | scan->escaped;
+
+    // Adding the starts of the runs on odd bits carries through each run, the
+    // bits it leaves behind tell runs starting on even and odd bits apart
+    u64 odd_starts = backslash & ~__DC_JSON_EVEN_BITS & ~follows_escape;
+    u64 sequences_on_even = odd_starts + backslash;
+
+    scan->escaped = sequences_on_even < odd_starts;
+
+    u64 invert = sequences_on_even << 1;
+
+    return (__DC_JSON_EVEN_BITS ^ invert) & follows_escape;
+}
+
+/**
+ * Bit `i` of the result is the xor of bits `0..i` of `bits`
+ */
+static u64 __dc_json_prefix_xor(u64 bits)
+{
+    bits ^= bits << 1;
+    bits ^= bits << 2;
+    bits ^= bits << 4;
+    bits ^= bits << 8;
+    bits ^= bits << 16;
+    bits ^= bits << 32;
+
+    return bits;
+}
+
+/**
+ * Indexes one block starting at `base` of the input, returns the end of the
+ * written positions
+ */
+static u32* __dc_json_index_block(__DCJsonScan* scan, const u8* bytes, usize base, u32* out)
+{
+    __DCJsonBlock block;
+    __dc_json_classify(bytes, &block);
+
+    u64 quote = block.quote & ~__dc_json_escaped(scan, block.backslash);
+
+    // Opening quotes and what follows them up to (not including) the closing ones
+    u64 in_string = __dc_json_prefix_xor(quote) ^ scan->in_string;
+    scan->in_string = (u64)((i64)in_string >> 63);
+
+    // No control character is allowed in strings, outside them only the white
+    // spaces are (rare enough to be checked one by one)
+    u64 bad_control = block.control & in_string;
+
+    u64 outside_control = block.control & ~in_string;
+    while (outside_control)
+    {
+        u32 i = dc_ctz64(outside_control);
+        if (bytes[i] != '\t' && bytes[i] != '\n' && bytes[i] != '\r') bad_control |= 1ull << i;
+
+        outside_control &= outside_control - 1;
+    }
+
+    if (bad_control && !scan->has_error)
+    {
+        scan->has_error = true;
+        scan->error_pos = base + dc_ctz64(bad_control);
+    }
+
+    // Anything else outside strings belongs to a number or a literal
+    u64 scalar = ~(block.op | block.space | block.quote | in_string);
+    u64 scalar_start = scalar & ~((scalar << 1) | scan->scalar);
+    scan->scalar = scalar >> 63;
+
+    u64 structural = (block.op & ~in_string) | quote | scalar_start;
+
+    while (structural)
+    {
+        *out++ = (u32)(base + dc_ctz64(structural));
+        structural &= structural - 1;
+    }
+
+    return out;
+}
+
+static DCResVoid __dc_json_index(DCJsonParser* jp, const u8* data, usize len, usize offset)
+{
+    DC_RES_void();
+
+    if (len > UINT32_MAX) __dc_json_fail(4, "JSON document is too big", offset);
+
+    // Every byte is at most one position
+    if (jp->index_cap < len || jp->index_cap == 0)
+    {
+        usize new_cap = jp->index_cap == 0 ? DC_JSON_INITIAL_CAP : jp->index_cap;
+        while (new_cap < len) new_cap *= 2;
+
+        u32* indexes = (u32*)realloc(jp->indexes, new_cap * sizeof(u32));
+        if (indexes == NULL)
+        {
+            dc_dbg_log("Memory re-allocation failed");
+
+            dc_ret_e(2, "Memory re-allocation failed");
+        }
+
+        jp->indexes = indexes;
+        jp->index_cap = new_cap;
+    }
+
+    __DCJsonScan scan = {0};
+    u32* out = jp->indexes;
+
+    usize i = 0;
+    for (; i + __DC_JSON_BLOCK <= len; i += __DC_JSON_BLOCK) out = __dc_json_index_block(&scan, data + i, i, out);
+
+    // The last block is padded with white spaces
+    if (i < len)
+    {
+        u8 tail[__DC_JSON_BLOCK];
+        memset(tail, ' ', sizeof(tail));
+        memcpy(tail, data + i, len - i);
+
+        out = __dc_json_index_block(&scan, tail, i, out);
+    }
+
+    jp->index_count = (usize)(out - jp->indexes);
+
+    if (scan.has_error) __dc_json_fail(3, "unexpected control character in JSON", offset + scan.error_pos);
+
+    if (scan.in_string) __dc_json_fail(4, "unterminated JSON string", offset + len);
+
+    dc_ret();
+}
+
+// ***************************************************************************************
+// * SECOND STAGE (BUILDING VALUES)
+// ***************************************************************************************
+
+/**
+ * Bytes that may follow a number or a literal
+ */
+static const b1 __dc_json_delimiters[256] = {
+    [' '] = true, ['\t'] = true, ['\n'] = true, ['\r'] = true, ['{'] = true, ['}'] = true,
+    ['['] = true, [']'] = true,  [':'] = true,  [','] = true,  ['"'] = true,
+};
+
+#define __dc_json_is_delimiter(C) __dc_json_delimiters[(u8)(C)]
+
+/**
+ * FNV-1a hash of keys folded to 32 bits, keys are mostly a few bytes long so a
+ * byte at a time is cheaper than the word based hash of dynamic values
+ */
+static u64 __dc_json_text_hash(const string str, usize len)
+{
+    u64 hash = 0xcbf29ce484222325ull;
+
+    for (usize i = 0; i < len; ++i)
+    {
+        hash ^= (u8)str[i];
+        hash *= 0x100000001b3ull;
+    }
+
+    return hash ^ (hash >> 32);
+}
+
+/**
+ * Text of a string like key (string, DCStringView or DCSymbolPtr)
+ */
+static b1 __dc_json_key_text(DCDynVal* key, string* out_str, usize* out_len)
+{
+    switch (key->type)
+    {
+        case dc_dvt(string):
+            if (!dc_dv_as(*key, string)) return false;
+
+            *out_str = dc_dv_as(*key, string);
+            *out_len = strlen(*out_str);
+
+            return true;
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (key->value.DCStringView_box == NULL) return false;
+#endif
+            DCStringView sv = dc_dv_as(*key, DCStringView);
+
+            *out_str = sv.str;
+            *out_len = sv.len;
+
+            return true;
+        }
+
+        case dc_dvt(DCSymbolPtr):
+            if (!dc_dv_as(*key, DCSymbolPtr)) return false;
+
+            *out_str = dc_dv_as(*key, DCSymbolPtr)->str;
+            *out_len = dc_dv_as(*key, DCSymbolPtr)->len;
+
+            return true;
+
+        default:
+            return false;
+    }
+}
+
+/**
+ * Hash function of parsed objects, keys are hashed by their text whether they
+ * are strings, views or symbols
+ */
+static DC_HT_HASH_FN_DECL(__dc_json_key_hash)
+{
+    DC_RES_u32();
+
+    string str;
+    usize len;
+    if (!__dc_json_key_text(_key, &str, &len))
+    {
+        dc_dbg_log("JSON object keys must be strings");
+
+        dc_ret_e(3, "JSON object keys must be strings");
+    }
+
+    dc_ret_ok((u32)__dc_json_text_hash(str, len));
+}
+
+static DC_HT_KEY_CMP_FN_DECL(__dc_json_key_cmp)
+{
+    DC_RES_bool();
+
+    string str1, str2;
+    usize len1, len2;
+    if (!__dc_json_key_text(_key1, &str1, &len1) || !__dc_json_key_text(_key2, &str2, &len2))
+    {
+        dc_dbg_log("JSON object keys must be strings");
+
+        dc_ret_e(3, "JSON object keys must be strings");
+    }
+
+    dc_ret_ok(len1 == len2 && (len1 == 0 || memcmp(str1, str2, len1) == 0));
+}
+
+#ifdef DC_DV_COMPACT
+
+/**
+ * Frees the boxes of compact string views when the arena is released
+ */
+static DCResVoid __dc_json_free_mem(voidptr memory)
+{
+    DC_RES_void();
+
+    free(memory);
+
+    dc_ret();
+}
+
+#endif
+
+static DCRes __dc_json_sv(DCJsonParser* jp, string str, usize len)
+{
+    DC_RES();
+
+#ifdef DC_DV_COMPACT
+    dc_try_or_fail_with3(DCRes, boxed, dc_dv_box_sv(dc_sv(str, 0, len)), {});
+    dc_try_or_fail_with3(DCResVoid, defer_res, dc_arena_defer(jp->arena, dc_unwrap2(boxed).value.DCStringView_box, __dc_json_free_mem),
+                         dc_dv_free(&dc_unwrap2(boxed), NULL));
+
+    dc_unwrap2(boxed).allocated = false;
+
+    return boxed;
+#else
+    (void)jp;
+
+    dc_ret_ok(dc_dv(DCStringView, dc_sv(str, 0, len)));
+#endif
+}
+
+static i32 __dc_json_hex(const u8* bytes)
+{
+    i32 value = 0;
+
+    for (u32 i = 0; i < 4; ++i)
+    {
+        u8 c = bytes[i];
+        i32 digit;
+
+        if (__dc_json_is_digit(c))
+            digit = c - '0';
+        else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'f')
+            digit = (c | 0x20) - 'a' + 10;
+        else
+            return -1;
+
+        value = (value << 4) | digit;
+    }
+
+    return value;
+}
+
+/**
+ * Decodes the escape sequences of `len` bytes of string content (starting at
+ * `pos` of the input) into `dest`, returns the decoded length
+ */
+static DCResUsize __dc_json_unescape(const u8* src, usize len, usize pos, u8* dest)
+{
+    DC_RES_usize();
+
+    usize written = 0;
+
+    for (usize i = 0; i < len;)
+    {
+        // Text between escapes is copied a run at a time
+        if (src[i] != '\\')
+        {
+            const u8* escape = (const u8*)memchr(src + i, '\\', len - i);
+            usize run = escape ? (usize)(escape - (src + i)) : len - i;
+
+            memcpy(dest + written, src + i, run);
+
+            written += run;
+            i += run;
+
+            continue;
+        }
+
+        // Strings end with an unescaped quote so a backslash is never the last byte
+        u8 c = src[i + 1];
+        i += 2;
+
+        switch (c)
+        {
+            case '"':
+            case '\\':
+            case '/':
+                dest[written++] = c;
+                break;
+
+            case 'b':
+                dest[written++] = '\b';
+                break;
+
+            case 'f':
+                dest[written++] = '\f';
+                break;
+
+            case 'n':
+                dest[written++] = '\n';
+                break;
+
+            case 'r':
+                dest[written++] = '\r';
+                break;
+
+            case 't':
+                dest[written++] = '\t';
+                break;
+
+            case 'u':
+            {
+                i32 code = len - i >= 4 ? __dc_json_hex(src + i) : -1;
+                if (code < 0) __dc_json_fail(3, "invalid unicode escape in JSON string", pos + i - 2);
+
+                i += 4;
+
+                u32 point = (u32)code;
+
+                // Characters outside the basic plane come as a surrogate pair
+                if (point >= 0xd800 && point <= 0xdbff)
+                {
+                    i32 low = len - i >= 6 && src[i] == '\\' && src[i + 1] == 'u' ? __dc_json_hex(src + i + 2) : -1;
+                    if (low < 0xdc00 || low > 0xdfff) __dc_json_fail(3, "invalid surrogate pair in JSON string", pos + i - 6);
+
+                    point = 0x10000 + ((point - 0xd800) << 10) + ((u32)low - 0xdc00);
+                    i += 6;
+                }
+                else if (point >= 0xdc00 && point <= 0xdfff)
+                {
+                    __dc_json_fail(3, "invalid surrogate pair in JSON string", pos + i - 6);
+                }
+
+                if (point < 0x80)
+                {
+                    dest[written++] = (u8)point;
+                }
+                else if (point < 0x800)
+                {
+                    dest[written++] = (u8)(0xc0 | (point >> 6));
+                    dest[written++] = (u8)(0x80 | (point & 0x3f));
+                }
+                else if (point < 0x10000)
+                {
+                    dest[written++] = (u8)(0xe0 | (point >> 12));
+                    dest[written++] = (u8)(0x80 | ((point >> 6) & 0x3f));
+                    dest[written++] = (u8)(0x80 | (point & 0x3f));
+                }
+                else
+                {
+                    dest[written++] = (u8)(0xf0 | (point >> 18));
+                    dest[written++] = (u8)(0x80 | ((point >> 12) & 0x3f));
+                    dest[written++] = (u8)(0x80 | ((point >> 6) & 0x3f));
+                    dest[written++] = (u8)(0x80 | (point & 0x3f));
+                }
+
+                break;
+            }
+
+            default:
+                __dc_json_fail(3, "invalid escape in JSON string", pos + i - 2);
+        }
+    }
+
+    dc_ret_ok(written);
+}
+
+/**
+ * Makes a view of the string between the quotes at `open` and `close`, it
+ * views the input unless it has escape sequences
+ */
+static DCRes __dc_json_string(DCJsonParser* jp, const string data, usize open, usize close, usize offset)
+{
+    DC_RES();
+
+    string str = data + open + 1;
+    usize len = close - open - 1;
+
+    if (len == 0 || memchr(str, '\\', len) == NULL) return __dc_json_sv(jp, str, len);
+
+    // Decoded text is never longer than the escaped one
+    dc_try_or_fail_with3(DCResVoidptr, memory, dc_arena_alloc(jp->arena, len + 1), {});
+
+    u8* dest = (u8*)dc_unwrap2(memory);
+    dc_try_or_fail_with3(DCResUsize, written, __dc_json_unescape((const u8*)str, len, offset + open + 1, dest), {});
+
+    dest[dc_unwrap2(written)] = '\0';
+
+    return __dc_json_sv(jp, (string)dest, dc_unwrap2(written));
+}
+
+/**
+ * Parses the number starting at `pos`, integers that fit are i64 and the rest
+ * f64
+ */
+static DCRes __dc_json_number(const string data, usize pos, usize len, usize offset)
+{
+    DC_RES();
+
+    const u8* start = (const u8*)data + pos;
+    const u8* end = (const u8*)data + len;
+    const u8* p = start;
+
+    b1 negative = *p == '-';
+    if (negative) ++p;
+
+    if (p == end || !__dc_json_is_digit(*p)) __dc_json_fail(3, "invalid JSON number", offset + pos);
+
+    // Up to 19 significant digits are kept, the rest only move the exponent
+    u64 mantissa = 0;
+    i32 digits = 0;
+    i64 exponent = 0;
+    b1 truncated = false;
+    b1 is_float = false;
+
+    if (*p == '0')
+    {
+        ++p;
+
+        if (p < end && __dc_json_is_digit(*p)) __dc_json_fail(3, "leading zeros in JSON number", offset + pos);
+    }
+    else
+    {
+        for (; p < end && __dc_json_is_digit(*p); ++p)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (u64)(*p - '0');
+                digits++;
+            }
+            else
+            {
+                exponent++;
+                truncated = true;
+            }
+        }
+    }
+
+    if (p < end && *p == '.')
+    {
+        is_float = true;
+        ++p;
+
+        if (p == end || !__dc_json_is_digit(*p)) __dc_json_fail(3, "invalid JSON number", offset + pos);
+
+        for (; p < end && __dc_json_is_digit(*p); ++p)
+        {
+            if (digits < 19)
+            {
+                mantissa = mantissa * 10 + (u64)(*p - '0');
+                if (mantissa != 0) digits++;
+                exponent--;
+            }
+            else if (*p != '0')
+            {
+                truncated = true;
+            }
+        }
+    }
+
+    if (p < end && (*p | 0x20) == 'e')
+    {
+        is_float = true;
+        ++p;
+
+        b1 negative_exponent = p < end && *p == '-';
+        if (p < end && (*p == '-' || *p == '+')) ++p;
+
+        if (p == end || !__dc_json_is_digit(*p)) __dc_json_fail(3, "invalid JSON number", offset + pos);
+
+        i64 value = 0;
+        for (; p < end && __dc_json_is_digit(*p); ++p)
+        {
+            if (value < 100000) value = value * 10 + (*p - '0');
+        }
+
+        exponent += negative_exponent ? -value : value;
+    }
+
+    if (p < end && !__dc_json_is_delimiter(*p)) __dc_json_fail(3, "invalid JSON number", offset + pos);
+
+    if (!is_float && !truncated)
+    {
+        if (!negative && mantissa <= (u64)INT64_MAX) dc_ret_ok(dc_dv(i64, (i64)mantissa));
+
+        if (negative && mantissa <= (u64)INT64_MAX + 1) dc_ret_ok(dc_dv(i64, (i64)(0 - mantissa)));
+    }
+
+    // Both the mantissa and the power of ten are exact so a single rounding
+    // gives the correctly rounded result
+    if (!truncated && mantissa <= (1ull << 53) && exponent >= -22 && exponent <= 22)
+    {
+        f64 value = (f64)mantissa;
+        value = exponent < 0 ? value / __dc_json_pow10[-exponent] : value * __dc_json_pow10[exponent];
+
+        dc_ret_ok(dc_dv(f64, negative ? -value : value));
+    }
+
+    // The rest is left to the C library on a terminated copy
+    usize number_len = (usize)(p - start);
+
+    char buf[64];
+    string copy = number_len < sizeof(buf) ? buf : (string)malloc(number_len + 1);
+    if (copy == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    memcpy(copy, start, number_len);
+    copy[number_len] = '\0';
+
+    f64 value = strtod(copy, NULL);
+
+    if (copy != buf) free(copy);
+
+    dc_ret_ok(dc_dv(f64, value));
+}
+
+static DCRes __dc_json_scalar(const string data, usize pos, usize len, usize offset)
+{
+    DC_RES();
+
+#define __dc_json_literal(TEXT, VALUE)                                                                                         \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize literal_len = sizeof(TEXT) - 1;                                                                                  \
+        if (len - pos >= literal_len && memcmp(data + pos, TEXT, literal_len) == 0 &&                                          \
+            (len - pos == literal_len || __dc_json_is_delimiter(data[pos + literal_len])))                                     \
+            dc_ret_ok((VALUE));                                                                                                \
+    } while (0)
+
+    switch (data[pos])
+    {
+        case 't':
+            __dc_json_literal("true", dc_dv(b1, true));
+            break;
+
+        case 'f':
+            __dc_json_literal("false", dc_dv(b1, false));
+            break;
+
+        case 'n':
+            __dc_json_literal("null", dc_dv(voidptr, NULL));
+            break;
+
+        default:
+            if (data[pos] == '-' || __dc_json_is_digit(data[pos])) return __dc_json_number(data, pos, len, offset);
+
+            break;
+    }
+
+#undef __dc_json_literal
+
+    __dc_json_fail(3, "unexpected character in JSON", offset + pos);
+}
+
+/**
+ * Strings without escapes are views of the input, in compact mode views are
+ * boxed so they always go through `__dc_json_string`
+ */
+static b1 __dc_json_plain_string(const string data, usize open, usize close, DCDynVal* out)
+{
+#ifdef DC_DV_COMPACT
+    (void)data;
+    (void)open;
+    (void)close;
+    (void)out;
+
+    return false;
+#else
+    string str = data + open + 1;
+    usize len = close - open - 1;
+
+    if (len > 0 && memchr(str, '\\', len) != NULL) return false;
+
+    *out = dc_dv(DCStringView, dc_sv(str, 0, len));
+
+    return true;
+#endif
+}
+
+/**
+ * Literals and numbers of up to 18 digits without an exponent, anything else
+ * (exponents, longer or malformed numbers) goes through `__dc_json_scalar`
+ *
+ * NOTE: Fractions are only read here when their digits fit in a double, they
+ * are then rounded once just like in `__dc_json_number`
+ */
+static b1 __dc_json_plain_scalar(const string data, usize pos, usize len, DCDynVal* out)
+{
+    const u8* p = (const u8*)data + pos;
+    const u8* end = (const u8*)data + len;
+
+#define __dc_json_plain_literal(TEXT, VALUE)                                                                                   \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize literal_len = sizeof(TEXT) - 1;                                                                                  \
+        if ((usize)(end - p) < literal_len || memcmp(p, TEXT, literal_len) != 0 ||                                             \
+            ((usize)(end - p) > literal_len && !__dc_json_is_delimiter(p[literal_len])))                                       \
+            return false;                                                                                                      \
+                                                                                                                               \
+        *out = (VALUE);                                                                                                        \
+        return true;                                                                                                           \
+    } while (0)
+
+    switch (*p)
+    {
+        case 't':
+            __dc_json_plain_literal("true", dc_dv(b1, true));
+
+        case 'f':
+            __dc_json_plain_literal("false", dc_dv(b1, false));
+
+        case 'n':
+            __dc_json_plain_literal("null", dc_dv(voidptr, NULL));
+
+        default:
+            break;
+    }
+
+#undef __dc_json_plain_literal
+
+    b1 negative = *p == '-';
+    if (negative) ++p;
+
+    const u8* digits = p;
+    u64 value = 0;
+
+    for (; p < end && p - digits < 18 && __dc_json_is_digit(*p); ++p) value = value * 10 + (u64)(*p - '0');
+
+    usize digit_count = (usize)(p - digits);
+
+    if (digit_count == 0 || (*digits == '0' && digit_count > 1)) return false;
+
+    usize fraction_count = 0;
+
+    if (p < end && *p == '.')
+    {
+        const u8* fraction = ++p;
+
+        for (; p < end && digit_count + (usize)(p - fraction) < 18 && __dc_json_is_digit(*p); ++p)
+            value = value * 10 + (u64)(*p - '0');
+
+        fraction_count = (usize)(p - fraction);
+
+        if (fraction_count == 0) return false;
+    }
+
+    if (p < end && !__dc_json_is_delimiter(*p)) return false;
+
+    if (fraction_count == 0)
+    {
+        *out = dc_dv(i64, negative ? -(i64)value : (i64)value);
+
+        return true;
+    }
+
+    if (value > (1ull << 53)) return false;
+
+    f64 number = (f64)value / __dc_json_pow10[fraction_count];
+    *out = dc_dv(f64, negative ? -number : number);
+
+    return true;
+}
+
+/**
+ * Takes `SIZE` bytes of the arena of the parser into `PTR`, straight from the
+ * newest chunk when it has room
+ */
+#define __dc_json_alloc(JP, PTR, SIZE)                                                                                         \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize __size = dc_arena_align((SIZE));                                                                                 \
+        (PTR) = __dc_arena_bump((JP)->arena, __size);                                                                          \
+        if ((PTR) == NULL)                                                                                                     \
+        {                                                                                                                      \
+            dc_try_or_fail_with3(DCResVoidptr, __memory, dc_arena_alloc((JP)->arena, __size), {});                             \
+            (PTR) = dc_unwrap2(__memory);                                                                                      \
+        }                                                                                                                      \
+    } while (0)
+
+/**
+ * Parsed keys are always string views
+ */
+#define __dc_json_key_view(KEY) dc_dv_as((KEY), DCStringView)
+
+/**
+ * Builds an array out of `count` values, `empty` is an empty arena array of the
+ * document the new one is copied from
+ */
+static DCRes __dc_json_array(DCJsonParser* jp, const DCDynArr* empty, DCDynVal* elements, usize count)
+{
+    DC_RES();
+
+    // The array and its elements are taken at once
+    DCDynArr* darr;
+    __dc_json_alloc(jp, darr, sizeof(DCDynArr) + count * sizeof(DCDynVal));
+
+    *darr = *empty;
+
+    darr->elements = (DCDynVal*)(darr + 1);
+    darr->cap = count;
+    darr->count = count;
+
+    for (usize i = 0; i < count; ++i)
+    {
+        darr->elements[i] = elements[i];
+        darr->owned_count += dc_dv_is_owning(elements[i]);
+    }
+
+    dc_ret_ok(dc_dv(DCDynArrPtr, darr));
+}
+
+/**
+ * Builds a hash table out of `count` keys and values, rows are sized before
+ * filling them so nothing is ever reallocated, a repeated key keeps its last
+ * value
+ *
+ * NOTE: Objects are mostly small so rows hold a few keys each, objects that fit
+ * in one row are not hashed at all
+ */
+static DCRes __dc_json_object(DCJsonParser* jp, const DCDynArr* empty, DCDynVal* entries, usize count)
+{
+    DC_RES();
+
+    // Keys are fewer than the indexes of the document so rows are picked with
+    // 32 bit divisions (same rows as `dc_ht_get_hash`)
+    usize cap = count > __DC_JSON_KEYS_PER_ROW ? (count + __DC_JSON_KEYS_PER_ROW - 1) / __DC_JSON_KEYS_PER_ROW : 1;
+
+    // The table, its rows, its pairs and the elements of the rows are taken
+    // at once
+    DCHashTable* ht;
+    __dc_json_alloc(jp, ht,
+                    sizeof(DCHashTable) + cap * sizeof(DCDynArr) + count * sizeof(DCPair) + count * sizeof(DCDynVal));
+
+    DCDynArr* rows = (DCDynArr*)(ht + 1);
+    DCPair* pairs = (DCPair*)(rows + cap);
+    DCDynVal* slots = (DCDynVal*)(pairs + count);
+
+    ht->container = rows;
+    ht->cap = cap;
+    ht->key_count = 0;
+    ht->hash_fn = __dc_json_key_hash;
+    ht->key_cmp_fn = __dc_json_key_cmp;
+    ht->pair_free_fn = NULL;
+
+    // Every row starts as an empty arena row so keys set later never leave
+    // the arena
+    for (usize i = 0; i < cap; ++i) rows[i] = *empty;
+
+    // Row of each key, small objects remember them so keys are hashed once
+    u32 key_rows[__DC_JSON_KEY_ROWS];
+
+    if (cap == 1)
+    {
+        rows[0].cap = count;
+    }
+    else
+    {
+        for (usize i = 0; i < count; ++i)
+        {
+            DCStringView key = __dc_json_key_view(entries[i * 2]);
+
+            u32 row = (u32)__dc_json_text_hash(key.str, key.len) % (u32)cap;
+            if (i < __DC_JSON_KEY_ROWS) key_rows[i] = row;
+
+            rows[row].cap++;
+        }
+    }
+
+    // Each row gets its share of the elements taken above
+    for (usize i = 0; i < cap; ++i)
+    {
+        if (rows[i].cap == 0) continue;
+
+        rows[i].elements = slots;
+        slots += rows[i].cap;
+    }
+
+    for (usize i = 0; i < count; ++i)
+    {
+        DCStringView key = __dc_json_key_view(entries[i * 2]);
+
+        usize index = 0;
+        if (cap > 1) index = i < __DC_JSON_KEY_ROWS ? key_rows[i] : (u32)__dc_json_text_hash(key.str, key.len) % (u32)cap;
+        DCDynArr* row = &rows[index];
+
+        DCPair* existing = NULL;
+        for (usize j = 0; j < row->count; ++j)
+        {
+            DCPair* pair = dc_dv_as(row->elements[j], DCPairPtr);
+            DCStringView other = __dc_json_key_view(pair->first);
+
+            if (other.len == key.len && (key.len == 0 || memcmp(other.str, key.str, key.len) == 0))
+            {
+                existing = pair;
+                break;
+            }
+        }
+
+        if (existing)
+        {
+            existing->second = entries[i * 2 + 1];
+            continue;
+        }
+
+        DCPair* pair = &pairs[ht->key_count++];
+        pair->first = entries[i * 2];
+        pair->second = entries[i * 2 + 1];
+
+        row->elements[row->count++] = dc_dv(DCPairPtr, pair);
+    }
+
+    dc_ret_ok(dc_dv(DCHashTablePtr, ht));
+}
+
+/**
+ * Makes room for `count` values on the value stack, every value takes at least
+ * one index so the indexes of a document bound its stack
+ */
+static DCResVoid __dc_json_reserve_values(DCJsonParser* jp, usize count)
+{
+    DC_RES_void();
+
+    if (jp->value_cap >= count) dc_ret();
+
+    usize new_cap = jp->value_cap == 0 ? DC_JSON_INITIAL_CAP : jp->value_cap;
+    while (new_cap < count) new_cap *= 2;
+
+    DCDynVal* values = (DCDynVal*)realloc(jp->values, new_cap * sizeof(DCDynVal));
+    if (values == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    jp->values = values;
+    jp->value_cap = new_cap;
+
+    dc_ret();
+}
+
+/**
+ * Builds the document indexed by the first stage, `offset` is where `data`
+ * starts in the input (only used for error messages)
+ */
+static DCRes __dc_json_document(DCJsonParser* jp, const string data, usize len, usize offset)
+{
+    DC_RES();
+
+    u32* indexes = jp->indexes;
+    usize count = jp->index_count;
+
+    if (count == 0) __dc_json_fail(4, "empty JSON document", offset);
+
+    __DCJsonFrame frames[DC_JSON_MAX_DEPTH];
+    usize depth = 0;
+
+    dc_try_fail_temp(DCResVoid, __dc_json_reserve_values(jp, count));
+
+    // Arrays and rows of the document are copies of this one
+    DCDynArr empty;
+    dc_try_fail_temp(DCResVoid, dc_da_init_arena(&empty, jp->arena, 0, NULL));
+
+    jp->value_count = 0;
+
+    __DCJsonState state = __DC_JSON_VALUE;
+    usize i = 0;
+
+#define __dc_json_at(I) ((I) < count ? data[indexes[(I)]] : '\0')
+#define __dc_json_pos(I) (offset + ((I) < count ? indexes[(I)] : len))
+
+    while (true)
+    {
+        switch (state)
+        {
+            case __DC_JSON_VALUE:
+            {
+                if (i >= count) __dc_json_fail(4, "unexpected end of JSON", offset + len);
+
+                usize pos = indexes[i];
+                char c = data[pos];
+
+                if (c == '{' || c == '[')
+                {
+                    if (depth >= DC_JSON_MAX_DEPTH) __dc_json_fail(4, "JSON is nested too deep", offset + pos);
+
+                    frames[depth++] = (__DCJsonFrame){.start = jp->value_count, .object = c == '{'};
+                    i++;
+
+                    if (__dc_json_at(i) == (c == '{' ? '}' : ']'))
+                    {
+                        i++;
+                        state = __DC_JSON_CLOSE;
+                    }
+                    else
+                    {
+                        state = c == '{' ? __DC_JSON_KEY : __DC_JSON_VALUE;
+                    }
+
+                    break;
+                }
+
+                if (c == '"')
+                {
+                    if (!__dc_json_plain_string(data, pos, indexes[i + 1], &jp->values[jp->value_count]))
+                    {
+                        dc_try_or_fail_with3(DCRes, str, __dc_json_string(jp, data, pos, indexes[i + 1], offset), {});
+                        jp->values[jp->value_count] = dc_unwrap2(str);
+                    }
+
+                    jp->value_count++;
+
+                    i += 2;
+                    state = __DC_JSON_NEXT;
+
+                    break;
+                }
+
+                if (c == '}' || c == ']' || c == ':' || c == ',') __dc_json_fail(3, "expected a JSON value", offset + pos);
+
+                if (!__dc_json_plain_scalar(data, pos, len, &jp->values[jp->value_count]))
+                {
+                    dc_try_or_fail_with3(DCRes, scalar, __dc_json_scalar(data, pos, len, offset), {});
+                    jp->values[jp->value_count] = dc_unwrap2(scalar);
+                }
+
+                jp->value_count++;
+
+                i++;
+                state = __DC_JSON_NEXT;
+
+                break;
+            }
+
+            case __DC_JSON_KEY:
+            {
+                if (__dc_json_at(i) != '"') __dc_json_fail(3, "expected a string key in JSON object", __dc_json_pos(i));
+
+                if (!__dc_json_plain_string(data, indexes[i], indexes[i + 1], &jp->values[jp->value_count]))
+                {
+                    dc_try_or_fail_with3(DCRes, key, __dc_json_string(jp, data, indexes[i], indexes[i + 1], offset), {});
+                    jp->values[jp->value_count] = dc_unwrap2(key);
+                }
+
+                jp->value_count++;
+
+                i += 2;
+
+                if (__dc_json_at(i) != ':') __dc_json_fail(3, "expected ':' in JSON object", __dc_json_pos(i));
+
+                i++;
+                state = __DC_JSON_VALUE;
+
+                break;
+            }
+
+            case __DC_JSON_CLOSE:
+            {
+                __DCJsonFrame frame = frames[--depth];
+                usize values = jp->value_count - frame.start;
+
+                DCRes container = frame.object ? __dc_json_object(jp, &empty, &jp->values[frame.start], values / 2)
+                                               : __dc_json_array(jp, &empty, &jp->values[frame.start], values);
+                dc_fail_if_err2(container);
+
+                jp->value_count = frame.start;
+                jp->values[jp->value_count++] = dc_unwrap2(container);
+
+                state = __DC_JSON_NEXT;
+
+                break;
+            }
+
+            case __DC_JSON_NEXT:
+            {
+                if (depth == 0)
+                {
+                    if (i < count) __dc_json_fail(3, "unexpected data after JSON document", __dc_json_pos(i));
+
+                    dc_ret_ok(jp->values[0]);
+                }
+
+                char c = __dc_json_at(i);
+                b1 object = frames[depth - 1].object;
+
+                if (c == ',')
+                {
+                    i++;
+                    state = object ? __DC_JSON_KEY : __DC_JSON_VALUE;
+
+                    break;
+                }
+
+                if (c == (object ? '}' : ']'))
+                {
+                    i++;
+                    state = __DC_JSON_CLOSE;
+
+                    break;
+                }
+
+                if (c == '\0') __dc_json_fail(4, "unexpected end of JSON", offset + len);
+
+                __dc_json_fail(3, object ? "expected ',' or '}' in JSON object" : "expected ',' or ']' in JSON array",
+                               __dc_json_pos(i));
+            }
+        }
+    }
+
+#undef __dc_json_at
+#undef __dc_json_pos
+}
+
+// ***************************************************************************************
+// * PARSER
+// ***************************************************************************************
+
+DCResVoid dc_json_init(DCJsonParser* jp, const string data, usize len, DCArena* arena)
+{
+    DC_RES_void();
+
+    if (!jp || !arena || (!data && len > 0))
+    {
+        dc_dbg_log("got NULL DCJsonParser, DCArena or data");
+
+        dc_ret_e(1, "got NULL DCJsonParser, DCArena or data");
+    }
+
+    jp->data = data;
+    jp->len = len;
+    jp->pos = 0;
+
+    jp->arena = arena;
+
+    jp->indexes = NULL;
+    jp->index_count = 0;
+    jp->index_cap = 0;
+
+    jp->values = NULL;
+    jp->value_count = 0;
+    jp->value_cap = 0;
+
+    dc_ret();
+}
+
+DCResVoid dc_json_free(DCJsonParser* jp)
+{
+    DC_RES_void();
+
+    if (!jp) dc_ret();
+
+    free(jp->indexes);
+    free(jp->values);
+
+    jp->indexes = NULL;
+    jp->index_count = 0;
+    jp->index_cap = 0;
+
+    jp->values = NULL;
+    jp->value_count = 0;
+    jp->value_cap = 0;
+
+    dc_ret();
+}
+
+DCRes dc_json_parse(DCJsonParser* jp)
+{
+    DC_RES();
+
+    if (!jp)
+    {
+        dc_dbg_log("got NULL DCJsonParser");
+
+        dc_ret_e(1, "got NULL DCJsonParser");
+    }
+
+    usize offset = jp->pos;
+    string data = jp->data + offset;
+    usize len = jp->len - offset;
+
+    jp->pos = jp->len;
+
+    dc_try_fail_temp(DCResVoid, __dc_json_index(jp, (const u8*)data, len, offset));
+
+    return __dc_json_document(jp, data, len, offset);
+}
+
+DCResBool dc_json_next(DCJsonParser* jp, DCDynVal* out_value)
+{
+    DC_RES_bool();
+
+    if (!jp || !out_value)
+    {
+        dc_dbg_log("got NULL DCJsonParser or output");
+
+        dc_ret_e(1, "got NULL DCJsonParser or output");
+    }
+
+    // JSON strings can't hold a raw new line so every line is a document
+    while (jp->pos < jp->len)
+    {
+        usize offset = jp->pos;
+        string data = jp->data + offset;
+
+        string line_end = (string)memchr(data, '\n', jp->len - offset);
+        usize len = line_end ? (usize)(line_end - data) : jp->len - offset;
+
+        jp->pos = offset + len + (line_end != NULL);
+
+        dc_try_fail_temp(DCResVoid, __dc_json_index(jp, (const u8*)data, len, offset));
+
+        // Blank lines are skipped
+        if (jp->index_count == 0) continue;
+
+        dc_try_or_fail_with3(DCRes, document, __dc_json_document(jp, data, len, offset), {});
+
+        *out_value = dc_unwrap2(document);
+
+        dc_ret_ok(true);
+    }
+
+    dc_ret_ok(false);
+}
+
+// ***************************************************************************************
+// * WRITER
+// ***************************************************************************************
+
+/**
+ * Strings are escaped this many bytes at a time, so a huge string never needs
+ * more than a bounded amount of buffer
+ */
+#define __DC_JW_CHUNK 4096
+
+/**
+ * Largest number of decimals floats are tried with before falling back to
+ * `snprintf`
+ */
+#define __DC_JW_MAX_SCALE 17
+
+#define __DC_JW_2P53 9007199254740992.0
+
+static const char __dc_jw_digit_pairs[] = "00010203040506070809101112131415161718192021222324252627282930313233343536373839404142434445"
+                                          "464748495051525354555657585960616263646566676869707172737475767778798081828384858687888990"
+                                          "919293949596979899";
+
+/**
+ * What follows the backslash of each control character, 'u' means `\u00XX`
+ */
+static const char __dc_jw_control_escapes[] = "uuuuuuuubtnufruuuuuuuuuuuuuuuuuu";
+
+static const char __dc_jw_hex_digits[] = "0123456789abcdef";
+
+#define __dc_jw_needs_escape(C) ((C) < 0x20 || (C) == '"' || (C) == '\\')
+
+/**
+ * Makes room for `extra` more bytes, writers with a file flush what they have
+ * instead of growing past `DC_JSON_FLUSH_SIZE`
+ */
+static DCResVoid __dc_jw_grow(DCJsonWriter* jw, usize extra)
+{
+    DC_RES_void();
+
+    if (jw->file && jw->sb.len >= DC_JSON_FLUSH_SIZE)
+    {
+        dc_try_fail(dc_jw_flush(jw));
+
+        if (extra < jw->sb.cap) dc_ret();
+    }
+
+    return dc_sb_reserve(&jw->sb, extra);
+}
+
+/**
+ * Makes sure `EXTRA` more bytes fit, the buffer only grows (or gets flushed)
+ * when it's full
+ *
+ * NOTE: The string builder keeps one more byte for the terminator
+ */
+#define __dc_jw_reserve(JW, EXTRA)                                                                                             \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        if ((EXTRA) >= (JW)->sb.cap - (JW)->sb.len) dc_try_fail(__dc_jw_grow((JW), (EXTRA)));                                 \
+    } while (0)
+
+#define __dc_jw_put(JW, STR, LEN)                                                                                              \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        usize __dc_jw_len = (LEN);                                                                                             \
+        __dc_jw_reserve((JW), __dc_jw_len);                                                                                    \
+        memcpy((JW)->sb.buf + (JW)->sb.len, (STR), __dc_jw_len);                                                               \
+        (JW)->sb.len += __dc_jw_len;                                                                                           \
+    } while (0)
+
+#define __dc_jw_put_char(JW, C)                                                                                                \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        __dc_jw_reserve((JW), 1);                                                                                              \
+        (JW)->sb.buf[(JW)->sb.len++] = (C);                                                                                    \
+    } while (0)
+
+/**
+ * Keeps the buffer NUL terminated like every string builder
+ */
+static void __dc_jw_terminate(DCJsonWriter* jw)
+{
+    if (jw->sb.buf) jw->sb.buf[jw->sb.len] = '\0';
+}
+
+/**
+ * Starts a new line indented for `depth` when pretty printing
+ */
+static DCResVoid __dc_jw_newline(DCJsonWriter* jw, usize depth)
+{
+    DC_RES_void();
+
+    if (jw->indent == 0) dc_ret();
+
+    usize spaces = depth * jw->indent;
+    __dc_jw_reserve(jw, spaces + 1);
+
+    jw->sb.buf[jw->sb.len++] = '\n';
+    memset(jw->sb.buf + jw->sb.len, ' ', spaces);
+    jw->sb.len += spaces;
+
+    dc_ret();
+}
+
+/**
+ * Writes what comes before an element or key at `depth`
+ */
+static DCResVoid __dc_jw_separate(DCJsonWriter* jw, b1 first, usize depth)
+{
+    DC_RES_void();
+
+    if (!first) __dc_jw_put_char(jw, ',');
+
+    return __dc_jw_newline(jw, depth);
+}
+
+static DCResVoid __dc_jw_put_colon(DCJsonWriter* jw)
+{
+    DC_RES_void();
+
+    if (jw->indent > 0)
+        __dc_jw_put(jw, ": ", 2);
+    else
+        __dc_jw_put_char(jw, ':');
+
+    dc_ret();
+}
+
+static DCResVoid __dc_jw_put_u64(DCJsonWriter* jw, u64 value, b1 negative)
+{
+    DC_RES_void();
+
+    char digits[21];
+    char* end = digits + sizeof(digits);
+    char* start = end;
+
+    // Two digits at a time from the end
+    while (value >= 100)
+    {
+        usize pair = (usize)(value % 100) * 2;
+        value /= 100;
+
+        *--start = __dc_jw_digit_pairs[pair + 1];
+        *--start = __dc_jw_digit_pairs[pair];
+    }
+
+    if (value >= 10)
+    {
+        *--start = __dc_jw_digit_pairs[value * 2 + 1];
+        *--start = __dc_jw_digit_pairs[value * 2];
+    }
+    else
+    {
+        *--start = (char)('0' + value);
+    }
+
+    if (negative) *--start = '-';
+
+    __dc_jw_put(jw, start, (usize)(end - start));
+
+    dc_ret();
+}
+
+static DCResVoid __dc_jw_put_i64(DCJsonWriter* jw, i64 value)
+{
+    return value < 0 ? __dc_jw_put_u64(jw, 0 - (u64)value, true) : __dc_jw_put_u64(jw, (u64)value, false);
+}
+
+/**
+ * Writes the shortest decimal text that reads back as the same float (or the
+ * same f32 when `single` is true)
+ *
+ * NOTE: Whole numbers keep a `.0` so they're read back as floats
+ */
+static DCResVoid __dc_jw_put_float(DCJsonWriter* jw, f64 value, b1 single)
+{
+    DC_RES_void();
+
+    // JSON has no way to write them
+    if (isnan(value) || isinf(value))
+    {
+        __dc_jw_put(jw, "null", 4);
+
+        dc_ret();
+    }
+
+    f64 magnitude = value < 0 ? -value : value;
+
+    // The first scale at which the nearest whole number divides back to the
+    // same value gives the fewest decimals, both numbers are exact so the
+    // division rounds like parsing the text does
+    for (u32 scale = 0; scale <= __DC_JW_MAX_SCALE && magnitude < __DC_JW_2P53; ++scale)
+    {
+        f64 scaled = magnitude * __dc_json_pow10[scale];
+        if (scaled >= __DC_JW_2P53) break;
+
+        u64 mantissa = (u64)(scaled + 0.5);
+        f64 back = (f64)mantissa / __dc_json_pow10[scale];
+
+        if (single ? (f32)back != (f32)magnitude : back != magnitude) continue;
+
+        char digits[24];
+        usize count = 0;
+
+        do
+        {
+            digits[count++] = (char)('0' + mantissa % 10);
+            mantissa /= 10;
+        } while (mantissa);
+
+        // Sign, "0." and leading zeros, the digits, and ".0" at most
+        char text[48];
+        usize len = 0;
+
+        if (value < 0) text[len++] = '-';
+
+        if (count <= scale)
+        {
+            text[len++] = '0';
+            text[len++] = '.';
+
+            for (usize i = count; i < scale; ++i) text[len++] = '0';
+        }
+        else
+        {
+            while (count > scale) text[len++] = digits[--count];
+
+            text[len++] = '.';
+            if (scale == 0) text[len++] = '0';
+        }
+
+        while (count > 0) text[len++] = digits[--count];
+
+        __dc_jw_put(jw, text, len);
+
+        dc_ret();
+    }
+
+    // Very big, very small or long values take the shortest precision that
+    // reads back the same
+    char text[40];
+    int len = 0;
+
+    for (int precision = single ? 6 : 15; precision <= (single ? 9 : 17); ++precision)
+    {
+        len = snprintf(text, sizeof(text), "%.*g", precision, value);
+
+        f64 back = strtod(text, NULL);
+        if (single ? (f32)back == (f32)value : back == value) break;
+    }
+
+    __dc_jw_put(jw, text, (usize)len);
+
+    dc_ret();
+}
+
+/**
+ * Length of the run of bytes at the start of `bytes` that need no escaping
+ */
+static usize __dc_jw_plain_run(const u8* bytes, usize len)
+{
+    usize i = 0;
+
+#ifdef __DC_JSON_SSE2
+    const __m128i quote = _mm_set1_epi8('"');
+    const __m128i backslash = _mm_set1_epi8('\\');
+    const __m128i control = _mm_set1_epi8(0x1f);
+
+    for (; i + 16 <= len; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128((const __m128i*)(bytes + i));
+
+        // Bytes at most 0x1f are the ones the unsigned maximum leaves alone
+        __m128i special = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(chunk, quote), _mm_cmpeq_epi8(chunk, backslash)),
+                                       _mm_cmpeq_epi8(_mm_max_epu8(chunk, control), control));
+
+        u32 mask = (u32)_mm_movemask_epi8(special);
+        if (mask) return i + dc_ctz64(mask);
+    }
+#endif
+
+    while (i < len && !__dc_jw_needs_escape(bytes[i])) ++i;
+
+    return i;
+}
+
+/**
+ * Writes `len` bytes of `str` as a quoted and escaped JSON string, bytes that
+ * aren't ASCII are copied as they are
+ */
+static DCResVoid __dc_jw_put_str(DCJsonWriter* jw, const char* str, usize len)
+{
+    DC_RES_void();
+
+    __dc_jw_put_char(jw, '"');
+
+    const u8* bytes = (const u8*)str;
+
+    for (usize pos = 0; pos < len;)
+    {
+        usize chunk = len - pos < __DC_JW_CHUNK ? len - pos : __DC_JW_CHUNK;
+
+        // Every byte takes 6 at most (`\u00XX`)
+        __dc_jw_reserve(jw, chunk * 6);
+
+        string out = jw->sb.buf + jw->sb.len;
+        usize end = pos + chunk;
+
+        while (pos < end)
+        {
+            usize run = __dc_jw_plain_run(bytes + pos, end - pos);
+
+            memcpy(out, bytes + pos, run);
+            out += run;
+            pos += run;
+
+            if (pos == end) break;
+
+            u8 c = bytes[pos++];
+            char escape = c < 0x20 ? __dc_jw_control_escapes[c] : (char)c;
+
+            *out++ = '\\';
+            *out++ = escape;
+
+            if (escape == 'u')
+            {
+                *out++ = '0';
+                *out++ = '0';
+                *out++ = __dc_jw_hex_digits[c >> 4];
+                *out++ = __dc_jw_hex_digits[c & 0xf];
+            }
+        }
+
+        jw->sb.len = (usize)(out - jw->sb.buf);
+    }
+
+    __dc_jw_put_char(jw, '"');
+
+    dc_ret();
+}
+
+static DCResVoid __dc_jw_value(DCJsonWriter* jw, DCDynVal* dv, usize depth);
+
+/**
+ * Fails when a container at `depth` would go past `DC_JSON_MAX_DEPTH`
+ */
+static DCResVoid __dc_jw_nest(usize depth)
+{
+    DC_RES_void();
+
+    if (depth >= DC_JSON_MAX_DEPTH)
+    {
+        dc_dbg_log("values are nested too deep (or have a cycle)");
+
+        dc_ret_e(4, "values are nested too deep (or have a cycle)");
+    }
+
+    dc_ret();
+}
+
+static DCResVoid __dc_jw_elements(DCJsonWriter* jw, DCDynVal* elements, usize count, usize stride, usize depth)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_jw_nest(depth));
+    __dc_jw_put_char(jw, '[');
+
+    for (usize i = 0; i < count; ++i)
+    {
+        dc_try_fail(__dc_jw_separate(jw, i == 0, depth + 1));
+        dc_try_fail(__dc_jw_value(jw, &elements[i * stride], depth + 1));
+    }
+
+    if (count > 0) dc_try_fail(__dc_jw_newline(jw, depth));
+
+    __dc_jw_put_char(jw, ']');
+
+    dc_ret();
+}
+
+/**
+ * Writes a key of a hash table, keys that aren't strings but numbers or
+ * booleans are quoted
+ */
+static DCResVoid __dc_jw_key(DCJsonWriter* jw, DCDynVal* key)
+{
+    DC_RES_void();
+
+    switch (key->type)
+    {
+        case dc_dvt(string):
+            if (!dc_dv_as(*key, string)) break;
+
+            return __dc_jw_value(jw, key, 0);
+
+        case dc_dvt(DCSymbolPtr):
+            if (!dc_dv_as(*key, DCSymbolPtr)) break;
+
+            return __dc_jw_value(jw, key, 0);
+
+        case dc_dvt(DCStringView):
+        case dc_dvt(DCInlineStr):
+        case dc_dvt(char):
+            return __dc_jw_value(jw, key, 0);
+
+        case dc_dvt(b1):
+        case dc_dvt(u8):
+        case dc_dvt(u16):
+        case dc_dvt(u32):
+        case dc_dvt(u64):
+        case dc_dvt(i8):
+        case dc_dvt(i16):
+        case dc_dvt(i32):
+        case dc_dvt(i64):
+        case dc_dvt(f32):
+        case dc_dvt(f64):
+        case dc_dvt(uptr):
+        case dc_dvt(size):
+        case dc_dvt(usize):
+            __dc_jw_put_char(jw, '"');
+            dc_try_fail(__dc_jw_value(jw, key, 0));
+            __dc_jw_put_char(jw, '"');
+
+            dc_ret();
+
+        default:
+            break;
+    };
+
+    dc_dbg_log("JSON object keys must be strings, numbers or booleans");
+
+    dc_ret_e(3, "JSON object keys must be strings, numbers or booleans");
+}
+
+static DCResVoid __dc_jw_object(DCJsonWriter* jw, DCHashTable* ht, usize depth)
+{
+    DC_RES_void();
+
+    dc_try_fail(__dc_jw_nest(depth));
+    __dc_jw_put_char(jw, '{');
+
+    b1 first = true;
+
+    for (usize i = 0; i < ht->cap; ++i)
+    {
+        DCDynArr* row = &ht->container[i];
+
+        for (usize j = 0; j < row->count; ++j)
+        {
+            DCPair* pair = dc_dv_as(row->elements[j], DCPairPtr);
+
+            dc_try_fail(__dc_jw_separate(jw, first, depth + 1));
+            dc_try_fail(__dc_jw_key(jw, &pair->first));
+            dc_try_fail(__dc_jw_put_colon(jw));
+            dc_try_fail(__dc_jw_value(jw, &pair->second, depth + 1));
+
+            first = false;
+        }
+    }
+
+    if (!first) dc_try_fail(__dc_jw_newline(jw, depth));
+
+    __dc_jw_put_char(jw, '}');
+
+    dc_ret();
+}
+
+#define __dc_jw_ret_null(JW)                                                                                                   \
+    do                                                                                                                         \
+    {                                                                                                                          \
+        __dc_jw_put((JW), "null", 4);                                                                                          \
+        dc_ret();                                                                                                              \
+    } while (0)
+
+/**
+ * Writes the given value, `depth` is the number of arrays and objects it's in
+ */
+static DCResVoid __dc_jw_value(DCJsonWriter* jw, DCDynVal* dv, usize depth)
+{
+    DC_RES_void();
+
+    switch (dv->type)
+    {
+        case dc_dvt(b1):
+            if (dc_dv_as(*dv, b1))
+                __dc_jw_put(jw, "true", 4);
+            else
+                __dc_jw_put(jw, "false", 5);
+
+            dc_ret();
+
+        case dc_dvt(i8):
+            return __dc_jw_put_i64(jw, dc_dv_as(*dv, i8));
+
+        case dc_dvt(i16):
+            return __dc_jw_put_i64(jw, dc_dv_as(*dv, i16));
+
+        case dc_dvt(i32):
+            return __dc_jw_put_i64(jw, dc_dv_as(*dv, i32));
+
+        case dc_dvt(i64):
+            return __dc_jw_put_i64(jw, dc_dv_as(*dv, i64));
+
+        case dc_dvt(size):
+            return __dc_jw_put_i64(jw, (i64)dc_dv_as(*dv, size));
+
+        case dc_dvt(u8):
+            return __dc_jw_put_u64(jw, dc_dv_as(*dv, u8), false);
+
+        case dc_dvt(u16):
+            return __dc_jw_put_u64(jw, dc_dv_as(*dv, u16), false);
+
+        case dc_dvt(u32):
+            return __dc_jw_put_u64(jw, dc_dv_as(*dv, u32), false);
+
+        case dc_dvt(u64):
+            return __dc_jw_put_u64(jw, dc_dv_as(*dv, u64), false);
+
+        case dc_dvt(uptr):
+            return __dc_jw_put_u64(jw, (u64)dc_dv_as(*dv, uptr), false);
+
+        case dc_dvt(usize):
+            return __dc_jw_put_u64(jw, (u64)dc_dv_as(*dv, usize), false);
+
+        case dc_dvt(f32):
+            return __dc_jw_put_float(jw, (f64)dc_dv_as(*dv, f32), true);
+
+        case dc_dvt(f64):
+            return __dc_jw_put_float(jw, dc_dv_as(*dv, f64), false);
+
+        case dc_dvt(char):
+            return __dc_jw_put_str(jw, &dc_dv_as(*dv, char), 1);
+
+        case dc_dvt(string):
+            if (!dc_dv_as(*dv, string)) __dc_jw_ret_null(jw);
+
+            return __dc_jw_put_str(jw, dc_dv_as(*dv, string), strlen(dc_dv_as(*dv, string)));
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCStringView_box == NULL) return __dc_jw_put_str(jw, "", 0);
+#endif
+            DCStringView sv = dc_dv_as(*dv, DCStringView);
+
+            return __dc_jw_put_str(jw, sv.str, sv.len);
+        }
+
+        case dc_dvt(DCInlineStr):
+        {
+            string str = dc_dv_istr_str(*dv);
+
+            return __dc_jw_put_str(jw, str, strlen(str));
+        }
+
+        case dc_dvt(DCSymbolPtr):
+            if (!dc_dv_as(*dv, DCSymbolPtr)) __dc_jw_ret_null(jw);
+
+            return __dc_jw_put_str(jw, dc_dv_symbol_str(*dv), dc_dv_as(*dv, DCSymbolPtr)->len);
+
+        case dc_dvt(DCDynValPtr):
+            if (!dc_dv_as(*dv, DCDynValPtr)) __dc_jw_ret_null(jw);
+
+            dc_try_fail(__dc_jw_nest(depth));
+
+            return __dc_jw_value(jw, dc_dv_as(*dv, DCDynValPtr), depth + 1);
+
+        case dc_dvt(DCRcPtr):
+        {
+            if (!dc_dv_as(*dv, DCRcPtr)) __dc_jw_ret_null(jw);
+
+            DCDynVal shared = dc_rc_dv(dc_dv_as(*dv, DCRcPtr));
+            return __dc_jw_value(jw, &shared, depth);
+        }
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            DCDynArr* darr = dc_dv_as(*dv, DCDynArrPtr);
+            if (!darr) __dc_jw_ret_null(jw);
+
+            return __dc_jw_elements(jw, darr->elements, darr->count, 1, depth);
+        }
+
+        case dc_dvt(DCDynArrView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCDynArrView_box == NULL) return __dc_jw_elements(jw, NULL, 0, 1, depth);
+#endif
+            DCDynArrView view = dc_dv_as(*dv, DCDynArrView);
+
+            return __dc_jw_elements(jw, view.elements, view.count, view.stride, depth);
+        }
+
+        case dc_dvt(DCHashTablePtr):
+            if (!dc_dv_as(*dv, DCHashTablePtr)) __dc_jw_ret_null(jw);
+
+            return __dc_jw_object(jw, dc_dv_as(*dv, DCHashTablePtr), depth);
+
+        case dc_dvt(DCPairPtr):
+        {
+            DCPair* pair = dc_dv_as(*dv, DCPairPtr);
+            if (!pair) __dc_jw_ret_null(jw);
+
+            dc_try_fail(__dc_jw_nest(depth));
+            __dc_jw_put_char(jw, '[');
+            dc_try_fail(__dc_jw_separate(jw, true, depth + 1));
+            dc_try_fail(__dc_jw_value(jw, &pair->first, depth + 1));
+            dc_try_fail(__dc_jw_separate(jw, false, depth + 1));
+            dc_try_fail(__dc_jw_value(jw, &pair->second, depth + 1));
+            dc_try_fail(__dc_jw_newline(jw, depth));
+            __dc_jw_put_char(jw, ']');
+
+            dc_ret();
+        }
+
+        // Null pointers read back as what JSON null is parsed to
+        case dc_dvt(voidptr):
+            if (!dc_dv_as(*dv, voidptr)) __dc_jw_ret_null(jw);
+
+            break;
+
+        case dc_dvt(fileptr):
+            if (!dc_dv_as(*dv, fileptr)) __dc_jw_ret_null(jw);
+
+            break;
+
+        // Extra types are written as their text
+        default:
+        {
+            const DCDvVTable* vtable = dc_dv_vtable(dv->type);
+            if (!vtable || !vtable->tostr_fn) break;
+
+            dc_try_or_fail_with3(DCResString, str, vtable->tostr_fn(dv), {});
+
+            __dc_res = __dc_jw_put_str(jw, dc_unwrap2(str), strlen(dc_unwrap2(str)));
+            free(dc_unwrap2(str));
+
+            dc_ret();
+        }
+    };
+
+    dc_dbg_log("cannot write dynamic value of type '%d' as JSON", dv->type);
+
+    dc_ret_e(3, "cannot write this type of dynamic value as JSON");
+}
+
+/**
+ * Writes what comes before the next value given to the streaming functions
+ */
+static DCResVoid __dc_jw_before_value(DCJsonWriter* jw)
+{
+    DC_RES_void();
+
+    // Documents go on lines of their own
+    if (jw->depth == 0)
+    {
+        if (!jw->empty) __dc_jw_put_char(jw, '\n');
+
+        dc_ret();
+    }
+
+    if (jw->objects[jw->depth - 1])
+    {
+        if (!jw->has_key)
+        {
+            dc_dbg_log("expected a key before the value of JSON object");
+
+            dc_ret_e(3, "expected a key before the value of JSON object");
+        }
+
+        jw->has_key = false;
+
+        dc_ret();
+    }
+
+    return __dc_jw_separate(jw, jw->empty, jw->depth);
+}
+
+static DCResVoid __dc_jw_begin(DCJsonWriter* jw, b1 object)
+{
+    DC_RES_void();
+
+    if (!jw)
+    {
+        dc_dbg_log("got NULL DCJsonWriter");
+
+        dc_ret_e(1, "got NULL DCJsonWriter");
+    }
+
+    dc_try_fail(__dc_jw_nest(jw->depth));
+    dc_try_fail(__dc_jw_before_value(jw));
+    __dc_jw_put_char(jw, object ? '{' : '[');
+
+    jw->objects[jw->depth++] = object;
+    jw->empty = true;
+
+    __dc_jw_terminate(jw);
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_init(DCJsonWriter* jw, fileptr file)
+{
+    DC_RES_void();
+
+    if (!jw)
+    {
+        dc_dbg_log("got NULL DCJsonWriter");
+
+        dc_ret_e(1, "got NULL DCJsonWriter");
+    }
+
+    dc_try_fail(dc_sb_init(&jw->sb, 0));
+
+    jw->file = file;
+    jw->indent = 0;
+
+    jw->depth = 0;
+    jw->empty = true;
+    jw->has_key = false;
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_write(DCJsonWriter* jw, DCDynVal* dv)
+{
+    DC_RES_void();
+
+    if (!jw || !dv)
+    {
+        dc_dbg_log("got NULL DCJsonWriter or dynamic value");
+
+        dc_ret_e(1, "got NULL DCJsonWriter or dynamic value");
+    }
+
+    dc_try_fail(__dc_jw_before_value(jw));
+
+    __dc_res = __dc_jw_value(jw, dv, jw->depth);
+
+    jw->empty = false;
+    __dc_jw_terminate(jw);
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_begin_array(DCJsonWriter* jw)
+{
+    return __dc_jw_begin(jw, false);
+}
+
+DCResVoid dc_jw_begin_object(DCJsonWriter* jw)
+{
+    return __dc_jw_begin(jw, true);
+}
+
+DCResVoid dc_jw_key(DCJsonWriter* jw, const string key, usize len)
+{
+    DC_RES_void();
+
+    if (!jw || (!key && len > 0))
+    {
+        dc_dbg_log("got NULL DCJsonWriter or key");
+
+        dc_ret_e(1, "got NULL DCJsonWriter or key");
+    }
+
+    if (jw->depth == 0 || !jw->objects[jw->depth - 1] || jw->has_key)
+    {
+        dc_dbg_log("JSON keys can only be written in objects before their value");
+
+        dc_ret_e(3, "JSON keys can only be written in objects before their value");
+    }
+
+    dc_try_fail(__dc_jw_separate(jw, jw->empty, jw->depth));
+    dc_try_fail(__dc_jw_put_str(jw, key, len));
+    dc_try_fail(__dc_jw_put_colon(jw));
+
+    jw->has_key = true;
+    jw->empty = false;
+
+    __dc_jw_terminate(jw);
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_end(DCJsonWriter* jw)
+{
+    DC_RES_void();
+
+    if (!jw)
+    {
+        dc_dbg_log("got NULL DCJsonWriter");
+
+        dc_ret_e(1, "got NULL DCJsonWriter");
+    }
+
+    if (jw->depth == 0 || jw->has_key)
+    {
+        dc_dbg_log("no JSON array or object to end (or a key without value)");
+
+        dc_ret_e(3, "no JSON array or object to end (or a key without value)");
+    }
+
+    jw->depth--;
+
+    if (!jw->empty) dc_try_fail(__dc_jw_newline(jw, jw->depth));
+    __dc_jw_put_char(jw, jw->objects[jw->depth] ? '}' : ']');
+
+    jw->empty = false;
+
+    __dc_jw_terminate(jw);
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_flush(DCJsonWriter* jw)
+{
+    DC_RES_void();
+
+    if (!jw)
+    {
+        dc_dbg_log("got NULL DCJsonWriter");
+
+        dc_ret_e(1, "got NULL DCJsonWriter");
+    }
+
+    if (!jw->file || jw->sb.len == 0) dc_ret();
+
+    if (fwrite(jw->sb.buf, 1, jw->sb.len, jw->file) != jw->sb.len)
+    {
+        dc_dbg_log("Cannot write to the file: (code %d) %s", errno, strerror(errno));
+
+        dc_ret_ea(errno, "%s", strerror(errno));
+    }
+
+    dc_sb_clear(&jw->sb);
+
+    dc_ret();
+}
+
+DCResVoid dc_jw_free(DCJsonWriter* jw)
+{
+    DC_RES_void();
+
+    if (!jw) dc_ret();
+
+    DCResVoid flush_res = dc_jw_flush(jw);
+
+    dc_sb_free(&jw->sb);
+
+    return flush_res;
+}
+
+#undef __DC_JSON_BLOCK
+#undef __DC_JSON_EVEN_BITS
+#undef __DC_JSON_KEY_ROWS
+#undef __DC_JSON_KEYS_PER_ROW
+#undef __dc_json_fail
+#undef __dc_json_is_digit
+#undef __dc_json_is_delimiter
+#undef __dc_json_alloc
+#undef __dc_json_key_view
+#undef __DC_JW_CHUNK
+#undef __DC_JW_MAX_SCALE
+#undef __DC_JW_2P53
+#undef __dc_jw_needs_escape
+#undef __dc_jw_reserve
+#undef __dc_jw_put
+#undef __dc_jw_put_char
+#undef __dc_jw_ret_null
+
+#ifdef __DC_JSON_SSE2
+#undef __DC_JSON_SSE2
+#endif
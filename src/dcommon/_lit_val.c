@@ -22,6 +22,106 @@
 
 #include "dcommon.h"
 
+/**
+ * Result of parsing the digits of an integer
+ */
+typedef enum
+{
+    __DC_STR_INT_OK,
+    __DC_STR_INT_INVALID,
+    __DC_STR_INT_OVERFLOW,
+} __DCStrIntStatus;
+
+/**
+ * Whether all 8 bytes of `chunk` are ASCII digits
+ */
+static b1 __dc_str_is_8_digits(u64 chunk)
+{
+    return ((chunk & 0xf0f0f0f0f0f0f0f0ull) | (((chunk + 0x0606060606060606ull) & 0xf0f0f0f0f0f0f0f0ull) >> 4)) ==
+           0x3333333333333333ull;
+}
+
+/**
+ * Value of 8 ASCII digits loaded little endian (first digit in the lowest
+ * byte), pairs, then quads, then the whole 8 are combined with a multiply each
+ */
+static u32 __dc_str_parse_8_digits(u64 chunk)
+{
+    chunk -= 0x3030303030303030ull;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000ff000000ffull) * (100 + (1000000ull << 32))) +
+             (((chunk >> 16) & 0x000000ff000000ffull) * (1 + (10000ull << 32)))) >>
+            32;
+
+    return (u32)chunk;
+}
+
+/**
+ * Parses `str` like `strtoull` in base 10 with the "C" locale does (leading
+ * white space, an optional sign and nothing but digits to the end), the sign
+ * and the magnitude are given separately so every type checks its own range
+ *
+ * NOTE: Digits are converted 8 at a time, overflow is found by the number of
+ * digits instead of `errno`
+ */
+static __DCStrIntStatus __dc_str_to_int(const string str, b1* negative, u64* magnitude)
+{
+    const char* text = str;
+    while (*text == ' ' || (*text >= '\t' && *text <= '\r')) ++text;
+
+    *negative = *text == '-';
+    if (*text == '+' || *text == '-') ++text;
+
+    usize len = strlen(text);
+    if (len == 0) return __DC_STR_INT_INVALID;
+
+    const u8* digits = (const u8*)text;
+
+    // Leading zeros don't count towards the overflow
+    usize i = 0;
+    while (i < len && digits[i] == '0') ++i;
+
+    usize first = i;
+    u64 value = 0;
+
+    for (; i + 8 <= len; i += 8)
+    {
+        u64 chunk;
+        memcpy(&chunk, digits + i, sizeof(chunk));
+
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        chunk = __builtin_bswap64(chunk);
+#endif
+
+        if (!__dc_str_is_8_digits(chunk)) return __DC_STR_INT_INVALID;
+
+        value = value * 100000000 + __dc_str_parse_8_digits(chunk);
+    }
+
+    for (; i < len; ++i)
+    {
+        u8 digit = (u8)(digits[i] - '0');
+        if (digit > 9) return __DC_STR_INT_INVALID;
+
+        value = value * 10 + digit;
+    }
+
+    // 20 digits only fit when they're between 1e19 and UINT64_MAX, past that
+    // `value` has wrapped around below 1e19
+    usize count = len - first;
+    if (count > 20 || (count == 20 && (digits[first] != '1' || value < 10000000000000000000ull)))
+        return __DC_STR_INT_OVERFLOW;
+
+    *magnitude = value;
+
+    return __DC_STR_INT_OK;
+}
+
+/**
+ * Signed value of the magnitude without overflowing on the smallest one
+ */
+#define __dc_str_signed(NEGATIVE, MAGNITUDE) ((NEGATIVE) && (MAGNITUDE) > 0 ? -(i64)((MAGNITUDE) - 1) - 1 : (i64)(MAGNITUDE))
+
 DCResI8 dc_str_to_i8(const string str)
 {
     DC_RES_i8();
@@ -33,27 +133,27 @@ DCResI8 dc_str_to_i8(const string str)
         dc_ret_e(1, "str is NULL or not provided");
     }
 
-    if (strlen(str) == 0) dc_ret_ok(0);
+    if (str[0] == '\0') dc_ret_ok(0);
 
-    string end;
-    errno = 0;
-    long val = strtol(str, &end, 10);
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
 
-    if (end == str || *end != '\0')
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val < INT8_MIN || val > INT8_MAX || errno == ERANGE)
+    if (status == __DC_STR_INT_OVERFLOW || magnitude > (negative ? (u64)INT8_MAX + 1 : (u64)INT8_MAX))
     {
         dc_dbg_log("result is not within the 'i8' range: %" PRId8 ", %" PRId8, INT8_MIN, INT8_MAX);
 
         dc_ret_e(1, "result is not within the 'i8' range");
     }
 
-    dc_ret_ok((i8)val);
+    dc_ret_ok((i8)__dc_str_signed(negative, magnitude));
 }
 
 DCResI16 dc_str_to_i16(const string str)
@@ -67,95 +167,119 @@ DCResI16 dc_str_to_i16(const string str)
         dc_ret_e(1, "str is NULL or not provided");
     }
 
-    if (strlen(str) == 0) dc_ret_ok(0);
+    if (str[0] == '\0') dc_ret_ok(0);
 
-    string end;
-    errno = 0;
-    long val = strtol(str, &end, 10);
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
 
-    if (end == str || *end != '\0')
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val < INT16_MIN || val > INT16_MAX || errno == ERANGE)
+    if (status == __DC_STR_INT_OVERFLOW || magnitude > (negative ? (u64)INT16_MAX + 1 : (u64)INT16_MAX))
     {
         dc_dbg_log("result is not within the 'i16' range: %" PRId16 ", %" PRId16, INT16_MIN, INT16_MAX);
 
         dc_ret_e(1, "result is not within the 'i16' range");
     }
 
-    dc_ret_ok((i16)val);
+    dc_ret_ok((i16)__dc_str_signed(negative, magnitude));
 }
 
 DCResI32 dc_str_to_i32(const string str)
 {
     DC_RES_i32();
 
-    string end;
-    errno = 0;
-    long val = strtol(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val < INT32_MIN || val > INT32_MAX || errno == ERANGE)
+    if (status == __DC_STR_INT_OVERFLOW || magnitude > (negative ? (u64)INT32_MAX + 1 : (u64)INT32_MAX))
     {
         dc_dbg_log("result is not within the 'i32' range: %" PRId32 ", %" PRId32, INT32_MIN, INT32_MAX);
 
         dc_ret_e(1, "result is not within the 'i32' range");
     }
 
-    dc_ret_ok((i32)val);
+    dc_ret_ok((i32)__dc_str_signed(negative, magnitude));
 }
 
 DCResI64 dc_str_to_i64(const string str)
 {
     DC_RES_i64();
 
-    string end;
-    errno = 0;
-    long long val = strtoll(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val < INT64_MIN || val > INT64_MAX || errno == ERANGE)
+    if (status == __DC_STR_INT_OVERFLOW || magnitude > (negative ? (u64)INT64_MAX + 1 : (u64)INT64_MAX))
     {
         dc_dbg_log("result is not within the 'i64' range: %" PRId64 ", %" PRId64, INT64_MIN, INT64_MAX);
 
         dc_ret_e(1, "result is not within the 'i64' range");
     }
 
-    dc_ret_ok((i64)val);
+    dc_ret_ok((i64)__dc_str_signed(negative, magnitude));
 }
 
 DCResU8 dc_str_to_u8(const string str)
 {
     DC_RES_u8();
 
-    string end;
-    errno = 0;
-    unsigned long val = strtoul(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val > UINT8_MAX || errno == ERANGE)
+    // Like `strtoul` a minus sign negates the value in unsigned arithmetic
+    u64 val = negative ? 0 - magnitude : magnitude;
+
+    if (status == __DC_STR_INT_OVERFLOW || val > UINT8_MAX)
     {
         dc_dbg_log("result is not within the 'u8' range: 0, %" PRIu8, UINT8_MAX);
 
@@ -169,18 +293,28 @@ DCResU16 dc_str_to_u16(const string str)
 {
     DC_RES_u16();
 
-    string end;
-    errno = 0;
-    unsigned long val = strtoul(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val > UINT16_MAX || errno == ERANGE)
+    // Like `strtoul` a minus sign negates the value in unsigned arithmetic
+    u64 val = negative ? 0 - magnitude : magnitude;
+
+    if (status == __DC_STR_INT_OVERFLOW || val > UINT16_MAX)
     {
         dc_dbg_log("result is not within the 'u16' range: 0, %" PRIu16, UINT16_MAX);
 
@@ -194,18 +328,28 @@ DCResU32 dc_str_to_u32(const string str)
 {
     DC_RES_u32();
 
-    string end;
-    errno = 0;
-    unsigned long val = strtoul(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val > UINT32_MAX || errno == ERANGE)
+    // Like `strtoul` a minus sign negates the value in unsigned arithmetic
+    u64 val = negative ? 0 - magnitude : magnitude;
+
+    if (status == __DC_STR_INT_OVERFLOW || val > UINT32_MAX)
     {
         dc_dbg_log("result is not within the 'u32' range: 0, %" PRIu32, UINT32_MAX);
 
@@ -219,18 +363,28 @@ DCResU64 dc_str_to_u64(const string str)
 {
     DC_RES_u64();
 
-    string end;
-    errno = 0;
-    unsigned long long val = strtoull(str, &end, 10);
+    if (!str)
+    {
+        dc_dbg_log("str is NULL or not provided");
 
-    if (end == str || *end != '\0')
+        dc_ret_e(1, "str is NULL or not provided");
+    }
+
+    b1 negative;
+    u64 magnitude;
+    __DCStrIntStatus status = __dc_str_to_int(str, &negative, &magnitude);
+
+    if (status == __DC_STR_INT_INVALID)
     {
         dc_dbg_log("str is not '\\0' terminated, or not provided");
 
         dc_ret_e(1, "str is not '\\0' terminated, or not provided");
     }
 
-    if (val > UINT64_MAX || errno == ERANGE)
+    // Like `strtoul` a minus sign negates the value in unsigned arithmetic
+    u64 val = negative ? 0 - magnitude : magnitude;
+
+    if (status == __DC_STR_INT_OVERFLOW || val > UINT64_MAX)
     {
         dc_dbg_log("result is not within the 'u64' range: 0, %" PRIu64, UINT64_MAX);
 
@@ -289,3 +443,5 @@ DCResF64 dc_str_to_f64(const string str)
 
     dc_ret_ok((f64)val);
 }
+
+#undef __dc_str_signed
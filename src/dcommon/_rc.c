@@ -0,0 +1,433 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _rc.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for reference counted, copy on
+// *               write dynamic arrays and hash tables
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_rc.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+
+#define __dc_rc_inc(RC) _InterlockedIncrement64((volatile __int64*)&(RC)->refs)
+#define __dc_rc_dec(RC) _InterlockedDecrement64((volatile __int64*)&(RC)->refs)
+#define __dc_rc_load(RC) _InterlockedOr64((volatile __int64*)&(RC)->refs, 0)
+
+#else
+
+// Taking a new reference needs no ordering, the last release must see every
+// write done through the other handles before freeing
+#define __dc_rc_inc(RC) __atomic_add_fetch(&(RC)->refs, 1, __ATOMIC_RELAXED)
+#define __dc_rc_dec(RC) __atomic_sub_fetch(&(RC)->refs, 1, __ATOMIC_ACQ_REL)
+#define __dc_rc_load(RC) __atomic_load_n(&(RC)->refs, __ATOMIC_ACQUIRE)
+
+#endif
+
+static DCRes __dc_rc_copy_dv(DCDynVal* dv);
+
+/**
+ * Boxes the container in a new reference counted box with one reference
+ */
+static DCRes __dc_rc_new(DCDynValType type, voidptr data)
+{
+    DC_RES();
+
+    if (!data)
+    {
+        dc_dbg_log("got NULL container");
+
+        dc_ret_e(1, "got NULL container");
+    }
+
+    DCRc* rc = (DCRc*)malloc(sizeof(DCRc));
+    if (rc == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    rc->refs = 1;
+    rc->type = type;
+    rc->data = data;
+
+    dc_ret_ok(dc_dva(DCRcPtr, rc));
+}
+
+/**
+ * Returns the reference counted box of an owning handle
+ */
+static DCResVoidptr __dc_rc_of_handle(DCDynVal* handle)
+{
+    DC_RES_voidptr();
+
+    if (!handle || !dc_dv_is(*handle, DCRcPtr) || dc_dv_as(*handle, DCRcPtr) == NULL)
+    {
+        dc_dbg_log("got NULL or non DCRcPtr handle");
+
+        dc_ret_e(1, "got NULL or non DCRcPtr handle");
+    }
+
+    if (dc_dv_is_not_allocated(*handle))
+    {
+        dc_dbg_log("got a borrowed DCRcPtr handle");
+
+        dc_ret_e(3, "only handles owning a reference can be mutated");
+    }
+
+    dc_ret_ok(dc_dv_as(*handle, DCRcPtr));
+}
+
+/**
+ * Deep copies a dynamic array, arrays without anything to release (see
+ * `dc_da_has_owned`) are copied in one go
+ *
+ * NOTE: What a custom element free function releases cannot be duplicated,
+ * such arrays fail the copy
+ */
+static DCResDa __dc_rc_copy_da(DCDynArr* darr)
+{
+    DC_RES_da();
+
+    if (darr->element_free_fn)
+    {
+        dc_dbg_log("cannot copy an array with an element free function");
+
+        dc_ret_e(3, "cannot copy an array with an element free function");
+    }
+
+    usize capacity = darr->count > DC_DA_INITIAL_CAP ? darr->count : DC_DA_INITIAL_CAP;
+
+    dc_try_or_fail_with3(DCResDa, copy_res, dc_da_new2(capacity, darr->multiplier, NULL), {});
+    DCDynArr* copy = dc_unwrap2(copy_res);
+
+    copy->growth = darr->growth;
+    copy->growth_factor = darr->growth_factor;
+
+    if (!dc_da_has_owned(*darr))
+    {
+        if (darr->count > 0) memcpy(copy->elements, darr->elements, darr->count * sizeof(DCDynVal));
+
+        copy->count = darr->count;
+
+        dc_ret_ok(copy);
+    }
+
+    for (usize i = 0; i < darr->count; ++i)
+    {
+        dc_try_or_fail_with3(DCRes, element, __dc_rc_copy_dv(&darr->elements[i]), {
+            dc_da_free(copy);
+            free(copy);
+        });
+
+        dc_try_or_fail_with3(DCResVoid, push_res, dc_da_push(copy, dc_unwrap2(element)), {
+            dc_dv_free(&dc_unwrap2(element), NULL);
+            dc_da_free(copy);
+            free(copy);
+        });
+    }
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Deep copies a hash table, keys and values are only copied deeply when the
+ * table owns them (it has a pair free function)
+ */
+static DCResHt __dc_rc_copy_ht(DCHashTable* ht)
+{
+    DC_RES_ht();
+
+    dc_try_or_fail_with3(DCResHt, copy_res, dc_ht_new(ht->cap, ht->hash_fn, ht->key_cmp_fn, ht->pair_free_fn), {});
+    DCHashTable* copy = dc_unwrap2(copy_res);
+
+    for (usize i = 0; i < ht->cap; ++i)
+    {
+        DC_HT_GET_AND_DEF_CONTAINER_ROW(row, *ht, i);
+
+        for (usize j = 0; j < row->count; ++j)
+        {
+            DCPair* pair = dc_dv_as(row->elements[j], DCPairPtr);
+
+            DCPair entry = *pair;
+            if (ht->pair_free_fn)
+            {
+                dc_try_or_fail_with3(DCRes, key, __dc_rc_copy_dv(&pair->first), {
+                    dc_ht_free(copy);
+                    free(copy);
+                });
+
+                dc_try_or_fail_with3(DCRes, value, __dc_rc_copy_dv(&pair->second), {
+                    dc_dv_free(&dc_unwrap2(key), NULL);
+                    dc_ht_free(copy);
+                    free(copy);
+                });
+
+                entry.first = dc_unwrap2(key);
+                entry.second = dc_unwrap2(value);
+            }
+
+            dc_try_or_fail_with3(DCResVoid, set_res, dc_ht_set(copy, entry.first, entry.second, DC_HT_SET_CREATE_OR_FAIL), {
+                if (ht->pair_free_fn)
+                {
+                    dc_dv_free(&entry.first, NULL);
+                    dc_dv_free(&entry.second, NULL);
+                }
+
+                dc_ht_free(copy);
+                free(copy);
+            });
+        }
+    }
+
+    dc_ret_ok(copy);
+}
+
+/**
+ * Deep copies what a dynamic value owns, values that do not own anything are
+ * copied as they are and shared handles get a new reference
+ */
+static DCRes __dc_rc_copy_dv(DCDynVal* dv)
+{
+    DC_RES();
+
+    switch (dv->type)
+    {
+        case dc_dvt(string):
+        {
+            if (dc_dv_is_not_allocated(*dv) || dc_dv_as(*dv, string) == NULL) dc_ret_ok(*dv);
+
+            dc_try_or_fail_with3(DCResString, str, dc_strdup(dc_dv_as(*dv, string)), {});
+
+            dc_ret_ok(dc_dva(string, dc_unwrap2(str)));
+        }
+
+        case dc_dvt(DCInlineStr):
+            if (!dv->istr_heap || dc_dv_is_not_allocated(*dv)) dc_ret_ok(*dv);
+
+            return dc_dv_istr(dc_dv_as(*dv, DCInlineStr).heap);
+
+        case dc_dvt(DCStringView):
+        {
+#ifdef DC_DV_COMPACT
+            if (dv->value.DCStringView_box == NULL) dc_ret_ok(*dv);
+#endif
+            // The cached c string belongs to the original
+            DCStringView sv = dc_dv_as(*dv, DCStringView);
+            sv.cstr = NULL;
+
+            return dc_dv_box_sv(sv);
+        }
+
+#ifdef DC_DV_COMPACT
+        case dc_dvt(DCDynArrView):
+            if (dv->value.DCDynArrView_box == NULL) dc_ret_ok(*dv);
+
+            return dc_dv_box_dav(dc_dv_as(*dv, DCDynArrView));
+#endif
+
+        case dc_dvt(DCRcPtr):
+            if (dc_dv_is_not_allocated(*dv) || dc_dv_as(*dv, DCRcPtr) == NULL) dc_ret_ok(*dv);
+
+            return dc_rc_share(dv);
+
+        case dc_dvt(DCDynArrPtr):
+        {
+            if (dc_dv_is_not_allocated(*dv) || dc_dv_as(*dv, DCDynArrPtr) == NULL) dc_ret_ok(*dv);
+
+            dc_try_or_fail_with3(DCResDa, darr, __dc_rc_copy_da(dc_dv_as(*dv, DCDynArrPtr)), {});
+
+            dc_ret_ok(dc_dva(DCDynArrPtr, dc_unwrap2(darr)));
+        }
+
+        case dc_dvt(DCHashTablePtr):
+        {
+            if (dc_dv_is_not_allocated(*dv) || dc_dv_as(*dv, DCHashTablePtr) == NULL) dc_ret_ok(*dv);
+
+            dc_try_or_fail_with3(DCResHt, ht, __dc_rc_copy_ht(dc_dv_as(*dv, DCHashTablePtr)), {});
+
+            dc_ret_ok(dc_dva(DCHashTablePtr, dc_unwrap2(ht)));
+        }
+
+        case dc_dvt(DCPairPtr):
+        {
+            if (dc_dv_is_not_allocated(*dv) || dc_dv_as(*dv, DCPairPtr) == NULL) dc_ret_ok(*dv);
+
+            DCPair* pair = (DCPair*)malloc(sizeof(DCPair));
+            if (pair == NULL)
+            {
+                dc_dbg_log("Memory allocation failed");
+
+                dc_ret_e(2, "Memory allocation failed");
+            }
+
+            dc_try_or_fail_with3(DCRes, first, __dc_rc_copy_dv(&dc_dv_as(*dv, DCPairPtr)->first), { free(pair); });
+            dc_try_or_fail_with3(DCRes, second, __dc_rc_copy_dv(&dc_dv_as(*dv, DCPairPtr)->second), {
+                dc_dv_free(&dc_unwrap2(first), NULL);
+                free(pair);
+            });
+
+            pair->first = dc_unwrap2(first);
+            pair->second = dc_unwrap2(second);
+
+            dc_ret_ok(dc_dva(DCPairPtr, pair));
+        }
+
+        default:
+            break;
+    }
+
+    if (dc_dv_is_not_allocated(*dv)) dc_ret_ok(*dv);
+
+    // Allocated voidptr, fileptr, DCDynValPtr and extra types cannot be duplicated
+    dc_dbg_log("cannot copy allocated value of type: %s", dc_tostr_dvt(dv));
+
+    dc_ret_ea(3, "cannot copy allocated value of type: %s", dc_tostr_dvt(dv));
+}
+
+DCRes dc_rc_new_da(DCDynArr* darr)
+{
+    return __dc_rc_new(dc_dvt(DCDynArrPtr), darr);
+}
+
+DCRes dc_rc_new_ht(DCHashTable* ht)
+{
+    return __dc_rc_new(dc_dvt(DCHashTablePtr), ht);
+}
+
+DCRes dc_rc_share(DCDynVal* handle)
+{
+    DC_RES();
+
+    if (!handle || !dc_dv_is(*handle, DCRcPtr) || dc_dv_as(*handle, DCRcPtr) == NULL)
+    {
+        dc_dbg_log("got NULL or non DCRcPtr handle");
+
+        dc_ret_e(1, "got NULL or non DCRcPtr handle");
+    }
+
+    DCRc* rc = dc_dv_as(*handle, DCRcPtr);
+    __dc_rc_inc(rc);
+
+    dc_ret_ok(dc_dva(DCRcPtr, rc));
+}
+
+DCResVoid dc_rc_release(DCRc* rc)
+{
+    DC_RES_void();
+
+    if (!rc) dc_ret();
+
+    if (__dc_rc_dec(rc) > 0) dc_ret();
+
+    if (rc->type == dc_dvt(DCDynArrPtr))
+    {
+        dc_try_fail(dc_da_free((DCDynArr*)rc->data));
+    }
+    else
+    {
+        dc_try_fail(dc_ht_free((DCHashTable*)rc->data));
+    }
+
+    free(rc->data);
+    free(rc);
+
+    dc_ret();
+}
+
+/**
+ * Makes sure the handle is the only owner of its container by copying it when
+ * it's shared
+ */
+static DCResVoidptr __dc_rc_mut(DCDynVal* handle, DCDynValType type)
+{
+    DC_RES_voidptr();
+
+    dc_try_or_fail_with3(DCResVoidptr, rc_res, __dc_rc_of_handle(handle), {});
+    DCRc* rc = (DCRc*)dc_unwrap2(rc_res);
+
+    if (rc->type != type)
+    {
+        dc_dbg_log("handle holds a different container type");
+
+        dc_ret_e(3, "handle holds a different container type");
+    }
+
+    // Nobody else can take a reference without a handle, so a sole owner
+    // stays the sole owner
+    if (__dc_rc_load(rc) == 1) dc_ret_ok(rc->data);
+
+    DCRes copy_res;
+    if (type == dc_dvt(DCDynArrPtr))
+    {
+        DCResDa darr_res = __dc_rc_copy_da((DCDynArr*)rc->data);
+        dc_fail_if_err2(darr_res);
+
+        copy_res = __dc_rc_new(type, dc_unwrap2(darr_res));
+        if (dc_is_err2(copy_res))
+        {
+            dc_da_free(dc_unwrap2(darr_res));
+            free(dc_unwrap2(darr_res));
+        }
+    }
+    else
+    {
+        DCResHt ht_res = __dc_rc_copy_ht((DCHashTable*)rc->data);
+        dc_fail_if_err2(ht_res);
+
+        copy_res = __dc_rc_new(type, dc_unwrap2(ht_res));
+        if (dc_is_err2(copy_res))
+        {
+            dc_ht_free(dc_unwrap2(ht_res));
+            free(dc_unwrap2(ht_res));
+        }
+    }
+
+    dc_fail_if_err2(copy_res);
+
+    dc_try_fail_temp(DCResVoid, dc_rc_release(rc));
+
+    *handle = dc_unwrap2(copy_res);
+
+    dc_ret_ok(dc_dv_as(*handle, DCRcPtr)->data);
+}
+
+DCResDa dc_rc_da_mut(DCDynVal* handle)
+{
+    DC_RES_da();
+
+    dc_try_or_fail_with3(DCResVoidptr, data, __dc_rc_mut(handle, dc_dvt(DCDynArrPtr)), {});
+
+    dc_ret_ok((DCDynArr*)dc_unwrap2(data));
+}
+
+DCResHt dc_rc_ht_mut(DCDynVal* handle)
+{
+    DC_RES_ht();
+
+    dc_try_or_fail_with3(DCResVoidptr, data, __dc_rc_mut(handle, dc_dvt(DCHashTablePtr)), {});
+
+    dc_ret_ok((DCHashTable*)dc_unwrap2(data));
+}
+
+#undef __dc_rc_inc
+#undef __dc_rc_dec
+#undef __dc_rc_load
@@ -0,0 +1,206 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _seg_arr.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for segmented array functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_seg_arr.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+/**
+ * Allocates the next chunk of the segmented array
+ */
+static DCResVoid __dc_sa_add_chunk(DCSegArr* sarr)
+{
+    DC_RES_void();
+
+    if (sarr->chunk_count == DC_SA_MAX_CHUNKS || dc_sa_chunk_cap(sarr->chunk_count) > SIZE_MAX / sizeof(DCDynVal))
+    {
+        dc_dbg_log("segmented array cannot grow any further");
+
+        dc_ret_e(2, "segmented array cannot grow any further");
+    }
+
+    DCDynVal* chunk = (DCDynVal*)malloc(dc_sa_chunk_cap(sarr->chunk_count) * sizeof(DCDynVal));
+    if (chunk == NULL)
+    {
+        dc_dbg_log("Memory allocation failed");
+
+        dc_ret_e(2, "Memory allocation failed");
+    }
+
+    sarr->chunks[sarr->chunk_count] = chunk;
+    sarr->chunk_count++;
+    sarr->cap = dc_sa_chunk_start(sarr->chunk_count);
+
+    dc_ret();
+}
+
+DCResVoid dc_sa_init(DCSegArr* sarr, DCDynValFreeFn element_free_fn)
+{
+    DC_RES_void();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    sarr->chunk_count = 0;
+    sarr->cap = 0;
+    sarr->count = 0;
+    sarr->element_free_fn = element_free_fn;
+
+    dc_ret();
+}
+
+DCResVoid dc_sa_free(DCSegArr* sarr)
+{
+    DC_RES_void();
+
+    if (!sarr) dc_ret();
+
+    while (sarr->count > 0) dc_try_fail(dc_sa_pop(sarr, NULL));
+
+    return dc_sa_trunc(sarr);
+}
+
+DCResVoid dc_sa_reserve(DCSegArr* sarr, usize capacity)
+{
+    DC_RES_void();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    while (sarr->cap < capacity) dc_try_fail(__dc_sa_add_chunk(sarr));
+
+    dc_ret();
+}
+
+DCResVoid dc_sa_trunc(DCSegArr* sarr)
+{
+    DC_RES_void();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    // Every chunk starting at or after count is unused
+    while (sarr->chunk_count > 0 && dc_sa_chunk_start(sarr->chunk_count - 1) >= sarr->count)
+    {
+        sarr->chunk_count--;
+
+        free(sarr->chunks[sarr->chunk_count]);
+        sarr->chunks[sarr->chunk_count] = NULL;
+    }
+
+    sarr->cap = dc_sa_chunk_start(sarr->chunk_count);
+
+    dc_ret();
+}
+
+DCResPtr dc_sa_push2(DCSegArr* sarr, DCDynVal value)
+{
+    DC_RES_dv();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    if (sarr->count == sarr->cap) dc_try_fail_temp(DCResVoid, __dc_sa_add_chunk(sarr));
+
+    DCDynVal* element = &dc_sa_get2(*sarr, sarr->count);
+    *element = value;
+    sarr->count++;
+
+    dc_ret_ok(element);
+}
+
+DCResVoid dc_sa_push(DCSegArr* sarr, DCDynVal value)
+{
+    DC_RES_void();
+
+    dc_try_fail_temp(DCResPtr, dc_sa_push2(sarr, value));
+
+    dc_ret();
+}
+
+DCResVoid dc_sa_pop(DCSegArr* sarr, DCDynVal* out_popped)
+{
+    DC_RES_void();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    if (sarr->count == 0)
+    {
+        dc_dbg_log("Try to pop from an empty array");
+
+        dc_ret_e(4, "Try to pop from an empty array");
+    }
+
+    sarr->count--;
+
+    DCDynVal* element = &dc_sa_get2(*sarr, sarr->count);
+
+    if (out_popped)
+    {
+        *out_popped = *element;
+
+        dc_ret();
+    }
+
+    return dc_dv_free(element, sarr->element_free_fn);
+}
+
+DCResPtr dc_sa_get(DCSegArr* sarr, usize index)
+{
+    DC_RES_dv();
+
+    if (!sarr)
+    {
+        dc_dbg_log("got NULL DCSegArr");
+
+        dc_ret_e(1, "got NULL DCSegArr");
+    }
+
+    if (index >= sarr->count)
+    {
+        dc_dbg_log("Index out of bound");
+
+        dc_ret_e(4, "Index out of bound");
+    }
+
+    dc_ret_ok(&dc_sa_get2(*sarr, index));
+}
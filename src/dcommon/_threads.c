@@ -0,0 +1,101 @@
+// ***************************************************************************************
+//    Project: dcommon -> https://github.com/dezashibi-c/dcommon
+//    File: _threads.c
+//    Date: 2024-09-10
+//    Author: Navid Dezashibi
+//    Contact: navid@dezashibi.com
+//    Website: https://dezashibi.com | https://github.com/dezashibi
+//    License:
+//     Please refer to the LICENSE file, repository or website for more
+//     information about the licensing of this work. If you have any questions
+//     or concerns, please feel free to contact me at the email address provided
+//     above.
+// ***************************************************************************************
+// *  Description: private implementation file for the minimal threading layer
+// *               used internally by parallel functionalities
+// *               DO NOT LINK TO THIS DIRECTLY
+// ***************************************************************************************
+
+#ifndef __DC_BYPASS_PRIVATE_PROTECTION
+#error "You cannot link to this source (_threads.c) directly, please consider including dcommon.h"
+#endif
+
+#include "_headers/aliases.h"
+#include "_headers/general.h"
+#include "_headers/macros.h"
+
+#if defined(DC_WINDOWS)
+#include <windows.h>
+
+typedef HANDLE __DCThread;
+
+/**
+ * Declares a function that can be used as a thread entry point, the argument
+ * is available as `_arg`
+ */
+#define __DC_THREAD_FN_DECL(NAME) DWORD WINAPI NAME(LPVOID _arg)
+
+#define __DC_THREAD_FN_RET() return 0
+
+typedef LPTHREAD_START_ROUTINE __DCThreadFn;
+
+#else
+#include <pthread.h>
+#include <unistd.h>
+
+typedef pthread_t __DCThread;
+
+/**
+ * Declares a function that can be used as a thread entry point, the argument
+ * is available as `_arg`
+ */
+#define __DC_THREAD_FN_DECL(NAME) voidptr NAME(voidptr _arg)
+
+#define __DC_THREAD_FN_RET() return NULL
+
+typedef voidptr (*__DCThreadFn)(voidptr);
+
+#endif
+
+/**
+ * Starts a new thread running `fn` with `arg`
+ *
+ * @return whether the thread could be started or not
+ */
+static b1 __dc_thread_start(__DCThread* thread, __DCThreadFn fn, voidptr arg)
+{
+#if defined(DC_WINDOWS)
+    *thread = CreateThread(NULL, 0, fn, arg, 0, NULL);
+
+    return *thread != NULL;
+#else
+    return pthread_create(thread, NULL, fn, arg) == 0;
+#endif
+}
+
+/**
+ * Waits for the given thread to finish and releases it
+ */
+static void __dc_thread_join(__DCThread thread)
+{
+#if defined(DC_WINDOWS)
+    WaitForSingleObject(thread, INFINITE);
+    CloseHandle(thread);
+#else
+    pthread_join(thread, NULL);
+#endif
+}
+
+usize dc_cpu_count()
+{
+#if defined(DC_WINDOWS)
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+
+    return info.dwNumberOfProcessors > 0 ? (usize)info.dwNumberOfProcessors : 1;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+
+    return count > 0 ? (usize)count : 1;
+#endif
+}
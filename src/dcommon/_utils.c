@@ -88,41 +88,20 @@ DCResUsize dc_sappend(string* str, const string fmt, ...)
         dc_ret_e(1, "got NULL str");
     }
 
+    // The existing string becomes a full builder
+    usize current_len = *str ? strlen(*str) : 0;
+    DCStrBuilder sb = {.buf = *str, .len = current_len, .cap = *str ? current_len + 1 : 0};
+
     va_list argp;
     va_start(argp, fmt);
-
-    // Calculate the length of the formatted string in one go
-    int len = vsnprintf(NULL, 0, fmt, argp);
-    if (len < 0)
-    {
-        dc_dbg_log("An encoding error occurred. Setting the input pointer to NULL.");
-        *str = NULL;
-        va_end(argp);
-
-        dc_ret_e(5, "An encoding error occurred. Setting the input pointer to NULL.");
-    }
+    DCResVoid append_res = dc_sb_vappendf(&sb, fmt, argp);
     va_end(argp);
 
-    // Calculate the current length of the existing string
-    size_t current_len = *str ? strlen(*str) : 0;
+    *str = sb.buf;
 
-    // Allocate memory for the new string (old length + new formatted part)
-    string new_str = realloc(*str, current_len + len + 1);
-    if (!new_str)
-    {
-        dc_dbg_log("Couldn't allocate %i chars.", len + 1);
-        dc_ret_e(1, "Memory allocation failed");
-    }
-
-    // Update the string pointer
-    *str = new_str;
-
-    // Append the new formatted string to the existing string
-    va_start(argp, fmt);
-    vsnprintf(*str + current_len, len + 1, fmt, argp);
-    va_end(argp);
+    dc_fail_if_err2(append_res);
 
-    dc_ret_ok(current_len + len);
+    dc_ret_ok(sb.len);
 }
 
 DCResString dc_strdup(const string in)
@@ -299,6 +278,200 @@ string dc_get_arch()
     return arch;
 }
 
+// ***************************************************************************************
+// * STRING BUILDER
+// ***************************************************************************************
+
+DCResVoid dc_sb_init(DCStrBuilder* sb, usize capacity)
+{
+    DC_RES_void();
+
+    if (!sb)
+    {
+        dc_dbg_log("got NULL DCStrBuilder");
+
+        dc_ret_e(1, "got NULL DCStrBuilder");
+    }
+
+    sb->buf = NULL;
+    sb->len = 0;
+    sb->cap = 0;
+
+    if (capacity > 0) dc_try_fail(dc_sb_reserve(sb, capacity - 1));
+
+    dc_ret();
+}
+
+DCResVoid dc_sb_reserve(DCStrBuilder* sb, usize extra)
+{
+    DC_RES_void();
+
+    if (!sb)
+    {
+        dc_dbg_log("got NULL DCStrBuilder");
+
+        dc_ret_e(1, "got NULL DCStrBuilder");
+    }
+
+    if (extra > SIZE_MAX / 2 - sb->len)
+    {
+        dc_dbg_log("requested string builder capacity is too big");
+
+        dc_ret_e(2, "requested string builder capacity is too big");
+    }
+
+    usize needed = sb->len + extra + 1;
+    if (needed <= sb->cap) dc_ret();
+
+    usize new_cap = sb->cap < DC_SB_INITIAL_CAP ? DC_SB_INITIAL_CAP : sb->cap * 2;
+    while (new_cap < needed) new_cap *= 2;
+
+    string buf = (string)realloc(sb->buf, new_cap);
+    if (buf == NULL)
+    {
+        dc_dbg_log("Memory re-allocation failed");
+
+        dc_ret_e(2, "Memory re-allocation failed");
+    }
+
+    if (!sb->buf) buf[0] = '\0';
+
+    sb->buf = buf;
+    sb->cap = new_cap;
+
+    dc_ret();
+}
+
+DCResVoid dc_sb_append(DCStrBuilder* sb, const string str, usize len)
+{
+    DC_RES_void();
+
+    if (!str && len > 0)
+    {
+        dc_dbg_log("got NULL string");
+
+        dc_ret_e(1, "got NULL string");
+    }
+
+    dc_try_fail(dc_sb_reserve(sb, len));
+
+    if (len > 0) memcpy(sb->buf + sb->len, str, len);
+
+    sb->len += len;
+    sb->buf[sb->len] = '\0';
+
+    dc_ret();
+}
+
+DCResVoid dc_sb_append_char(DCStrBuilder* sb, char c)
+{
+    DC_RES_void();
+
+    dc_try_fail(dc_sb_reserve(sb, 1));
+
+    sb->buf[sb->len++] = c;
+    sb->buf[sb->len] = '\0';
+
+    dc_ret();
+}
+
+DCResVoid dc_sb_vappendf(DCStrBuilder* sb, const string fmt, va_list args)
+{
+    DC_RES_void();
+
+    if (!sb || !fmt)
+    {
+        dc_dbg_log("got NULL DCStrBuilder or format");
+
+        dc_ret_e(1, "got NULL DCStrBuilder or format");
+    }
+
+    // First try to format right into the free space
+    va_list args_copy;
+    va_copy(args_copy, args);
+
+    usize available = sb->cap - sb->len;
+    int len = vsnprintf(sb->buf ? sb->buf + sb->len : NULL, available, fmt, args_copy);
+    va_end(args_copy);
+
+    if (len < 0)
+    {
+        dc_dbg_log("An encoding error occurred.");
+
+        if (sb->buf) sb->buf[sb->len] = '\0';
+
+        dc_ret_e(5, "An encoding error occurred.");
+    }
+
+    if ((usize)len >= available)
+    {
+        dc_try_fail(dc_sb_reserve(sb, (usize)len));
+
+        vsnprintf(sb->buf + sb->len, (usize)len + 1, fmt, args);
+    }
+
+    sb->len += (usize)len;
+
+    dc_ret();
+}
+
+DCResVoid dc_sb_appendf(DCStrBuilder* sb, const string fmt, ...)
+{
+    va_list argp;
+    va_start(argp, fmt);
+
+    DCResVoid res = dc_sb_vappendf(sb, fmt, argp);
+
+    va_end(argp);
+
+    return res;
+}
+
+DCResString dc_sb_take(DCStrBuilder* sb)
+{
+    DC_RES_string();
+
+    if (!sb)
+    {
+        dc_dbg_log("got NULL DCStrBuilder");
+
+        dc_ret_e(1, "got NULL DCStrBuilder");
+    }
+
+    if (!sb->buf) dc_try_fail_temp(DCResVoid, dc_sb_reserve(sb, 0));
+
+    string result = sb->buf;
+
+    sb->buf = NULL;
+    sb->len = 0;
+    sb->cap = 0;
+
+    dc_ret_ok(result);
+}
+
+void dc_sb_clear(DCStrBuilder* sb)
+{
+    if (!sb) return;
+
+    sb->len = 0;
+    if (sb->buf) sb->buf[0] = '\0';
+}
+
+DCResVoid dc_sb_free(DCStrBuilder* sb)
+{
+    DC_RES_void();
+
+    if (!sb) dc_ret();
+
+    free(sb->buf);
+
+    sb->buf = NULL;
+    sb->len = 0;
+    sb->cap = 0;
+
+    dc_ret();
+}
+
 // ***************************************************************************************
 // * CLEANUP
 // ***************************************************************************************
@@ -565,6 +738,36 @@ DCResVoid dc_result_free(voidptr res_ptr)
     dc_ret();
 }
 
+u32 __dc_ctz64(u64 x)
+{
+    if (x == 0) return 64;
+
+    u32 n = 0;
+
+    while ((x & 1) == 0)
+    {
+        x >>= 1;
+        n++;
+    }
+
+    return n;
+}
+
+u32 __dc_clz64(u64 x)
+{
+    if (x == 0) return 64;
+
+    u32 n = 0;
+
+    while ((x & ((u64)1 << 63)) == 0)
+    {
+        x <<= 1;
+        n++;
+    }
+
+    return n;
+}
+
 // ***************************************************************************************
 // * Files
 // ***************************************************************************************
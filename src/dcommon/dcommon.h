@@ -156,6 +156,48 @@ DCResVoid dc_da_init(DCDynArr* darr, DCDynValFreeFn element_free_fn);
  */
 DCResVoid dc_da_init2(DCDynArr* darr, usize capacity, usize capacity_grow_multiplier, DCDynValFreeFn element_free_fn);
 
+/**
+ * Initializes a dynamic array whose first `capacity` elements are taken from
+ * the given arena, growing beyond that takes a bigger block from the same arena
+ * (the old one is left to the arena)
+ *
+ * NOTE: The elements stay valid only as long as the arena, `dc_da_free` never
+ * releases the arena memory and arena arrays don't need to be freed at all,
+ * elements marked as allocated are still yours to free before resetting the
+ * arena
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_init_arena(DCDynArr* darr, DCArena* arena, usize capacity, DCDynValFreeFn element_free_fn);
+
+/**
+ * Initializes a dynamic array whose elements live in the memory mapped file at
+ * `path`, the file is created if it doesn't exist and reopened with its
+ * elements otherwise, string payloads are kept in a side heap file
+ * (`<path>.heap`)
+ *
+ * NOTE: Only scalars, strings and inline strings stored in place can be added
+ * to such arrays (others fail with error code 3), strings are copied to the
+ * side heap and allocated ones are released right away
+ *
+ * NOTE: Changes reach the file only after `dc_da_sync` (or `dc_da_free`), the
+ * file layout depends on `DCDynVal` so it can only be reopened by builds with
+ * the same dynamic value configuration
+ *
+ * NOTE: Not supported on windows
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_open_file(DCDynArr* darr, string path);
+
+/**
+ * Writes count and side heap state of a file backed dynamic array (see
+ * `dc_da_open_file`) to its header and flushes both files to disk
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_sync(DCDynArr* darr);
+
 /**
  * Creates, allocates, initializes and returns a pointer to dynamic array
  *
@@ -193,19 +235,34 @@ DCResDa dc_da_new2(usize capacity, usize capacity_grow_multiplier, DCDynValFreeF
 DCResVoid __dc_da_init_with_values(DCDynArr* darr, usize count, DCDynValFreeFn element_free_fn, DCDynVal values[]);
 
 /**
- * Grows the capacity of given dynamic array pointer by current capacity *
- * registered multiplier
+ * Grows the capacity of given dynamic array pointer according to its growth
+ * policy (by default current capacity * registered multiplier)
+ *
+ * NOTE: default multiplier is 2, the capacity always grows by at least one
  *
- * NOTE: default multiplier is 2
+ * NOTE: Arrays growing past `DC_DA_MMAP_THRESHOLD` bytes are moved to their
+ * own memory mapping (where supported) and from then on grow without copying
  *
  * @return nothing or error
  */
 DCResVoid dc_da_grow(DCDynArr* darr);
 
+/**
+ * Changes the growth policy of the dynamic array (see `DCDynArrGrowth`)
+ *
+ * @param growth_factor is only used by `DC_DA_GROW_FACTOR` and must be greater
+ *                      than 1 (e.g. 1.5)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_set_growth(DCDynArr* darr, DCDynArrGrowth growth, f32 growth_factor);
+
 /**
  * Grows the capacity of given dynamic array pointer by current capacity +
  * provided amount
  *
+ * NOTE: Fails if the new capacity in bytes would not fit in a usize
+ *
  * @return nothing or error
  */
 DCResVoid dc_da_grow_by(DCDynArr* darr, usize amount);
@@ -213,6 +270,8 @@ DCResVoid dc_da_grow_by(DCDynArr* darr, usize amount);
 /**
  * Grows the capacity of given dynamic array pointer to provided amount
  *
+ * NOTE: Fails if the new capacity in bytes would not fit in a usize
+ *
  * @return nothing or error
  */
 DCResVoid dc_da_grow_to(DCDynArr* darr, usize amount);
@@ -244,7 +303,7 @@ DCResVoid dc_da_push(DCDynArr* darr, DCDynVal value);
 
 /**
  * Pushes multiple values to the given array with causes to check/grow the
- * capacity only once in case needed
+ * capacity only once in case needed, values are copied all at once
  *
  * NOTE: see `dc_da_append_values` macro in macros.h, it helps passing values
  * without the count
@@ -271,6 +330,9 @@ DCResPtr dc_da_get(DCDynArr* darr, usize index);
 /**
  * Checks whether two given pointers to dynamic values are equal or not
  *
+ * NOTE: Symbols (DCSymbolPtr) are compared by address, symbols of different
+ * pools are never equal
+ *
  * @return b1 or error
  */
 DCResBool dc_dv_eq(DCDynVal* dv1, DCDynVal* dv2);
@@ -290,11 +352,45 @@ DCResBool dc_dv_eq2(DCDynVal* dv1, DCDynVal dv2);
  */
 DCResBool dc_dv_eq3(DCDynVal dv1, DCDynVal dv2);
 
+/**
+ * Hashes the given dynamic value by its content, arrays, views, pairs, hash
+ * tables and shared handles are hashed through everything nested in them and
+ * pointed values (DCDynValPtr) as what they point to
+ *
+ * NOTE: Values that `dc_dv_cmp` finds equal get the same hash, hash tables are
+ * hashed independently of their capacity and the order of their pairs
+ *
+ * NOTE: Extra types are hashed with the `hash_fn` of their vtable (see
+ * `dc_dv_register_type`), nesting deeper than `DC_DV_MAX_DEPTH` (e.g. a cycle)
+ * fails with error code 4
+ *
+ * @return the hash or error
+ */
+DCResU64 dc_dv_hash(DCDynVal* dv, u64 seed);
+
+/**
+ * Total ordering of dynamic values, values of different types are ordered by
+ * their type, numbers by their value (floats with NaNs last), strings,
+ * views, inline strings and symbols by their text, arrays, views and pairs
+ * element by element and pointed values (DCDynValPtr) as what they point to
+ *
+ * NOTE: Hash tables with the same pairs are equal, others are ordered by
+ * their number of keys, their hash (see `dc_dv_hash`) and then their pairs
+ * sorted by key and value
+ *
+ * NOTE: Extra types are ordered with the `cmp_fn` of their vtable (see
+ * `dc_dv_register_type`), nesting deeper than `DC_DV_MAX_DEPTH` (e.g. a cycle)
+ * fails with error code 4
+ *
+ * @return negative, zero or positive number or error
+ */
+DCResI32 dc_dv_cmp(DCDynVal* dv1, DCDynVal* dv2);
+
 /**
  * Searches for given element (a pointer to a dynamic value) in an array
  *
  * @param dv_eq_fn is a function that compares custom extra types added to
- *                 dynamic value
+ *                 dynamic value, when NULL the registered one is used
  *
  * @return index or error
  *
@@ -302,11 +398,38 @@ DCResBool dc_dv_eq3(DCDynVal dv1, DCDynVal dv2);
  */
 DCResUsize dc_da_find2(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn);
 
+/**
+ * Collects indexes of all the elements equal to the given element (a pointer to
+ * a dynamic value) in an array
+ *
+ * @param dv_eq_fn is a function that compares custom extra types added to
+ *                 dynamic value, when NULL the registered one is used
+ *
+ * @return number of found indexes or error
+ *
+ * NOTE: `out_indexes` is terminated with `dc_stopper(usize)` even if nothing
+ * is found
+ *
+ * NOTE: Allocates memory
+ */
+DCResUsize dc_da_find_all(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn, usize** out_indexes);
+
+/**
+ * Counts the elements equal to the given element (a pointer to a dynamic value)
+ * in an array
+ *
+ * @param dv_eq_fn is a function that compares custom extra types added to
+ *                 dynamic value, when NULL the registered one is used
+ *
+ * @return number of matching elements or error
+ */
+DCResUsize dc_da_count(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn);
+
 /**
  * Searches for given element (a literal dynamic value) in an array
  *
  * @param dv_eq_fn is a function that compares custom extra types added to
- *                 dynamic value
+ *                 dynamic value, when NULL the registered one is used
  *
  * @return index or error
  *
@@ -314,6 +437,118 @@ DCResUsize dc_da_find2(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn);
  */
 DCResUsize dc_da_find(DCDynArr* darr, DCDynVal el, DCDvEqFn dv_eq_fn);
 
+/**
+ * Takes a view of `count` consecutive elements of the given array starting from
+ * `start`
+ *
+ * @return a DCDynArrView or error
+ *
+ * NOTE: No memory allocation or copy happens, the view points into the array
+ * and must not be used after the array is grown, truncated or freed
+ */
+DCResDav dc_da_view(DCDynArr* darr, usize start, usize count);
+
+/**
+ * Takes a view of `count` elements of the given array starting from `start`
+ * and picking every `stride`-th element (e.g. stride of 2 views every other
+ * element)
+ *
+ * @return a DCDynArrView or error
+ *
+ * NOTE: No memory allocation or copy happens, the view points into the array
+ * and must not be used after the array is grown, truncated or freed
+ */
+DCResDav dc_da_view2(DCDynArr* darr, usize start, usize count, usize stride);
+
+/**
+ * Takes a view of `count` elements of the given view starting from `start`
+ * (both in terms of the given view's elements)
+ *
+ * @return a DCDynArrView or error
+ */
+DCResDav dc_dav_view(DCDynArrView* view, usize start, usize count);
+
+/**
+ * Searches for given element (a pointer to a dynamic value) in a view
+ *
+ * @param dv_eq_fn is a function that compares custom extra types added to
+ *                 dynamic value, when NULL the registered one is used
+ *
+ * @return index (in the view) or error
+ *
+ * NOTE: error code 6 means not found, other error types might happen as well
+ */
+DCResUsize dc_dav_find2(DCDynArrView* view, DCDynVal* el, DCDvEqFn dv_eq_fn);
+
+/**
+ * Searches for given element (a literal dynamic value) in a view
+ *
+ * @param dv_eq_fn is a function that compares custom extra types added to
+ *                 dynamic value, when NULL the registered one is used
+ *
+ * @return index (in the view) or error
+ *
+ * NOTE: error code 6 means not found, other error types might happen as well
+ */
+DCResUsize dc_dav_find(DCDynArrView* view, DCDynVal el, DCDvEqFn dv_eq_fn);
+
+/**
+ * Counts the elements equal to the given element (a pointer to a dynamic value)
+ * in a view
+ *
+ * @param dv_eq_fn is a function that compares custom extra types added to
+ *                 dynamic value, when NULL the registered one is used
+ *
+ * @return number of matching elements or error
+ */
+DCResUsize dc_dav_count(DCDynArrView* view, DCDynVal* el, DCDvEqFn dv_eq_fn);
+
+/**
+ * Creates an inline string dynamic value (DCInlineStr) holding a copy of the
+ * given string, strings up to `DC_ISTR_MAX_LEN` characters are kept inside the
+ * dynamic value and longer ones are copied to the heap (and marked as allocated)
+ *
+ * @return dynamic value or error
+ */
+DCRes dc_dv_istr(const string str);
+
+/**
+ * Creates an inline string dynamic value (DCInlineStr) holding a copy of the
+ * first `len` characters of the given string (see `dc_dv_istr`)
+ *
+ * @return dynamic value or error
+ */
+DCRes dc_dv_istr2(const string str, usize len);
+
+/**
+ * Length of the string held by the given inline string dynamic value
+ *
+ * @return length or error
+ */
+DCResUsize dc_dv_istr_len(DCDynVal* dv);
+
+/**
+ * Creates a dynamic value holding the given string view
+ *
+ * NOTE: When `DC_DV_COMPACT` is defined the string view is copied to a heap box
+ * owned by the dynamic value (marked as allocated) which is freed by
+ * `dc_dv_free`, otherwise it is the same as `dc_dv(DCStringView, sv)`
+ *
+ * @return dynamic value or error
+ */
+DCRes dc_dv_box_sv(DCStringView sv);
+
+/**
+ * Creates a dynamic value holding the given dynamic array view
+ *
+ * NOTE: When `DC_DV_COMPACT` is defined the view is copied to a heap box owned
+ * by the dynamic value (marked as allocated) which is freed by `dc_dv_free`,
+ * otherwise it is the same as `dc_dv(DCDynArrView, view)`
+ *
+ * @return dynamic value or error
+ */
+DCRes dc_dv_box_dav(DCDynArrView view);
+
 /**
  * Frees allocated string or voidptr, does nothing for the rest of dynamic value
  * types
@@ -327,10 +562,37 @@ DCResUsize dc_da_find(DCDynArr* darr, DCDynVal el, DCDvEqFn dv_eq_fn);
  * - For voidptr types it first send them to `custom_free_fn` then if it is
  * allocated frees it and set it to `NULL`.
  *
+ * - For DCRcPtr types an allocated (owning) handle only drops its reference
+ * (see `dc_rc_release`) and is set to `NULL`.
+ *
+ * - For extra types allocated values are sent to `custom_free_fn` or when it's
+ * NULL to the `free_fn` of their registered vtable (see `dc_dv_register_type`).
+ *
  * @return nothing or error
  */
 DCResVoid dc_dv_free(DCDynVal* element, DCDynValFreeFn custom_free_fn);
 
+/**
+ * Registers the operations of a type declared with `DC_DV_EXTRA_TYPES`, the
+ * vtable is copied and replaces the previous one of the type
+ *
+ * NOTE: Registration is meant to happen once at startup before any value of
+ * the type is used, it's not synchronized with readers in other threads
+ *
+ * NOTE: Up to `DC_DV_MAX_EXTRA_TYPES` extra types can be registered, built-in
+ * types cannot be (error code 3) and `name` is mandatory
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dv_register_type(DCDynValType type, const DCDvVTable* vtable);
+
+/**
+ * Retrieves the registered vtable of an extra type
+ *
+ * @return the vtable or NULL for built-in and not registered types
+ */
+const DCDvVTable* dc_dv_vtable(DCDynValType type);
+
 /**
  * General function for cleanup process of a dynamic value
  *
@@ -348,6 +610,11 @@ DCResVoid __dc_dv_free(voidptr dv);
  * Frees all the dynamic values of the given dynamic array and then the array
  * itself and reset capacity back to zero
  *
+ * NOTE: Arrays without owned elements (see `dc_da_has_owned`) release only
+ * their storage without visiting the elements
+ *
+ * NOTE: File backed arrays are synced and closed, their files are kept
+ *
  * @return nothing or error
  */
 DCResVoid dc_da_free(DCDynArr* darr);
@@ -372,11 +639,135 @@ DCResVoid __dc_da_free(voidptr darr);
  */
 DCResVoid dc_da_delete(DCDynArr* darr, usize index);
 
+/**
+ * Deletes `count` elements starting at `start_index` in the given darr, every
+ * element is freed and the rest of the array is shifted only once
+ *
+ * NOTE: In case freeing an element fails, the already freed ones are still
+ * removed from the array and the error is returned
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_delete_range(DCDynArr* darr, usize start_index, usize count);
+
+/**
+ * Keeps only the elements that the given predicate returns true for, the array
+ * is compacted in place in a single pass and only the removed elements are
+ * freed (using the registered `element_free_fn`)
+ *
+ * NOTE: If the predicate fails the array stays valid, not yet visited elements
+ * are kept and the error is returned
+ *
+ * @return number of removed elements or error
+ */
+DCResUsize dc_da_retain(DCDynArr* darr, DCDvPredicateFn predicate);
+
+/**
+ * Replaces the element at the given index, the old element is freed (using the
+ * registered `element_free_fn`)
+ *
+ * NOTE: Unlike writing to `dc_da_get_as` or `dc_da_get2` directly this keeps
+ * the owned element count of the array up to date
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_set(DCDynArr* darr, usize index, DCDynVal value);
+
+/**
+ * Rescans the elements of the array and refreshes `owned_count`, needed only
+ * after assigning owned values to elements in place (see `dc_da_has_owned`)
+ *
+ * @return number of owned elements or error
+ */
+DCResUsize dc_da_update_owned(DCDynArr* darr);
+
+/**
+ * Sorts the array in place in ascending order (not stable)
+ *
+ * @param cmp_fn is a function that orders two dynamic values, when NULL
+ *               `dc_dv_cmp` is used
+ *
+ * NOTE: Without `cmp_fn` numeric arrays whose elements all have the same type
+ * are radix sorted and arrays of strings are sorted with multikey quicksort
+ *
+ * NOTE: If the comparator fails the array holds the same elements in an
+ * unspecified order and the error is returned
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_sort(DCDynArr* darr, DCDvCmpFn cmp_fn);
+
+/**
+ * Sorts the array in place in ascending order keeping the relative order of
+ * equal elements (see `dc_da_sort` for `cmp_fn`)
+ *
+ * @return nothing or error
+ *
+ * NOTE: Allocates a temporary buffer
+ */
+DCResVoid dc_da_sort_stable(DCDynArr* darr, DCDvCmpFn cmp_fn);
+
+/**
+ * Stable sort of the array in ascending order of the i64 keys that `key_fn`
+ * returns, the key of each element is extracted exactly once
+ *
+ * NOTE: If extracting a key fails the array is left untouched
+ *
+ * @return nothing or error
+ *
+ * NOTE: Allocates a temporary buffer
+ */
+DCResVoid dc_da_sort_by_key(DCDynArr* darr, DCDvKeyFn key_fn);
+
+#ifdef DC_PARALLEL
+
+/**
+ * Sorts the array using multiple threads, the array is split into chunks that
+ * are sorted in parallel (see `dc_da_sort_stable`) and then merged in parallel
+ *
+ * @param thread_count is the maximum number of threads to use, 0 means the
+ *                     number of available cpus (see `DC_DA_PAR_MIN_CHUNK`)
+ *
+ * NOTE: The result is stable and the same as `dc_da_sort_stable` no matter how
+ * many threads are used, so `cmp_fn` must be safe to call from multiple threads
+ *
+ * NOTE: Parallel functions are only available when `DC_PARALLEL` is defined
+ * before including `dcommon.h`, on POSIX systems they need `-pthread`
+ *
+ * NOTE: No thread outlives the call, threads are started for the chunks and
+ * again for every merge round and joined before moving on, so small arrays are
+ * better sorted with `dc_da_sort_stable`
+ *
+ * @return nothing or error
+ *
+ * NOTE: Allocates a temporary buffer as big as the array
+ */
+DCResVoid dc_da_par_sort(DCDynArr* darr, DCDvCmpFn cmp_fn, usize thread_count);
+
+/**
+ * Calls the visitor for every element of the array with its index and the given
+ * context, the array is split into contiguous chunks (one per thread) and each
+ * chunk is visited in order
+ *
+ * @param thread_count is the maximum number of threads to use, 0 means the
+ *                     number of available cpus (see `DC_DA_PAR_MIN_CHUNK`)
+ *
+ * NOTE: A failing visitor stops its own chunk only, the error of the lowest
+ * failing chunk is returned
+ *
+ * NOTE: Threads are started for each call and joined before it returns
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_da_par_for(DCDynArr* darr, DCDaVisitorFn visitor, voidptr ctx, usize thread_count);
+
+#endif
+
 /**
  * Tries to delete an element by pointer in the given darr
  *
  * @param dv_eq_fn is a function that compares custom extra types added to
- *                 dynamic value
+ *                 dynamic value, when NULL the registered one is used
  *
  * NOTE: it first tries to find the item then it will delete it, so an error
  * with code 6 (not found) can happen.
@@ -389,7 +780,7 @@ DCResVoid dc_da_delete_elp(DCDynArr* darr, DCDynVal* el, DCDvEqFn dv_eq_fn);
  * Tries to delete an element in the given darr
  *
  * @param dv_eq_fn is a function that compares custom extra types added to
- *                 dynamic value
+ *                 dynamic value, when NULL the registered one is used
  *
  * NOTE: it first tries to find the item then it will delete it, so an error
  * with code 6 (not found) can happen.
@@ -614,6 +1005,9 @@ DCResUsize dc_usize_da_to_flat_arr(DCDynArr* arr, usize** out_arr, b1 must_fail)
  * when receives any type other than string, when false the unmatched types will
  * be ignored
  *
+ * NOTE: Inline strings (DCInlineStr) are exported as pointers to their
+ * characters, which stay valid as long as the elements are not changed
+ *
  * @return the number of exported values or error
  */
 DCResUsize dc_string_da_to_flat_arr(DCDynArr* arr, string** out_arr, b1 must_fail);
@@ -657,63 +1051,859 @@ DCResUsize dc_fileptr_da_to_flat_arr(DCDynArr* arr, fileptr** out_arr, b1 must_f
  */
 DCResUsize dc_DCStringView_da_to_flat_arr(DCDynArr* arr, DCStringView** out_arr, b1 must_fail);
 
-// ***************************************************************************************
-
 /**
- * Initializes the given pointer to hash table with wanted capacity and other
- * information (see params)
- *
- * NOTE: capacity cannot and must not be changed after initialization
- *
- * @param hash_fn is the function that hashes the provided keys, keys are
- * voidptr so they can be anything so to say
- *
- * @param key_cmp_fn is the function that compares a provided key and keys in
- * the buckets
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
  *
- * @param pair_free_fn as each hash pair is saved as a dynamic value if they must be
- * freed using special process this is the parameter to be provided
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than i8, when false the unmatched types will be
+ * ignored
  *
- * @return nothing or error
+ * @return the number of exported values or error
  */
-DCResVoid dc_ht_init(DCHashTable* ht, usize capacity, DCHashFn hash_fn, DCKeyCompFn key_cmp_fn, DCHtPairFreeFn pair_free_fn);
+DCResUsize dc_i8_dav_to_flat_arr(DCDynArrView* arr, i8** out_arr, b1 must_fail);
 
 /**
- * Creates, allocates, initializes and returns a pointer to hash table
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
  *
- * @return hash table pointer (DCHashTable*) or error
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than i16, when false the unmatched types will be
+ * ignored
  *
- * NOTE: Allocates memory
+ * @return the number of exported values or error
  */
-DCResHt dc_ht_new(usize capacity, DCHashFn hash_fn, DCKeyCompFn key_cmp_fn, DCHtPairFreeFn pair_free_fn);
+DCResUsize dc_i16_dav_to_flat_arr(DCDynArrView* arr, i16** out_arr, b1 must_fail);
 
 /**
- * Frees the given hash table and all the values
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
  *
- * @return nothing or error
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than i32, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
  */
-DCResVoid dc_ht_free(DCHashTable* ht);
+DCResUsize dc_i32_dav_to_flat_arr(DCDynArrView* arr, i32** out_arr, b1 must_fail);
 
 /**
- * General free function for cleanup process see `dc_cleanup_push_ht` in macros
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
  *
- * @return nothing or error
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than i64, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
  */
-DCResVoid __dc_ht_free(voidptr ht);
+DCResUsize dc_i64_dav_to_flat_arr(DCDynArrView* arr, i64** out_arr, b1 must_fail);
 
 /**
- * Searches for the key and provides the value
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
  *
- * @param out_result is the pointer to the dynamic value pointer in the hash
- * table
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than u8, when false the unmatched types will be
+ * ignored
  *
- * @return index of the value in its bucket or error
+ * @return the number of exported values or error
  */
-DCResUsize dc_ht_find_by_key(DCHashTable* ht, DCDynVal key, DCDynVal** out_result);
+DCResUsize dc_u8_dav_to_flat_arr(DCDynArrView* arr, u8** out_arr, b1 must_fail);
 
 /**
- * Sets a value for the given key
- *
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than u16, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_u16_dav_to_flat_arr(DCDynArrView* arr, u16** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than u32, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_u32_dav_to_flat_arr(DCDynArrView* arr, u32** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than u64, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_u64_dav_to_flat_arr(DCDynArrView* arr, u64** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than f32, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_f32_dav_to_flat_arr(DCDynArrView* arr, f32** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than f64, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_f64_dav_to_flat_arr(DCDynArrView* arr, f64** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than uptr, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_uptr_dav_to_flat_arr(DCDynArrView* arr, uptr** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than char, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_char_dav_to_flat_arr(DCDynArrView* arr, char** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than size, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_size_dav_to_flat_arr(DCDynArrView* arr, size** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than usize, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_usize_dav_to_flat_arr(DCDynArrView* arr, usize** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than string, when false the unmatched types will be
+ * ignored
+ *
+ * NOTE: Inline strings (DCInlineStr) are exported as pointers to their
+ * characters, which stay valid as long as the elements are not changed
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_string_dav_to_flat_arr(DCDynArrView* arr, string** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than voidptr, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_voidptr_dav_to_flat_arr(DCDynArrView* arr, voidptr** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than fileptr, when false the unmatched types will be
+ * ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_fileptr_dav_to_flat_arr(DCDynArrView* arr, fileptr** out_arr, b1 must_fail);
+
+/**
+ * Converts given view to actual array of literal values in dynamic values
+ * supposing all or most of the values are of a same type (see `must_fail`
+ * parameter)
+ *
+ * @param must_fail when true causes the process to break with error code -1
+ * when receives any type other than DCStringView, when false the unmatched types
+ * will be ignored
+ *
+ * @return the number of exported values or error
+ */
+DCResUsize dc_DCStringView_dav_to_flat_arr(DCDynArrView* arr, DCStringView** out_arr, b1 must_fail);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given deque with at least the given capacity (rounded up to a
+ * power of two, minimum is `DC_DQ_INITIAL_CAP`)
+ *
+ * @param element_free_fn is the custom free function for extra types added to
+ * dynamic values
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_init(DCDeque* dq, usize capacity, DCDynValFreeFn element_free_fn);
+
+/**
+ * Frees all the elements of the deque and then the buffer itself and resets it
+ * to zero capacity
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_free(DCDeque* dq);
+
+/**
+ * Frees all the elements of the deque but keeps its capacity
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_clear(DCDeque* dq);
+
+/**
+ * Makes sure the deque can hold `capacity` elements without growing, the
+ * elements are unwrapped to the start of the new buffer while growing
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_reserve(DCDeque* dq, usize capacity);
+
+/**
+ * Adds the given value to the back of the deque
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_push_back(DCDeque* dq, DCDynVal value);
+
+/**
+ * Adds the given value to the front of the deque
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_push_front(DCDeque* dq, DCDynVal value);
+
+/**
+ * Removes the element at the back of the deque
+ *
+ * @param out_popped when provided receives the removed element (and the
+ * responsibility of freeing it), otherwise the element is freed
+ *
+ * NOTE: error code 4 means the deque is empty
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_pop_back(DCDeque* dq, DCDynVal* out_popped);
+
+/**
+ * Removes the element at the front of the deque
+ *
+ * @param out_popped when provided receives the removed element (and the
+ * responsibility of freeing it), otherwise the element is freed
+ *
+ * NOTE: error code 4 means the deque is empty
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_pop_front(DCDeque* dq, DCDynVal* out_popped);
+
+/**
+ * Retrieves pointer to the element at certain index counted from the front of
+ * the deque
+ *
+ * @return pointer to the element or error
+ */
+DCResPtr dc_dq_get(DCDeque* dq, usize index);
+
+/**
+ * Adds `count` values to the back of the deque keeping their order, so
+ * `values[count - 1]` becomes the back element
+ *
+ * NOTE: The values are copied in at most two blocks
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_push_back_values(DCDeque* dq, usize count, DCDynVal* values);
+
+/**
+ * Adds `count` values to the front of the deque keeping their order, so
+ * `values[0]` becomes the front element
+ *
+ * NOTE: The values are copied in at most two blocks
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_push_front_values(DCDeque* dq, usize count, DCDynVal* values);
+
+/**
+ * Removes `count` elements from the front of the deque
+ *
+ * @param out_popped when provided must have room for `count` elements and
+ * receives the removed elements in deque order (and the responsibility of
+ * freeing them), otherwise the elements are freed
+ *
+ * NOTE: The elements are copied out in at most two blocks
+ *
+ * NOTE: In case freeing an element fails, the already freed ones are still
+ * removed from the deque and the error is returned
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_pop_front_values(DCDeque* dq, usize count, DCDynVal* out_popped);
+
+/**
+ * Removes `count` elements from the back of the deque
+ *
+ * @param out_popped when provided must have room for `count` elements and
+ * receives the removed elements in deque order (and the responsibility of
+ * freeing them), otherwise the elements are freed
+ *
+ * NOTE: The elements are copied out in at most two blocks
+ *
+ * NOTE: In case freeing an element fails, the already freed ones are still
+ * removed from the deque and the error is returned
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dq_pop_back_values(DCDeque* dq, usize count, DCDynVal* out_popped);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given segmented array, no chunk is allocated until the first
+ * element is pushed
+ *
+ * @param element_free_fn is the custom free function for extra types added to
+ * dynamic values
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_init(DCSegArr* sarr, DCDynValFreeFn element_free_fn);
+
+/**
+ * Frees all the elements of the segmented array and then all the chunks
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_free(DCSegArr* sarr);
+
+/**
+ * Allocates chunks so the segmented array can hold `capacity` elements
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_reserve(DCSegArr* sarr, usize capacity);
+
+/**
+ * Frees the chunks that are not needed by the current elements
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_trunc(DCSegArr* sarr);
+
+/**
+ * Adds the given value to the end of the segmented array, when the last chunk
+ * is full a new (twice as big) chunk is added and no element is moved
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_push(DCSegArr* sarr, DCDynVal value);
+
+/**
+ * Adds the given value to the end of the segmented array
+ *
+ * @return pointer to the added element (stays valid until it is popped or the
+ * array is freed) or error
+ */
+DCResPtr dc_sa_push2(DCSegArr* sarr, DCDynVal value);
+
+/**
+ * Removes the last element of the segmented array
+ *
+ * @param out_popped when provided receives the removed element (and the
+ * responsibility of freeing it), otherwise the element is freed
+ *
+ * NOTE: error code 4 means the array is empty
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sa_pop(DCSegArr* sarr, DCDynVal* out_popped);
+
+/**
+ * Retrieves pointer to the element at certain index
+ *
+ * @return pointer to the element or error
+ */
+DCResPtr dc_sa_get(DCSegArr* sarr, usize index);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given arena, chunks are allocated lazily
+ *
+ * @param chunk_size is the size of each chunk in bytes, 0 means
+ * `DC_ARENA_CHUNK_SIZE`
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_arena_init(DCArena* arena, usize chunk_size);
+
+/**
+ * Allocates `size` bytes aligned to `DC_ARENA_ALIGN` from the arena
+ *
+ * NOTE: The memory must not be freed, it's released by `dc_arena_reset` or
+ * `dc_arena_free`
+ *
+ * @return pointer to the memory or error
+ */
+DCResVoidptr dc_arena_alloc(DCArena* arena, usize size);
+
+/**
+ * Copies `size` bytes of `src` into memory allocated from the arena
+ *
+ * @return pointer to the copy or error
+ */
+DCResVoidptr dc_arena_memdup(DCArena* arena, const voidptr src, usize size);
+
+/**
+ * Registers a cleanup job that is run on `element` when the arena is reset or
+ * freed (newest first), useful for things living in the arena that hold
+ * memory of their own (e.g. hash tables)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_arena_defer(DCArena* arena, voidptr element, DCCleanupFn cleanup_fn);
+
+/**
+ * Runs the registered cleanup jobs and releases all the memory of the arena
+ * but keeps its newest chunk for reuse
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_arena_reset(DCArena* arena);
+
+/**
+ * Runs the registered cleanup jobs and releases all the memory of the arena
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_arena_free(DCArena* arena);
+
+/**
+ * Deep copies the given dynamic value and everything reachable from it
+ * (strings, arrays, hash tables, pairs, pointed values and shared handles) into
+ * the arena, objects reached more than once are copied once and stay shared
+ * (cycles included)
+ *
+ * NOTE: The copy is released all at once with the arena and must not be freed
+ * with `dc_dv_free`, nothing in it is marked as allocated (long inline strings
+ * stay on the heap but are freed by the arena), symbols are not copied as they
+ * belong to their pool
+ *
+ * NOTE: Copied arrays and hash tables grow inside the arena (new pairs too),
+ * values you add to them are still yours to release, hash tables are copied
+ * bucket by bucket without a pair free function and shared handles become
+ * borrowed handles (see `dc_rc_da_mut`)
+ *
+ * NOTE: On failure the arena may keep a partial copy until it's released,
+ * allocated voidptr, fileptr and extra types cannot be cloned (error code 3)
+ *
+ * @return the copy or error
+ */
+DCRes dc_dv_clone(DCDynVal* dv, DCArena* arena);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given intern pool
+ *
+ * @param capacity is the initial number of slots, it's rounded up to a power
+ * of two and 0 means `DC_INTERN_INITIAL_CAP`
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_intern_init(DCInternPool* pool, usize capacity);
+
+/**
+ * Frees the pool and all of its symbols
+ *
+ * NOTE: Dynamic values holding symbols of the pool must not be used anymore
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_intern_free(DCInternPool* pool);
+
+/**
+ * Returns the symbol of the given NULL terminated string, interning a copy of
+ * it if it's seen for the first time
+ *
+ * @return the symbol or error
+ */
+DCResSymbol dc_intern(DCInternPool* pool, const string str);
+
+/**
+ * Same as `dc_intern` for `len` bytes of `str` (no terminator needed)
+ *
+ * @return the symbol or error
+ */
+DCResSymbol dc_intern2(DCInternPool* pool, const string str, usize len);
+
+/**
+ * Same as `dc_intern` for the text of a string view
+ *
+ * @return the symbol or error
+ */
+DCResSymbol dc_intern_sv(DCInternPool* pool, DCStringView sv);
+
+/**
+ * Looks up `len` bytes of `str` without interning it
+ *
+ * @return the symbol or NULL when it's not interned, or error
+ */
+DCResSymbol dc_intern_find(DCInternPool* pool, const string str, usize len);
+
+/**
+ * Returns the symbol with the given id
+ *
+ * @return the symbol or error (code 4) when there's no such id
+ */
+DCResSymbol dc_intern_get(DCInternPool* pool, u32 id);
+
+/**
+ * Interns the given string and wraps the symbol in a dynamic value
+ *
+ * NOTE: The value is not marked as allocated, symbols are owned by the pool
+ *
+ * @return DCSymbolPtr dynamic value or error
+ */
+DCRes dc_dv_intern(DCInternPool* pool, const string str);
+
+/**
+ * Hash function (`DCHashFn`) for hash tables with DCSymbolPtr keys, returns
+ * the hash computed when the symbol was interned
+ *
+ * @return the hash or error
+ */
+DCResU32 dc_symbol_hash(DCDynVal* key);
+
+/**
+ * Key comparison function (`DCKeyCompFn`) for hash tables with DCSymbolPtr
+ * keys, symbols of the same pool are equal only when they're the same symbol
+ *
+ * @return whether the keys are equal or error
+ */
+DCResBool dc_symbol_key_cmp(DCDynVal* key1, DCDynVal* key2);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given binary writer, encoded values are collected in its
+ * buffer (`buf` and `len`) or streamed to `file` if it's not NULL
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bw_init(DCBinWriter* bw, fileptr file);
+
+/**
+ * Encodes the given dynamic value (and everything nested in it) in the tagged
+ * binary format
+ *
+ * NOTE: Pointed values (DCDynValPtr) and shared handles (DCRcPtr) are written
+ * as the value they point to and views (DCDynArrView) as arrays, extra types
+ * are written through the `to_bin_fn` of their vtable (see
+ * `dc_dv_register_type`), voidptr, fileptr and extra types without one cannot
+ * be serialized (error code 3)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bw_write(DCBinWriter* bw, DCDynVal* dv);
+
+/**
+ * Writes the buffered bytes to the file of the writer (if any)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bw_flush(DCBinWriter* bw);
+
+/**
+ * Flushes the writer and frees its buffer, the file is not closed
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bw_free(DCBinWriter* bw);
+
+/**
+ * Initializes the given binary reader over `len` bytes of `data`
+ *
+ * @param arena when not NULL everything the reader creates is allocated from it
+ * and nothing is marked as allocated (hash tables are registered for cleanup
+ * with `dc_arena_defer` and arrays grow inside the arena), so freeing the
+ * arena releases all the values
+ *
+ * @param zero_copy when true strings and string views point into `data`, which
+ * must then outlive the values
+ *
+ * NOTE: `hash_fn` and `key_cmp_fn` of the reader are given to the hash tables
+ * being read (NULL means the defaults of `dc_ht_init`), set `pool` to read
+ * symbols back as symbols (see `dc_intern`)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_br_init(DCBinReader* br, u8* data, usize len, DCArena* arena, b1 zero_copy);
+
+/**
+ * Decodes the next value of the input (see `dc_br_done`)
+ *
+ * NOTE: Without an arena the returned value owns everything nested in it and is
+ * released with `dc_dv_free`
+ *
+ * NOTE: Extra types are made by the `from_bin_fn` of their vtable whether or
+ * not the reader has an arena
+ *
+ * @return the dynamic value or error
+ */
+DCRes dc_br_read(DCBinReader* br);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given JSON parser over `len` bytes of `data`, every value it
+ * parses is allocated from `arena` so freeing (or resetting) the arena
+ * releases them
+ *
+ * NOTE: `data` doesn't need to be NUL terminated
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_json_init(DCJsonParser* jp, const string data, usize len, DCArena* arena);
+
+/**
+ * Frees the scratch buffers of the parser, parsed values are left to the arena
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_json_free(DCJsonParser* jp);
+
+/**
+ * Parses the rest of the input as one JSON document
+ *
+ * NOTE: Object keys are string views, the hash tables look them up by text so
+ * `dc_dv(string, "key")` finds them too, a repeated key keeps its last value
+ *
+ * NOTE: Parsed hash tables and arrays live in the arena, they must not be
+ * freed, pushing elements or setting keys takes memory from the same arena
+ *
+ * NOTE: Hash tables get a row per four keys (small objects get a single row)
+ * and like every hash table they never grow, setting many more keys on them
+ * makes their rows longer
+ *
+ * NOTE: Malformed input fails with error code 3 (4 for truncated or too deeply
+ * nested input) and the byte position in the message, the text of strings is
+ * not checked to be valid UTF-8
+ *
+ * @return the dynamic value or error
+ */
+DCRes dc_json_parse(DCJsonParser* jp);
+
+/**
+ * Parses the next line of newline delimited JSON into `out_value`, blank lines
+ * are skipped (see `dc_json_parse` for how values are made)
+ *
+ * NOTE: A malformed line fails but the parser moves past it, so calling again
+ * continues with the next line
+ *
+ * @return true if there was a document, false at the end of the input or error
+ */
+DCResBool dc_json_next(DCJsonParser* jp, DCDynVal* out_value);
+
+/**
+ * Initializes the given JSON writer, text is collected in its string builder
+ * (`sb`) or streamed to `file` if it's not NULL
+ *
+ * NOTE: Set `indent` of the writer afterwards for pretty printing
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_init(DCJsonWriter* jw, fileptr file);
+
+/**
+ * Writes the given dynamic value (and everything nested in it) as JSON, as an
+ * element of the open array, the value of the last key of the open object or
+ * a document of its own (documents are separated by new lines)
+ *
+ * NOTE: Integers, floats, booleans and strings (string, DCStringView,
+ * DCInlineStr, DCSymbolPtr and char) are written as themselves, hash tables as
+ * objects, arrays, views and pairs as arrays, pointed values and shared
+ * handles as what they point to, NULL pointers, NaN and infinities as null
+ *
+ * NOTE: Keys of hash tables must be strings, numbers or booleans (the latter
+ * are quoted), extra types are written as the string made by their `tostr_fn`
+ * (see `dc_dv_register_type`), other voidptr and fileptr cannot be written
+ * (error code 3)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_write(DCJsonWriter* jw, DCDynVal* dv);
+
+/**
+ * Opens an array, following writes are its elements until `dc_jw_end`
+ *
+ * NOTE: Elements are written as they come so arrays of any length take the
+ * same memory when the writer has a file
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_begin_array(DCJsonWriter* jw);
+
+/**
+ * Opens an object, following writes are its keys (see `dc_jw_key`) and
+ * values until `dc_jw_end`
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_begin_object(DCJsonWriter* jw);
+
+/**
+ * Writes the key of the next value of the open object
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_key(DCJsonWriter* jw, const string key, usize len);
+
+/**
+ * Closes the last opened array or object
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_end(DCJsonWriter* jw);
+
+/**
+ * Writes the buffered text to the file of the writer (if any)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_flush(DCJsonWriter* jw);
+
+/**
+ * Flushes the writer and frees its buffer, the file is not closed
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_jw_free(DCJsonWriter* jw);
+
+// ***************************************************************************************
+
+/**
+ * Initializes the given pointer to hash table with wanted capacity and other
+ * information (see params)
+ *
+ * NOTE: capacity cannot and must not be changed after initialization
+ *
+ * @param hash_fn is the function that hashes the provided keys, keys are
+ * voidptr so they can be anything so to say, when NULL keys are hashed with
+ * `dc_dv_hash`
+ *
+ * @param key_cmp_fn is the function that compares a provided key and keys in
+ * the buckets, when NULL keys are equal when `dc_dv_cmp` finds them equal
+ *
+ * @param pair_free_fn as each hash pair is saved as a dynamic value if they must be
+ * freed using special process this is the parameter to be provided
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_ht_init(DCHashTable* ht, usize capacity, DCHashFn hash_fn, DCKeyCompFn key_cmp_fn, DCHtPairFreeFn pair_free_fn);
+
+/**
+ * Creates, allocates, initializes and returns a pointer to hash table
+ *
+ * @return hash table pointer (DCHashTable*) or error
+ *
+ * NOTE: Allocates memory
+ */
+DCResHt dc_ht_new(usize capacity, DCHashFn hash_fn, DCKeyCompFn key_cmp_fn, DCHtPairFreeFn pair_free_fn);
+
+/**
+ * Frees the given hash table and all the values
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_ht_free(DCHashTable* ht);
+
+/**
+ * General free function for cleanup process see `dc_cleanup_push_ht` in macros
+ *
+ * @return nothing or error
+ */
+DCResVoid __dc_ht_free(voidptr ht);
+
+/**
+ * Searches for the key and provides the value
+ *
+ * @param out_result is the pointer to the dynamic value pointer in the hash
+ * table
+ *
+ * @return index of the value in its bucket or error
+ */
+DCResUsize dc_ht_find_by_key(DCHashTable* ht, DCDynVal key, DCDynVal** out_result);
+
+/**
+ * Sets a value for the given key
+ *
  * @param set_status indicates the action that must be taken when setting the pair see `DCHashTableSetStatus`, in case of
  * failure error code 7 will be returned
  *
@@ -766,6 +1956,248 @@ DCResUsize dc_ht_keys(DCHashTable* ht, DCDynVal** out_arr);
 
 // ***************************************************************************************
 
+/**
+ * Takes ownership of a heap allocated dynamic array (e.g. from `dc_da_new`) and
+ * boxes it in a reference counted box
+ *
+ * NOTE: The returned value is an owning handle (allocated DCRcPtr), more
+ * handles are made with `dc_rc_share` and `dc_dv_free` on a handle only drops
+ * its reference, the array is freed with the last one
+ *
+ * @return an owning handle or error
+ */
+DCRes dc_rc_new_da(DCDynArr* darr);
+
+/**
+ * Takes ownership of a heap allocated hash table (e.g. from `dc_ht_new`) and
+ * boxes it in a reference counted box
+ *
+ * NOTE: see `dc_rc_new_da`
+ *
+ * @return an owning handle or error
+ */
+DCRes dc_rc_new_ht(DCHashTable* ht);
+
+/**
+ * Takes one more reference to the container of the given handle, nothing is
+ * copied
+ *
+ * NOTE: Safe to call from different threads, as long as the container is only
+ * read while shared
+ *
+ * @return a new owning handle or error
+ */
+DCRes dc_rc_share(DCDynVal* handle);
+
+/**
+ * Drops one reference, the last one frees the container and the box
+ *
+ * NOTE: Usually called through `dc_dv_free` on an owning handle
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_rc_release(DCRc* rc);
+
+/**
+ * Returns the dynamic array of the given owning handle ready to be changed,
+ * when the array is shared it is deep copied first (copy on write) and the
+ * handle is moved to the copy
+ *
+ * NOTE: Strings, pairs, arrays and hash tables owned by the elements are
+ * duplicated, shared handles get one more reference and allocated voidptr,
+ * fileptr and DCDynValPtr elements fail the copy with error code 3
+ *
+ * NOTE: Elements that are not marked as allocated are copied as they are,
+ * arrays (nested ones too) with an `element_free_fn` cannot be copied since
+ * what it releases is unknown (error code 3)
+ *
+ * @return the array or error
+ */
+DCResDa dc_rc_da_mut(DCDynVal* handle);
+
+/**
+ * Returns the hash table of the given owning handle ready to be changed, see
+ * `dc_rc_da_mut`
+ *
+ * NOTE: Keys and values are only deep copied when the table has a
+ * `pair_free_fn` (it owns them)
+ *
+ * @return the hash table or error
+ */
+DCResHt dc_rc_ht_mut(DCDynVal* handle);
+
+// ***************************************************************************************
+
+/**
+ * Initializes an empty ordered map (B+tree)
+ *
+ * @param cmp_fn orders the keys, when NULL the built-in ordering of
+ *               `dc_da_sort` is used
+ *
+ * @param element_free_fn is passed to `dc_dv_free` for every released key and
+ *                        value
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_init(DCBTree* bt, DCDvCmpFn cmp_fn, DCDynValFreeFn element_free_fn);
+
+/**
+ * Releases every key and value and all the nodes of the tree
+ *
+ * NOTE: It does not free the tree itself
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_free(DCBTree* bt);
+
+/**
+ * General function for cleanup process of a B+tree
+ *
+ * @return nothing or error
+ */
+DCResVoid __dc_bt_free(voidptr bt);
+
+/**
+ * Finds the value stored for the given key, `out_value` is set to NULL when the
+ * key does not exist
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_find(DCBTree* bt, DCDynVal key, DCDynVal** out_value);
+
+/**
+ * Creates or updates the entry of the given key in O(log n)
+ *
+ * @param set_status indicates the action that must be taken when the key exists
+ *                   or not, see `DCHashTableSetStatus`, in case of failure error
+ *                   code 7 will be returned
+ *
+ * NOTE: When an existing entry is updated its old value and the given key are
+ * released, the stored key is kept
+ *
+ * NOTE: When nothing is stored the caller keeps the ownership of the key and
+ * value
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_set(DCBTree* bt, DCDynVal key, DCDynVal value, DCHashTableSetStatus set_status);
+
+/**
+ * Deletes and releases the entry of the given key in O(log n)
+ *
+ * @return true if key exists, false if it doesn't or error
+ */
+DCResBool dc_bt_delete(DCBTree* bt, DCDynVal key);
+
+/**
+ * Prepares an iterator over the entries with keys between `from` and `to`
+ * (both inclusive) in key order, see `dc_bt_next`
+ *
+ * NOTE: NULL `from` starts from the smallest key and NULL `to` goes up to the
+ * biggest one, `to` must stay valid while iterating
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_iter(DCBTree* bt, DCDynVal* from, DCDynVal* to, DCBTreeIter* out_it);
+
+/**
+ * Moves the iterator to the next entry and exports pointers to its key and
+ * value (any of the outputs can be NULL)
+ *
+ * NOTE: Keys must not be changed through the exported pointer
+ *
+ * @return true if there was an entry, false at the end of the range or error
+ */
+DCResBool dc_bt_next(DCBTreeIter* it, DCDynVal** out_key, DCDynVal** out_value);
+
+/**
+ * Builds the tree bottom up out of pairs sorted by unique keys in O(n), which
+ * is much faster than setting them one by one
+ *
+ * NOTE: The tree must be empty, on success keys and values are owned by the
+ * tree, if the pairs are not sorted error code 1 is returned and nothing is
+ * taken
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_bt_bulk_load(DCBTree* bt, usize count, DCPair pairs[]);
+
+// ***************************************************************************************
+
+/**
+ * Initializes a heap over the given array and arranges the elements it
+ * already has into heap order in O(n)
+ *
+ * @param cmp_fn orders the elements (smallest on top), when NULL the built-in
+ *               ordering of `dc_da_sort` is used
+ *
+ * NOTE: Handles of the elements already in the array are their indices before
+ * the call
+ *
+ * NOTE: The array stays owned by the caller and must outlive the heap
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_heap_init(DCHeap* heap, DCDynArr* darr, DCDvCmpFn cmp_fn);
+
+/**
+ * Frees the handle bookkeeping of the heap
+ *
+ * NOTE: It does not free the array or its elements, see `dc_da_free`
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_heap_free(DCHeap* heap);
+
+/**
+ * Adds the value to the heap in O(log n)
+ *
+ * NOTE: Handles of popped elements are reused
+ *
+ * @return handle of the new element or error
+ */
+DCResUsize dc_heap_push(DCHeap* heap, DCDynVal value);
+
+/**
+ * Removes the smallest element of the heap in O(log n), when `out_popped` is
+ * provided the element is moved there and the caller owns it, otherwise it is
+ * freed
+ *
+ * NOTE: Popping from an empty heap returns error code 4
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_heap_pop(DCHeap* heap, DCDynVal* out_popped);
+
+/**
+ * Finds the element of the given handle
+ *
+ * NOTE: The returned pointer is valid until the next change to the heap, if you
+ * change the order of the element in place call `dc_heap_fix` afterward
+ *
+ * @return pointer to the element or error
+ */
+DCResPtr dc_heap_get(DCHeap* heap, usize handle);
+
+/**
+ * Restores the heap order after the element of the given handle has been
+ * changed in place in O(log n)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_heap_fix(DCHeap* heap, usize handle);
+
+/**
+ * Replaces the element of the given handle (the old one is freed like
+ * `dc_da_set` does) and moves it to its new place in O(log n), usually to
+ * decrease its key but increasing works as well
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_heap_update(DCHeap* heap, usize handle, DCDynVal value);
+
+// ***************************************************************************************
+
 /**
  * Creates and return a string view literal struct
  *
@@ -805,6 +2237,9 @@ DCResUsize dc_sprintf(string* str, string fmt, ...) __dc_attribute((format(print
  * @return size of allocated string or error
  *
  * NOTE: Allocates memory when str is empty or reallocates it
+ *
+ * NOTE: The length of `str` is measured on every call, use a `DCStrBuilder`
+ * for appending many times
  */
 DCResUsize dc_sappend(string* str, const string fmt, ...) __dc_attribute((format(printf, 2, 3)));
 
@@ -817,9 +2252,90 @@ DCResUsize dc_sappend(string* str, const string fmt, ...) __dc_attribute((format
  */
 DCResString dc_strdup(const string in);
 
+/**
+ * Initializes the given string builder
+ *
+ * @param capacity is the number of bytes reserved up front (including the
+ * terminator), 0 means the buffer is allocated on the first append
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_init(DCStrBuilder* sb, usize capacity);
+
+/**
+ * Makes room for at least `extra` more bytes (plus the terminator)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_reserve(DCStrBuilder* sb, usize extra);
+
+/**
+ * Appends `len` bytes of the given string
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_append(DCStrBuilder* sb, const string str, usize len);
+
+/**
+ * Appends a single character
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_append_char(DCStrBuilder* sb, char c);
+
+/**
+ * Appends the formatted string, formatting goes straight to the free space of
+ * the buffer and is only repeated when it didn't fit
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_appendf(DCStrBuilder* sb, const string fmt, ...) __dc_attribute((format(printf, 2, 3)));
+
+/**
+ * Same as `dc_sb_appendf` with a `va_list`
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_vappendf(DCStrBuilder* sb, const string fmt, va_list args);
+
+/**
+ * Hands over the built string and leaves the builder empty
+ *
+ * NOTE: The string is allocated (an empty one if nothing was appended) and
+ * must be freed by the caller
+ *
+ * @return string or error
+ */
+DCResString dc_sb_take(DCStrBuilder* sb);
+
+/**
+ * Empties the string builder keeping its buffer
+ */
+void dc_sb_clear(DCStrBuilder* sb);
+
+/**
+ * Frees the buffer of the string builder
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_sb_free(DCStrBuilder* sb);
+
+/**
+ * Renders the given dynamic value (and everything nested in it) at the end of
+ * the string builder in one pass
+ *
+ * NOTE: Extra types are rendered with the `tostr_fn` of their vtable (see
+ * `dc_dv_register_type`)
+ *
+ * @return nothing or error
+ */
+DCResVoid dc_dv_write(DCStrBuilder* sb, DCDynVal* dv);
+
 /**
  * Converts the current value of the dynamic value to string
  *
+ * NOTE: Allocates memory
+ *
  * @return string or error
  */
 DCResString dc_tostr_dv(DCDynVal* dv);
@@ -883,6 +2399,17 @@ string dc_get_os();
  */
 string dc_get_arch();
 
+#ifdef DC_PARALLEL
+
+/**
+ * Returns number of available cpus (at least 1)
+ *
+ * NOTE: Only available when `DC_PARALLEL` is defined
+ */
+usize dc_cpu_count();
+
+#endif
+
 /**
  * Function for handling signals and trigger the cleanup in case of
  * pre-initializing
@@ -957,6 +2484,20 @@ DCResVoid dc_free(voidptr variable);
  */
 DCResVoid dc_result_free(voidptr res_ptr);
 
+/**
+ * Portable fallback for `dc_ctz64` when compiler builtins are not available
+ *
+ * NOTE: Result is 64 when x is 0
+ */
+u32 __dc_ctz64(u64 x);
+
+/**
+ * Portable fallback for `dc_clz64` when compiler builtins are not available
+ *
+ * NOTE: Result is 64 when x is 0
+ */
+u32 __dc_clz64(u64 x);
+
 // ***************************************************************************************
 // * Files
 // ***************************************************************************************
@@ -1027,8 +2568,26 @@ DCCleanupPool dc_cleanup_pool = {0};
 
 #include "_dv.c"
 
+#include "_arena.c"
 #include "_da.c"
+#include "_da_sort.c"
+#include "_dv_hash.c"
+
+#ifdef DC_PARALLEL
+#include "_threads.c"
+#include "_da_par.c"
+#endif
+
+#include "_deque.c"
+#include "_seg_arr.c"
 #include "_ht.c"
+#include "_rc.c"
+#include "_btree.c"
+#include "_heap.c"
+#include "_dv_clone.c"
+#include "_intern.c"
+#include "_bin.c"
+#include "_json.c"
 #include "_lit_val.c"
 #include "_string_view.c"
 #include "_utils.c"
@@ -61,9 +61,17 @@ typedef DCHashTable* DCHashTablePtr;
 typedef struct DCDynArr DCDynArr;
 typedef DCDynArr* DCDynArrPtr;
 
+typedef struct DCDynArrView DCDynArrView;
+
 typedef struct DCPair DCPair;
 typedef DCPair* DCPairPtr;
 
+typedef struct DCRc DCRc;
+typedef DCRc* DCRcPtr;
+
+typedef struct DCSymbol DCSymbol;
+typedef DCSymbol* DCSymbolPtr;
+
 // ***************************************************************************************
 // * RESULT TYPE DECLARATIONS
 // ***************************************************************************************